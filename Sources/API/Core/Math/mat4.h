@@ -48,9 +48,15 @@ class CL_Mat3;
 template<typename Type>
 class CL_Mat4;
 
+template<typename Type>
+class CL_Vec2;
+
 template<typename Type>
 class CL_Vec3;
 
+template<typename Type>
+class CL_Vec4;
+
 class CL_Angle;
 
 /// \brief 4D matrix
@@ -365,6 +371,57 @@ public:
 	/// \return reference to this object
 	CL_Mat4<Type> &transpose();
 
+	/// \brief Transform an array of vectors with this matrix
+	///
+	/// Each vector is transformed as: dest = this * src
+	///
+	/// \param src = Vectors to transform
+	/// \param dest = Transformed vectors. May be the same array as src
+	/// \param count = Number of vectors
+	void transform(const CL_Vec4<Type> *src, CL_Vec4<Type> *dest, int count) const;
+
+	/// \brief Transform an array of points with this matrix
+	///
+	/// Each point is transformed as the point (x, y, z, 1), without the perspective divide of get_transformed_point().
+	///
+	/// \param src = Points to transform
+	/// \param dest = Transformed points. May be the same array as src
+	/// \param count = Number of points
+	void transform(const CL_Vec3<Type> *src, CL_Vec3<Type> *dest, int count) const;
+
+	/// \brief Transform an array of 2D points with this matrix
+	///
+	/// Each point is transformed as the point (x, y, 0, 1).
+	///
+	/// \param src = Points to transform
+	/// \param dest = Transformed points. May be the same array as src
+	/// \param count = Number of points
+	void transform(const CL_Vec2<Type> *src, CL_Vec2<Type> *dest, int count) const;
+
+	/// \brief Transform 2D points stored as separate x and y arrays with this matrix
+	///
+	/// Each point is transformed as the point (x, y, 0, 1). The destination arrays may be the same as the source arrays.
+	///
+	/// \param src_x = X coordinates to transform
+	/// \param src_y = Y coordinates to transform
+	/// \param dest_x = Transformed x coordinates
+	/// \param dest_y = Transformed y coordinates
+	/// \param count = Number of points
+	void transform(const Type *src_x, const Type *src_y, Type *dest_x, Type *dest_y, int count) const;
+
+	/// \brief Transform 3D points stored as separate x, y and z arrays with this matrix
+	///
+	/// Each point is transformed as the point (x, y, z, 1). The destination arrays may be the same as the source arrays.
+	///
+	/// \param src_x = X coordinates to transform
+	/// \param src_y = Y coordinates to transform
+	/// \param src_z = Z coordinates to transform
+	/// \param dest_x = Transformed x coordinates
+	/// \param dest_y = Transformed y coordinates
+	/// \param dest_z = Transformed z coordinates
+	/// \param count = Number of points
+	void transform(const Type *src_x, const Type *src_y, const Type *src_z, Type *dest_x, Type *dest_y, Type *dest_z, int count) const;
+
 /// \}
 /// \name Operators
 /// \{
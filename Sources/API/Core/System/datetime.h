@@ -163,7 +163,7 @@ private:
 	unsigned int nanoseconds;
 
 	TimeZone timezone;
-	static const cl_byte64 ticks_from_1601_to_1900;
+	static const cl_byte64 ticks_from_1601_to_1970;
 /// \}
 };
 /// \}
@@ -546,6 +546,15 @@ public:
 	/// \return Temp String
 	static CL_String utf8_to_text(const CL_StringRef8 &utf8);
 
+	/// \brief Checks if a string is well-formed UTF-8
+	///
+	/// Overlong encodings, UTF-16 surrogates and code points above U+10FFFF are rejected.
+	///
+	/// \param utf8 = String Ref8
+	///
+	/// \return true if valid
+	static bool utf8_verify(const CL_StringRef8 &utf8);
+
 	enum BOMType
 	{
 		bom_none,
@@ -605,6 +614,16 @@ private:
 	static const char trailing_bytes_for_utf8[256];
 
 	static const unsigned char bitmask_leadbyte_for_utf8[6];
+
+	/// \brief Returns the length of the leading run of non-null 7-bit ASCII characters
+	static CL_String8::size_type utf8_ascii_length(const unsigned char *data, CL_String8::size_type length);
+
+	/// \brief Returns the length of the leading run of 7-bit ASCII characters
+	static CL_String16::size_type ucs2_ascii_length(const CL_String16::char_type *data, CL_String16::size_type length);
+
+	static void widen_ascii(const unsigned char *input, CL_String8::size_type length, CL_String16::char_type *output);
+
+	static void narrow_ascii(const CL_String16::char_type *input, CL_String16::size_type length, unsigned char *output);
 /// \}
 };
 
@@ -62,6 +62,11 @@ public:
 /// \name Attributes
 /// \{
 public:
+	/// \brief Returns true if this object is invalid
+	bool is_null() const { return !impl; }
+
+	/// \brief Returns the provider interface for this connection
+	CL_DBConnectionProvider *get_provider();
 /// \}
 
 /// \name Operations
@@ -119,6 +124,56 @@ public:
 
 	/// \brief Execute database command.
 	void execute_non_query(CL_DBCommand &command);
+
+	/// \brief Execute database command with its current input parameters as one row of a batch.
+	///
+	/// With Sqlite, the prepared statement is executed directly without creating a reader, and its input
+	/// parameters are cleared afterwards so the next row can be bound. Unless a transaction is already
+	/// active, the first row begins an implicit transaction that is committed by commit_batch(). If a row
+	/// fails, the implicit transaction is rolled back and the batch is discarded. Other providers execute
+	/// each row as execute_non_query() does.
+	void execute_batch_row(CL_DBCommand &command);
+
+	/// \brief Execute database command as one row of a batch with 1 input argument.
+	template <class Arg1>
+	void execute_batch_row(CL_DBCommand &command, Arg1 arg1)
+	{ CL_DBCommand cmd = begin_arg(command).set_arg(arg1).get_result(); execute_batch_row(cmd); }
+
+	/// \brief Execute database command as one row of a batch with 2 input arguments.
+	template <class Arg1, class Arg2>
+	void execute_batch_row(CL_DBCommand &command, Arg1 arg1, Arg2 arg2)
+	{ CL_DBCommand cmd = begin_arg(command).set_arg(arg1).set_arg(arg2).get_result(); execute_batch_row(cmd); }
+
+	/// \brief Execute database command as one row of a batch with 3 input arguments.
+	template <class Arg1, class Arg2, class Arg3>
+	void execute_batch_row(CL_DBCommand &command, Arg1 arg1, Arg2 arg2, Arg3 arg3)
+	{ CL_DBCommand cmd = begin_arg(command).set_arg(arg1).set_arg(arg2).set_arg(arg3).get_result(); execute_batch_row(cmd); }
+
+	/// \brief Execute database command as one row of a batch with 4 input arguments.
+	template <class Arg1, class Arg2, class Arg3, class Arg4>
+	void execute_batch_row(CL_DBCommand &command, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4)
+	{ CL_DBCommand cmd = begin_arg(command).set_arg(arg1).set_arg(arg2).set_arg(arg3).set_arg(arg4).get_result(); execute_batch_row(cmd); }
+
+	/// \brief Execute database command as one row of a batch with 5 input arguments.
+	template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5>
+	void execute_batch_row(CL_DBCommand &command, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5)
+	{ CL_DBCommand cmd = begin_arg(command).set_arg(arg1).set_arg(arg2).set_arg(arg3).set_arg(arg4).set_arg(arg5).get_result(); execute_batch_row(cmd); }
+
+	/// \brief Execute database command as one row of a batch with 6 input arguments.
+	template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6>
+	void execute_batch_row(CL_DBCommand &command, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5, Arg6 arg6)
+	{ CL_DBCommand cmd = begin_arg(command).set_arg(arg1).set_arg(arg2).set_arg(arg3).set_arg(arg4).set_arg(arg5).set_arg(arg6).get_result(); execute_batch_row(cmd); }
+
+	/// \brief Execute database command as one row of a batch with 7 input arguments.
+	template <class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6, class Arg7>
+	void execute_batch_row(CL_DBCommand &command, Arg1 arg1, Arg2 arg2, Arg3 arg3, Arg4 arg4, Arg5 arg5, Arg6 arg6, Arg7 arg7)
+	{ CL_DBCommand cmd = begin_arg(command).set_arg(arg1).set_arg(arg2).set_arg(arg3).set_arg(arg4).set_arg(arg5).set_arg(arg6).set_arg(arg7).get_result(); execute_batch_row(cmd); }
+
+	/// \brief Ends the batch of a database command.
+	///
+	/// Commits the implicit transaction begun by the first batch row, if any.
+	/// \return The number of rows executed in the batch
+	int commit_batch(CL_DBCommand &command);
 /// \}
 
 /// \name Implementation
@@ -128,6 +183,7 @@ private:
 	{
 	public:
 		DBArg(CL_DBConnection &db, const CL_StringRef &format, CL_DBCommand::Type type) : cmd(db.create_command(format, type)), i(1){}
+		DBArg(const CL_DBCommand &cmd) : cmd(cmd), i(1){}
 
 		DBArg &set_arg(const CL_StringRef &arg)
 		{
@@ -193,6 +249,11 @@ private:
 		return DBArg(*this, format, type);
 	}
 
+	DBArg begin_arg(const CL_DBCommand &command)
+	{
+		return DBArg(command);
+	}
+
 	CL_SharedPtr<CL_DBConnection_Impl> impl;
 
 /// \}
@@ -0,0 +1,119 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanDatabase_System clanDatabase System
+/// \{
+
+#pragma once
+
+#include "api_database.h"
+#include "db_connection.h"
+#include "../Core/Signals/callback_0.h"
+
+class CL_DBConnectionPool_Impl;
+
+/// \brief Database connection pool.
+///
+/// Hands out one connection per thread, so several threads can use the same database concurrently.
+/// A thread keeps its connection until it calls release_connection() or the thread ends. The
+/// connection then goes back to the pool and is reused by the next thread asking for one.
+///
+/// The pool opens connections by calling the function given to the constructor, which is also the
+/// place to tune them. For Sqlite a typical setup is WAL mode, where readers never block the writer:
+///
+/// <pre>
+/// CL_DBConnection open_connection()
+/// {
+///     CL_SqliteConnection connection("data.db");
+///     connection.set_journal_mode(CL_SqliteConnection::journal_wal);
+///     connection.set_synchronous(CL_SqliteConnection::synchronous_normal);
+///     connection.set_mmap_size(256*1024*1024);
+///     return connection;
+/// }
+///
+/// CL_DBConnectionPool pool((CL_Callback_0<CL_DBConnection>(&open_connection)));
+/// </pre>
+///
+/// Connections are used from threads created with CL_Thread, which provide the thread local storage
+/// the pool relies on.
+///
+/// \xmlonly !group=Database/System! !header=database.h! \endxmlonly
+class CL_API_DATABASE CL_DBConnectionPool
+{
+/// \name Construction
+/// \{
+public:
+	/// \brief Constructs a null instance
+	CL_DBConnectionPool();
+
+	/// \brief Constructs a connection pool
+	///
+	/// \param func_create_connection = Called to open a connection when no idle connection is available
+	/// \param max_idle_connections = Maximum number of released connections kept open for reuse
+	CL_DBConnectionPool(const CL_Callback_0<CL_DBConnection> &func_create_connection, int max_idle_connections = 16);
+
+	~CL_DBConnectionPool();
+/// \}
+
+/// \name Attributes
+/// \{
+public:
+	/// \brief Returns true if this object is invalid
+	bool is_null() const { return !impl; }
+
+	/// \brief Throw an exception if this object is invalid
+	void throw_if_null() const;
+
+	/// \brief Returns the number of connections opened by the pool
+	int get_connection_count() const;
+
+	/// \brief Returns the number of open connections not currently owned by a thread
+	int get_idle_connection_count() const;
+/// \}
+
+/// \name Operations
+/// \{
+public:
+	/// \brief Returns the connection owned by the calling thread, taking one from the pool on first use
+	CL_DBConnection get_connection();
+
+	/// \brief Returns the connection of the calling thread to the pool
+	void release_connection();
+
+	/// \brief Closes all idle connections
+	void close_idle_connections();
+/// \}
+
+/// \name Implementation
+/// \{
+private:
+	CL_SharedPtr<CL_DBConnectionPool_Impl> impl;
+/// \}
+};
+
+/// \}
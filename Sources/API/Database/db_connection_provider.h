@@ -34,6 +34,7 @@
 #include "api_database.h"
 #include "db_command.h"
 #include "db_transaction.h"
+#include <map>
 
 class CL_DBCommandProvider;
 class CL_DBTransactionProvider;
@@ -75,11 +76,33 @@ public:
 
 	/// \brief Execute database command.
 	virtual void execute_non_query(CL_DBCommandProvider *command) = 0;
+
+	/// \brief Execute database command as one row of a batch.
+	///
+	/// The default implementation executes each row with execute_non_query().
+	virtual void execute_batch_row(CL_DBCommandProvider *command)
+	{
+		execute_non_query(command);
+		batch_rows[command]++;
+	}
+
+	/// \brief Ends the batch of a database command and returns the number of rows executed.
+	virtual int commit_batch(CL_DBCommandProvider *command)
+	{
+		std::map<CL_DBCommandProvider *, int>::iterator it = batch_rows.find(command);
+		if (it == batch_rows.end())
+			return 0;
+		int rows = it->second;
+		batch_rows.erase(it);
+		return rows;
+	}
 /// \}
 
 /// \name Implementation
 /// \{
 private:
+	/// \brief Rows executed per command by the default execute_batch_row()
+	std::map<CL_DBCommandProvider *, int> batch_rows;
 /// \}
 };
 
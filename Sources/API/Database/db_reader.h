@@ -95,6 +95,19 @@ public:
 	/// \brief Retrieves the value of the specified column as a CL_DataBuffer
 	CL_DataBuffer get_column_binary(int index) const;
 
+	/// \brief Retrieves the value of the specified column as a string reference without copying it
+	///
+	/// The reference is only valid until the next call to retrieve_row() or close().
+	CL_StringRef get_column_string_ref(int index) const;
+
+	/// \brief Retrieves the value of the specified column as a pointer to its binary data without copying it
+	///
+	/// The pointer is only valid until the next call to retrieve_row() or close().
+	const void *get_column_binary_data(int index) const;
+
+	/// \brief Returns the size in bytes of the binary value of the specified column
+	int get_column_binary_size(int index) const;
+
 	/// \brief Retrieves the value of the specified column as a string
 	CL_String get_column_string(const CL_StringRef &column_name) const;
 
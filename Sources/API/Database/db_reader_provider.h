@@ -32,9 +32,11 @@
 #pragma once
 
 #include "api_database.h"
+#include "../Core/Text/string_types.h"
+#include "../Core/System/databuffer.h"
+#include <vector>
 
 class CL_DateTime;
-class CL_DataBuffer;
 
 /// \brief Database reader provider.
 ///
@@ -76,6 +78,34 @@ public:
 	
 	/// \brief Retrieves the value of the specified column as a CL_DataBuffer
 	virtual CL_DataBuffer get_column_binary(int index) const = 0;
+
+	/// \brief Returns a reference to the string value of the specified column, valid until the next row is retrieved
+	///
+	/// The default implementation keeps a copy made by get_column_string().
+	virtual CL_StringRef get_column_string_ref(int index) const
+	{
+		if (index >= (int) column_strings.size())
+			column_strings.resize(index + 1);
+		column_strings[index] = get_column_string(index);
+		return column_strings[index];
+	}
+
+	/// \brief Returns a pointer to the binary value of the specified column, valid until the next row is retrieved
+	///
+	/// The default implementation keeps a copy made by get_column_binary().
+	virtual const void *get_column_binary_data(int index) const
+	{
+		if (index >= (int) column_binaries.size())
+			column_binaries.resize(index + 1);
+		column_binaries[index] = get_column_binary(index);
+		return column_binaries[index].get_data();
+	}
+
+	/// \brief Returns the size in bytes of the binary value of the specified column
+	virtual int get_column_binary_size(int index) const
+	{
+		return get_column_binary(index).get_size();
+	}
 /// \}
 
 /// \name Operations
@@ -92,6 +122,9 @@ public:
 /// \name Implementation
 /// \{
 private:
+	/// \brief Column values kept by the default get_column_string_ref() and get_column_binary_data()
+	mutable std::vector<CL_String> column_strings;
+	mutable std::vector<CL_DataBuffer> column_binaries;
 /// \}
 };
 
@@ -0,0 +1,130 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanDisplay_Collision clanDisplay Collision
+/// \{
+
+#pragma once
+
+#include "../api_display.h"
+#include "../../Core/System/sharedptr.h"
+#include <vector>
+
+class CL_CollisionOutline;
+class CL_CollisionWorld_Impl;
+
+/// \brief Pair of outlines found by a collision world.
+///
+/// \xmlonly !group=Display/Collision! !header=display.h! \endxmlonly
+struct CL_CollisionPair
+{
+	/// \brief Id of the first outline, as returned by CL_CollisionWorld::add. Always the lowest id of the pair.
+	int outline1;
+
+	/// \brief Id of the second outline.
+	int outline2;
+};
+
+/// \brief Broad-phase collision detection for many collision outlines.
+///
+/// <p>Testing every outline against every other outline with CL_CollisionOutline::collide
+///    scales quadratically with the number of outlines. A collision world keeps the outlines
+///    in a spatial hash keyed on their minimum enclosing discs, so only outlines whose discs
+///    overlap are passed on to the contour tests.</p>
+/// <p>The world keeps a reference to each outline, so outlines can be moved, rotated and scaled
+///    as usual between calls to find_collisions().</p>
+/// \xmlonly !group=Display/Collision! !header=display.h! \endxmlonly
+class CL_API_DISPLAY CL_CollisionWorld
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs an empty collision world.
+	CL_CollisionWorld();
+
+	~CL_CollisionWorld();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the number of outlines in the world.
+	int get_outline_count() const;
+
+	/// \brief Returns the outline with the given id.
+	CL_CollisionOutline get_outline(int id) const;
+
+	/// \brief Returns the cell size of the spatial hash, or 0 if it is chosen automatically.
+	float get_cell_size() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Adds an outline to the world.
+	///
+	/// \return Id of the outline. Ids of removed outlines are reused.
+	int add(const CL_CollisionOutline &outline);
+
+	/// \brief Removes an outline from the world.
+	void remove(int id);
+
+	/// \brief Removes all outlines from the world.
+	void clear();
+
+	/// \brief Sets the cell size of the spatial hash.
+	///
+	/// \param size = Width and height of a cell, or 0 to use the average diameter of the enclosing discs.
+	void set_cell_size(float size);
+
+	/// \brief Returns all pairs of outlines whose minimum enclosing discs overlap.
+	///
+	/// The pairs are sorted by outline1, then outline2.
+	std::vector<CL_CollisionPair> find_candidate_pairs();
+
+	/// \brief Returns all pairs of outlines that collide.
+	///
+	/// Each candidate pair is tested with CL_CollisionOutline::collide. When collision info
+	/// is enabled on an outline, it receives the info for all pairs where it is outline1.
+	///
+	/// \param num_threads = Number of threads to spread the contour tests over, or 0 for one per core.
+	std::vector<CL_CollisionPair> find_collisions(int num_threads = 1);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SharedPtr<CL_CollisionWorld_Impl> impl;
+/// \}
+};
+
+/// \}
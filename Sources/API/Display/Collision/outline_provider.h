@@ -34,6 +34,7 @@
 
 #include "../api_display.h"
 #include "contour.h"
+#include "../../Core/Math/circle.h"
 
 /// \brief Collision detection contour.
 ///
@@ -62,6 +63,11 @@ class CL_OutlineProvider
 
 	/// \brief return the height of the image used as basis for outline creation, or -1 when loading a precompiled outline.
 	virtual int get_height()=0;
+
+	/// \brief return the minimum enclosing disc of the outline, or a disc with radius 0 if it has to be calculated.
+	///
+	/// When the disc is known and every contour already has sub circles, the outline uses them as they are.
+	virtual CL_Circlef get_minimum_enclosing_disc() { return CL_Circlef(0.0f, 0.0f, 0.0f); }
 /// \}
 /// \name Operations
 /// \{
@@ -42,7 +42,9 @@ class CL_InputSourceProvider;
 
 /// \brief File outline provider is used to load precompiled outlines.
 ///
-/// <p>A CL_OutlineProviderFile is used to load precompiled outlines.</p> 
+/// <p>A CL_OutlineProviderFile is used to load precompiled outlines, as written by CL_CollisionOutline::save.</p>
+/// <p>Version 2 files also contain the sub circles of each contour and the minimum enclosing disc, so
+///    outlines load without tracing or recalculating anything. Version 1 files are still supported.</p>
 /// \xmlonly !group=Display/Collision! !header=display.h! \endxmlonly
 class CL_API_DISPLAY CL_OutlineProviderFile : public CL_OutlineProvider
 {
@@ -81,6 +83,12 @@ class CL_API_DISPLAY CL_OutlineProviderFile : public CL_OutlineProvider
 	/// \brief Not used for file provider. Returns -1.
 	virtual int get_height();
 
+	/// \brief return the minimum enclosing disc stored in the file.
+	virtual CL_Circlef get_minimum_enclosing_disc();
+
+	/// \brief return the version of the outline file format that was loaded.
+	int get_version() const;
+
 /// \}
 /// \name Operations
 /// \{
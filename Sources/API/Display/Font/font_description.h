@@ -130,6 +130,9 @@ public:
 	/// \brief Get the font subpixel rendering setting (defaults to true)
 	bool get_subpixel() const;
 
+	/// \brief Get the font distance field rendering setting (defaults to false)
+	bool get_distance_field() const;
+
 	/// \biref Get the font charset
 	Charset get_charset() const;
 
@@ -183,6 +186,14 @@ public:
 	/// \brief Sets the font subpixel rendering setting (defaults to true)
 	void set_subpixel(bool setting = true);
 
+	/// \brief Sets the font distance field rendering setting (defaults to false)
+	///
+	/// Distance field fonts rasterize each glyph once at a reference size into a signed distance field.
+	/// All sizes of the same typeface share these glyphs, and remain sharp when scaled.
+	/// Only supported by CL_Font_Freetype. Subpixel rendering is ignored when this is set.
+	/// The shared glyphs can only be drawn on one graphic context.
+	void set_distance_field(bool setting = true);
+
 	/// \brief Sets the font charset (defaults to charset_default)
 	///
 	/// \param new_charset = The charset. charset_default = Use operating systems default
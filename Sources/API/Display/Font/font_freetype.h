@@ -105,6 +105,9 @@ public:
 /// \{
 public:
 	/// \brief Set the texture font to use a specified texture group
+	///
+	/// Distance field fonts share their glyphs with all sizes of the typeface, so the texture group applies to all of them.
+	/// It must be set before any of them is drawn.
 	void set_texture_group(CL_TextureGroup &new_texture_group);
 
 /// \}
@@ -33,6 +33,20 @@
 
 #include "../api_display.h"
 #include "pixel_buffer.h"
+#include <vector>
+
+/// \brief Filters used when scaling pixel buffers.
+enum CL_PixelBufferScaleFilter
+{
+	/// \brief Averages the source pixels covered by each destination pixel.
+	cl_scale_filter_box,
+
+	/// \brief Linear interpolation (a tent filter when downscaling).
+	cl_scale_filter_bilinear,
+
+	/// \brief Windowed sinc with three lobes. Sharpest, but can ring at hard edges.
+	cl_scale_filter_lanczos3
+};
 
 /// \brief Pixel data helper class
 ///
@@ -44,6 +58,25 @@ class CL_API_DISPLAY CL_PixelBufferHelp
 public:
 	/// \brief Add a border around a pixelbuffer, duplicating the edge pixels
 	static CL_PixelBuffer add_border(const CL_PixelBuffer &pb, int border_size, const CL_Rect &rect);
+
+	/// \brief Scales a pixelbuffer to a new size using a separable filter
+	///
+	/// \param pb Pixel buffer to scale. Buffers in other formats are converted to cl_rgba8 first.
+	/// \param new_width Width of the scaled buffer
+	/// \param new_height Height of the scaled buffer
+	/// \param filter Resampling filter
+	/// \param num_threads Number of threads to split the rows between (0 uses one per core)
+	/// \return The scaled pixel buffer, in cl_rgba8 format
+	static CL_PixelBuffer scale(const CL_PixelBuffer &pb, int new_width, int new_height, CL_PixelBufferScaleFilter filter = cl_scale_filter_lanczos3, int num_threads = 0);
+
+	/// \brief Generates the full mipmap chain of a pixelbuffer
+	///
+	/// Each level is half the size of the previous one (rounded down, but at least 1), down to 1x1.
+	/// \param pb Pixel buffer for level 0. Buffers in other formats are converted to cl_rgba8 first.
+	/// \param filter Resampling filter used to produce each level from the previous one
+	/// \param num_threads Number of threads to split the rows between (0 uses one per core)
+	/// \return All levels in cl_rgba8 format, starting with level 0
+	static std::vector<CL_PixelBuffer> generate_mipmaps(const CL_PixelBuffer &pb, CL_PixelBufferScaleFilter filter = cl_scale_filter_box, int num_threads = 0);
 /// \}
 };
 
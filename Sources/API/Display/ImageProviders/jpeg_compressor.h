@@ -107,6 +107,18 @@ public:
 	/// \param height = value
 	void set_size(int width, int height);
 
+	/// \brief Set restart interval
+	///
+	/// Restart markers allow decoders to process intervals of the image independently.
+	///
+	/// \param mcus = Number of MCUs between restart markers, or 0 to disable them
+	void set_restart_interval(int mcus);
+
+	/// \brief Set progressive
+	///
+	/// \param enable = Write the image as a series of progressively refined scans
+	void set_progressive(bool enable);
+
 	/// \brief Set color space
 	///
 	/// \param in_color_space = Color Space
@@ -36,6 +36,7 @@
 #include "../Image/pixel_buffer.h"
 #include "../../Core/Text/string_types.h"
 #include "../../Core/IOData/virtual_directory.h"
+#include "../../Core/Signals/callback_v1.h"
 
 class CL_VirtualDirectory;
 
@@ -62,6 +63,52 @@ public:
 	static CL_PixelBuffer load(
 		CL_IODevice &file);
 
+	/// \brief Loads an image scaled down by 1/2, 1/4 or 1/8.
+	///
+	/// The scaling is done as part of the inverse DCT, which makes this considerably
+	/// faster than loading the image at full size and scaling it afterwards.
+	///
+	/// \param filename Name of the file to load.
+	/// \param directory Directory that file name is relative to.
+	/// \param scale_denominator 1, 2, 4 or 8.
+	/// \param num_threads Number of threads used for decoding. 0 uses one per core.
+	static CL_PixelBuffer load_scaled(
+		const CL_String &filename,
+		const CL_VirtualDirectory &directory,
+		int scale_denominator,
+		int num_threads = 0);
+
+	static CL_PixelBuffer load_scaled(
+		const CL_String &fullname,
+		int scale_denominator,
+		int num_threads = 0);
+
+	static CL_PixelBuffer load_scaled(
+		CL_IODevice &file,
+		int scale_denominator,
+		int num_threads = 0);
+
+	/// \brief Loads an image while keeping memory usage low.
+	///
+	/// DCT coefficients are kept in a compact form while the file is read and the image is
+	/// converted band by band afterwards. For a large progressive image this needs a fraction
+	/// of the memory of load(). If \a preview is set, it is invoked with a 1/8 scale image as
+	/// soon as the DC scans of a progressive image have been read, which can be displayed as a
+	/// placeholder while the remaining scans are decoded.
+	///
+	/// \param file File to load.
+	/// \param preview Callback receiving the preview image.
+	/// \param scale_denominator 1, 2, 4 or 8.
+	static CL_PixelBuffer load_low_memory(
+		CL_IODevice &file,
+		const CL_Callback_v1<CL_PixelBuffer> &preview = CL_Callback_v1<CL_PixelBuffer>(),
+		int scale_denominator = 1);
+
+	static CL_PixelBuffer load_low_memory(
+		const CL_String &fullname,
+		const CL_Callback_v1<CL_PixelBuffer> &preview = CL_Callback_v1<CL_PixelBuffer>(),
+		int scale_denominator = 1);
+
 	/// \brief Save the given PixelBuffer into a JPEG
 	///
 	/// \param buffer The CL_PixelBuffer to save, format doesn't matter its converted if needed
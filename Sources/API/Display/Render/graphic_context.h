@@ -96,7 +96,8 @@ enum CL_StandardProgram
 {
 	cl_program_color_only,
 	cl_program_single_texture,
-	cl_program_sprite
+	cl_program_sprite,
+	cl_program_distance_field	///< Sprite program that draws the alpha channel of the textures as a signed distance field
 };
 
 /// \brief Program Object Matrix Flags
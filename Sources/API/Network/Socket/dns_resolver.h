@@ -38,9 +38,13 @@
 class CL_DNSResourceRecord;
 class CL_DNSPacket;
 class CL_DNSResolver_Impl;
+class CL_SocketName;
 
 /// \brief DNS resolver.
 ///
+/// Answers from lookup_resource are cached for as long as their time to live allows, including
+/// negative answers. Concurrent lookups of the same resource share a single query.
+///
 /// \xmlonly !group=Network/Socket! !header=network.h! \endxmlonly
 class CL_API_NETWORK CL_DNSResolver
 {
@@ -50,6 +54,11 @@ class CL_API_NETWORK CL_DNSResolver
 public:
 	CL_DNSResolver();
 
+	/// \brief Constructs a DNS resolver using the specified DNS servers instead of the system configuration
+	///
+	/// \param dns_servers = Socket names of the DNS servers
+	CL_DNSResolver(const std::vector<CL_SocketName> &dns_servers);
+
 	~CL_DNSResolver();
 
 /// \}
@@ -73,17 +82,41 @@ public:
 		int timeout,
 		const CL_String &dns_server_name);
 
+	CL_DNSPacket perform_query(
+		CL_DNSPacket &packet,
+		int timeout,
+		const CL_SocketName &dns_server);
+
 	CL_DNSPacket perform_query(
 		const CL_String &domain_name,
 		const CL_String &resource_type,
 		int timeout,
 		const CL_String &dns_server_name);
 
+	CL_DNSPacket perform_query(
+		const CL_String &domain_name,
+		const CL_String &resource_type,
+		int timeout,
+		const CL_SocketName &dns_server);
+
+	/// \brief Removes all cached answers
+	void clear_cache();
+
 /// \}
 /// \name Implementation
 /// \{
 
 private:
+	std::vector<CL_DNSResourceRecord> lookup_resource_uncached(
+		const CL_String &domain_name,
+		const CL_String &resource_type,
+		int timeout,
+		int &out_ttl,
+		bool &out_negative);
+
+	static int get_ttl(const std::vector<CL_DNSResourceRecord> &records);
+	static int get_negative_ttl(const CL_DNSPacket &packet);
+
 	CL_SharedPtr<CL_DNSResolver_Impl> impl;
 /// \}
 };
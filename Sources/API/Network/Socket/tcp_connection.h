@@ -98,6 +98,9 @@ public:
 	/// \return write_event
 	CL_Event get_write_event();
 
+	/// \brief Returns true if the connection buffers sent and received data
+	bool is_buffered() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -139,6 +142,20 @@ public:
 	/// Both timeout and interval must be set to a non-zero value before any of them are used.  They cannot be specified individually.
 	void set_keep_alive(bool enable, int timeout = 0, int interval = 0);
 
+	/// \brief Enables or disables buffering of sent and received data in user space
+	///
+	/// In buffered mode small writes are collected and sent with a single system call, and
+	/// receives read as much data as is available so small reads (such as read_uint16) are
+	/// served from memory. Buffered data is sent by flush(), when the buffer is full, before
+	/// any receive and by disconnect_graceful().
+	///
+	/// Received data may be waiting in the buffer without the read event being set, so use
+	/// peek() or receive() instead of waiting on get_read_event() in buffered mode.
+	void set_buffered(bool enable = true);
+
+	/// \brief Sends any data held back by buffered mode
+	void flush();
+
 /// \}
 /// \name Implementation
 /// \{
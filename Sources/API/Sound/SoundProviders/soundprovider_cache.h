@@ -0,0 +1,168 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanSound_Sound_Providers clanSound Sound Providers
+/// \{
+
+#pragma once
+
+#include "../api_sound.h"
+#include "../../Core/System/sharedptr.h"
+#include <vector>
+
+/// \brief Decoded sample data stored in the sound provider cache.
+///
+/// \xmlonly !group=Sound/Sound Providers! !header=sound.h! \endxmlonly
+class CL_API_SOUND CL_SoundProviderCacheData
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs an empty block of decoded sample data.
+	///
+	/// \param num_channels Number of channels stored
+	/// \param frequency Playback frequency of the samples
+	CL_SoundProviderCacheData(int num_channels, int frequency);
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the number of channels.
+	int get_num_channels() const { return (int) channels.size(); }
+
+	/// \brief Returns the playback frequency.
+	int get_frequency() const { return frequency; }
+
+	/// \brief Returns the number of samples stored per channel.
+	int get_num_samples() const { return channels.empty() ? 0 : (int) channels[0].size(); }
+
+	/// \brief Returns the number of bytes used by the sample data.
+	int get_memory_size() const { return get_num_samples() * get_num_channels() * sizeof(float); }
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Appends samples to the end of the stored data.
+	///
+	/// \param data_ptr One float array per channel
+	/// \param offset Offset into the arrays of the first sample to append
+	/// \param num_samples Number of samples to append
+	void append(float **data_ptr, int offset, int num_samples);
+
+	/// \brief Copies stored samples into the arrays in data_ptr.
+	///
+	/// \param position Sample position to start reading from
+	/// \param data_ptr One float array per channel
+	/// \param offset Offset into the arrays of the first sample to write
+	/// \param data_requested Number of samples requested
+	/// \return Number of samples copied.
+	int get_data(int position, float **data_ptr, int offset, int data_requested) const;
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	int frequency;
+	std::vector< std::vector<float> > channels;
+/// \}
+};
+
+/// \brief Process wide cache of decoded sample data.
+///
+/// <p>Sound providers that are expensive to decode (such as Ogg Vorbis) store their fully
+///    decoded samples here, keyed by their provider implementation. Later sessions of the
+///    same provider play back from the cache instead of decoding again. The cache evicts
+///    the least recently used entries when the memory budget is exceeded.</p>
+/// <p>The cache also holds the streaming policy: providers larger than the stream
+///    threshold are decoded ahead on a background thread instead of being cached.</p>
+///
+/// \xmlonly !group=Sound/Sound Providers! !header=sound.h! \endxmlonly
+class CL_API_SOUND CL_SoundProviderCache
+{
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the maximum number of bytes the cache may use.
+	static int get_memory_budget();
+
+	/// \brief Returns the number of bytes currently used by cached entries.
+	static int get_memory_used();
+
+	/// \brief Returns the number of lookups that found an entry.
+	static int get_hits();
+
+	/// \brief Returns the number of lookups that did not find an entry.
+	static int get_misses();
+
+	/// \brief Returns the encoded size in bytes above which a provider streams instead of caching.
+	static int get_stream_threshold();
+
+	/// \brief Returns how far ahead, in milliseconds, streaming sessions decode.
+	static int get_stream_buffer_length();
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Looks up the decoded data stored for key.
+	/** \return The cached data, or a null pointer if no entry exists.*/
+	static CL_SharedPtr<CL_SoundProviderCacheData> find(const void *key);
+
+	/// \brief Stores decoded data for key, evicting least recently used entries as needed.
+	/** \return False if the data is larger than the memory budget and was not stored.*/
+	static bool insert(const void *key, const CL_SharedPtr<CL_SoundProviderCacheData> &data);
+
+	/// \brief Removes the entry for key, if any.
+	static void remove(const void *key);
+
+	/// \brief Removes all entries.
+	static void clear();
+
+	/// \brief Sets the maximum number of bytes the cache may use. Defaults to 32 MB.
+	static void set_memory_budget(int bytes);
+
+	/// \brief Resets the hit and miss counters.
+	static void reset_statistics();
+
+	/// \brief Sets the encoded size in bytes above which a provider streams. Defaults to 1 MB.
+	static void set_stream_threshold(int bytes);
+
+	/// \brief Sets how far ahead, in milliseconds, streaming sessions decode. Defaults to 2000.
+	static void set_stream_buffer_length(int milliseconds);
+/// \}
+};
+
+/// \}
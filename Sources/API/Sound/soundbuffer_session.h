@@ -40,6 +40,18 @@ class CL_SoundBuffer;
 class CL_SoundBuffer_Session_Impl;
 class CL_SoundOutput;
 
+/// \brief Sample rate conversion quality used when a session frequency differs from the mixing frequency.
+///
+/// \xmlonly !group=Sound/Audio Mixing! !header=sound.h! \endxmlonly
+enum CL_SoundResampleQuality
+{
+	/// \brief Linear interpolation between neighbouring samples.
+	cl_resample_linear,
+
+	/// \brief Band-limited interpolation using a windowed sinc filter.
+	cl_resample_sinc
+};
+
 /// \brief CL_SoundBuffer_Session provides control over a playing soundeffect.
 ///
 ///    <p>Whenever a soundbuffer is played, it returns a CL_SoundBuffer_Session
@@ -108,6 +120,15 @@ public:
 	/// \brief Returns true if the session is playing
 	bool is_playing();
 
+	/// \brief Returns the sample rate conversion quality.
+	CL_SoundResampleQuality get_resample_quality() const;
+
+	/// \brief Returns the priority of the session.
+	int get_priority() const;
+
+	/// \brief Returns the distance attenuation of the session (0 -> 1).
+	float get_attenuation() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -141,6 +162,33 @@ public:
 	/// \param new_freq New frequency of session.
 	void set_frequency(int new_freq);
 
+	/// \brief Sets the sample rate conversion quality.
+	///
+	/// Linear interpolation is the default. The windowed sinc filter costs more
+	///    per sample but avoids aliasing when pitching sounds up or down.
+	///    No conversion is done when the session and mixing frequencies match.
+	///
+	/// \param quality = Resample quality
+	void set_resample_quality(CL_SoundResampleQuality quality);
+
+	/// \brief Sets the priority of the session.
+	///
+	/// When more sessions are playing than the sound output allows real voices
+	///    for, the sessions with the highest priority are mixed. Sessions with equal
+	///    priority are ranked by their volume multiplied by their attenuation. The
+	///    remaining sessions become virtual: they are silent, and only their position advances.
+	///
+	/// \param priority = Priority, higher values are more important. Default is 0.
+	void set_priority(int priority);
+
+	/// \brief Sets the distance attenuation of the session.
+	///
+	/// The attenuation is multiplied with the volume, and is usually calculated
+	///    by the application from the distance between the listener and the sound source.
+	///
+	/// \param attenuation = Attenuation from 0 (inaudible) to 1 (no attenuation).
+	void set_attenuation(float attenuation);
+
 	/// \brief Sets the volume of the session in a relative measure (0->1)
 	///
 	/// A value of 0 will effectively mute the sound (although it will
@@ -103,9 +103,13 @@ public:
 	void stop_all();
 
 	/// \brief Sets the main/mixer volume on the sound output.
+	///
+	/// The change is queued to the mixer thread and takes effect from the next mixed fragment.
 	void set_global_volume(float volume);
 
 	/// \brief Sets the main panning position on the sound output.
+	///
+	/// The change is queued to the mixer thread and takes effect from the next mixed fragment.
 	void set_global_pan(float pan);
 
 	/// \brief Adds the sound filter to the sound output.
@@ -132,6 +136,7 @@ private:
 	friend class CL_SoundBuffer;
 	friend class CL_Sound;
 	friend class CL_SoundBuffer_Session;
+	friend class CL_SoundOutput_Offline;
 /// \}
 };
 
@@ -61,6 +61,12 @@ public:
 	/// \brief Returns the mixing latency in milliseconds.
 	int get_mixing_latency() const;
 
+	/// \brief Returns the number of threads used to mix sessions.
+	int get_mixer_threads() const;
+
+	/// \brief Returns the maximum number of sessions mixed at the same time.
+	int get_max_real_voices() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -72,6 +78,21 @@ public:
 	/// \brief Sets the mixing latency in milliseconds.
 	void set_mixing_latency(int latency);
 
+	/// \brief Sets the number of threads used to mix sessions.
+	///
+	/// The default, 1, mixes all sessions on the mixer thread. Higher values
+	///    split the playing sessions between that many threads, each mixing into its
+	///    own buffers. 0 uses one thread per core.
+	void set_mixer_threads(int num_threads);
+
+	/// \brief Sets the maximum number of sessions mixed at the same time.
+	///
+	/// Sessions beyond this limit become virtual voices. They are not decoded or
+	///    mixed, and only their position advances, until they are important enough
+	///    to be mixed again. See CL_SoundBuffer_Session::set_priority. The default,
+	///    0, mixes every playing session.
+	void set_max_real_voices(int max_voices);
+
 /// \}
 /// \name Implementation
 /// \{
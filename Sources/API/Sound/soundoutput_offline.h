@@ -0,0 +1,107 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+/// \addtogroup clanSound_Audio_Mixing clanSound Audio Mixing
+/// \{
+
+#pragma once
+
+#include "api_sound.h"
+#include "soundoutput.h"
+
+class CL_IODevice;
+class CL_SoundOutput_Description;
+class CL_SoundOutput_Offline_Impl;
+
+/// \brief Sound output that mixes into memory or a wave file instead of a sound card.
+///
+///   <p>No mixer thread is started. Fragments are mixed as fast as possible whenever
+///    render() is called, which makes the output suitable for benchmarking the mixer
+///    and for rendering audio on machines without sound hardware.</p>
+/// \xmlonly !group=Sound/Audio Mixing! !header=sound.h! \endxmlonly
+class CL_API_SOUND CL_SoundOutput_Offline : public CL_SoundOutput
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a null instance
+	CL_SoundOutput_Offline();
+
+	/// \brief Constructs an offline output rendering into memory.
+	///
+	/// \param desc Mixing frequency and latency. The latency determines the fragment size.
+	CL_SoundOutput_Offline(const CL_SoundOutput_Description &desc);
+
+	/// \brief Constructs an offline output writing 16-bit stereo wave data to a file.
+	///
+	/// \param desc Mixing frequency and latency. The latency determines the fragment size.
+	/// \param wave_file Device the wave file is written to. Must support seeking.
+	CL_SoundOutput_Offline(const CL_SoundOutput_Description &desc, CL_IODevice &wave_file);
+
+	~CL_SoundOutput_Offline();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the number of samples mixed in each fragment.
+	int get_fragment_size() const;
+
+	/// \brief Returns the total number of samples rendered.
+	int get_rendered_samples() const;
+
+	/// \brief Returns the interleaved stereo samples rendered into memory since the last clear().
+	const float *get_data() const;
+
+	/// \brief Returns the number of stereo samples returned by get_data().
+	int get_data_size() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Mixes whole fragments until at least num_samples samples have been rendered.
+	/** \return The number of samples rendered.*/
+	int render(int num_samples);
+
+	/// \brief Discards the samples rendered into memory.
+	void clear();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	CL_SoundOutput_Offline_Impl *get_offline_impl() const;
+/// \}
+};
+
+/// \}
@@ -34,6 +34,8 @@
 #include "api_sqlite.h"
 #include "../Database/db_connection.h"
 
+class CL_SqliteConnectionProvider;
+
 /// \brief Sqlite database connection.
 ///
 /// \xmlonly !group=Sqlite/System! !header=sqlite.h! \endxmlonly
@@ -43,6 +45,38 @@ class CL_API_SQLITE CL_SqliteConnection : public CL_DBConnection
 /// \{
 
 public:
+	/// \brief How CL_DateTime input parameters are stored
+	enum DateTimeStorage
+	{
+		/// \brief As text in the "YYYY-MM-DD HH:MM:SS" format
+		datetime_text,
+
+		/// \brief As a 64 bit integer of UTC ticks (CL_DateTime::to_ticks), which is smaller and needs no parsing
+		datetime_ticks
+	};
+
+	/// \brief Journal modes, see the journal_mode pragma in the Sqlite documentation
+	enum JournalMode
+	{
+		journal_delete,
+		journal_truncate,
+		journal_persist,
+		journal_memory,
+
+		/// \brief Write-ahead log. Readers do not block the writer and the writer does not block readers.
+		journal_wal,
+		journal_off
+	};
+
+	/// \brief How often Sqlite waits for data to reach the disk, see the synchronous pragma in the Sqlite documentation
+	enum SynchronousLevel
+	{
+		synchronous_off,
+
+		/// \brief Safe against corruption in WAL mode, but a power loss may roll back the last transactions
+		synchronous_normal,
+		synchronous_full
+	};
 
 	/// \brief Constructs a SqliteConnection
 	///
@@ -56,18 +90,65 @@ public:
 /// \{
 
 public:
+	/// \brief Returns the maximum number of idle prepared statements kept by the statement cache
+	int get_statement_cache_size() const;
+
+	/// \brief Returns how many commands reused a cached prepared statement
+	cl_ubyte64 get_statement_cache_hits() const;
+
+	/// \brief Returns how many commands had to prepare their SQL text
+	cl_ubyte64 get_statement_cache_misses() const;
+
+	/// \brief Returns how CL_DateTime input parameters are stored
+	DateTimeStorage get_datetime_storage() const;
 
 /// \}
 /// \name Operations
 /// \{
 
 public:
+	/// \brief Sets the maximum number of idle prepared statements kept by the statement cache
+	///
+	/// Commands created with SQL text seen recently reuse the compiled statement instead of preparing
+	/// it again. The least recently used statements are finalized when the cache is full.
+	/// A size of 0 disables the cache. The default size is 64.
+	void set_statement_cache_size(int size);
+
+	/// \brief Finalizes all idle prepared statements in the statement cache
+	void clear_statement_cache();
+
+	/// \brief Sets how CL_DateTime input parameters are stored
+	///
+	/// get_column_datetime() reads both representations, so existing text values stay readable.
+	/// The default is datetime_text.
+	void set_datetime_storage(DateTimeStorage storage);
+
+	/// \brief Sets the journal mode of the database
+	///
+	/// WAL mode is persistent and applies to all connections of the database file.
+	/// Throws an exception if Sqlite cannot switch to the mode, such as WAL for an in-memory database.
+	void set_journal_mode(JournalMode mode);
+
+	/// \brief Sets the synchronous level of this connection
+	void set_synchronous(SynchronousLevel level);
+
+	/// \brief Sets the page cache size of this connection in kilobytes
+	void set_cache_size(int kilobytes);
+
+	/// \brief Sets the maximum number of bytes of the database file accessed through memory mapped I/O
+	///
+	/// A size of 0 disables memory mapped I/O.
+	void set_mmap_size(cl_byte64 size);
+
+	/// \brief Sets how long a statement waits for a lock held by another connection before failing
+	void set_busy_timeout(int milliseconds);
 
 /// \}
 /// \name Implementation
 /// \{
 
 private:
+	CL_SqliteConnectionProvider *get_sqlite_provider() const;
 /// \}
 };
 
@@ -51,7 +51,7 @@ public:
 	///
 	/// \param filename Filename of module file.
 	/// \param provider Input source provider used to retrieve module file.
-	/// \param stream If true, will stream from disk. If false, will load it to memory.
+	/// \param stream If true, decodes ahead on a background thread while playing. If false, the decoded samples are kept in CL_SoundProviderCache (large files stream regardless).
 	CL_SoundProvider_Vorbis(
 		const CL_String &filename,
 		const CL_VirtualDirectory &directory,
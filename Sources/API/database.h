@@ -37,6 +37,7 @@
 
 #include "Database/db_command.h"
 #include "Database/db_connection.h"
+#include "Database/db_connection_pool.h"
 #include "Database/db_transaction.h"
 #include "Database/db_reader.h"
 #include "Database/db_value.h"
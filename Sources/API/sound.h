@@ -44,6 +44,7 @@
 #include "Sound/sound.h"
 #include "Sound/soundoutput.h"
 #include "Sound/soundoutput_description.h"
+#include "Sound/soundoutput_offline.h"
 #include "Sound/soundformat.h"
 #include "Sound/SoundProviders/soundprovider.h"
 #include "Sound/SoundProviders/soundprovider_session.h"
@@ -55,6 +56,7 @@
 
 #include "Sound/SoundProviders/soundprovider_wave.h"
 #include "Sound/SoundProviders/soundprovider_raw.h"
+#include "Sound/SoundProviders/soundprovider_cache.h"
 #include "Sound/SoundProviders/soundprovider_recorder.h"
 #include "Sound/SoundProviders/soundfilter_provider.h"
 
@@ -28,7 +28,10 @@
 
 #include "Core/precomp.h"
 #include "delauney_triangulator_generic.h"
+#include "API/Core/Math/cl_math.h"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_DelauneyTriangulator_Generic construction:
@@ -79,6 +82,14 @@ struct CL_CompareVertices
 	}
 };
 
+struct CL_EqualVertices
+{
+	bool operator()(CL_DelauneyTriangulator_Vertex *a, CL_DelauneyTriangulator_Vertex *b) const
+	{
+		return a->x == b->x && a->y == b->y;
+	}
+};
+
 void CL_DelauneyTriangulator_Generic::create_ordered_vertex_list(std::vector<CL_DelauneyTriangulator_Vertex *> &vertices)
 {
 	std::vector<CL_DelauneyTriangulator_Vertex>::size_type index_vertices, num_vertices;
@@ -92,24 +103,7 @@ void CL_DelauneyTriangulator_Generic::create_ordered_vertex_list(std::vector<CL_
 	std::sort(vertices.begin(), vertices.end(), CL_CompareVertices());
 
 	// Remove duplicates:
-	std::vector<CL_DelauneyTriangulator_Vertex *>::iterator it = vertices.begin();
-	if (it == vertices.end()) return;
-	float last_x = (*it)->x;
-	float last_y = (*it)->y;
-	++it;
-	while (it != vertices.end())
-	{
-		if (last_x == (*it)->x && last_y == (*it)->y)
-		{
-			it = vertices.erase(it);
-		}
-		else
-		{
-			last_x = (*it)->x;
-			last_y = (*it)->y;
-			++it;
-		}
-	}
+	vertices.erase(std::unique(vertices.begin(), vertices.end(), CL_EqualVertices()), vertices.end());
 }
 
 void CL_DelauneyTriangulator_Generic::calculate_supertriangle(std::vector<CL_DelauneyTriangulator_Vertex *> &vertices, CL_DelauneyTriangulator_Triangle &super_triangle)
@@ -145,171 +139,627 @@ void CL_DelauneyTriangulator_Generic::calculate_supertriangle(std::vector<CL_Del
 		}
 	}
 
-	// Setup super triangle based on min/max values:
+	// Setup super triangle based on min/max values.  It is made much larger
+	// than the bounding box, as triangles along the convex hull are lost when
+	// their circumcircle reaches one of the super triangle vertices:
+
+	float margin = 16.0f * cl_max(max_x-min_x, max_y-min_y);
+	if (margin == 0.0f)
+		margin = 1.0f;
 
-	super_triangle.vertex_A->x = min_x-1;
-	super_triangle.vertex_A->y = min_y-1;
+	super_triangle.vertex_A->x = min_x-margin;
+	super_triangle.vertex_A->y = min_y-margin;
 	super_triangle.vertex_A->data = 0;
 
-	super_triangle.vertex_B->x = max_x+(max_x-min_x)+1;
-	super_triangle.vertex_B->y = min_y-1;
+	super_triangle.vertex_B->x = max_x+2.0f*margin;
+	super_triangle.vertex_B->y = min_y-margin;
 	super_triangle.vertex_B->data = 0;
 
-	super_triangle.vertex_C->x = min_x-1;
-	super_triangle.vertex_C->y = max_y+(max_y-min_y)+1;
+	super_triangle.vertex_C->x = min_x-margin;
+	super_triangle.vertex_C->y = max_y+2.0f*margin;
 	super_triangle.vertex_C->data = 0;
 }
 
-void CL_DelauneyTriangulator_Generic::perform_delauney_triangulation(
-	const std::vector<CL_DelauneyTriangulator_Vertex *> &vertices,
-	const CL_DelauneyTriangulator_Triangle &super_triangle,
-	std::vector<CL_DelauneyTriangulator_Triangle> &triangles)
+/////////////////////////////////////////////////////////////////////////////
+// CL_DelauneyTriangulator_Predicates:
+
+/// \brief Robust orientation and in-circle predicates.
+///
+/// The determinants are first evaluated in double precision.  Only when the
+/// rounding error could have changed the sign are they recalculated exactly
+/// using floating-point expansions (J. R. Shewchuk, "Adaptive Precision
+/// Floating-Point Arithmetic and Fast Robust Geometric Predicates").
+/// Coordinate differences are assumed to be exact, which holds for float
+/// input vertices.
+class CL_DelauneyTriangulator_Predicates
 {
-/*
-	delauney triangulation algorithm:
-
-	subroutine triangulate
-	input : vertex list
-	output : triangle list
-		initialize the triangle list
-		determine the supertriangle
-		add supertriangle vertices to the end of the vertex list
-		add the supertriangle to the triangle list
-		for each sample point in the vertex list
-			initialize the edge buffer
-			for each triangle currently in the triangle list
-				calculate the triangle circumcircle center and radius
-				if the point lies in the triangle circumcircle then
-					add the three triangle edges to the edge buffer
-					remove the triangle from the triangle list
-				endif
-			endfor
-			delete all doubly specified edges from the edge buffer
-				this leaves the edges of the enclosing polygon only
-			add to the triangle list all triangles formed between the point 
-				and the edges of the enclosing polygon
-		endfor
-		remove any triangles from the triangle list that use the supertriangle vertices
-		remove the supertriangle vertices from the vertex list
-	end
+public:
+	/// \brief Positive if a, b and c are in counter-clockwise order, negative if clockwise and zero if colinear.
+	static double orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+	{
+		double detleft = (ax - cx) * (by - cy);
+		double detright = (ay - cy) * (bx - cx);
+		double det = detleft - detright;
+		double errbound = ccw_error_bound * (fabs(detleft) + fabs(detright));
+		if (det > errbound || -det > errbound)
+			return det;
+
+		double left[2], right[2], sum[4];
+		two_product(ax - cx, by - cy, left[1], left[0]);
+		two_product(-(ay - cy), bx - cx, right[1], right[0]);
+		int length = expansion_sum(2, left, 2, right, sum);
+		return sum[length - 1];
+	}
 
-	See http://astronomy.swin.edu.au/~pbourke/terrain/triangulate/ for more info
-*/
+	/// \brief Positive if d lies inside the circumcircle of the counter-clockwise triangle a, b, c.
+	static double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+	{
+		double adx = ax - dx;
+		double ady = ay - dy;
+		double bdx = bx - dx;
+		double bdy = by - dy;
+		double cdx = cx - dx;
+		double cdy = cy - dy;
+
+		double bdxcdy = bdx * cdy;
+		double cdxbdy = cdx * bdy;
+		double alift = adx * adx + ady * ady;
+
+		double cdxady = cdx * ady;
+		double adxcdy = adx * cdy;
+		double blift = bdx * bdx + bdy * bdy;
+
+		double adxbdy = adx * bdy;
+		double bdxady = bdx * ady;
+		double clift = cdx * cdx + cdy * cdy;
+
+		double det =
+			alift * (bdxcdy - cdxbdy) +
+			blift * (cdxady - adxcdy) +
+			clift * (adxbdy - bdxady);
+
+		double permanent =
+			(fabs(bdxcdy) + fabs(cdxbdy)) * alift +
+			(fabs(cdxady) + fabs(adxcdy)) * blift +
+			(fabs(adxbdy) + fabs(bdxady)) * clift;
+		double errbound = icc_error_bound * permanent;
+		if (det > errbound || -det > errbound)
+			return det;
+
+		double a_term[32], b_term[32], c_term[32], ab_sum[64], det_sum[96];
+		int a_length = incircle_term(adx, ady, bdx, bdy, cdx, cdy, a_term);
+		int b_length = incircle_term(bdx, bdy, cdx, cdy, adx, ady, b_term);
+		int c_length = incircle_term(cdx, cdy, adx, ady, bdx, bdy, c_term);
+		int ab_length = expansion_sum(a_length, a_term, b_length, b_term, ab_sum);
+		int det_length = expansion_sum(ab_length, ab_sum, c_length, c_term, det_sum);
+		return det_sum[det_length - 1];
+	}
 
-	// Reset triangle list.
-	triangles.clear();
+	static const double epsilon;
+	static const double ccw_error_bound;
+	static const double icc_error_bound;
+
+private:
+	/// \brief Exact value of (ux*ux + uy*uy) * (vx*wy - wx*vy).
+	static int incircle_term(double ux, double uy, double vx, double vy, double wx, double wy, double *result)
+	{
+		double lift_x[2], lift_y[2], lift[4];
+		two_product(ux, ux, lift_x[1], lift_x[0]);
+		two_product(uy, uy, lift_y[1], lift_y[0]);
+		int lift_length = expansion_sum(2, lift_x, 2, lift_y, lift);
+
+		double cross_left[2], cross_right[2], cross[4];
+		two_product(vx, wy, cross_left[1], cross_left[0]);
+		two_product(-wx, vy, cross_right[1], cross_right[0]);
+		int cross_length = expansion_sum(2, cross_left, 2, cross_right, cross);
+
+		int length = 0;
+		double scaled[8], accumulated[32];
+		for (int i = 0; i < lift_length; i++)
+		{
+			int scaled_length = scale_expansion(cross_length, cross, lift[i], scaled);
+			length = expansion_sum(length, result, scaled_length, scaled, accumulated);
+			for (int j = 0; j < length; j++)
+				result[j] = accumulated[j];
+		}
+		if (length == 0)
+			result[length++] = 0.0;
+		return length;
+	}
 
-	// add supertriangle vertices to the end of the vertex list
-	triangles.push_back(super_triangle);
+	static void two_sum(double a, double b, double &x, double &y)
+	{
+		x = a + b;
+		double bvirt = x - a;
+		double avirt = x - bvirt;
+		double bround = b - bvirt;
+		double around = a - avirt;
+		y = around + bround;
+	}
 
-	// for each sample point in the vertex list:
-	std::vector<CL_DelauneyTriangulator_Vertex *>::size_type index_vertices, num_vertices;
-	num_vertices = vertices.size();
-	for (index_vertices = 0; index_vertices < num_vertices; index_vertices++)
+	static void fast_two_sum(double a, double b, double &x, double &y)
 	{
-		CL_DelauneyTriangulator_Vertex *insertion_point = vertices[index_vertices];
+		x = a + b;
+		double bvirt = x - a;
+		y = b - bvirt;
+	}
 
-		// Init edge buffer
-		typedef std::pair<CL_DelauneyTriangulator_Vertex *, CL_DelauneyTriangulator_Vertex *> CL_DelauneyTriangulator_Triangle_Edge;
-		std::vector<CL_DelauneyTriangulator_Triangle_Edge> edges;
+	static void split(double a, double &hi, double &lo)
+	{
+		double c = splitter * a;
+		double abig = c - a;
+		hi = c - abig;
+		lo = a - hi;
+	}
 
-		// For each triangle currently in the triangle list
-		std::vector<CL_DelauneyTriangulator_Triangle>::size_type index_triangles, num_triangles;
-		num_triangles = triangles.size();
-		for (index_triangles = 0; index_triangles < num_triangles; index_triangles++)
+	static void two_product(double a, double b, double &x, double &y)
+	{
+		x = a * b;
+		double ahi, alo, bhi, blo;
+		split(a, ahi, alo);
+		split(b, bhi, blo);
+		double err1 = x - (ahi * bhi);
+		double err2 = err1 - (alo * bhi);
+		double err3 = err2 - (ahi * blo);
+		y = (alo * blo) - err3;
+	}
+
+	/// \brief Sums two expansions, eliminating zero components. Returns the length of h.
+	static int expansion_sum(int elen, const double *e, int flen, const double *f, double *h)
+	{
+		int hlen = 0;
+		for (int i = 0; i < elen; i++)
+			h[hlen++] = e[i];
+
+		for (int i = 0; i < flen; i++)
+		{
+			double q = f[i];
+			int length = 0;
+			for (int j = 0; j < hlen; j++)
+			{
+				double sum, round;
+				two_sum(q, h[j], sum, round);
+				if (round != 0.0)
+					h[length++] = round;
+				q = sum;
+			}
+			if (q != 0.0 || length == 0)
+				h[length++] = q;
+			hlen = length;
+		}
+
+		if (hlen == 0)
+			h[hlen++] = 0.0;
+		return hlen;
+	}
+
+	/// \brief Multiplies an expansion by a double, eliminating zero components. Returns the length of h.
+	static int scale_expansion(int elen, const double *e, double b, double *h)
+	{
+		int hlen = 0;
+		double q, round;
+		two_product(e[0], b, q, round);
+		if (round != 0.0)
+			h[hlen++] = round;
+		for (int i = 1; i < elen; i++)
+		{
+			double product1, product0, sum;
+			two_product(e[i], b, product1, product0);
+			two_sum(q, product0, sum, round);
+			if (round != 0.0)
+				h[hlen++] = round;
+			fast_two_sum(product1, sum, q, round);
+			if (round != 0.0)
+				h[hlen++] = round;
+		}
+		if (q != 0.0 || hlen == 0)
+			h[hlen++] = q;
+		return hlen;
+	}
+
+	static const double splitter;
+};
+
+const double CL_DelauneyTriangulator_Predicates::epsilon = 1.1102230246251565e-16; // 2^-53
+const double CL_DelauneyTriangulator_Predicates::splitter = 134217729.0; // 2^27 + 1
+const double CL_DelauneyTriangulator_Predicates::ccw_error_bound = (3.0 + 16.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16;
+const double CL_DelauneyTriangulator_Predicates::icc_error_bound = (10.0 + 96.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16;
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DelauneyTriangulator_Mesh:
+
+/// \brief Triangle mesh with adjacency used for incremental Bowyer-Watson insertion.
+///
+/// Each inserted point is located by walking from the most recently created
+/// triangle, and the cavity of triangles whose circumcircle contains it is
+/// found by a flood fill through the neighbours.  With the points inserted
+/// along a Hilbert curve both steps touch a constant number of triangles on
+/// average, giving O(n log n) for the whole triangulation (dominated by the sort).
+class CL_DelauneyTriangulator_Mesh
+{
+public:
+	struct Triangle
+	{
+		/// \brief Vertex indices in counter-clockwise order.
+		int vertices[3];
+
+		/// \brief Triangle sharing the edge vertices[i] -> vertices[(i+1)%3], or -1.
+		int neighbours[3];
+
+		/// \brief Cached circumcenter, relative to vertices[0].
+		double center_x, center_y;
+
+		/// \brief Upper bound of the rounding error in center_x and center_y.
+		double center_error;
+
+		int visited;
+	};
+
+	CL_DelauneyTriangulator_Mesh(const std::vector<CL_DelauneyTriangulator_Vertex *> &vertices, const CL_DelauneyTriangulator_Triangle &super_triangle)
+	: last_triangle(0), visit_stamp(0), random_seed(1)
+	{
+		int num_vertices = (int) vertices.size();
+		points.resize((num_vertices + 3) * 2);
+		for (int i = 0; i < num_vertices; i++)
+		{
+			points[i * 2] = vertices[i]->x;
+			points[i * 2 + 1] = vertices[i]->y;
+		}
+		points[num_vertices * 2] = super_triangle.vertex_A->x;
+		points[num_vertices * 2 + 1] = super_triangle.vertex_A->y;
+		points[num_vertices * 2 + 2] = super_triangle.vertex_B->x;
+		points[num_vertices * 2 + 3] = super_triangle.vertex_B->y;
+		points[num_vertices * 2 + 4] = super_triangle.vertex_C->x;
+		points[num_vertices * 2 + 5] = super_triangle.vertex_C->y;
+
+		vertex_lookup.resize(num_vertices + 3, -1);
+		triangles.reserve(num_vertices * 2 + 1);
+
+		// The super triangle vertices must be counter-clockwise:
+		int a = num_vertices, b = num_vertices + 1, c = num_vertices + 2;
+		if (orient2d(a, b, c) < 0.0)
+			std::swap(b, c);
+
+		Triangle super;
+		super.vertices[0] = a;
+		super.vertices[1] = b;
+		super.vertices[2] = c;
+		super.neighbours[0] = -1;
+		super.neighbours[1] = -1;
+		super.neighbours[2] = -1;
+		super.visited = 0;
+		triangles.push_back(super);
+		update_circumcircle(0);
+	}
+
+	void insert(int point)
+	{
+		double x = points[point * 2];
+		double y = points[point * 2 + 1];
+
+		// Find all triangles whose circumcircle contain the point.  They form
+		// a connected cavity around the triangle containing the point:
+		int start = locate(point);
+		visit_stamp++;
+		cavity.clear();
+		cavity.push_back(start);
+		triangles[start].visited = visit_stamp;
+		for (std::vector<int>::size_type index_cavity = 0; index_cavity < cavity.size(); index_cavity++)
 		{
-			CL_DelauneyTriangulator_Triangle &cur_triangle = triangles[index_triangles];
-
-			// todo: cache circumcenter in triangle?
-			CL_DelauneyTriangulator_Vertex circumcenter = find_circumcenter(cur_triangle);
-			float radius_x = cur_triangle.vertex_A->x-circumcenter.x;
-			float radius_y = cur_triangle.vertex_A->y-circumcenter.y;
-			float radius2 = radius_x*radius_x + radius_y*radius_y;
-
-			// Check if the point lies in the triangle circumcircle:
-			float dist_x = insertion_point->x - circumcenter.x;
-			float dist_y = insertion_point->y - circumcenter.y;
-			float dist2 = dist_x*dist_x + dist_y*dist_y;
-			if (dist2 < radius2)
+			const Triangle &cur_triangle = triangles[cavity[index_cavity]];
+			for (int edge = 0; edge < 3; edge++)
 			{
-				// Add triangle edges to edge buffer:
-				edges.push_back(CL_DelauneyTriangulator_Triangle_Edge(cur_triangle.vertex_A, cur_triangle.vertex_B));
-				edges.push_back(CL_DelauneyTriangulator_Triangle_Edge(cur_triangle.vertex_B, cur_triangle.vertex_C));
-				edges.push_back(CL_DelauneyTriangulator_Triangle_Edge(cur_triangle.vertex_C, cur_triangle.vertex_A));
-
-				// Remove triange from triangle list:
-				triangles.erase(triangles.begin()+index_triangles);
-				index_triangles--;
-				num_triangles--;
+				int neighbour = cur_triangle.neighbours[edge];
+				if (neighbour == -1)
+					continue;
+				Triangle &neighbour_triangle = triangles[neighbour];
+				if (neighbour_triangle.visited == visit_stamp || neighbour_triangle.visited == -visit_stamp)
+					continue;
+
+				if (in_circumcircle(neighbour, x, y))
+				{
+					neighbour_triangle.visited = visit_stamp;
+					cavity.push_back(neighbour);
+				}
+				else
+				{
+					neighbour_triangle.visited = -visit_stamp;
+				}
 			}
 		}
 
-		// Delete all doubly specified edges from the edge buffer
-		// this leaves the edges of the enclosing polygon only
-		int index_edges1, index_edges2, num_edges; // intentionally integer to allow index to be negative when deleting index.
-		num_edges = (int) edges.size();
-		for (index_edges1 = 0; index_edges1 < num_edges; index_edges1++)
+		// Find the edges of the enclosing polygon:
+		boundary.clear();
+		for (std::vector<int>::size_type index_cavity = 0; index_cavity < cavity.size(); index_cavity++)
 		{
-			CL_DelauneyTriangulator_Triangle_Edge &edge1 = edges[index_edges1];
-			for (index_edges2 = 0/*index_edges1+1*/; index_edges2 < num_edges; index_edges2++)
+			const Triangle &cur_triangle = triangles[cavity[index_cavity]];
+			for (int edge = 0; edge < 3; edge++)
 			{
-				if (index_edges1 == index_edges2) continue;
-				CL_DelauneyTriangulator_Triangle_Edge &edge2 = edges[index_edges2];
-				if ((edge1.first == edge2.first && edge1.second == edge2.second) ||
-					(edge1.second == edge2.first && edge1.first == edge2.second))
+				int neighbour = cur_triangle.neighbours[edge];
+				if (neighbour == -1 || triangles[neighbour].visited != visit_stamp)
 				{
-					// Same edges, delete both:
-					if (index_edges1 < index_edges2)
-					{
-						edges.erase(edges.begin()+index_edges2);
-						edges.erase(edges.begin()+index_edges1);
-					}
-					else
+					BoundaryEdge boundary_edge;
+					boundary_edge.vertex_A = cur_triangle.vertices[edge];
+					boundary_edge.vertex_B = cur_triangle.vertices[(edge + 1) % 3];
+					boundary_edge.outside = neighbour;
+					boundary.push_back(boundary_edge);
+				}
+			}
+		}
+
+		// Replace the cavity with triangles formed between the point and the
+		// polygon edges, reusing the slots of the removed triangles:
+		for (std::vector<BoundaryEdge>::size_type index_boundary = 0; index_boundary < boundary.size(); index_boundary++)
+		{
+			const BoundaryEdge &boundary_edge = boundary[index_boundary];
+
+			int index_triangle;
+			if (index_boundary < cavity.size())
+			{
+				index_triangle = cavity[index_boundary];
+			}
+			else
+			{
+				index_triangle = (int) triangles.size();
+				triangles.push_back(Triangle());
+			}
+
+			Triangle &new_triangle = triangles[index_triangle];
+			new_triangle.vertices[0] = boundary_edge.vertex_A;
+			new_triangle.vertices[1] = boundary_edge.vertex_B;
+			new_triangle.vertices[2] = point;
+			new_triangle.neighbours[0] = boundary_edge.outside;
+			new_triangle.neighbours[1] = -1;
+			new_triangle.neighbours[2] = -1;
+			new_triangle.visited = 0;
+			update_circumcircle(index_triangle);
+
+			if (boundary_edge.outside != -1)
+			{
+				Triangle &outside_triangle = triangles[boundary_edge.outside];
+				for (int edge = 0; edge < 3; edge++)
+				{
+					if (outside_triangle.vertices[edge] == boundary_edge.vertex_B)
 					{
-						edges.erase(edges.begin()+index_edges1);
-						edges.erase(edges.begin()+index_edges2);
+						outside_triangle.neighbours[edge] = index_triangle;
+						break;
 					}
-					num_edges -= 2;
-					index_edges1--;
+				}
+			}
+
+			vertex_lookup[boundary_edge.vertex_A] = index_triangle;
+		}
+
+		// Link the new triangles to each other.  Every polygon vertex starts
+		// exactly one edge, so the triangle following a->b is the one starting at b:
+		for (std::vector<BoundaryEdge>::size_type index_boundary = 0; index_boundary < boundary.size(); index_boundary++)
+		{
+			int index_triangle = vertex_lookup[boundary[index_boundary].vertex_A];
+			int next_triangle = vertex_lookup[boundary[index_boundary].vertex_B];
+			triangles[index_triangle].neighbours[1] = next_triangle;
+			triangles[next_triangle].neighbours[2] = index_triangle;
+		}
+
+		last_triangle = vertex_lookup[boundary[0].vertex_A];
+	}
+
+	std::vector<double> points;
+	std::vector<Triangle> triangles;
+
+private:
+	struct BoundaryEdge
+	{
+		int vertex_A;
+		int vertex_B;
+		int outside;
+	};
+
+	double orient2d(int a, int b, int c) const
+	{
+		return CL_DelauneyTriangulator_Predicates::orient2d(
+			points[a * 2], points[a * 2 + 1],
+			points[b * 2], points[b * 2 + 1],
+			points[c * 2], points[c * 2 + 1]);
+	}
+
+	/// \brief Walks from the last created triangle towards the point.
+	int locate(int point)
+	{
+		int index_triangle = last_triangle;
+		while (true)
+		{
+			const Triangle &cur_triangle = triangles[index_triangle];
+
+			// Start at a random edge to guarantee termination of the walk:
+			random_seed = random_seed * 1103515245 + 12345;
+			int first_edge = (random_seed >> 16) % 3;
+
+			int edge;
+			for (edge = 0; edge < 3; edge++)
+			{
+				int cur_edge = (first_edge + edge) % 3;
+				if (orient2d(cur_triangle.vertices[cur_edge], cur_triangle.vertices[(cur_edge + 1) % 3], point) < 0.0 &&
+					cur_triangle.neighbours[cur_edge] != -1)
+				{
+					index_triangle = cur_triangle.neighbours[cur_edge];
 					break;
 				}
 			}
+			if (edge == 3)
+				return index_triangle;
 		}
+	}
 
-		// add to the triangle list all triangles formed between the point 
-		// and the edges of the enclosing polygon
-		for (index_edges1 = 0; index_edges1 < num_edges; index_edges1++)
+	void update_circumcircle(int index_triangle)
+	{
+		const double epsilon = CL_DelauneyTriangulator_Predicates::epsilon;
+		Triangle &triangle = triangles[index_triangle];
+
+		double a_x = points[triangle.vertices[0] * 2];
+		double a_y = points[triangle.vertices[0] * 2 + 1];
+		double A = points[triangle.vertices[1] * 2] - a_x;
+		double B = points[triangle.vertices[1] * 2 + 1] - a_y;
+		double C = points[triangle.vertices[2] * 2] - a_x;
+		double D = points[triangle.vertices[2] * 2 + 1] - a_y;
+
+		double E = A*A + B*B;
+		double F = C*C + D*D;
+		double AD = A*D;
+		double BC = B*C;
+		double G = 2.0 * (AD - BC);
+		if (G == 0.0)
 		{
-			CL_DelauneyTriangulator_Triangle triangle;
-			triangle.vertex_A = edges[index_edges1].first;
-			triangle.vertex_B = edges[index_edges1].second;
-			triangle.vertex_C = insertion_point;
-			triangles.push_back(triangle);
+			// Degenerate; always use the exact predicate.
+			triangle.center_x = 0.0;
+			triangle.center_y = 0.0;
+			triangle.center_error = std::numeric_limits<double>::infinity();
+			return;
+		}
+
+		triangle.center_x = (D*E - B*F) / G;
+		triangle.center_y = (A*F - C*E) / G;
+
+		double center_magnitude = fabs(triangle.center_x) + fabs(triangle.center_y);
+		double numerator_error = 4.0 * epsilon * cl_max(fabs(D)*E + fabs(B)*F, fabs(A)*F + fabs(C)*E);
+		double denominator_error = 4.0 * epsilon * (fabs(AD) + fabs(BC));
+		triangle.center_error = 2.0 * ((numerator_error + center_magnitude * denominator_error) / fabs(G) + epsilon * center_magnitude);
+	}
+
+	/// \brief Tests the point against the cached circumcircle, falling back to the exact predicate when too close to call.
+	bool in_circumcircle(int index_triangle, double x, double y) const
+	{
+		const double epsilon = CL_DelauneyTriangulator_Predicates::epsilon;
+		const Triangle &triangle = triangles[index_triangle];
+
+		double a_x = points[triangle.vertices[0] * 2];
+		double a_y = points[triangle.vertices[0] * 2 + 1];
+		double q_x = x - a_x;
+		double q_y = y - a_y;
+
+		// |q - center|^2 - |center|^2
+		double t_x = q_x - 2.0 * triangle.center_x;
+		double t_y = q_y - 2.0 * triangle.center_y;
+		double distance = q_x * t_x + q_y * t_y;
+		double error = 2.0 * ((fabs(q_x) + fabs(q_y)) * 2.0 * triangle.center_error + 3.0 * epsilon * (fabs(q_x * t_x) + fabs(q_y * t_y)));
+		if (distance < -error)
+			return true;
+		if (distance > error)
+			return false;
+
+		int b = triangle.vertices[1];
+		int c = triangle.vertices[2];
+		return CL_DelauneyTriangulator_Predicates::incircle(
+			a_x, a_y,
+			points[b * 2], points[b * 2 + 1],
+			points[c * 2], points[c * 2 + 1],
+			x, y) > 0.0;
+	}
+
+	std::vector<int> cavity;
+	std::vector<BoundaryEdge> boundary;
+	std::vector<int> vertex_lookup;
+	int last_triangle;
+	int visit_stamp;
+	unsigned int random_seed;
+};
+
+/// \brief Position of a point along a Hilbert curve on a 65536x65536 grid.
+static unsigned int cl_delauney_hilbert_index(unsigned int x, unsigned int y)
+{
+	unsigned int index = 0;
+	for (unsigned int s = 1 << 15; s > 0; s >>= 1)
+	{
+		unsigned int rx = (x & s) ? 1 : 0;
+		unsigned int ry = (y & s) ? 1 : 0;
+		index += s * s * ((3 * rx) ^ ry);
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				x = 0xffff - x;
+				y = 0xffff - y;
+			}
+			std::swap(x, y);
 		}
 	}
+	return index;
+}
+
+void CL_DelauneyTriangulator_Generic::perform_delauney_triangulation(
+	const std::vector<CL_DelauneyTriangulator_Vertex *> &vertices,
+	const CL_DelauneyTriangulator_Triangle &super_triangle,
+	std::vector<CL_DelauneyTriangulator_Triangle> &triangles)
+{
+/*
+	Incremental Bowyer-Watson delauney triangulation:
+
+	The vertices are inserted one at a time into a triangle mesh that starts
+	out as the supertriangle.  For each vertex, the triangles whose
+	circumcircle contains it are removed and the resulting cavity is
+	retriangulated by connecting the vertex to the cavity edges.  Finally any
+	triangles that use the supertriangle vertices are removed.
+
+	Unlike the classic formulation, which tests every triangle for every
+	vertex (O(n^2)), this implementation keeps triangle adjacency and cached
+	circumcircles, and inserts the vertices in Hilbert curve order so that
+	locating each vertex and finding its cavity only visits nearby triangles.
+
+	See http://astronomy.swin.edu.au/~pbourke/terrain/triangulate/ for more info
+*/
+
+	// Reset triangle list.
+	triangles.clear();
+
+	int num_vertices = (int) vertices.size();
+	if (num_vertices == 0)
+		return;
+
+	// Sort the vertices along a Hilbert curve:
+	float min_x = vertices[0]->x;
+	float max_x = vertices[0]->x;
+	float min_y = vertices[0]->y;
+	float max_y = vertices[0]->y;
+	for (int index_vertices = 1; index_vertices < num_vertices; index_vertices++)
+	{
+		min_x = cl_min(min_x, vertices[index_vertices]->x);
+		max_x = cl_max(max_x, vertices[index_vertices]->x);
+		min_y = cl_min(min_y, vertices[index_vertices]->y);
+		max_y = cl_max(max_y, vertices[index_vertices]->y);
+	}
+	double extent = cl_max(max_x - min_x, max_y - min_y);
+	double scale = (extent > 0.0) ? 65535.0 / extent : 0.0;
+
+	std::vector< std::pair<unsigned int, int> > insertion_order(num_vertices);
+	for (int index_vertices = 0; index_vertices < num_vertices; index_vertices++)
+	{
+		unsigned int x = (unsigned int) ((vertices[index_vertices]->x - min_x) * scale);
+		unsigned int y = (unsigned int) ((vertices[index_vertices]->y - min_y) * scale);
+		insertion_order[index_vertices].first = cl_delauney_hilbert_index(cl_min(x, 0xffffu), cl_min(y, 0xffffu));
+		insertion_order[index_vertices].second = index_vertices;
+	}
+	std::sort(insertion_order.begin(), insertion_order.end());
+
+	// Insert the vertices:
+	CL_DelauneyTriangulator_Mesh mesh(vertices, super_triangle);
+	for (int index_vertices = 0; index_vertices < num_vertices; index_vertices++)
+		mesh.insert(insertion_order[index_vertices].second);
 
-	// remove any triangles from the triangle list that use the supertriangle vertices
-	std::vector<CL_DelauneyTriangulator_Triangle>::size_type index_triangles, num_triangles;
-	num_triangles = triangles.size();
+	// Output the triangles that do not use the supertriangle vertices:
+	std::vector<CL_DelauneyTriangulator_Mesh::Triangle>::size_type index_triangles, num_triangles;
+	num_triangles = mesh.triangles.size();
+	triangles.reserve(num_triangles);
 	for (index_triangles = 0; index_triangles < num_triangles; index_triangles++)
 	{
-		CL_DelauneyTriangulator_Triangle &cur_triangle = triangles[index_triangles];
-
-		if (
-			cur_triangle.vertex_A == super_triangle.vertex_A ||
-			cur_triangle.vertex_A == super_triangle.vertex_B ||
-			cur_triangle.vertex_A == super_triangle.vertex_C ||
-			cur_triangle.vertex_B == super_triangle.vertex_A ||
-			cur_triangle.vertex_B == super_triangle.vertex_B ||
-			cur_triangle.vertex_B == super_triangle.vertex_C ||
-			cur_triangle.vertex_C == super_triangle.vertex_A ||
-			cur_triangle.vertex_C == super_triangle.vertex_B ||
-			cur_triangle.vertex_C == super_triangle.vertex_C)
+		const CL_DelauneyTriangulator_Mesh::Triangle &cur_triangle = mesh.triangles[index_triangles];
+		if (cur_triangle.vertices[0] < num_vertices &&
+			cur_triangle.vertices[1] < num_vertices &&
+			cur_triangle.vertices[2] < num_vertices)
 		{
-			// triangle share one or more points with supertriangle, remove it:
-			triangles.erase(triangles.begin()+index_triangles);
-			index_triangles--;
-			num_triangles--;
+			CL_DelauneyTriangulator_Triangle triangle;
+			triangle.vertex_A = vertices[cur_triangle.vertices[0]];
+			triangle.vertex_B = vertices[cur_triangle.vertices[1]];
+			triangle.vertex_C = vertices[cur_triangle.vertices[2]];
+			triangles.push_back(triangle);
 		}
 	}
 }
@@ -32,6 +32,7 @@
 #include "API/Core/Math/point.h"
 #include "API/Core/Math/triangle_math.h"
 #include "API/Core/Math/line_math.h"
+#include "API/Core/Math/cl_math.h"
 #include "API/Core/Text/string_types.h"
 #include "ear_clip_triangulator_impl.h"
 #include <cfloat>
@@ -40,7 +41,9 @@
 // CL_EarClipTriangulator_Impl Construction:
 
 CL_EarClipTriangulator_Impl::CL_EarClipTriangulator_Impl()
-: orientation(cl_clockwise), vertex_count(0)
+: orientation(cl_clockwise), ear_stamp_counter(0),
+  vertex_grid_width(0), vertex_grid_height(0), vertex_grid_x(0.0f), vertex_grid_y(0.0f), vertex_grid_scale(0.0f),
+  vertex_count(0)
 {
 	target_array = &vertices;
 }
@@ -107,11 +110,13 @@ void CL_EarClipTriangulator_Impl::clear()
 	vertices.clear();
 	hole.clear();
 	ear_list.clear();
+	vertex_grid.clear();
 	vertex_count = 0;
 }
 
 CL_EarClipResult CL_EarClipTriangulator_Impl::triangulate()
 {
+	create_vertex_grid();
 	create_lists(true);
 
 	int num_triangles = vertices.size()-2;
@@ -121,11 +126,15 @@ CL_EarClipResult CL_EarClipTriangulator_Impl::triangulate()
 	
 	while( tri_count < num_triangles )
 	{
+		while( !ear_list.empty() && !ear_list.back().is_valid() )
+			ear_list.pop_back();
+
 		if( ear_list.empty() ) // something went wrong, but lets not crash anyway. 
 			break;
 
-		LinkedVertice *v = ear_list.back();
+		LinkedVertice *v = ear_list.back().vertex;
 		ear_list.pop_back();
+		v->is_ear = false;
  
 		CL_EarClipTriangulator_Triangle tri;
 
@@ -142,63 +151,23 @@ CL_EarClipResult CL_EarClipTriangulator_Impl::triangulate()
 
 		v->next->previous = v->previous;
 		v->previous->next = v->next;
+		remove_from_vertex_grid(v);
 
 		if( is_ear(*v->next) )
-		{
-			if( v->next->is_ear == false ) // not marked as an ear yet. Mark it, and add to the list.
-			{
-				v->next->is_ear = true;
-				ear_list.push_back(v->next);
-			}
-		}
+			mark_ear(v->next);
 		else
-		{
-			if( v->next->is_ear == true ) // Not an ear any more. Delete from ear list.
-			{
-				v->next->is_ear = false;
-				
-				std::vector<LinkedVertice*>::iterator it;
-				for( it = ear_list.begin(); it != ear_list.end(); ++it )
-				{
-					if( (*it) == v->next )
-					{
-						ear_list.erase(it);
-						break;
-					}
-				}
-			}
-		}
+			unmark_ear(v->next);
 
 		if( is_ear(*v->previous) )
-		{
-			if( v->previous->is_ear == false ) // not marked as an ear yet. Mark it, and add to the list.
-			{
-				v->previous->is_ear = true;
-				ear_list.push_back(v->previous);
-			}
-		}
+			mark_ear(v->previous);
 		else
-		{
-			if( v->previous->is_ear == true ) // Not an ear any more. Delete from ear list.
-			{
-				v->previous->is_ear = false;
-				
-				std::vector<LinkedVertice*>::iterator it;
-				for( it = ear_list.begin(); it != ear_list.end(); ++it )
-				{
-					if( (*it) == v->previous )
-					{
-						ear_list.erase(it);
-						break;
-					}
-				}
-			}
-		}
+			unmark_ear(v->previous);
 
 /*		cl_write_console_line("Ear list:");
-		for( std::vector<LinkedVertice*>::iterator it = ear_list.begin(); it != ear_list.end(); ++it )
+		for( std::vector<EarListEntry>::iterator it = ear_list.begin(); it != ear_list.end(); ++it )
 		{
-			cl_write_console_line("    (%1,%2)", (*it)->x, (*it)->y );
+			if( it->is_valid() )
+				cl_write_console_line("    (%1,%2)", it->vertex->x, it->vertex->y );
 		}
 		cl_write_console_line("");
 */
@@ -240,8 +209,58 @@ void CL_EarClipTriangulator_Impl::end_hole()
 	float inner_point_rel;
 	float distance = FLT_MAX;
 
+	// An outer vertice can never be closer to the hole than to its bounding box. Find
+	// an upper bound for the closest distance from the vertice nearest to the box,
+	// then skip all vertices further away than that from the box. The margin covers
+	// the rounding in the closest point calculation.
+
+	float hole_min_x = hole[0]->x;
+	float hole_max_x = hole[0]->x;
+	float hole_min_y = hole[0]->y;
+	float hole_max_y = hole[0]->y;
+	for (unsigned int hole_cnt = 1; hole_cnt < hole.size(); hole_cnt++)
+	{
+		hole_min_x = cl_min(hole_min_x, hole[hole_cnt]->x);
+		hole_max_x = cl_max(hole_max_x, hole[hole_cnt]->x);
+		hole_min_y = cl_min(hole_min_y, hole[hole_cnt]->y);
+		hole_max_y = cl_max(hole_max_y, hole[hole_cnt]->y);
+	}
+	float hole_margin = 0.0001f * (cl_max(cl_max(fabs(hole_min_x), fabs(hole_max_x)), cl_max(fabs(hole_min_y), fabs(hole_max_y))) + 1.0f);
+	hole_min_x -= hole_margin;
+	hole_max_x += hole_margin;
+	hole_min_y -= hole_margin;
+	hole_max_y += hole_margin;
+
+	std::vector<float> box_distances(vertices.size());
+	unsigned int nearest_box_vertice = 0;
+	for (unsigned int vertex_cnt = 0; vertex_cnt < vertices.size(); vertex_cnt++)
+	{
+		float dx = cl_max(cl_max(hole_min_x - vertices[vertex_cnt]->x, vertices[vertex_cnt]->x - hole_max_x), 0.0f);
+		float dy = cl_max(cl_max(hole_min_y - vertices[vertex_cnt]->y, vertices[vertex_cnt]->y - hole_max_y), 0.0f);
+		box_distances[vertex_cnt] = sqrt(dx*dx + dy*dy);
+		if (box_distances[vertex_cnt] < box_distances[nearest_box_vertice])
+			nearest_box_vertice = vertex_cnt;
+	}
+
+	float distance_bound = FLT_MAX;
+	if (!vertices.empty())
+	{
+		CL_Pointf tmp_outer_point = CL_Pointf(vertices[nearest_box_vertice]->x,vertices[nearest_box_vertice]->y);
+		for (unsigned int hole_cnt = 0; hole_cnt < hole.size(); hole_cnt++)
+		{
+			CL_Pointf tmp_line_start(hole[hole_cnt]->x, hole[hole_cnt]->y);
+			CL_Pointf tmp_line_end(hole[hole_cnt]->next->x, hole[hole_cnt]->next->y);
+			CL_Pointf tmp_inner_point = CL_LineMath::closest_point(tmp_outer_point, tmp_line_start, tmp_line_end);
+			distance_bound = cl_min(distance_bound, tmp_inner_point.distance(tmp_outer_point));
+		}
+		distance_bound *= 1.0001f;
+	}
+
 	for (unsigned int vertex_cnt = 0; vertex_cnt < vertices.size(); vertex_cnt++)
 	{
+		if (box_distances[vertex_cnt] > distance_bound)
+			continue;
+
 		CL_Pointf tmp_outer_point = CL_Pointf(vertices[vertex_cnt]->x,vertices[vertex_cnt]->y);
 
 		for (unsigned int hole_cnt = 0; hole_cnt < hole.size(); hole_cnt++)
@@ -399,8 +418,7 @@ void CL_EarClipTriangulator_Impl::create_lists(bool create_ear_list)
 		{
 			if( is_ear(*(*it)) )
 			{
-				ear_list.push_back((*it));
-				(*it)->is_ear = true;
+				mark_ear(*it);
 
 //				cl_write_console_line(cl_format("    (%1,%2)", (*it)->x, (*it)->y ) );
 			}
@@ -409,12 +427,132 @@ void CL_EarClipTriangulator_Impl::create_lists(bool create_ear_list)
 	}
 }
 
+void CL_EarClipTriangulator_Impl::mark_ear(LinkedVertice *v)
+{
+	if( v->is_ear == false ) // not marked as an ear yet. Mark it, and add to the list.
+	{
+		v->is_ear = true;
+		v->ear_stamp = ++ear_stamp_counter;
+		ear_list.push_back(EarListEntry(v));
+	}
+}
+
+void CL_EarClipTriangulator_Impl::unmark_ear(LinkedVertice *v)
+{
+	// Not an ear any more. The entry in the ear list is invalidated by this and skipped when reached.
+	v->is_ear = false;
+}
+
+void CL_EarClipTriangulator_Impl::create_vertex_grid()
+{
+	vertex_grid.clear();
+
+	// Small polygons are tested linearly, which is faster and matches the historic results exactly.
+	const unsigned int min_grid_vertices = 256;
+	if( vertices.size() < min_grid_vertices )
+		return;
+
+	float min_x = vertices[0]->x;
+	float max_x = vertices[0]->x;
+	float min_y = vertices[0]->y;
+	float max_y = vertices[0]->y;
+	for( unsigned int i = 1; i < vertices.size(); i++ )
+	{
+		min_x = cl_min(min_x, vertices[i]->x);
+		max_x = cl_max(max_x, vertices[i]->x);
+		min_y = cl_min(min_y, vertices[i]->y);
+		max_y = cl_max(max_y, vertices[i]->y);
+	}
+
+	// Aim for roughly one vertex per cell:
+	float width = max_x - min_x;
+	float height = max_y - min_y;
+	float cell_size = sqrt(width * height / vertices.size());
+	if( cell_size <= 0.0f )
+		cell_size = cl_max(cl_max(width, height) / vertices.size(), 1.0f);
+
+	vertex_grid_x = min_x;
+	vertex_grid_y = min_y;
+	vertex_grid_scale = 1.0f / cell_size;
+	vertex_grid_width = cl_min((int)(width * vertex_grid_scale) + 1, (int)vertices.size());
+	vertex_grid_height = cl_min((int)(height * vertex_grid_scale) + 1, (int)vertices.size());
+	vertex_grid.resize(vertex_grid_width * vertex_grid_height);
+
+	for( unsigned int i = 0; i < vertices.size(); i++ )
+	{
+		LinkedVertice *v = vertices[i];
+		vertex_grid[get_vertex_grid_x(v->x) + get_vertex_grid_y(v->y) * vertex_grid_width].push_back(v);
+	}
+}
+
+void CL_EarClipTriangulator_Impl::remove_from_vertex_grid(LinkedVertice *v)
+{
+	if( vertex_grid.empty() )
+		return;
+
+	std::vector<LinkedVertice *> &cell = vertex_grid[get_vertex_grid_x(v->x) + get_vertex_grid_y(v->y) * vertex_grid_width];
+	for( std::vector<LinkedVertice *>::size_type i = 0; i < cell.size(); i++ )
+	{
+		if( cell[i] == v )
+		{
+			cell[i] = cell.back();
+			cell.pop_back();
+			break;
+		}
+	}
+}
+
+int CL_EarClipTriangulator_Impl::get_vertex_grid_x(float x) const
+{
+	int cell_x = (int)((x - vertex_grid_x) * vertex_grid_scale);
+	return cl_clamp(cell_x, 0, vertex_grid_width - 1);
+}
+
+int CL_EarClipTriangulator_Impl::get_vertex_grid_y(float y) const
+{
+	int cell_y = (int)((y - vertex_grid_y) * vertex_grid_scale);
+	return cl_clamp(cell_y, 0, vertex_grid_height - 1);
+}
+
 bool CL_EarClipTriangulator_Impl::is_ear(const LinkedVertice &v)
 {
 	if( is_reflex(v) ) return false;
 
 	CL_Trianglef triangle( CL_Pointf(v.x, v.y), CL_Pointf(v.next->x, v.next->y), CL_Pointf(v.previous->x, v.previous->y) );
 
+	if( !vertex_grid.empty() )
+	{
+		// Only test the remaining vertices in the cells covered by the triangle bounding box,
+		// expanded slightly to cover the rounding in CL_Trianglef::point_inside.
+		float min_x = cl_min(v.x, cl_min(v.next->x, v.previous->x));
+		float max_x = cl_max(v.x, cl_max(v.next->x, v.previous->x));
+		float min_y = cl_min(v.y, cl_min(v.next->y, v.previous->y));
+		float max_y = cl_max(v.y, cl_max(v.next->y, v.previous->y));
+		float margin = (max_x - min_x + max_y - min_y) * 0.0001f;
+
+		int start_x = get_vertex_grid_x(min_x - margin);
+		int end_x = get_vertex_grid_x(max_x + margin);
+		int start_y = get_vertex_grid_y(min_y - margin);
+		int end_y = get_vertex_grid_y(max_y + margin);
+		for( int cell_y = start_y; cell_y <= end_y; cell_y++ )
+		{
+			for( int cell_x = start_x; cell_x <= end_x; cell_x++ )
+			{
+				const std::vector<LinkedVertice *> &cell = vertex_grid[cell_x + cell_y * vertex_grid_width];
+				for( std::vector<LinkedVertice *>::size_type i = 0; i < cell.size(); i++ )
+				{
+					const LinkedVertice *v_check = cell[i];
+					if( v_check == &v || v_check == v.next || v_check == v.previous )
+						continue;
+
+					if( triangle.point_inside( CL_Pointf(v_check->x, v_check->y) ) )
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
 	LinkedVertice *v_check = v.next->next;
 
 	while( v_check != v.previous )
@@ -34,18 +34,19 @@
 class LinkedVertice
 {
 public:
-	LinkedVertice() : x(0), y(0), is_ear(0), previous(0), next(0)
+	LinkedVertice() : x(0), y(0), is_ear(0), ear_stamp(0), previous(0), next(0)
 	{
 		return;
 	}
 
-	LinkedVertice(float x, float y) : x(x), y(y), is_ear(0), previous(0), next(0)
+	LinkedVertice(float x, float y) : x(x), y(y), is_ear(0), ear_stamp(0), previous(0), next(0)
 	{
 		return;
 	}
 
 	float x, y;
 	bool is_ear;
+	int ear_stamp;
 	LinkedVertice *previous;
 	LinkedVertice *next;
 };
@@ -95,10 +96,29 @@ public:
 /// \{
 
 private:
+	struct EarListEntry
+	{
+		EarListEntry(LinkedVertice *vertex) : vertex(vertex), ear_stamp(vertex->ear_stamp) { }
+
+		/// \brief Entries are removed lazily; an entry is only valid while the vertex is still marked with the same stamp.
+		bool is_valid() const { return vertex->is_ear && vertex->ear_stamp == ear_stamp; }
+
+		LinkedVertice *vertex;
+		int ear_stamp;
+	};
+
 	bool is_reflex(const LinkedVertice &v);
 	bool is_ear(const LinkedVertice &v);
 	void create_lists(bool create_ear_list);
 
+	void mark_ear(LinkedVertice *v);
+	void unmark_ear(LinkedVertice *v);
+
+	void create_vertex_grid();
+	void remove_from_vertex_grid(LinkedVertice *v);
+	int get_vertex_grid_x(float x) const;
+	int get_vertex_grid_y(float y) const;
+
 	void set_bridge_vertice_offset(
 		LinkedVertice *target,
 		CL_Pointf split_point,
@@ -111,7 +131,16 @@ private:
 	std::vector<LinkedVertice *> hole;
 	std::vector<LinkedVertice *> *target_array;
 
-	std::vector<LinkedVertice *> ear_list;
+	std::vector<EarListEntry> ear_list;
+	int ear_stamp_counter;
+
+	/// \brief Buckets of the polygon vertices not yet clipped, used by is_ear() for large polygons.
+	std::vector< std::vector<LinkedVertice *> > vertex_grid;
+	int vertex_grid_width;
+	int vertex_grid_height;
+	float vertex_grid_x;
+	float vertex_grid_y;
+	float vertex_grid_scale;
 
 	int vertex_count;
 /// \}
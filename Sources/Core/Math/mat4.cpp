@@ -29,6 +29,8 @@
 
 #include "Core/precomp.h"
 #include "API/Core/Math/mat4.h"
+#include "API/Core/Math/vec2.h"
+#include "API/Core/Math/vec3.h"
 #include "API/Core/Math/vec4.h"
 #include "API/Core/Math/angle.h"
 #include <limits>
@@ -90,6 +92,142 @@ CL_Mat4<float> &CL_Mat4<float>::multiply(const CL_Mat4<float> &mult)
 }
 
 
+#ifndef CL_DISABLE_SSE2
+
+template<>
+void CL_Mat4<float>::transform(const CL_Vec4<float> *src, CL_Vec4<float> *dest, int count) const
+{
+	__m128 col0 = _mm_loadu_ps(matrix);
+	__m128 col1 = _mm_loadu_ps(matrix+4);
+	__m128 col2 = _mm_loadu_ps(matrix+8);
+	__m128 col3 = _mm_loadu_ps(matrix+12);
+
+	for (int i = 0; i < count; i++)
+	{
+		__m128 v = _mm_loadu_ps(&src[i].x);
+		__m128 result = _mm_mul_ps(col0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0,0,0,0)));
+		result = _mm_add_ps(result, _mm_mul_ps(col1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1,1,1,1))));
+		result = _mm_add_ps(result, _mm_mul_ps(col2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2,2,2,2))));
+		result = _mm_add_ps(result, _mm_mul_ps(col3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,3,3))));
+		_mm_storeu_ps(&dest[i].x, result);
+	}
+}
+
+template<>
+void CL_Mat4<float>::transform(const CL_Vec3<float> *src, CL_Vec3<float> *dest, int count) const
+{
+	__m128 col0 = _mm_loadu_ps(matrix);
+	__m128 col1 = _mm_loadu_ps(matrix+4);
+	__m128 col2 = _mm_loadu_ps(matrix+8);
+	__m128 col3 = _mm_loadu_ps(matrix+12);
+
+	for (int i = 0; i < count; i++)
+	{
+		__m128 result = _mm_mul_ps(col0, _mm_set1_ps(src[i].x));
+		result = _mm_add_ps(result, _mm_mul_ps(col1, _mm_set1_ps(src[i].y)));
+		result = _mm_add_ps(result, _mm_mul_ps(col2, _mm_set1_ps(src[i].z)));
+		result = _mm_add_ps(result, col3);
+		_mm_storel_pi((__m64 *) &dest[i].x, result);
+		_mm_store_ss(&dest[i].z, _mm_movehl_ps(result, result));
+	}
+}
+
+template<>
+void CL_Mat4<float>::transform(const CL_Vec2<float> *src, CL_Vec2<float> *dest, int count) const
+{
+	// Two points per register: (x0, y0, x1, y1)
+	__m128 col0 = _mm_setr_ps(matrix[0], matrix[1], matrix[0], matrix[1]);
+	__m128 col1 = _mm_setr_ps(matrix[4], matrix[5], matrix[4], matrix[5]);
+	__m128 col3 = _mm_setr_ps(matrix[12], matrix[13], matrix[12], matrix[13]);
+
+	int i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128 v = _mm_loadu_ps(&src[i].x);
+		__m128 result = _mm_mul_ps(col0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2,2,0,0)));
+		result = _mm_add_ps(result, _mm_mul_ps(col1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,1,1))));
+		result = _mm_add_ps(result, col3);
+		_mm_storeu_ps(&dest[i].x, result);
+	}
+
+	if (i < count)
+	{
+		float x = src[i].x;
+		float y = src[i].y;
+		dest[i].x = x * matrix[0] + y * matrix[4] + matrix[12];
+		dest[i].y = x * matrix[1] + y * matrix[5] + matrix[13];
+	}
+}
+
+template<>
+void CL_Mat4<float>::transform(const float *src_x, const float *src_y, float *dest_x, float *dest_y, int count) const
+{
+	__m128 m0 = _mm_set1_ps(matrix[0]);
+	__m128 m1 = _mm_set1_ps(matrix[1]);
+	__m128 m4 = _mm_set1_ps(matrix[4]);
+	__m128 m5 = _mm_set1_ps(matrix[5]);
+	__m128 m12 = _mm_set1_ps(matrix[12]);
+	__m128 m13 = _mm_set1_ps(matrix[13]);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(src_x + i);
+		__m128 y = _mm_loadu_ps(src_y + i);
+		_mm_storeu_ps(dest_x + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m0), _mm_mul_ps(y, m4)), m12));
+		_mm_storeu_ps(dest_y + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m1), _mm_mul_ps(y, m5)), m13));
+	}
+
+	for (; i < count; i++)
+	{
+		float x = src_x[i];
+		float y = src_y[i];
+		dest_x[i] = x * matrix[0] + y * matrix[4] + matrix[12];
+		dest_y[i] = x * matrix[1] + y * matrix[5] + matrix[13];
+	}
+}
+
+template<>
+void CL_Mat4<float>::transform(const float *src_x, const float *src_y, const float *src_z, float *dest_x, float *dest_y, float *dest_z, int count) const
+{
+	__m128 m0 = _mm_set1_ps(matrix[0]);
+	__m128 m1 = _mm_set1_ps(matrix[1]);
+	__m128 m2 = _mm_set1_ps(matrix[2]);
+	__m128 m4 = _mm_set1_ps(matrix[4]);
+	__m128 m5 = _mm_set1_ps(matrix[5]);
+	__m128 m6 = _mm_set1_ps(matrix[6]);
+	__m128 m8 = _mm_set1_ps(matrix[8]);
+	__m128 m9 = _mm_set1_ps(matrix[9]);
+	__m128 m10 = _mm_set1_ps(matrix[10]);
+	__m128 m12 = _mm_set1_ps(matrix[12]);
+	__m128 m13 = _mm_set1_ps(matrix[13]);
+	__m128 m14 = _mm_set1_ps(matrix[14]);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(src_x + i);
+		__m128 y = _mm_loadu_ps(src_y + i);
+		__m128 z = _mm_loadu_ps(src_z + i);
+		_mm_storeu_ps(dest_x + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m0), _mm_mul_ps(y, m4)), _mm_mul_ps(z, m8)), m12));
+		_mm_storeu_ps(dest_y + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m1), _mm_mul_ps(y, m5)), _mm_mul_ps(z, m9)), m13));
+		_mm_storeu_ps(dest_z + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m2), _mm_mul_ps(y, m6)), _mm_mul_ps(z, m10)), m14));
+	}
+
+	for (; i < count; i++)
+	{
+		float x = src_x[i];
+		float y = src_y[i];
+		float z = src_z[i];
+		dest_x[i] = x * matrix[0] + y * matrix[4] + z * matrix[8] + matrix[12];
+		dest_y[i] = x * matrix[1] + y * matrix[5] + z * matrix[9] + matrix[13];
+		dest_z[i] = x * matrix[2] + y * matrix[6] + z * matrix[10] + matrix[14];
+	}
+}
+
+#endif
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_Mat4 construction:
 
@@ -1015,6 +1153,65 @@ CL_Mat4<Type> &CL_Mat4<Type>::transpose()
 	return *this;
 }
 
+template<typename Type>
+void CL_Mat4<Type>::transform(const CL_Vec4<Type> *src, CL_Vec4<Type> *dest, int count) const
+{
+	for (int i = 0; i < count; i++)
+		dest[i] = (*this) * src[i];
+}
+
+template<typename Type>
+void CL_Mat4<Type>::transform(const CL_Vec3<Type> *src, CL_Vec3<Type> *dest, int count) const
+{
+	for (int i = 0; i < count; i++)
+	{
+		Type x = src[i].x;
+		Type y = src[i].y;
+		Type z = src[i].z;
+		dest[i].x = x * matrix[0] + y * matrix[4] + z * matrix[8] + matrix[12];
+		dest[i].y = x * matrix[1] + y * matrix[5] + z * matrix[9] + matrix[13];
+		dest[i].z = x * matrix[2] + y * matrix[6] + z * matrix[10] + matrix[14];
+	}
+}
+
+template<typename Type>
+void CL_Mat4<Type>::transform(const CL_Vec2<Type> *src, CL_Vec2<Type> *dest, int count) const
+{
+	for (int i = 0; i < count; i++)
+	{
+		Type x = src[i].x;
+		Type y = src[i].y;
+		dest[i].x = x * matrix[0] + y * matrix[4] + matrix[12];
+		dest[i].y = x * matrix[1] + y * matrix[5] + matrix[13];
+	}
+}
+
+template<typename Type>
+void CL_Mat4<Type>::transform(const Type *src_x, const Type *src_y, Type *dest_x, Type *dest_y, int count) const
+{
+	for (int i = 0; i < count; i++)
+	{
+		Type x = src_x[i];
+		Type y = src_y[i];
+		dest_x[i] = x * matrix[0] + y * matrix[4] + matrix[12];
+		dest_y[i] = x * matrix[1] + y * matrix[5] + matrix[13];
+	}
+}
+
+template<typename Type>
+void CL_Mat4<Type>::transform(const Type *src_x, const Type *src_y, const Type *src_z, Type *dest_x, Type *dest_y, Type *dest_z, int count) const
+{
+	for (int i = 0; i < count; i++)
+	{
+		Type x = src_x[i];
+		Type y = src_y[i];
+		Type z = src_z[i];
+		dest_x[i] = x * matrix[0] + y * matrix[4] + z * matrix[8] + matrix[12];
+		dest_y[i] = x * matrix[1] + y * matrix[5] + z * matrix[9] + matrix[13];
+		dest_z[i] = x * matrix[2] + y * matrix[6] + z * matrix[10] + matrix[14];
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_Mat4 implementation:
 
@@ -228,19 +228,33 @@ void CL_PointSetMath::minimum_disc_with_3points(
 {
 	// There is only one circle with all three points on its boundary.
 
-	// Find center:
-	// http://astronomy.swin.edu.au/~pbourke/geometry/circlefrom3/
-	// 
-	CL_Pointf ji_mid  = CL_LineMath::midpoint(points[i],points[j]);
-	CL_Pointf ji_norm = ji_mid + CL_Pointf(points[i].y - ji_mid.y, -(points[i].x - ji_mid.x));
-	CL_Pointf ki_mid  = CL_LineMath::midpoint(points[k],points[i]);
-	CL_Pointf ki_norm = ki_mid + CL_Pointf(points[k].y - ki_mid.y, -(points[k].x - ki_mid.x));
-
-	CL_LineSegment2f line_segment_a( ji_mid, ji_norm );
-	CL_LineSegment2f line_segment_b( ki_mid, ki_norm );
-
-	bool did_intersect;
-	smalldisc.position = line_segment_a.get_intersection( line_segment_b, did_intersect );
+	// Find center as the intersection of the perpendicular bisectors of (i,j) and (i,k).
+	// The bisectors are lines, not segments, so solve for the intersection directly.
+	float bx = points[j].x - points[i].x;
+	float by = points[j].y - points[i].y;
+	float cx = points[k].x - points[i].x;
+	float cy = points[k].y - points[i].y;
+	float d = 2.0f * (bx * cy - by * cx);
+	if (d == 0.0f)
+	{
+		// Collinear points; the disc spans the two points furthest apart
+		const CL_Pointf *a = &points[i], *b = &points[j];
+		if (points[i].distance(points[k]) > a->distance(*b))
+			b = &points[k];
+		if (points[j].distance(points[k]) > a->distance(*b))
+		{
+			a = &points[j];
+			b = &points[k];
+		}
+		smalldisc.position = CL_LineMath::midpoint(*a, *b);
+		smalldisc.radius = a->distance(*b) / 2.0f;
+		return;
+	}
+
+	float b_len2 = bx * bx + by * by;
+	float c_len2 = cx * cx + cy * cy;
+	smalldisc.position.x = points[i].x + (cy * b_len2 - by * c_len2) / d;
+	smalldisc.position.y = points[i].y + (bx * c_len2 - cx * b_len2) / d;
 
 	// Since (i,j,k) are all on the circle, just get distance to one of them
 	smalldisc.radius = smalldisc.position.distance(points[i]);
@@ -40,7 +40,7 @@
 
 
 #ifndef WIN32
-const cl_byte64 CL_DateTime::ticks_from_1601_to_1900 = 94354848000000000LL;
+const cl_byte64 CL_DateTime::ticks_from_1601_to_1970 = 116444736000000000LL;
 #endif
 
 CL_DateTime::CL_DateTime()
@@ -83,7 +83,7 @@ CL_DateTime CL_DateTime::get_current_utc_time()
 	unix_ticks = time(&unix_ticks);
 	if (unix_ticks == -1)
 		throw CL_Exception("Failed to get current UTC time");
-	cl_byte64 ticks = ticks_from_1601_to_1900 + ((cl_byte64) unix_ticks) * 10000000;
+	cl_byte64 ticks = ticks_from_1601_to_1970 + ((cl_byte64) unix_ticks) * 10000000;
 	return CL_DateTime::get_utc_time_from_ticks(ticks);
 #endif
 }
@@ -120,7 +120,7 @@ CL_DateTime CL_DateTime::get_utc_time_from_ticks(cl_byte64 ticks)
 	#else
 		tm tm_utc;
 		memset(&tm_utc, 0, sizeof(tm));
-		time_t unix_ticks = (ticks - ticks_from_1601_to_1900) / 10000000;
+		time_t unix_ticks = (ticks - ticks_from_1601_to_1970) / 10000000;
 		tm *result = gmtime_r(&unix_ticks, &tm_utc);
 		if (result == 0)
 			throw CL_Exception("gmtime_r failed");
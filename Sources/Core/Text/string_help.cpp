@@ -30,6 +30,7 @@
 #include "API/Core/Text/string_help.h"
 #include "API/Core/Text/logger.h"
 #include "API/Core/System/exception.h"
+#include "API/Core/Math/cl_math.h"
 #ifndef WIN32
 #include <wchar.h>
 #include <wctype.h>
@@ -51,6 +52,10 @@
 #include <cstdio>
 #endif
 
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
 // This function or variable may be unsafe. Consider using xxxx instead.
 // To disable deprecation, use _CRT_SECURE_NO_DEPRECATE. See online help for details.
 #ifdef WIN32
@@ -899,14 +904,24 @@ CL_String8 CL_StringHelp::ucs2_to_utf8(const CL_StringRef16 &ucs2)
 {
 	// Calculate length:
 
+	const CL_String16::char_type *data_ucs2 = ucs2.data();
 	CL_String16::size_type length_ucs2 = ucs2.length();
 	CL_String8::size_type length_utf8 = 0;
 	CL_String16::size_type pos;
 	for (pos = 0; pos < length_ucs2; pos++)
 	{
-		if (ucs2[pos] < 0x0080)
+		if (data_ucs2[pos] < 0x0080)
+		{
+			CL_String16::size_type run = ucs2_ascii_length(data_ucs2 + pos, length_ucs2 - pos);
+			if (run > 1)
+			{
+				length_utf8 += run;
+				pos += run - 1;
+				continue;
+			}
 			length_utf8++;
-		else if (ucs2[pos] < 0x0800)
+		}
+		else if (data_ucs2[pos] < 0x0800)
 			length_utf8 += 2;
 		else
 			length_utf8 += 3;
@@ -915,23 +930,32 @@ CL_String8 CL_StringHelp::ucs2_to_utf8(const CL_StringRef16 &ucs2)
 	// Perform conversion:
 	
 	CL_String8 utf8(length_utf8, ' ');
+	unsigned char *data_utf8 = (unsigned char *) utf8.data();
 	CL_String8::size_type pos_utf8 = 0;
 	for (pos = 0; pos < length_ucs2; pos++)
 	{
-		if (ucs2[pos] < 0x0080)
+		if (data_ucs2[pos] < 0x0080)
 		{
-			utf8[pos_utf8++] = (char) ucs2[pos];
+			CL_String16::size_type run = ucs2_ascii_length(data_ucs2 + pos, length_ucs2 - pos);
+			if (run > 1)
+			{
+				narrow_ascii(data_ucs2 + pos, run, data_utf8 + pos_utf8);
+				pos_utf8 += run;
+				pos += run - 1;
+				continue;
+			}
+			data_utf8[pos_utf8++] = (unsigned char) data_ucs2[pos];
 		}
-		else if (ucs2[pos] < 0x0800)
+		else if (data_ucs2[pos] < 0x0800)
 		{
-			utf8[pos_utf8++] = 0xc0 + (ucs2[pos] >> 6);
-			utf8[pos_utf8++] = 0x80 + (ucs2[pos] & 0x3f);
+			data_utf8[pos_utf8++] = 0xc0 + (data_ucs2[pos] >> 6);
+			data_utf8[pos_utf8++] = 0x80 + (data_ucs2[pos] & 0x3f);
 		}
 		else
 		{
-			utf8[pos_utf8++] = 0xe0 + (ucs2[pos] >> 12);
-			utf8[pos_utf8++] = 0x80 + ((ucs2[pos] >> 6) & 0x3f);
-			utf8[pos_utf8++] = 0x80 + (ucs2[pos] & 0x3f);
+			data_utf8[pos_utf8++] = 0xe0 + (data_ucs2[pos] >> 12);
+			data_utf8[pos_utf8++] = 0x80 + ((data_ucs2[pos] >> 6) & 0x3f);
+			data_utf8[pos_utf8++] = 0x80 + (data_ucs2[pos] & 0x3f);
 		}
 	}
 
@@ -975,12 +999,24 @@ CL_String16 CL_StringHelp::utf8_to_ucs2(const CL_StringRef8 &utf8)
 {
 	// Calculate length:
 
+	const unsigned char *data_utf8 = (const unsigned char *) utf8.data();
 	CL_String16::size_type length_ucs2 = 0;
 	CL_String8::size_type length_utf8 = utf8.length();
 	CL_String8::size_type pos = 0;
 	while (pos < length_utf8)
 	{
-		unsigned char c = utf8[pos++];
+		unsigned char c = data_utf8[pos];
+		if (c < 0x80)
+		{
+			CL_String8::size_type run = utf8_ascii_length(data_utf8 + pos, length_utf8 - pos);
+			if (run > 0)
+			{
+				length_ucs2 += run;
+				pos += run;
+				continue;
+			}
+		}
+		pos++;
 		int trailing_bytes = trailing_bytes_for_utf8[c];
 		length_ucs2++;
 		pos += trailing_bytes;
@@ -996,16 +1032,29 @@ CL_String16 CL_StringHelp::utf8_to_ucs2(const CL_StringRef8 &utf8)
 	// Perform conversion:
 	
 	CL_String16 ucs2(length_ucs2, L'?');
+	CL_String16::char_type *data_ucs2 = ucs2.data();
 	pos = 0;
 	CL_String16::size_type ucs2_pos = 0;
 	while (pos < length_utf8 && ucs2_pos < length_ucs2)
 	{
-		unsigned char c = utf8[pos++];
+		unsigned char c = data_utf8[pos];
+		if (c < 0x80)
+		{
+			CL_String8::size_type run = utf8_ascii_length(data_utf8 + pos, cl_min(length_utf8 - pos, length_ucs2 - ucs2_pos));
+			if (run > 0)
+			{
+				widen_ascii(data_utf8 + pos, run, data_ucs2 + ucs2_pos);
+				ucs2_pos += run;
+				pos += run;
+				continue;
+			}
+		}
+		pos++;
 		int trailing_bytes = trailing_bytes_for_utf8[c];
 		unsigned int ucs4 = (c & bitmask_leadbyte_for_utf8[trailing_bytes]);
 		for (int i=0; i<trailing_bytes; i++)
 		{
-			c = (unsigned char) utf8[pos+i];
+			c = data_utf8[pos+i];
 			if (c < 0xc0)
 			{
 				ucs4 = (ucs4 << 6) + (c & 0x3f);
@@ -1018,9 +1067,9 @@ CL_String16 CL_StringHelp::utf8_to_ucs2(const CL_StringRef8 &utf8)
 			}
 		}
 		if (ucs4 > 0 && ucs4 <= 0xffff)
-			ucs2[ucs2_pos] = ucs4;
+			data_ucs2[ucs2_pos] = ucs4;
 		else
-			ucs2[ucs2_pos] = L'?';
+			data_ucs2[ucs2_pos] = L'?';
 
 		ucs2_pos++;
 		pos += trailing_bytes;
@@ -1288,6 +1337,163 @@ const unsigned char CL_StringHelp::bitmask_leadbyte_for_utf8[6] =
 	0x01
 };
 
+CL_String8::size_type CL_StringHelp::utf8_ascii_length(const unsigned char *data, CL_String8::size_type length)
+{
+	// Null characters are excluded since utf8_to_ucs2 maps them to '?'
+	CL_String8::size_type pos = 0;
+#ifndef CL_DISABLE_SSE2
+	__m128i zero = _mm_setzero_si128();
+	while (pos + 32 <= length)
+	{
+		__m128i block0 = _mm_loadu_si128((const __m128i *) (data + pos));
+		__m128i block1 = _mm_loadu_si128((const __m128i *) (data + pos + 16));
+		__m128i nulls = _mm_or_si128(_mm_cmpeq_epi8(block0, zero), _mm_cmpeq_epi8(block1, zero));
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(block0, block1), nulls)) != 0)
+			break;
+		pos += 32;
+	}
+	while (pos + 16 <= length)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *) (data + pos));
+		if (_mm_movemask_epi8(_mm_or_si128(block, _mm_cmpeq_epi8(block, zero))) != 0)
+			break;
+		pos += 16;
+	}
+#endif
+	while (pos < length && data[pos] != 0 && data[pos] < 0x80)
+		pos++;
+	return pos;
+}
+
+CL_String16::size_type CL_StringHelp::ucs2_ascii_length(const CL_String16::char_type *data, CL_String16::size_type length)
+{
+	CL_String16::size_type pos = 0;
+#ifndef CL_DISABLE_SSE2
+	if (sizeof(CL_String16::char_type) == 2)
+	{
+		__m128i mask = _mm_set1_epi16((short) 0xff80);
+		__m128i zero = _mm_setzero_si128();
+		while (pos + 16 <= length)
+		{
+			__m128i block0 = _mm_loadu_si128((const __m128i *) (data + pos));
+			__m128i block1 = _mm_loadu_si128((const __m128i *) (data + pos + 8));
+			__m128i high_bits = _mm_and_si128(_mm_or_si128(block0, block1), mask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, zero)) != 0xffff)
+				break;
+			pos += 16;
+		}
+	}
+	else
+	{
+		__m128i mask = _mm_set1_epi32(0xffffff80);
+		__m128i zero = _mm_setzero_si128();
+		while (pos + 16 <= length)
+		{
+			__m128i block0 = _mm_loadu_si128((const __m128i *) (data + pos));
+			__m128i block1 = _mm_loadu_si128((const __m128i *) (data + pos + 4));
+			__m128i block2 = _mm_loadu_si128((const __m128i *) (data + pos + 8));
+			__m128i block3 = _mm_loadu_si128((const __m128i *) (data + pos + 12));
+			__m128i combined = _mm_or_si128(_mm_or_si128(block0, block1), _mm_or_si128(block2, block3));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(combined, mask), zero)) != 0xffff)
+				break;
+			pos += 16;
+		}
+	}
+#endif
+	while (pos < length && (unsigned int) data[pos] < 0x80)
+		pos++;
+	return pos;
+}
+
+void CL_StringHelp::widen_ascii(const unsigned char *input, CL_String8::size_type length, CL_String16::char_type *output)
+{
+	CL_String8::size_type pos = 0;
+#ifndef CL_DISABLE_SSE2
+	__m128i zero = _mm_setzero_si128();
+	for (; pos + 16 <= length; pos += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *) (input + pos));
+		__m128i low = _mm_unpacklo_epi8(block, zero);
+		__m128i high = _mm_unpackhi_epi8(block, zero);
+		if (sizeof(CL_String16::char_type) == 2)
+		{
+			_mm_storeu_si128((__m128i *) (output + pos), low);
+			_mm_storeu_si128((__m128i *) (output + pos + 8), high);
+		}
+		else
+		{
+			_mm_storeu_si128((__m128i *) (output + pos), _mm_unpacklo_epi16(low, zero));
+			_mm_storeu_si128((__m128i *) (output + pos + 4), _mm_unpackhi_epi16(low, zero));
+			_mm_storeu_si128((__m128i *) (output + pos + 8), _mm_unpacklo_epi16(high, zero));
+			_mm_storeu_si128((__m128i *) (output + pos + 12), _mm_unpackhi_epi16(high, zero));
+		}
+	}
+#endif
+	for (; pos < length; pos++)
+		output[pos] = input[pos];
+}
+
+void CL_StringHelp::narrow_ascii(const CL_String16::char_type *input, CL_String16::size_type length, unsigned char *output)
+{
+	CL_String16::size_type pos = 0;
+#ifndef CL_DISABLE_SSE2
+	for (; pos + 16 <= length; pos += 16)
+	{
+		__m128i low, high;
+		if (sizeof(CL_String16::char_type) == 2)
+		{
+			low = _mm_loadu_si128((const __m128i *) (input + pos));
+			high = _mm_loadu_si128((const __m128i *) (input + pos + 8));
+		}
+		else
+		{
+			low = _mm_packs_epi32(_mm_loadu_si128((const __m128i *) (input + pos)), _mm_loadu_si128((const __m128i *) (input + pos + 4)));
+			high = _mm_packs_epi32(_mm_loadu_si128((const __m128i *) (input + pos + 8)), _mm_loadu_si128((const __m128i *) (input + pos + 12)));
+		}
+		_mm_storeu_si128((__m128i *) (output + pos), _mm_packus_epi16(low, high));
+	}
+#endif
+	for (; pos < length; pos++)
+		output[pos] = (unsigned char) input[pos];
+}
+
+bool CL_StringHelp::utf8_verify(const CL_StringRef8 &utf8)
+{
+	const unsigned char *data = (const unsigned char *) utf8.data();
+	CL_String8::size_type length = utf8.length();
+	CL_String8::size_type pos = 0;
+	while (pos < length)
+	{
+		unsigned char c = data[pos];
+		if (c < 0x80)
+		{
+			CL_String8::size_type run = utf8_ascii_length(data + pos, length - pos);
+			pos += (run > 0) ? run : 1;
+			continue;
+		}
+
+		int trailing_bytes = trailing_bytes_for_utf8[c];
+		if (trailing_bytes == 0 || trailing_bytes > 3 || pos + trailing_bytes >= length)
+			return false;
+
+		unsigned int ucs4 = (c & bitmask_leadbyte_for_utf8[trailing_bytes]);
+		for (int i = 1; i <= trailing_bytes; i++)
+		{
+			if ((data[pos+i] & 0xc0) != 0x80)
+				return false;
+			ucs4 = (ucs4 << 6) + (data[pos+i] & 0x3f);
+		}
+
+		// Reject overlong encodings, UTF-16 surrogates and values beyond the unicode range
+		static const unsigned int minimum_for_length[4] = { 0, 0x80, 0x800, 0x10000 };
+		if (ucs4 < minimum_for_length[trailing_bytes] || (ucs4 >= 0xd800 && ucs4 <= 0xdfff) || ucs4 > 0x10ffff)
+			return false;
+
+		pos += 1 + trailing_bytes;
+	}
+	return true;
+}
+
 #ifndef WIN32
 #ifndef HAVE_WCSCASECMP
 int
@@ -102,6 +102,9 @@ CL_String8::size_type CL_UTF8_Reader_Impl::get_char_length()
 {
 	if (current_position < length)
 	{
+		if (data[current_position] < 0x80)
+			return 1;
+
 		int trailing_bytes = trailing_bytes_for_utf8[data[current_position]];
 		if (current_position+1+trailing_bytes > length)
 			return 1;
@@ -157,6 +160,9 @@ unsigned int CL_UTF8_Reader_Impl::get_char()
 	if (current_position >= length)
 		return 0;
 
+	if (data[current_position] < 0x80)
+		return data[current_position];
+
 	int trailing_bytes = trailing_bytes_for_utf8[data[current_position]];
 	if (trailing_bytes == 0 && (data[current_position] & 0x80) == 0x80)
 		return '?';
@@ -56,6 +56,10 @@ CL_DBConnection::~CL_DBConnection()
 /////////////////////////////////////////////////////////////////////////////
 // CL_DBConnection Attributes:
 
+CL_DBConnectionProvider *CL_DBConnection::get_provider()
+{
+	return impl->provider;
+}
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_DBConnection Operations:
@@ -93,5 +97,15 @@ void CL_DBConnection::execute_non_query(CL_DBCommand &command)
 	impl->provider->execute_non_query(command.get_provider());
 }
 
+void CL_DBConnection::execute_batch_row(CL_DBCommand &command)
+{
+	impl->provider->execute_batch_row(command.get_provider());
+}
+
+int CL_DBConnection::commit_batch(CL_DBCommand &command)
+{
+	return impl->provider->commit_batch(command.get_provider());
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_DBConnection Implementation:
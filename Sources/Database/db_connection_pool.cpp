@@ -0,0 +1,150 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Database/precomp.h"
+#include "API/Database/db_connection_pool.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/System/thread_local_storage.h"
+#include "API/Core/Text/string_help.h"
+#include "db_connection_pool_impl.h"
+
+/// \brief Thread local storage data owning the connection of one thread
+class CL_DBConnectionPool_ThreadData : public CL_ThreadLocalStorageData
+{
+public:
+	CL_DBConnectionPool_ThreadData(const CL_SharedPtr<CL_DBConnectionPool_Impl> &pool, const CL_DBConnection &connection)
+	: pool(pool), connection(connection)
+	{
+	}
+
+	~CL_DBConnectionPool_ThreadData()
+	{
+		// Runs when the thread releases its connection or ends
+		CL_MutexSection mutex_lock(&pool->mutex);
+		if ((int)pool->idle_connections.size() < pool->max_idle_connections)
+			pool->idle_connections.push_back(connection);
+		else
+			pool->num_connections--;
+	}
+
+	CL_SharedPtr<CL_DBConnectionPool_Impl> pool;
+	CL_DBConnection connection;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DBConnectionPool Construction:
+
+CL_DBConnectionPool::CL_DBConnectionPool()
+{
+}
+
+CL_DBConnectionPool::CL_DBConnectionPool(const CL_Callback_0<CL_DBConnection> &func_create_connection, int max_idle_connections)
+: impl(new CL_DBConnectionPool_Impl(func_create_connection, max_idle_connections))
+{
+	impl->tls_name = "CL_DBConnectionPool_" + CL_StringHelp::ull_to_text((unsigned long long)(size_t)impl.get());
+}
+
+CL_DBConnectionPool::~CL_DBConnectionPool()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DBConnectionPool Attributes:
+
+void CL_DBConnectionPool::throw_if_null() const
+{
+	if (!impl)
+		throw CL_Exception("CL_DBConnectionPool is null");
+}
+
+int CL_DBConnectionPool::get_connection_count() const
+{
+	throw_if_null();
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->num_connections;
+}
+
+int CL_DBConnectionPool::get_idle_connection_count() const
+{
+	throw_if_null();
+	CL_MutexSection mutex_lock(&impl->mutex);
+	return impl->idle_connections.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DBConnectionPool Operations:
+
+CL_DBConnection CL_DBConnectionPool::get_connection()
+{
+	throw_if_null();
+
+	CL_SharedPtr<CL_ThreadLocalStorageData> data = CL_ThreadLocalStorage::get_variable(impl->tls_name);
+	if (data)
+		return static_cast<CL_DBConnectionPool_ThreadData *>(data.get())->connection;
+
+	CL_DBConnection connection;
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		if (!impl->idle_connections.empty())
+		{
+			connection = impl->idle_connections.back();
+			impl->idle_connections.pop_back();
+		}
+	}
+
+	if (connection.is_null())
+	{
+		// Opened outside the lock, as opening and tuning a connection may take a while
+		connection = impl->func_create_connection.invoke();
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->num_connections++;
+	}
+
+	CL_ThreadLocalStorage::set_variable(impl->tls_name, CL_SharedPtr<CL_ThreadLocalStorageData>(new CL_DBConnectionPool_ThreadData(impl, connection)));
+	return connection;
+}
+
+void CL_DBConnectionPool::release_connection()
+{
+	throw_if_null();
+	CL_ThreadLocalStorage::set_variable(impl->tls_name, CL_SharedPtr<CL_ThreadLocalStorageData>());
+}
+
+void CL_DBConnectionPool::close_idle_connections()
+{
+	throw_if_null();
+	std::vector<CL_DBConnection> connections;
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		connections.swap(impl->idle_connections);
+		impl->num_connections -= connections.size();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_DBConnectionPool Implementation:
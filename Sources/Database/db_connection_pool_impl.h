@@ -0,0 +1,65 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+
+#include "API/Database/db_connection.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/Signals/callback_0.h"
+#include <vector>
+
+class CL_DBConnectionPool_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_DBConnectionPool_Impl(const CL_Callback_0<CL_DBConnection> &func_create_connection, int max_idle_connections)
+	: func_create_connection(func_create_connection), max_idle_connections(max_idle_connections), num_connections(0)
+	{
+	}
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	CL_Callback_0<CL_DBConnection> func_create_connection;
+	int max_idle_connections;
+
+	/// \brief Name of the thread local storage variable holding a thread's connection
+	CL_String tls_name;
+
+	CL_Mutex mutex;
+	std::vector<CL_DBConnection> idle_connections;
+	int num_connections;
+/// \}
+};
+
+
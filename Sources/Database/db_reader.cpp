@@ -109,6 +109,21 @@ CL_DataBuffer CL_DBReader::get_column_binary(int index) const
 	return impl->provider->get_column_binary(index);
 }
 
+CL_StringRef CL_DBReader::get_column_string_ref(int index) const
+{
+	return impl->provider->get_column_string_ref(index);
+}
+
+const void *CL_DBReader::get_column_binary_data(int index) const
+{
+	return impl->provider->get_column_binary_data(index);
+}
+
+int CL_DBReader::get_column_binary_size(int index) const
+{
+	return impl->provider->get_column_binary_size(index);
+}
+
 CL_String CL_DBReader::get_column_string(const CL_StringRef &column_name) const
 {
 	return impl->provider->get_column_string(get_name_index(column_name));
@@ -50,12 +50,7 @@ void CL_Draw::point(CL_GraphicContext &gc, float x1, float y1, const CL_Colorf &
 		CL_Vec2f(x1, y1)
 	};
 
-	CL_PrimitivesArray prim_array(gc);
-	prim_array.set_attributes(0, positions);
-	prim_array.set_attribute(1, color);
-	gc.set_program_object(cl_program_color_only);
-	gc.draw_primitives(cl_points, 1, prim_array);
-	gc.reset_program_object();
+	gc.impl->get_primitives_batcher()->draw(gc, cl_points, positions, color, 1);
 }
 
 void CL_Draw::point(CL_GraphicContext &gc, const CL_Pointf &p, const CL_Colorf &color)
@@ -71,12 +66,7 @@ void CL_Draw::line(CL_GraphicContext &gc, float x1, float y1, float x2, float y2
 		CL_Vec2f(x2, y2)
 	};
 
-	CL_PrimitivesArray prim_array(gc);
-	prim_array.set_attributes(0, positions);
-	prim_array.set_attribute(1, color);
-	gc.set_program_object(cl_program_color_only);
-	gc.draw_primitives(cl_lines, 2, prim_array);
-	gc.reset_program_object();
+	gc.impl->get_primitives_batcher()->draw(gc, cl_lines, positions, color, 2);
 }
 
 void CL_Draw::line(CL_GraphicContext &gc, const CL_Pointf &start, const CL_Pointf &end, const CL_Colorf &color)
@@ -91,20 +81,20 @@ void CL_Draw::line(CL_GraphicContext &gc, const CL_LineSegment2f &line_segment,
 
 void CL_Draw::box(CL_GraphicContext &gc, float x1, float y1, float x2, float y2, const CL_Colorf &color)
 {
-	CL_Vec2f positions[4] =
+	// Drawn as four separate lines rather than a line loop so consecutive boxes and lines share one batch
+	CL_Vec2f positions[8] =
 	{
 		CL_Vec2f(x1, y1),
 		CL_Vec2f(x2, y1),
+		CL_Vec2f(x2, y1),
+		CL_Vec2f(x2, y2),
 		CL_Vec2f(x2, y2),
-		CL_Vec2f(x1, y2)
+		CL_Vec2f(x1, y2),
+		CL_Vec2f(x1, y2),
+		CL_Vec2f(x1, y1)
 	};
 
-	CL_PrimitivesArray prim_array(gc);
-	prim_array.set_attributes(0, positions);
-	prim_array.set_attribute(1, color);
-	gc.set_program_object(cl_program_color_only);
-	gc.draw_primitives(cl_line_loop, 4, prim_array);
-	gc.reset_program_object();
+	gc.impl->get_primitives_batcher()->draw(gc, cl_lines, positions, color, 8);
 }
 
 void CL_Draw::box(CL_GraphicContext &gc, const CL_Pointf &start, const CL_Pointf &end, const CL_Colorf &color)
@@ -327,12 +317,7 @@ void CL_Draw::gradient_circle(CL_GraphicContext &gc, const CL_Pointf &center, co
 			CL_Vec2f(center.x - ((float)radius * pos4), center.y + ((float)radius * pos3))
 		};
 
-		CL_PrimitivesArray prim_array(gc);
-		prim_array.set_attributes(0, positions);
-		prim_array.set_attributes(1, triangle_colors);
-		gc.set_program_object(cl_program_color_only);
-		gc.draw_primitives(cl_triangles, 4*3, prim_array);
-		gc.reset_program_object();
+		gc.impl->get_primitives_batcher()->draw(gc, cl_triangles, positions, triangle_colors, 4*3);
 	}
 }
 
@@ -345,12 +330,7 @@ void CL_Draw::triangle(CL_GraphicContext &gc, const CL_Pointf &a, const CL_Point
 		CL_Vec2f(c.x, c.y)
 	};
 
-	CL_PrimitivesArray prim_array(gc);
-	prim_array.set_attributes(0, positions);
-	prim_array.set_attribute(1, color);
-	gc.set_program_object(cl_program_color_only);
-	gc.draw_primitives(cl_triangles, 3, prim_array);
-	gc.reset_program_object();
+	gc.impl->get_primitives_batcher()->draw(gc, cl_triangles, positions, color, 3);
 }
 
 void CL_Draw::triangle(CL_GraphicContext &gc,  const CL_Trianglef &dest_triangle, const CL_Colorf &color)
@@ -33,7 +33,7 @@
 int CL_RenderBatch2D::max_textures = 4;	// For use by the GL1 target, so it can reduce the number of textures
 
 CL_RenderBatch2D::CL_RenderBatch2D()
-: modelview(CL_Mat4f::identity()), origin(0.0f, 0.0f), x_dir(1.0f, 0.0f), y_dir(0.0f, 1.0f), position(0), num_current_textures(0), use_glyph_program(false)
+: modelview(CL_Mat4f::identity()), sprite_transform(CL_Mat4f::identity()), origin(0.0f, 0.0f), x_dir(1.0f, 0.0f), y_dir(0.0f, 1.0f), position(0), num_current_textures(0), program_mode(program_sprite)
 {
 }
 
@@ -41,18 +41,24 @@ void CL_RenderBatch2D::draw_sprite(CL_GraphicContext &gc, const CL_Surface_DrawP
 {
 	int texindex = set_batcher_active(gc, texture);
 
-	to_sprite_vertex(params, 0, vertices[position++], texindex);
-	to_sprite_vertex(params, 1, vertices[position++], texindex);
-	to_sprite_vertex(params, 2, vertices[position++], texindex);
-	to_sprite_vertex(params, 1, vertices[position++], texindex);
-	to_sprite_vertex(params, 3, vertices[position++], texindex);
-	to_sprite_vertex(params, 2, vertices[position++], texindex);
+	// Transform the four corners once, rather than once per triangle vertex
+	CL_Vec2f corners[4];
+	for (int i = 0; i < 4; i++)
+		corners[i] = params->dest_position[i];
+	sprite_transform.transform(corners, corners, 4);
+
+	to_sprite_vertex(params, corners, 0, vertices[position++], texindex);
+	to_sprite_vertex(params, corners, 1, vertices[position++], texindex);
+	to_sprite_vertex(params, corners, 2, vertices[position++], texindex);
+	to_sprite_vertex(params, corners, 1, vertices[position++], texindex);
+	to_sprite_vertex(params, corners, 3, vertices[position++], texindex);
+	to_sprite_vertex(params, corners, 2, vertices[position++], texindex);
 }
 
-inline void CL_RenderBatch2D::to_sprite_vertex(const CL_Surface_DrawParams1 *params, int index, CL_RenderBatch2D::SpriteVertex &v, int texindex) const
+inline void CL_RenderBatch2D::to_sprite_vertex(const CL_Surface_DrawParams1 *params, const CL_Vec2f *corners, int index, CL_RenderBatch2D::SpriteVertex &v, int texindex) const
 {
-	v.position.x = origin.x + x_dir.x * params->dest_position[index].x + y_dir.x * params->dest_position[index].y;
-	v.position.y = origin.y + x_dir.y * params->dest_position[index].x + y_dir.y * params->dest_position[index].y;
+	v.position.x = corners[index].x;
+	v.position.y = corners[index].y;
 	v.position.z = params->destZ;
 	v.color.r = params->color[index].r;
 	v.color.g = params->color[index].g;
@@ -92,7 +98,19 @@ void CL_RenderBatch2D::draw_image(CL_GraphicContext &gc, const CL_Rectf &src, co
 
 void CL_RenderBatch2D::draw_glyph_subpixel(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture)
 {
-	int texindex = set_batcher_active(gc, texture, true, color);
+	int texindex = set_batcher_active(gc, texture, program_glyph_subpixel, color);
+	add_glyph(src, dest, CL_Vec4f(1.0f, 1.0f, 1.0f, 1.0f), texindex);
+}
+
+void CL_RenderBatch2D::draw_glyph_distance_field(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture)
+{
+	// The color is also the constant color, so each batch has a single text alpha for targets that alpha test the distance
+	int texindex = set_batcher_active(gc, texture, program_distance_field, color);
+	add_glyph(src, dest, CL_Vec4f(color.r, color.g, color.b, color.a), texindex);
+}
+
+void CL_RenderBatch2D::add_glyph(const CL_Rectf &src, const CL_Rectf &dest, const CL_Vec4f &color, int texindex)
+{
 	vertices[position+0].position = to_position(dest.left, dest.top);
 	vertices[position+1].position = to_position(dest.right, dest.top);
 	vertices[position+2].position = to_position(dest.left, dest.bottom);
@@ -111,7 +129,7 @@ void CL_RenderBatch2D::draw_glyph_subpixel(CL_GraphicContext &gc, const CL_Rectf
 	vertices[position+5].texcoord = CL_Vec2f(src_left, src_bottom);
 	for (int i=0; i<6; i++)
 	{
-		vertices[position+i].color = CL_Vec4f(1.0f, 1.0f, 1.0f, 1.0f);
+		vertices[position+i].color = color;
 		vertices[position+i].texindex.x = (float)texindex;
 	}
 	position += 6;
@@ -143,12 +161,12 @@ inline CL_Vec3f CL_RenderBatch2D::to_position(float x, float y) const
 		1.0f);
 }
 
-int CL_RenderBatch2D::set_batcher_active(CL_GraphicContext &gc, const CL_Texture &texture, bool glyph_program, const CL_Colorf &new_constant_color)
+int CL_RenderBatch2D::set_batcher_active(CL_GraphicContext &gc, const CL_Texture &texture, ProgramMode mode, const CL_Colorf &new_constant_color)
 {
-	if (use_glyph_program != glyph_program || constant_color != new_constant_color)
+	if (program_mode != mode || constant_color != new_constant_color)
 	{
 		gc.flush_batcher();
-		use_glyph_program = glyph_program;
+		program_mode = mode;
 		constant_color = new_constant_color;
 	}
 
@@ -182,10 +200,10 @@ int CL_RenderBatch2D::set_batcher_active(CL_GraphicContext &gc, const CL_Texture
 
 int CL_RenderBatch2D::set_batcher_active(CL_GraphicContext &gc)
 {
-	if (use_glyph_program != false)
+	if (program_mode != program_sprite)
 	{
 		gc.flush_batcher();
-		use_glyph_program = false;
+		program_mode = program_sprite;
 	}
 
 	if (position == 0 || position+6 > max_vertices)
@@ -199,9 +217,20 @@ void CL_RenderBatch2D::flush(CL_GraphicContext &gc)
 	if (position > 0)
 	{
 		gc.set_modelview(CL_Mat4f::identity());
-		gc.set_program_object(cl_program_sprite);
 
-		if (use_glyph_program)
+		CL_BlendMode distance_field_old_blend_mode;
+		if (program_mode == program_distance_field)
+		{
+			// Targets without shaders alpha test the distance, and read the text alpha from the blend color to scale the test
+			distance_field_old_blend_mode = gc.get_blend_mode();
+			CL_BlendMode blend_mode = distance_field_old_blend_mode;
+			blend_mode.set_blend_color(constant_color);
+			gc.set_blend_mode(blend_mode);
+		}
+
+		gc.set_program_object(program_mode == program_distance_field ? cl_program_distance_field : cl_program_sprite);
+
+		if (program_mode == program_glyph_subpixel)
 		{
 			CL_BlendMode old_blend_mode = gc.get_blend_mode();
 			CL_BlendMode blend_mode;
@@ -237,6 +266,8 @@ void CL_RenderBatch2D::flush(CL_GraphicContext &gc)
 		}
 
 		gc.reset_program_object();
+		if (program_mode == program_distance_field)
+			gc.set_blend_mode(distance_field_old_blend_mode);
 		gc.set_modelview(modelview);
 		position = 0;
 		for (int i = 0; i < num_current_textures; i++)
@@ -253,4 +284,12 @@ void CL_RenderBatch2D::modelview_changed(const CL_Mat4f &new_modelview)
 	origin = modelview * CL_Vec4f(0.0f, 0.0f, 1.0f, 1.0f);
 	x_dir -= origin;
 	y_dir -= origin;
+
+	sprite_transform = CL_Mat4f::identity();
+	sprite_transform[0] = x_dir.x;
+	sprite_transform[1] = x_dir.y;
+	sprite_transform[4] = y_dir.x;
+	sprite_transform[5] = y_dir.y;
+	sprite_transform[12] = origin.x;
+	sprite_transform[13] = origin.y;
 }
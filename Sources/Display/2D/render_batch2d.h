@@ -42,6 +42,7 @@ public:
 	void draw_sprite(CL_GraphicContext &gc, const CL_Surface_DrawParams1 *params, const CL_Texture &texture);
 	void draw_image(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture);
 	void draw_glyph_subpixel(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture);
+	void draw_glyph_distance_field(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture);
 	void fill(CL_GraphicContext &gc, float x1, float y1, float x2, float y2, const CL_Colorf &color);
 
 public:
@@ -56,14 +57,23 @@ private:
 		CL_Vec1f texindex;
 	};
 
-	int set_batcher_active(CL_GraphicContext &gc, const CL_Texture &texture, bool glyph_program = false, const CL_Colorf &constant_color = CL_Colorf::black);
+	enum ProgramMode
+	{
+		program_sprite,
+		program_glyph_subpixel,
+		program_distance_field
+	};
+
+	int set_batcher_active(CL_GraphicContext &gc, const CL_Texture &texture, ProgramMode mode = program_sprite, const CL_Colorf &constant_color = CL_Colorf::black);
 	int set_batcher_active(CL_GraphicContext &gc);
+	void add_glyph(const CL_Rectf &src, const CL_Rectf &dest, const CL_Vec4f &color, int texindex);
 	void flush(CL_GraphicContext &gc);
 	void modelview_changed(const CL_Mat4f &modelview);
-	inline void to_sprite_vertex(const CL_Surface_DrawParams1 *params, int index, CL_RenderBatch2D::SpriteVertex &v, int texindex) const;
+	inline void to_sprite_vertex(const CL_Surface_DrawParams1 *params, const CL_Vec2f *corners, int index, CL_RenderBatch2D::SpriteVertex &v, int texindex) const;
 	inline CL_Vec3f to_position(float x, float y) const;
 
 	CL_Mat4f modelview;
+	CL_Mat4f sprite_transform;
 	CL_Vec2f origin;
 	CL_Vec2f x_dir, y_dir;
 	int position;
@@ -72,6 +82,6 @@ private:
 	CL_Texture current_textures[4];
 	int num_current_textures;
 	CL_Sizef tex_sizes[4];
-	bool use_glyph_program;
+	ProgramMode program_mode;
 	CL_Colorf constant_color;
 };
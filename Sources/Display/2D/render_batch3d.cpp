@@ -33,7 +33,7 @@
 int CL_RenderBatch3D::max_textures = 4;	// For use by the GL1 target, so it can reduce the number of textures
 
 CL_RenderBatch3D::CL_RenderBatch3D()
-: modelview(CL_Mat4f::identity()), position(0), num_current_textures(0), use_glyph_program(false)
+: modelview(CL_Mat4f::identity()), position(0), num_current_textures(0), program_mode(program_sprite)
 {
 }
 
@@ -100,7 +100,19 @@ void CL_RenderBatch3D::draw_image(CL_GraphicContext &gc, const CL_Rectf &src, co
 
 void CL_RenderBatch3D::draw_glyph_subpixel(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture)
 {
-	int texindex = set_batcher_active(gc, texture, true, color);
+	int texindex = set_batcher_active(gc, texture, program_glyph_subpixel, color);
+	add_glyph(src, dest, CL_Vec4f(1.0f, 1.0f, 1.0f, 1.0f), texindex);
+}
+
+void CL_RenderBatch3D::draw_glyph_distance_field(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture)
+{
+	// The color is also the constant color, so each batch has a single text alpha for targets that alpha test the distance
+	int texindex = set_batcher_active(gc, texture, program_distance_field, color);
+	add_glyph(src, dest, CL_Vec4f(color.r, color.g, color.b, color.a), texindex);
+}
+
+void CL_RenderBatch3D::add_glyph(const CL_Rectf &src, const CL_Rectf &dest, const CL_Vec4f &color, int texindex)
+{
 	vertices[position+0].position = to_position(dest.left, dest.top);
 	vertices[position+1].position = to_position(dest.right, dest.top);
 	vertices[position+2].position = to_position(dest.left, dest.bottom);
@@ -119,7 +131,7 @@ void CL_RenderBatch3D::draw_glyph_subpixel(CL_GraphicContext &gc, const CL_Rectf
 	vertices[position+5].texcoord = CL_Vec2f(src_left, src_bottom);
 	for (int i=0; i<6; i++)
 	{
-		vertices[position+i].color = CL_Vec4f(1.0f, 1.0f, 1.0f, 1.0f);
+		vertices[position+i].color = color;
 		vertices[position+i].texindex.x = (float)texindex;
 	}
 	position += 6;
@@ -151,12 +163,12 @@ inline CL_Vec3f CL_RenderBatch3D::to_position(float x, float y) const
 		modelview.matrix[0*4+2]*x + modelview.matrix[1*4+2]*y + modelview.matrix[3*4+2]);
 }
 
-int CL_RenderBatch3D::set_batcher_active(CL_GraphicContext &gc, const CL_Texture &texture, bool glyph_program, const CL_Colorf &new_constant_color)
+int CL_RenderBatch3D::set_batcher_active(CL_GraphicContext &gc, const CL_Texture &texture, ProgramMode mode, const CL_Colorf &new_constant_color)
 {
-	if (use_glyph_program != glyph_program || constant_color != new_constant_color)
+	if (program_mode != mode || constant_color != new_constant_color)
 	{
 		gc.flush_batcher();
-		use_glyph_program = glyph_program;
+		program_mode = mode;
 		constant_color = new_constant_color;
 	}
 
@@ -191,10 +203,10 @@ int CL_RenderBatch3D::set_batcher_active(CL_GraphicContext &gc, const CL_Texture
 
 int CL_RenderBatch3D::set_batcher_active(CL_GraphicContext &gc)
 {
-	if (use_glyph_program != false)
+	if (program_mode != program_sprite)
 	{
 		gc.flush_batcher();
-		use_glyph_program = false;
+		program_mode = program_sprite;
 	}
 
 	if (position == 0 || position+6 > max_vertices)
@@ -208,9 +220,20 @@ void CL_RenderBatch3D::flush(CL_GraphicContext &gc)
 	if (position > 0)
 	{
 		gc.set_modelview(CL_Mat4f::identity());
-		gc.set_program_object(cl_program_sprite);
 
-		if (use_glyph_program)
+		CL_BlendMode distance_field_old_blend_mode;
+		if (program_mode == program_distance_field)
+		{
+			// Targets without shaders alpha test the distance, and read the text alpha from the blend color to scale the test
+			distance_field_old_blend_mode = gc.get_blend_mode();
+			CL_BlendMode blend_mode = distance_field_old_blend_mode;
+			blend_mode.set_blend_color(constant_color);
+			gc.set_blend_mode(blend_mode);
+		}
+
+		gc.set_program_object(program_mode == program_distance_field ? cl_program_distance_field : cl_program_sprite);
+
+		if (program_mode == program_glyph_subpixel)
 		{
 			CL_BlendMode old_blend_mode = gc.get_blend_mode();
 			CL_BlendMode blend_mode;
@@ -246,6 +269,8 @@ void CL_RenderBatch3D::flush(CL_GraphicContext &gc)
 		}
 
 		gc.reset_program_object();
+		if (program_mode == program_distance_field)
+			gc.set_blend_mode(distance_field_old_blend_mode);
 		gc.set_modelview(modelview);
 		position = 0;
 		for (int i = 0; i < num_current_textures; i++)
@@ -0,0 +1,123 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Display/precomp.h"
+#include "render_batch_primitives.h"
+
+CL_RenderBatchPrimitives::CL_RenderBatchPrimitives()
+: modelview(CL_Mat4f::identity()), origin(0.0f, 0.0f, 0.0f, 1.0f), x_dir(1.0f, 0.0f, 0.0f, 0.0f), y_dir(0.0f, 1.0f, 0.0f, 0.0f), current_type(cl_triangles), position(0)
+{
+}
+
+void CL_RenderBatchPrimitives::draw(CL_GraphicContext &gc, CL_PrimitivesType type, const CL_Vec2f *positions, const CL_Colorf &color, int num_vertices)
+{
+	CL_Vec4f vertex_color(color.r, color.g, color.b, color.a);
+	while (num_vertices > 0)
+	{
+		int count = set_batcher_active(gc, type, num_vertices);
+		for (int i = 0; i < count; i++)
+		{
+			vertices[position+i].position = to_position(positions[i]);
+			vertices[position+i].color = vertex_color;
+		}
+		position += count;
+		positions += count;
+		num_vertices -= count;
+	}
+}
+
+void CL_RenderBatchPrimitives::draw(CL_GraphicContext &gc, CL_PrimitivesType type, const CL_Vec2f *positions, const CL_Vec4f *colors, int num_vertices)
+{
+	while (num_vertices > 0)
+	{
+		int count = set_batcher_active(gc, type, num_vertices);
+		for (int i = 0; i < count; i++)
+		{
+			vertices[position+i].position = to_position(positions[i]);
+			vertices[position+i].color = colors[i];
+		}
+		position += count;
+		positions += count;
+		colors += count;
+		num_vertices -= count;
+	}
+}
+
+inline CL_Vec4f CL_RenderBatchPrimitives::to_position(const CL_Vec2f &point) const
+{
+	return CL_Vec4f(
+		origin.x + x_dir.x * point.x + y_dir.x * point.y,
+		origin.y + x_dir.y * point.x + y_dir.y * point.y,
+		origin.z + x_dir.z * point.x + y_dir.z * point.y,
+		origin.w + x_dir.w * point.x + y_dir.w * point.y);
+}
+
+int CL_RenderBatchPrimitives::set_batcher_active(CL_GraphicContext &gc, CL_PrimitivesType type, int num_vertices)
+{
+	if (current_type != type)
+	{
+		gc.flush_batcher();
+		current_type = type;
+	}
+
+	if (position == max_vertices)
+		gc.flush_batcher();
+	gc.set_batcher(this);
+
+	// max_vertices is a multiple of 1, 2 and 3 so a primitive is never split across two batches
+	int count = cl_min(num_vertices, max_vertices - position);
+	if (position + count > (int) vertices.size())
+		vertices.resize(cl_min(cl_max(position + count, (int) vertices.size() * 2), (int) max_vertices));
+	return count;
+}
+
+void CL_RenderBatchPrimitives::flush(CL_GraphicContext &gc)
+{
+	if (position > 0)
+	{
+		gc.set_modelview(CL_Mat4f::identity());
+		gc.set_program_object(cl_program_color_only);
+
+		CL_PrimitivesArray prim_array(gc);
+		prim_array.set_attributes(0, &vertices[0].position, sizeof(PrimitivesVertex));
+		prim_array.set_attributes(1, &vertices[0].color, sizeof(PrimitivesVertex));
+		gc.draw_primitives(current_type, position, prim_array);
+
+		gc.reset_program_object();
+		gc.set_modelview(modelview);
+		position = 0;
+	}
+}
+
+void CL_RenderBatchPrimitives::modelview_changed(const CL_Mat4f &new_modelview)
+{
+	modelview = new_modelview;
+	origin = modelview * CL_Vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+	x_dir = modelview * CL_Vec4f(1.0f, 0.0f, 0.0f, 0.0f);
+	y_dir = modelview * CL_Vec4f(0.0f, 1.0f, 0.0f, 0.0f);
+}
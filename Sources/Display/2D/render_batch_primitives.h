@@ -0,0 +1,76 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Display/Render/render_batcher.h"
+#include "API/Display/Render/graphic_context.h"
+#include "API/Display/Render/primitives_array.h"
+#include <vector>
+
+/// \brief Batches coloured points, lines and triangles drawn by CL_Draw into a single vertex buffer.
+///
+/// Vertices are transformed by the current modelview on the CPU, so consecutive primitives of the same
+/// type end up in one draw call. The batch is flushed when the primitive type changes, the buffer is
+/// full, or any graphic context state is changed.
+class CL_RenderBatchPrimitives : public CL_RenderBatcher
+{
+public:
+	CL_RenderBatchPrimitives();
+
+	/// \brief Adds vertices with a single colour.
+	///
+	/// \param type = cl_points, cl_lines or cl_triangles
+	/// \param num_vertices = Vertex count. Must be a multiple of the vertex count of one primitive.
+	void draw(CL_GraphicContext &gc, CL_PrimitivesType type, const CL_Vec2f *positions, const CL_Colorf &color, int num_vertices);
+
+	/// \brief Adds vertices with a colour per vertex.
+	void draw(CL_GraphicContext &gc, CL_PrimitivesType type, const CL_Vec2f *positions, const CL_Vec4f *colors, int num_vertices);
+
+private:
+	struct PrimitivesVertex
+	{
+		CL_Vec4f position;
+		CL_Vec4f color;
+	};
+
+	int set_batcher_active(CL_GraphicContext &gc, CL_PrimitivesType type, int num_vertices);
+	void flush(CL_GraphicContext &gc);
+	void modelview_changed(const CL_Mat4f &modelview);
+	inline CL_Vec4f to_position(const CL_Vec2f &point) const;
+
+	CL_Mat4f modelview;
+	CL_Vec4f origin;
+	CL_Vec4f x_dir, y_dir;
+	CL_PrimitivesType current_type;
+	int position;
+	enum { max_vertices = 4096*3*2 };
+
+	/// \brief Grows up to max_vertices as needed, so contexts that draw few primitives stay small
+	std::vector<PrimitivesVertex> vertices;
+};
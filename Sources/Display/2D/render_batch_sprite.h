@@ -40,5 +40,6 @@ public:
 	virtual void draw_sprite(CL_GraphicContext &gc, const CL_Surface_DrawParams1 *params, const CL_Texture &texture) = 0;
 	virtual void draw_image(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture) = 0;
 	virtual void draw_glyph_subpixel(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture) = 0;
+	virtual void draw_glyph_distance_field(CL_GraphicContext &gc, const CL_Rectf &src, const CL_Rectf &dest, const CL_Colorf &color, const CL_Texture &texture) = 0;
 	virtual void fill(CL_GraphicContext &gc, float x1, float y1, float x2, float y2, const CL_Colorf &color) = 0;
 };
@@ -268,11 +268,15 @@ void CL_CollisionOutline::load(CL_IODevice &file)
 	impl->contours = provider->get_contours();
 	impl->width = provider->get_width();
 	impl->height = provider->get_height();
+	impl->minimum_enclosing_disc = provider->get_minimum_enclosing_disc();
 
 	provider = CL_SharedPtr<CL_OutlineProviderFile>();
 
-	impl->calculate_radius();
-	impl->calculate_sub_circles();
+	if( !impl->has_sub_circles() )
+	{
+		impl->calculate_radius();
+		impl->calculate_sub_circles();
+	}
 }
 
 CL_CollisionOutline &CL_CollisionOutline::copy(const CL_CollisionOutline &other)
@@ -48,6 +48,10 @@
 #include <cfloat>
 #include <iostream>
 
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
 template<typename T> inline T pow2(T a) { return a*a; }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -99,11 +103,15 @@ CL_CollisionOutline_Generic::CL_CollisionOutline_Generic(
 	contours = provider->get_contours();
 	width = provider->get_width();
 	height = provider->get_height();
-	//TODO: minimum_enclosing_disc = provider->get_minimum_enclosing_disc();
+	minimum_enclosing_disc = provider->get_minimum_enclosing_disc();
 
 	provider->destroy();
 	provider = NULL;
 
+	// Precompiled outlines come with their sub circles and enclosing disc
+	if( accuracy == accuracy_raw && has_sub_circles() )
+		return;
+
 	int check_distance = 3;
 
 	switch( accuracy )
@@ -159,84 +167,20 @@ void CL_CollisionOutline_Generic::set_translation(float x, float y, bool offset_
 	else
 		translation = (position - old_position);
 
-	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
-	{
-		CL_Contour *contour_ptr = &contours[outer_cnt];
-		std::vector<CL_Pointf>::size_type point_size = contour_ptr->get_points().size();
-		for (int inner_cnt = 0; inner_cnt < point_size; inner_cnt++)
-		{
-			contour_ptr->get_points()[inner_cnt] += translation;
-		}
-	}
-
-	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
-	{
-		CL_Contour *contour_ptr = &contours[outer_cnt];
-		std::vector<CL_Pointf>::size_type sub_circles_size = contour_ptr->get_sub_circles().size();
-		for (int inner_cnt = 0; inner_cnt < sub_circles_size; inner_cnt++)
-		{
-			contour_ptr->get_sub_circles()[inner_cnt].position += translation;
-		}
-	}
-
-	minimum_enclosing_disc.position += translation;
+	transform_outline(CL_Mat4f::translate(translation.x, translation.y, 0.0f), true);
 }
 
 void CL_CollisionOutline_Generic::rotate(const CL_Angle &add_angle)
 {
 	angle += add_angle.to_degrees();
-
-	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
-	{
-		CL_Contour *contour_ptr = &contours[outer_cnt];
-		std::vector<CL_Pointf>::size_type point_size = contour_ptr->get_points().size();
-		for (int inner_cnt = 0; inner_cnt < point_size; inner_cnt++)
-		{
-			contour_ptr->get_points()[inner_cnt].rotate(position+rotation_hotspot, add_angle);
-		}
-	}
-
-	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
-	{
-		CL_Contour *contour_ptr = &contours[outer_cnt];
-		std::vector<CL_Pointf>::size_type sub_circles_size = contour_ptr->get_sub_circles().size();
-		for (int inner_cnt = 0; inner_cnt < sub_circles_size; inner_cnt++)
-		{
-			contour_ptr->get_sub_circles()[inner_cnt].position.rotate(position+rotation_hotspot, add_angle);
-		}
-	}
-
-	// Rotate our "radius" too
-	minimum_enclosing_disc.position.rotate(position+rotation_hotspot, add_angle);
+	transform_outline(get_rotation_matrix(add_angle), true);
 }
 
 void CL_CollisionOutline_Generic::set_angle(const CL_Angle &angle)
 {
 	float rotate_angle = angle.to_degrees() - this->angle;
 	this->angle = angle.to_degrees();
-
-	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
-	{
-		CL_Contour *contour_ptr = &contours[outer_cnt];
-		std::vector<CL_Pointf>::size_type point_size = contour_ptr->get_points().size();
-		for (int inner_cnt = 0; inner_cnt < point_size; inner_cnt++)
-		{
-			contour_ptr->get_points()[inner_cnt].rotate(position+rotation_hotspot, CL_Angle(rotate_angle, cl_degrees));
-		}
-	}
-
-	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
-	{
-		CL_Contour *contour_ptr = &contours[outer_cnt];
-		std::vector<CL_Pointf>::size_type sub_circles_size = contour_ptr->get_sub_circles().size();
-		for (int inner_cnt = 0; inner_cnt < sub_circles_size; inner_cnt++)
-		{
-			contour_ptr->get_sub_circles()[inner_cnt].position.rotate(position+rotation_hotspot, CL_Angle(rotate_angle, cl_degrees));
-		}
-	}
-
-	// Rotate our "radius" too
-	minimum_enclosing_disc.position.rotate(position+rotation_hotspot, CL_Angle(rotate_angle,cl_degrees));
+	transform_outline(get_rotation_matrix(CL_Angle(rotate_angle, cl_degrees)), true);
 }
 
 void CL_CollisionOutline_Generic::set_scale(float new_scale_x, float new_scale_y)
@@ -250,16 +194,12 @@ void CL_CollisionOutline_Generic::set_scale(float new_scale_x, float new_scale_y
 	float scale_x = new_scale_x / scale_factor.x;
 	float scale_y = new_scale_y / scale_factor.y;
 	
-	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
-	{
-		CL_Contour *contour_ptr = &contours[outer_cnt];
-		std::vector<CL_Pointf>::size_type point_size = contour_ptr->get_points().size();
-		for (int inner_cnt = 0; inner_cnt < point_size; inner_cnt++)
-		{
-			contour_ptr->get_points()[inner_cnt].x = position.x + ((contour_ptr->get_points()[inner_cnt].x-position.x)*scale_x);
-			contour_ptr->get_points()[inner_cnt].y = position.y + ((contour_ptr->get_points()[inner_cnt].y-position.y)*scale_y);
-		}
-	}
+	CL_Mat4f scale_matrix = CL_Mat4f::identity();
+	scale_matrix[0] = scale_x;
+	scale_matrix[5] = scale_y;
+	scale_matrix[12] = position.x - position.x * scale_x;
+	scale_matrix[13] = position.y - position.y * scale_y;
+	transform_outline(scale_matrix, false);
 	
 	// we can skip this recalculation (if its a unit-scale)
 	if(new_scale_x == new_scale_y)
@@ -281,6 +221,47 @@ void CL_CollisionOutline_Generic::set_scale(float new_scale_x, float new_scale_y
 	scale_factor.y = new_scale_y;
 }
 
+CL_Mat4f CL_CollisionOutline_Generic::get_rotation_matrix(const CL_Angle &rotate_angle) const
+{
+	// Rotation around position+rotation_hotspot, matching CL_Vec2::rotate
+	CL_Pointf hotspot = position + rotation_hotspot;
+	float radians = rotate_angle.to_radians();
+	float sin_angle = sinf(radians);
+	float cos_angle = cosf(radians);
+
+	CL_Mat4f matrix = CL_Mat4f::identity();
+	matrix[0] = cos_angle;
+	matrix[1] = sin_angle;
+	matrix[4] = -sin_angle;
+	matrix[5] = cos_angle;
+	matrix[12] = hotspot.x - hotspot.x * cos_angle + hotspot.y * sin_angle;
+	matrix[13] = hotspot.y - hotspot.x * sin_angle - hotspot.y * cos_angle;
+	return matrix;
+}
+
+void CL_CollisionOutline_Generic::transform_outline(const CL_Mat4f &matrix, bool transform_circles)
+{
+	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
+	{
+		// CL_Pointf adds no members to CL_Vec2f, so the points can be transformed as one array
+		std::vector<CL_Pointf> &points = contours[outer_cnt].get_points();
+		if (!points.empty())
+			matrix.transform(&points[0], &points[0], (int) points.size());
+	}
+
+	if (!transform_circles)
+		return;
+
+	for (unsigned int outer_cnt = 0; outer_cnt < contours.size(); outer_cnt++)
+	{
+		std::vector<CL_OutlineCircle> &sub_circles = contours[outer_cnt].get_sub_circles();
+		for (unsigned int inner_cnt = 0; inner_cnt < sub_circles.size(); inner_cnt++)
+			matrix.transform(&sub_circles[inner_cnt].position, &sub_circles[inner_cnt].position, 1);
+	}
+
+	matrix.transform(&minimum_enclosing_disc.position, &minimum_enclosing_disc.position, 1);
+}
+
 void CL_CollisionOutline_Generic::calculate_radius()
 {
 	std::vector<CL_Pointf> allpoints;
@@ -447,6 +428,7 @@ void CL_CollisionOutline_Generic::save(CL_IODevice &output_source) const
 
 	uint32  type        // file type identifier	
 	uint8   version     // file version	
+	uint8   reserved[3] // padding, so all following fields are 4 byte aligned
 	uint32  width       // width of the outline
 	uint32  height      // height of the outline
 	float32 x-pos       // of enclosing disc
@@ -454,23 +436,37 @@ void CL_CollisionOutline_Generic::save(CL_IODevice &output_source) const
 	float32 radius      // of enclosing disc
 
 	uint32 num_contours
+		uint32 flags contour 1 // 1 = inside contour
 		uint32 num_points contour 1
+		uint32 num_sub_circles contour 1
 			float32 px1
 			float32 py1
 			float32 px2
 			float32 py2
-			... contour 1 data ...
-		uint32 num_points contour 2
+			... contour 1 points ...
+			float32 x-pos sub circle 1
+			float32 y-pos sub circle 1
+			float32 radius sub circle 1
+			uint32 start sub circle 1
+			uint32 end sub circle 1
+			... contour 1 sub circles ...
+		uint32 flags contour 2
 			... contour 2 data ...
-		uint32 num_points contour N
+		uint32 flags contour N
 			... contour N data ...
+
+	Version 1 files have no padding, flags or sub circles.
 */
 
 	// file type identifier
 	output_source.write_uint32( 0x16082004 );
 
 	// fileformat version
-	output_source.write_uint8(1);
+	output_source.write_uint8(2);
+
+	// padding
+	const char reserved[3] = { 0, 0, 0 };
+	output_source.write(reserved, 3);
 
 	// width
 	output_source.write_int32(width);
@@ -493,8 +489,12 @@ void CL_CollisionOutline_Generic::save(CL_IODevice &output_source) const
 	std::vector<CL_Contour>::const_iterator it_cont;
 	for( it_cont = contours.begin(); it_cont != contours.end(); ++it_cont )
 	{
-		// number of points in contours
+		// flags
+		output_source.write_uint32((*it_cont).is_inside_contour() ? 1 : 0);
+
+		// number of points and sub circles in contours
 		output_source.write_uint32((*it_cont).get_points().size());
+		output_source.write_uint32((*it_cont).get_sub_circles().size());
 		
 		std::vector<CL_Pointf>::const_iterator it;
 		for( it = (*it_cont).get_points().begin(); it != (*it_cont).get_points().end(); ++it )
@@ -503,6 +503,16 @@ void CL_CollisionOutline_Generic::save(CL_IODevice &output_source) const
 			output_source.write_float((float)(*it).x);
 			output_source.write_float((float)(*it).y);
 		}
+
+		std::vector<CL_OutlineCircle>::const_iterator it_circle;
+		for( it_circle = (*it_cont).get_sub_circles().begin(); it_circle != (*it_cont).get_sub_circles().end(); ++it_circle )
+		{
+			output_source.write_float((*it_circle).position.x);
+			output_source.write_float((*it_circle).position.y);
+			output_source.write_float((*it_circle).radius);
+			output_source.write_uint32((*it_circle).start);
+			output_source.write_uint32((*it_circle).end);
+		}
 	}
 }
 
@@ -520,6 +530,10 @@ bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, b
 		return false;
 
 	bool any_collisions = false;
+
+	// Kept on the stack, so outlines can be tested from several threads at once
+	CL_CollisionOutline_Segments segments2;
+
 	// collision sub circle test
 	std::vector<CL_Contour>::const_iterator it_contours, it_contours2;
 	for( it_contours = contours.begin(); it_contours != contours.end(); ++it_contours )
@@ -528,7 +542,7 @@ bool CL_CollisionOutline_Generic::collide( const CL_CollisionOutline &outline, b
 			 it_contours2 != outline.get_contours().end();
 			 ++it_contours2 )
 		{
-			if( contours_collide( (*it_contours), (*it_contours2) ) )
+			if( contours_collide( (*it_contours), (*it_contours2), true, segments2 ) )
 			{
 				if( collision_info_collect == false ) 
 					return true; // don't return info about all line intersections
@@ -596,6 +610,19 @@ bool CL_CollisionOutline_Generic::point_inside( const CL_Pointf &point ) const
 	return false;
 }
 
+bool CL_CollisionOutline_Generic::has_sub_circles() const
+{
+	if( minimum_enclosing_disc.radius <= 0.0f )
+		return false;
+
+	for( unsigned int i = 0; i < contours.size(); i++ )
+	{
+		if( contours[i].get_sub_circles().empty() )
+			return false;
+	}
+	return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_CollisionOutline_Generic Implementation:
 
@@ -661,78 +688,123 @@ inline bool CL_CollisionOutline_Generic::line_bounding_box_overlap( const std::v
 }
 
 bool CL_CollisionOutline_Generic::contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, bool do_subcirle_test)
+{
+	CL_CollisionOutline_Segments segments2;
+	return contours_collide(contour1, contour2, do_subcirle_test, segments2);
+}
+
+bool CL_CollisionOutline_Generic::contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, bool do_subcirle_test, CL_CollisionOutline_Segments &segments2)
 {
 	CL_CollidingContours metadata(&contour1, &contour2);
-	
-	std::vector<CL_OutlineCircle>::const_iterator it_oc1, it_oc2;
-	for( it_oc1 = contour1.get_sub_circles().begin(); it_oc1 != contour1.get_sub_circles().end(); ++it_oc1 )
+
+	const std::vector<CL_Pointf> &points1 = contour1.get_points();
+	const std::vector<CL_Pointf> &points2 = contour2.get_points();
+
+	int num_points1 = points1.size();
+	int num_points2 = points2.size();
+
+	const std::vector<CL_OutlineCircle> &sub_circles1 = contour1.get_sub_circles();
+	const std::vector<CL_OutlineCircle> &sub_circles2 = contour2.get_sub_circles();
+
+	segments2.reset(contour2);
+
+	for (unsigned int oc1 = 0; oc1 < sub_circles1.size(); oc1++)
 	{
-		for( it_oc2 = contour2.get_sub_circles().begin(); it_oc2 != contour2.get_sub_circles().end(); ++it_oc2 )
+		for (unsigned int oc2 = 0; oc2 < sub_circles2.size(); oc2++)
 		{
-			if( do_subcirle_test ? (*it_oc1).collide(*it_oc2) : true ) // outline circles collide
+			if( do_subcirle_test && !sub_circles1[oc1].collide(sub_circles2[oc2]) )
+				continue;
+
+			if (!segments2.sub_circle_built[oc2])
+				segments2.build_sub_circle(oc2);
+
+			const CL_Rectf &bounds2 = segments2.sub_circle_bounds[oc2];
+
+			// test each line segment inside the colliding circles
+			for( unsigned int counter_i=sub_circles1[oc1].start; counter_i != sub_circles1[oc1].end; ++counter_i )
 			{
-				// test each line segment inside the colliding circles
-
-				const std::vector<CL_Pointf> &points1 = contour1.get_points();
-				const std::vector<CL_Pointf> &points2 = contour2.get_points();
-				
-				int num_points1 = points1.size();
-				int num_points2 = points2.size();
-				
-				for( unsigned int counter_i=(*it_oc1).start; counter_i != (*it_oc1).end; ++counter_i )
+				int i  = counter_i % num_points1;
+				int i2 = (counter_i+1) % num_points1;
+
+				float left   = cl_min(points1[i].x, points1[i2].x);
+				float right  = cl_max(points1[i].x, points1[i2].x);
+				float top    = cl_min(points1[i].y, points1[i2].y);
+				float bottom = cl_max(points1[i].y, points1[i2].y);
+
+				// No segment of the second circle can overlap if its bounding box does not
+				if (bounds2.left > right || bounds2.right < left || bounds2.top > bottom || bounds2.bottom < top)
+					continue;
+
+				// The segments of a sub circle are contiguous, unless the circle wraps past the last point
+				unsigned int counter_j = sub_circles2[oc2].start;
+				while (counter_j != sub_circles2[oc2].end)
 				{
-					int i  = counter_i % num_points1;
-					int i2 = (counter_i+1) % num_points1;
-					
-					for( unsigned int counter_j=(*it_oc2).start; counter_j != (*it_oc2).end; ++counter_j )
+					int first_j = counter_j % num_points2;
+					int count = cl_min((unsigned int) (num_points2 - first_j), sub_circles2[oc2].end - counter_j);
+					counter_j += count;
+
+#ifndef CL_DISABLE_SSE2
+					__m128 p_x = _mm_set1_ps(points1[i].x);
+					__m128 p_y = _mm_set1_ps(points1[i].y);
+					__m128 delta1_x = _mm_set1_ps(points1[i2].x - points1[i].x);
+					__m128 delta1_y = _mm_set1_ps(points1[i2].y - points1[i].y);
+					__m128 left4 = _mm_set1_ps(left);
+					__m128 right4 = _mm_set1_ps(right);
+					__m128 top4 = _mm_set1_ps(top);
+					__m128 bottom4 = _mm_set1_ps(bottom);
+					__m128 zero = _mm_setzero_ps();
+					__m128 one = _mm_set1_ps(1.0f);
+					__m128i lane = _mm_set_epi32(3, 2, 1, 0);
+
+					for (int block = 0; block < count; block += 4)
 					{
-						int j  = counter_j % num_points2;
-						int j2 = (counter_j+1) % num_points2;
-						
-						if( line_bounding_box_overlap(points1, points2, i, j, i2, j2) )
+						int j = first_j + block;
+
+						// Same bounding box test as line_bounding_box_overlap()
+						__m128 mask = _mm_and_ps(
+							_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&segments2.min_x[j]), right4), _mm_cmpge_ps(_mm_loadu_ps(&segments2.max_x[j]), left4)),
+							_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&segments2.min_y[j]), bottom4), _mm_cmpge_ps(_mm_loadu_ps(&segments2.max_y[j]), top4)));
+						mask = _mm_and_ps(mask, _mm_castsi128_ps(_mm_cmplt_epi32(lane, _mm_set1_epi32(count - block))));
+						if (_mm_movemask_ps(mask) == 0)
+							continue;
+
+						// Same intersection test as CL_LineSegment2f::get_intersection(), done for four segments at once
+						__m128 start_x = _mm_loadu_ps(&segments2.start_x[j]);
+						__m128 start_y = _mm_loadu_ps(&segments2.start_y[j]);
+						__m128 end_y = _mm_loadu_ps(&segments2.end_y[j]);
+						__m128 delta2_x = _mm_sub_ps(_mm_loadu_ps(&segments2.end_x[j]), start_x);
+						__m128 delta2_y = _mm_sub_ps(end_y, start_y);
+						__m128 offset_x = _mm_sub_ps(p_x, start_x);
+						__m128 offset_y = _mm_sub_ps(p_y, start_y);
+
+						__m128 denominator = _mm_sub_ps(_mm_mul_ps(delta1_x, delta2_y), _mm_mul_ps(delta1_y, delta2_x));
+						__m128 r = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(offset_y, delta2_x), _mm_mul_ps(offset_x, delta2_y)), denominator);
+						__m128 s = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(offset_y, delta1_x), _mm_mul_ps(offset_x, delta1_y)), denominator);
+
+						// s is in [0;1) or (0;1] depending on the direction of the second segment
+						__m128 upwards = _mm_cmplt_ps(start_y, end_y);
+						__m128 s_inside = _mm_or_ps(
+							_mm_and_ps(upwards, _mm_and_ps(_mm_cmpge_ps(s, zero), _mm_cmplt_ps(s, one))),
+							_mm_andnot_ps(upwards, _mm_and_ps(_mm_cmpgt_ps(s, zero), _mm_cmple_ps(s, one))));
+						__m128 r_inside = _mm_and_ps(_mm_cmpge_ps(r, zero), _mm_cmple_ps(r, one));
+
+						mask = _mm_and_ps(mask, _mm_cmpneq_ps(denominator, zero));
+						int hits = _mm_movemask_ps(_mm_and_ps(mask, _mm_and_ps(s_inside, r_inside)));
+						for (int k = 0; hits != 0; k++, hits >>= 1)
 						{
-							CL_LineSegment2f line1(points1[i], points1[i2]);
-							CL_LineSegment2f line2(points2[j], points2[j2]);
-							CL_Pointf dest_intercept;
-
-							bool did_intersect;
-							dest_intercept = line1.get_intersection( line2, did_intersect );
-							if( did_intersect )
-							{
-								if( collision_info_collect )
-								{
-									CL_CollisionPoint collisionpoint;
-									
-									if ( collision_info_points )
-									{
-										collisionpoint.point = dest_intercept;
-									}
-									
-									if( collision_info_normals )
-									{
-										collisionpoint.normal = line2.normal();
-									}
-									
-									if( collision_info_meta )
-									{
-										collisionpoint.contour1_line_start = i;
-										collisionpoint.contour1_line_end   = i2;
-										collisionpoint.contour2_line_start = j;
-										collisionpoint.contour2_line_end   = j2;
-										// Found by the dot-product of line1 and the perpendicular of line2:
-										{
-											CL_Pointf line1(points1[i2].x - points1[i].x, points1[i2].y - points1[i].y);
-											CL_Pointf line2(-(points2[j2].y - points2[j].y), points2[j2].x - points2[j].x);
-											collisionpoint.is_entry = (line1.x * line2.x + line1.y * line2.y) < 0.0;
-										}
-									}
-									metadata.points.push_back(collisionpoint);
-								}
-								else
-									return true;
-							}
+							if ((hits & 1) && segments_collide(metadata, points1, points2, i, i2, j + k, (j + k + 1) % num_points2) && !collision_info_collect)
+								return true;
 						}
 					}
+#else
+					for (int j = first_j; j < first_j + count; j++)
+					{
+						int j2 = (j+1) % num_points2;
+						if( line_bounding_box_overlap(points1, points2, i, j, i2, j2) &&
+							segments_collide(metadata, points1, points2, i, i2, j, j2) && !collision_info_collect )
+							return true;
+					}
+#endif
 				}
 			}
 		}
@@ -748,6 +820,48 @@ bool CL_CollisionOutline_Generic::contours_collide(const CL_Contour &contour1, c
 	return false;
 }
 
+bool CL_CollisionOutline_Generic::segments_collide(CL_CollidingContours &metadata, const std::vector<CL_Pointf> &points1, const std::vector<CL_Pointf> &points2, int i, int i2, int j, int j2)
+{
+	CL_LineSegment2f line1(points1[i], points1[i2]);
+	CL_LineSegment2f line2(points2[j], points2[j2]);
+
+	bool did_intersect;
+	CL_Pointf dest_intercept = line1.get_intersection( line2, did_intersect );
+	if( !did_intersect )
+		return false;
+
+	if( collision_info_collect )
+	{
+		CL_CollisionPoint collisionpoint;
+
+		if ( collision_info_points )
+		{
+			collisionpoint.point = dest_intercept;
+		}
+
+		if( collision_info_normals )
+		{
+			collisionpoint.normal = line2.normal();
+		}
+
+		if( collision_info_meta )
+		{
+			collisionpoint.contour1_line_start = i;
+			collisionpoint.contour1_line_end   = i2;
+			collisionpoint.contour2_line_start = j;
+			collisionpoint.contour2_line_end   = j2;
+			// Found by the dot-product of line1 and the perpendicular of line2:
+			{
+				CL_Pointf line1(points1[i2].x - points1[i].x, points1[i2].y - points1[i].y);
+				CL_Pointf line2(-(points2[j2].y - points2[j].y), points2[j2].x - points2[j].x);
+				collisionpoint.is_entry = (line1.x * line2.x + line1.y * line2.y) < 0.0;
+			}
+		}
+		metadata.points.push_back(collisionpoint);
+	}
+	return true;
+}
+
 void CL_CollisionOutline_Generic::calculate_penetration_depth( std::vector< CL_CollidingContours > & collision_info )
 {
 	// Figure out the pen-depth
@@ -860,3 +974,56 @@ void CL_CollisionOutline_Generic::calculate_penetration_depth( std::vector< CL_C
 		//NONO: maxpendepth = std::min(maxpendepth, 40.0f);
 	}
 }
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionOutline_Segments Implementation:
+
+void CL_CollisionOutline_Segments::reset(const CL_Contour &new_contour)
+{
+	contour = &new_contour;
+	num_segments = contour->get_points().size();
+
+	// Padding, so the last segments can be loaded four at a time
+	int padded_size = num_segments + 3;
+	start_x.resize(padded_size);
+	start_y.resize(padded_size);
+	end_x.resize(padded_size);
+	end_y.resize(padded_size);
+	min_x.resize(padded_size);
+	max_x.resize(padded_size);
+	min_y.resize(padded_size);
+	max_y.resize(padded_size);
+
+	sub_circle_bounds.resize(contour->get_sub_circles().size());
+	sub_circle_built.assign(contour->get_sub_circles().size(), false);
+}
+
+void CL_CollisionOutline_Segments::build_sub_circle(unsigned int index)
+{
+	const std::vector<CL_Pointf> &points = contour->get_points();
+	const CL_OutlineCircle &sub_circle = contour->get_sub_circles()[index];
+
+	CL_Rectf bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (unsigned int counter = sub_circle.start; counter != sub_circle.end; ++counter)
+	{
+		int i = counter % num_segments;
+		const CL_Pointf &start = points[i];
+		const CL_Pointf &end = points[(i + 1) % num_segments];
+		start_x[i] = start.x;
+		start_y[i] = start.y;
+		end_x[i] = end.x;
+		end_y[i] = end.y;
+		min_x[i] = cl_min(start.x, end.x);
+		max_x[i] = cl_max(start.x, end.x);
+		min_y[i] = cl_min(start.y, end.y);
+		max_y[i] = cl_max(start.y, end.y);
+
+		bounds.left = cl_min(bounds.left, min_x[i]);
+		bounds.right = cl_max(bounds.right, max_x[i]);
+		bounds.top = cl_min(bounds.top, min_y[i]);
+		bounds.bottom = cl_max(bounds.bottom, max_y[i]);
+	}
+
+	sub_circle_bounds[index] = bounds;
+	sub_circle_built[index] = true;
+}
@@ -36,9 +36,33 @@
 #include "API/Display/Collision/outline_circle.h"
 #include "API/Display/Collision/outline_accuracy.h"
 #include "API/Core/IOData/virtual_directory.h"
+#include "API/Core/Math/mat4.h"
 
 class CL_OutlineProvider;
 
+/// \brief Line segments of a contour in structure-of-arrays form.
+///
+/// Segment i runs from point i to point i+1 of the contour. The segments are gathered one
+/// sub circle at a time, when a sub circle first passes the sub circle test. The arrays are
+/// padded so four segments can always be loaded at once.
+class CL_CollisionOutline_Segments
+{
+public:
+	CL_CollisionOutline_Segments() : contour(0), num_segments(0) { }
+
+	void reset(const CL_Contour &contour);
+	void build_sub_circle(unsigned int index);
+
+	const CL_Contour *contour;
+	int num_segments;
+	std::vector<float> start_x, start_y, end_x, end_y;
+	std::vector<float> min_x, max_x, min_y, max_y;
+
+	/// \brief Bounding box of the segments inside each sub circle
+	std::vector<CL_Rectf> sub_circle_bounds;
+	std::vector<bool> sub_circle_built;
+};
+
 class CL_CollisionOutline_Generic
 {
 /// \name Construction
@@ -75,7 +99,7 @@ public:
 	bool collision_info_normals;
 	bool collision_info_meta;
 	bool collision_info_pen_depth;
-	///< points || normals || meta (quick way of seeing if any info is collected)
+	/// \brief points || normals || meta (quick way of seeing if any info is collected)
 	bool collision_info_collect;
 
 	std::vector<CL_CollidingContours> collision_info;
@@ -96,6 +120,7 @@ public:
 
 	bool collide( const CL_CollisionOutline &outline, bool remove_old_collision_info);
 	bool point_inside( const CL_Pointf &point ) const;
+	bool has_sub_circles() const;
 	static bool point_inside_contour( const CL_Pointf &point, const CL_Contour &contour);
 	bool contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, bool do_subcirle_test=true);
 	static void calculate_penetration_depth(std::vector<CL_CollidingContours> &collision_info);
@@ -109,6 +134,17 @@ public:
 
 /// \}
 
+private:
+	CL_Mat4f get_rotation_matrix(const CL_Angle &rotate_angle) const;
+
+	/// \brief Transforms all points, and optionally the sub circles and enclosing disc, by a 2D matrix
+	void transform_outline(const CL_Mat4f &matrix, bool transform_circles);
+
+	/// \brief Tests two contours, using segments2 as scratch space for the segments of contour2
+	bool contours_collide(const CL_Contour &contour1, const CL_Contour &contour2, bool do_subcirle_test, CL_CollisionOutline_Segments &segments2);
+
+	bool segments_collide(CL_CollidingContours &metadata, const std::vector<CL_Pointf> &points1, const std::vector<CL_Pointf> &points2, int i, int i2, int j, int j2);
+
 /// \}
 /// \name Implementation
 /// \{
@@ -0,0 +1,362 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Display/precomp.h"
+#include "API/Display/Collision/collision_world.h"
+#include "API/Display/Collision/collision_outline.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/Text/string_format.h"
+#include "collision_world_impl.h"
+#include <algorithm>
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld Construction:
+
+CL_CollisionWorld::CL_CollisionWorld()
+: impl(new CL_CollisionWorld_Impl)
+{
+}
+
+CL_CollisionWorld::~CL_CollisionWorld()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld Attributes:
+
+int CL_CollisionWorld::get_outline_count() const
+{
+	return impl->num_outlines;
+}
+
+CL_CollisionOutline CL_CollisionWorld::get_outline(int id) const
+{
+	if (id < 0 || id >= (int) impl->slots.size() || !impl->slots[id].used)
+		throw CL_Exception(cl_format("Invalid collision world outline id %1", id));
+	return impl->slots[id].outline;
+}
+
+float CL_CollisionWorld::get_cell_size() const
+{
+	return impl->cell_size;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld Operations:
+
+int CL_CollisionWorld::add(const CL_CollisionOutline &outline)
+{
+	int id;
+	if (impl->free_ids.empty())
+	{
+		id = (int) impl->slots.size();
+		impl->slots.push_back(CL_CollisionWorld_Impl::Slot());
+	}
+	else
+	{
+		id = impl->free_ids.back();
+		impl->free_ids.pop_back();
+	}
+
+	impl->slots[id].used = true;
+	impl->slots[id].outline = outline;
+	impl->num_outlines++;
+	return id;
+}
+
+void CL_CollisionWorld::remove(int id)
+{
+	if (id < 0 || id >= (int) impl->slots.size() || !impl->slots[id].used)
+		throw CL_Exception(cl_format("Invalid collision world outline id %1", id));
+
+	impl->slots[id].used = false;
+	impl->slots[id].outline = CL_CollisionOutline();
+	impl->free_ids.push_back(id);
+	impl->num_outlines--;
+}
+
+void CL_CollisionWorld::clear()
+{
+	impl->slots.clear();
+	impl->free_ids.clear();
+	impl->num_outlines = 0;
+}
+
+void CL_CollisionWorld::set_cell_size(float size)
+{
+	impl->cell_size = cl_max(size, 0.0f);
+}
+
+std::vector<CL_CollisionPair> CL_CollisionWorld::find_candidate_pairs()
+{
+	std::vector<CL_CollisionPair> pairs;
+	impl->find_candidate_pairs(pairs);
+	return pairs;
+}
+
+std::vector<CL_CollisionPair> CL_CollisionWorld::find_collisions(int num_threads)
+{
+	std::vector<CL_CollisionPair> pairs;
+	impl->find_collisions(pairs, num_threads);
+	return pairs;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld_Impl Construction:
+
+CL_CollisionWorld_Impl::CL_CollisionWorld_Impl()
+: num_outlines(0), cell_size(0.0f)
+{
+}
+
+CL_CollisionWorld_Impl::~CL_CollisionWorld_Impl()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld_Impl Operations:
+
+void CL_CollisionWorld_Impl::find_candidate_pairs(std::vector<CL_CollisionPair> &pairs)
+{
+	pairs.clear();
+	cell_entries.clear();
+	oversized.clear();
+	bounds.resize(slots.size());
+
+	// Use the average enclosing disc diameter as cell size, unless one was specified:
+	float size = cell_size;
+	if (size <= 0.0f)
+	{
+		float total_diameter = 0.0f;
+		for (std::vector<Slot>::size_type id = 0; id < slots.size(); id++)
+		{
+			if (slots[id].used)
+				total_diameter += slots[id].outline.get_minimum_enclosing_disc().radius * 2.0f;
+		}
+		if (num_outlines > 0)
+			size = total_diameter / num_outlines;
+		if (size <= 0.0f)
+			size = 1.0f;
+	}
+	float scale = 1.0f / size;
+
+	// Insert the outlines into every cell their disc bounding box covers:
+	for (std::vector<Slot>::size_type id = 0; id < slots.size(); id++)
+	{
+		if (!slots[id].used)
+			continue;
+
+		Bounds &cur_bounds = bounds[id];
+		cur_bounds.disc = slots[id].outline.get_minimum_enclosing_disc();
+		cur_bounds.min_x = (int) floor((cur_bounds.disc.position.x - cur_bounds.disc.radius) * scale);
+		cur_bounds.min_y = (int) floor((cur_bounds.disc.position.y - cur_bounds.disc.radius) * scale);
+		cur_bounds.max_x = (int) floor((cur_bounds.disc.position.x + cur_bounds.disc.radius) * scale);
+		cur_bounds.max_y = (int) floor((cur_bounds.disc.position.y + cur_bounds.disc.radius) * scale);
+
+		cl_byte64 num_cells = (cl_byte64) (cur_bounds.max_x - cur_bounds.min_x + 1) * (cur_bounds.max_y - cur_bounds.min_y + 1);
+		cur_bounds.oversized = num_cells > max_cells_per_outline;
+		if (cur_bounds.oversized)
+		{
+			oversized.push_back(id);
+			continue;
+		}
+
+		for (int y = cur_bounds.min_y; y <= cur_bounds.max_y; y++)
+		{
+			for (int x = cur_bounds.min_x; x <= cur_bounds.max_x; x++)
+			{
+				CellEntry entry;
+				entry.cell = get_cell_key(x, y);
+				entry.id = id;
+				cell_entries.push_back(entry);
+			}
+		}
+	}
+
+	// Sorting groups the entries of each cell together, ordered by id:
+	std::sort(cell_entries.begin(), cell_entries.end());
+
+	std::vector<CellEntry>::size_type num_entries = cell_entries.size();
+	std::vector<CellEntry>::size_type start = 0;
+	while (start < num_entries)
+	{
+		std::vector<CellEntry>::size_type end = start + 1;
+		while (end < num_entries && cell_entries[end].cell == cell_entries[start].cell)
+			end++;
+
+		int cell_x = (int) (cl_ubyte32) (cell_entries[start].cell >> 32);
+		int cell_y = (int) (cl_ubyte32) cell_entries[start].cell;
+
+		for (std::vector<CellEntry>::size_type i = start; i < end; i++)
+		{
+			const Bounds &bounds1 = bounds[cell_entries[i].id];
+			for (std::vector<CellEntry>::size_type j = i + 1; j < end; j++)
+			{
+				const Bounds &bounds2 = bounds[cell_entries[j].id];
+
+				// Two outlines share all cells in the overlap of their cell ranges.
+				// Only report the pair from the first of those cells:
+				if (cl_max(bounds1.min_x, bounds2.min_x) != cell_x || cl_max(bounds1.min_y, bounds2.min_y) != cell_y)
+					continue;
+
+				if (discs_overlap(bounds1.disc, bounds2.disc))
+				{
+					CL_CollisionPair pair;
+					pair.outline1 = cell_entries[i].id;
+					pair.outline2 = cell_entries[j].id;
+					pairs.push_back(pair);
+				}
+			}
+		}
+
+		start = end;
+	}
+
+	// Outlines too large for the grid are tested against everything:
+	for (std::vector<int>::size_type index_oversized = 0; index_oversized < oversized.size(); index_oversized++)
+	{
+		int id1 = oversized[index_oversized];
+		for (std::vector<Slot>::size_type id2 = 0; id2 < slots.size(); id2++)
+		{
+			if (!slots[id2].used || (int) id2 == id1 || (bounds[id2].oversized && (int) id2 < id1))
+				continue;
+
+			if (discs_overlap(bounds[id1].disc, bounds[id2].disc))
+			{
+				CL_CollisionPair pair;
+				pair.outline1 = cl_min(id1, (int) id2);
+				pair.outline2 = cl_max(id1, (int) id2);
+				pairs.push_back(pair);
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end(), CL_CollisionWorld_Impl::pair_less);
+}
+
+void CL_CollisionWorld_Impl::find_collisions(std::vector<CL_CollisionPair> &pairs, int num_threads)
+{
+	std::vector<CL_CollisionPair> candidates;
+	find_candidate_pairs(candidates);
+
+	for (std::vector<Slot>::size_type id = 0; id < slots.size(); id++)
+	{
+		if (slots[id].used)
+			slots[id].outline.clean_collision_info();
+	}
+
+	int num_candidates = (int) candidates.size();
+	if (num_threads <= 0)
+		num_threads = CL_System::get_num_cores();
+	num_threads = cl_max(cl_min(num_threads, num_candidates / min_pairs_per_thread), 1);
+
+	// Collision info is written to outline1, so all pairs sharing outline1 must go to the same thread:
+	std::vector<int> range_starts;
+	range_starts.push_back(0);
+	for (int i = 1; i < num_threads; i++)
+	{
+		int range_start = cl_max((int) ((cl_byte64) num_candidates * i / num_threads), range_starts.back());
+		while (range_start > 0 && range_start < num_candidates && candidates[range_start].outline1 == candidates[range_start - 1].outline1)
+			range_start++;
+		range_starts.push_back(range_start);
+	}
+	range_starts.push_back(num_candidates);
+
+	std::vector<unsigned char> results(num_candidates, 0);
+	const std::vector<CL_CollisionPair> *candidates_ptr = &candidates;
+	std::vector<unsigned char> *results_ptr = &results;
+
+	std::vector<CL_Thread> threads;
+	for (int i = 1; i < num_threads; i++)
+	{
+		CL_Thread thread;
+		thread.start(this, &CL_CollisionWorld_Impl::collide_pairs, candidates_ptr, range_starts[i], range_starts[i + 1], results_ptr);
+		threads.push_back(thread);
+	}
+
+	collide_pairs(candidates_ptr, range_starts[0], range_starts[1], results_ptr);
+
+	for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	// CL_CollisionOutline::collide only calculates the penetration depth when it clears the old info:
+	for (std::vector<Slot>::size_type id = 0; id < slots.size(); id++)
+	{
+		if (!slots[id].used || slots[id].outline.get_collision_info().empty())
+			continue;
+
+		bool points, normals, metadata, pen_depth;
+		slots[id].outline.get_collision_info_state(points, normals, metadata, pen_depth);
+		if (pen_depth)
+		{
+			std::vector<CL_CollidingContours> collision_info = slots[id].outline.get_collision_info();
+			CL_CollisionOutline::calculate_penetration_depth(collision_info);
+			slots[id].outline.set_collision_info(collision_info);
+		}
+	}
+
+	pairs.clear();
+	for (int i = 0; i < num_candidates; i++)
+	{
+		if (results[i])
+			pairs.push_back(candidates[i]);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_CollisionWorld_Impl Implementation:
+
+cl_ubyte64 CL_CollisionWorld_Impl::get_cell_key(int x, int y)
+{
+	return (((cl_ubyte64) (cl_ubyte32) x) << 32) | (cl_ubyte32) y;
+}
+
+bool CL_CollisionWorld_Impl::discs_overlap(const CL_Circlef &disc1, const CL_Circlef &disc2)
+{
+	float dx = disc1.position.x - disc2.position.x;
+	float dy = disc1.position.y - disc2.position.y;
+	float radius = disc1.radius + disc2.radius;
+	return dx * dx + dy * dy <= radius * radius;
+}
+
+bool CL_CollisionWorld_Impl::pair_less(const CL_CollisionPair &pair1, const CL_CollisionPair &pair2)
+{
+	return pair1.outline1 != pair2.outline1 ? pair1.outline1 < pair2.outline1 : pair1.outline2 < pair2.outline2;
+}
+
+void CL_CollisionWorld_Impl::collide_pairs(const std::vector<CL_CollisionPair> *pairs, int start, int end, std::vector<unsigned char> *results)
+{
+	for (int i = start; i < end; i++)
+	{
+		const CL_CollisionPair &pair = (*pairs)[i];
+		if (slots[pair.outline1].outline.collide(slots[pair.outline2].outline, false))
+			(*results)[i] = 1;
+	}
+}
@@ -0,0 +1,107 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Display/Collision/collision_world.h"
+#include "API/Display/Collision/collision_outline.h"
+
+class CL_CollisionWorld_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_CollisionWorld_Impl();
+	~CL_CollisionWorld_Impl();
+
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	struct Slot
+	{
+		Slot() : used(false) { }
+
+		bool used;
+		CL_CollisionOutline outline;
+	};
+
+	std::vector<Slot> slots;
+	std::vector<int> free_ids;
+	int num_outlines;
+	float cell_size;
+
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void find_candidate_pairs(std::vector<CL_CollisionPair> &pairs);
+	void find_collisions(std::vector<CL_CollisionPair> &pairs, int num_threads);
+
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	struct Bounds
+	{
+		CL_Circlef disc;
+		int min_x, min_y, max_x, max_y;
+		bool oversized;
+	};
+
+	struct CellEntry
+	{
+		cl_ubyte64 cell;
+		int id;
+
+		bool operator<(const CellEntry &other) const { return cell != other.cell ? cell < other.cell : id < other.id; }
+	};
+
+	static cl_ubyte64 get_cell_key(int x, int y);
+	static bool discs_overlap(const CL_Circlef &disc1, const CL_Circlef &disc2);
+	static bool pair_less(const CL_CollisionPair &pair1, const CL_CollisionPair &pair2);
+
+	void collide_pairs(const std::vector<CL_CollisionPair> *pairs, int start, int end, std::vector<unsigned char> *results);
+
+	std::vector<Bounds> bounds;
+	std::vector<CellEntry> cell_entries;
+	std::vector<int> oversized;
+
+	/// \brief Outlines covering more cells than this are tested against all other outlines instead.
+	static const int max_cells_per_outline = 64;
+
+	static const int min_pairs_per_thread = 64;
+/// \}
+};
@@ -82,6 +82,16 @@ int CL_OutlineProviderFile::get_height()
 	return impl->height;
 }
 
+CL_Circlef CL_OutlineProviderFile::get_minimum_enclosing_disc()
+{
+	return impl->minimum_enclosing_disc;
+}
+
+int CL_OutlineProviderFile::get_version() const
+{
+	return impl->version;
+}
+
 void CL_OutlineProviderFile::destroy()
 {
 	delete this;
@@ -32,6 +32,7 @@
 #include "Display/precomp.h"
 #include "API/Core/System/exception.h"
 #include "API/Core/IOData/iodevice.h"
+#include "API/Core/IOData/cl_endian.h"
 #include "API/Core/Text/string_format.h"
 #include "outline_provider_file_generic.h"
 
@@ -55,12 +56,20 @@ void CL_OutlineProviderFile_Generic::load(CL_IODevice &input_source)
 {
 	// file type & version identifiers
 	int type = input_source.read_uint32();
-	unsigned char version = input_source.read_uint8();
+	version = input_source.read_uint8();
 
 	if( type != 0x16082004  )
 		throw CL_Exception("File is not a collision outline file" );
-	if( version != 1 )
-		throw CL_Exception(cl_format("Unsupported version of outline format: %1. Supported versions: 1.", version) );
+	if( version != 1 && version != 2 )
+		throw CL_Exception(cl_format("Unsupported version of outline format: %1. Supported versions: 1, 2.", version) );
+
+	// Version 2 pads the header, so everything after it is 4 byte aligned
+	if( version >= 2 )
+	{
+		char reserved[3];
+		if( input_source.read(reserved, 3) != 3 )
+			throw CL_Exception("Collision outline file is truncated");
+	}
 
 	// read in width and height
 	width = input_source.read_int32();
@@ -72,7 +81,15 @@ void CL_OutlineProviderFile_Generic::load(CL_IODevice &input_source)
 	minimum_enclosing_disc.position.y = input_source.read_float();
 	// radius of enclosing disc
 	minimum_enclosing_disc.radius = input_source.read_float();
-	
+
+	if( version == 1 )
+		load_contours_version1(input_source);
+	else
+		load_contours_version2(input_source);
+}
+
+void CL_OutlineProviderFile_Generic::load_contours_version1(CL_IODevice &input_source)
+{
 	// num contours
 	int num_contours = input_source.read_uint32();
 
@@ -94,3 +111,64 @@ void CL_OutlineProviderFile_Generic::load(CL_IODevice &input_source)
 		contours.push_back(contour);
 	}
 }
+
+void CL_OutlineProviderFile_Generic::load_contours_version2(CL_IODevice &input_source)
+{
+	int num_contours = input_source.read_uint32();
+
+	std::vector<cl_ubyte32> sub_circle_data;
+	for( int cc=0; cc < num_contours; ++cc )
+	{
+		CL_Contour contour;
+
+		cl_ubyte32 flags = input_source.read_uint32();
+		contour.set_inside_contour((flags & 1) != 0);
+
+		int num_points = input_source.read_uint32();
+		int num_sub_circles = input_source.read_uint32();
+
+		// Sub circles cover line segments, so a contour with sub circles needs at least one segment
+		if( num_sub_circles > 0 && num_points < 2 )
+			throw CL_Exception("Collision outline file has sub circles on a contour without line segments");
+
+		// The points are stored as one array of x,y floats
+		std::vector<CL_Pointf> &points = contour.get_points();
+		points.resize(num_points);
+		if( num_points > 0 )
+		{
+			int size = num_points * 2 * sizeof(float);
+			if( input_source.read(&points[0], size) != size )
+				throw CL_Exception("Collision outline file is truncated");
+			if( input_source.is_little_endian() == CL_Endian::is_system_big() )
+				CL_Endian::swap(&points[0], sizeof(float), num_points * 2);
+		}
+
+		// Each sub circle is stored as x,y,radius floats followed by start,end integers
+		std::vector<CL_OutlineCircle> &sub_circles = contour.get_sub_circles();
+		sub_circles.resize(num_sub_circles);
+		if( num_sub_circles > 0 )
+		{
+			sub_circle_data.resize(num_sub_circles * 5);
+			int size = num_sub_circles * 5 * sizeof(cl_ubyte32);
+			if( input_source.read(&sub_circle_data[0], size) != size )
+				throw CL_Exception("Collision outline file is truncated");
+			if( input_source.is_little_endian() == CL_Endian::is_system_big() )
+				CL_Endian::swap(&sub_circle_data[0], sizeof(cl_ubyte32), num_sub_circles * 5);
+
+			for( int sc=0; sc < num_sub_circles; ++sc )
+			{
+				const cl_ubyte32 *data = &sub_circle_data[sc * 5];
+				CL_OutlineCircle &circle = sub_circles[sc];
+				memcpy(&circle.position.x, data, sizeof(float));
+				memcpy(&circle.position.y, data + 1, sizeof(float));
+				memcpy(&circle.radius, data + 2, sizeof(float));
+				circle.start = data[3];
+				circle.end = data[4];
+				if( circle.start >= (unsigned int) num_points || circle.end > (unsigned int) num_points || circle.end <= circle.start )
+					throw CL_Exception("Collision outline file has an invalid sub circle");
+			}
+		}
+
+		contours.push_back(contour);
+	}
+}
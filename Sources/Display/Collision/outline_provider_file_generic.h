@@ -47,9 +47,12 @@ public:
 	std::vector<CL_Contour> contours;
 	int width, height;
 	CL_Circlef minimum_enclosing_disc;
+	int version;
 
 private:
 	void load(CL_IODevice &file);
+	void load_contours_version1(CL_IODevice &file);
+	void load_contours_version2(CL_IODevice &file);
 };
 
 
@@ -29,8 +29,10 @@
 
 #pragma once
 
+#include "API/Display/Font/font.h"
+#include <vector>
+
 class CL_FontMetrics;
-class CL_FontPixelBuffer;
 class CL_Colorf;
 
 class CL_FontEngine
@@ -42,4 +44,40 @@ public:
 	virtual CL_FontPixelBuffer get_font_glyph_standard(int glyph, bool anti_alias) = 0;
 	virtual CL_FontPixelBuffer get_font_glyph_subpixel(int glyph) = 0;
 
+	/// \brief Constructs a pixel buffer whose alpha channel is a signed distance field of the glyph.
+	///
+	/// Alpha 0.5 is the glyph edge. Font engines without outline access fall back to an anti-aliased glyph.
+	virtual CL_FontPixelBuffer get_font_glyph_distance_field(int glyph) { return get_font_glyph_standard(glyph, true); }
+
+	/// \brief Constructs pixel buffers for a list of glyphs.
+	///
+	/// Font engines able to rasterize in parallel override this. The default renders the glyphs one at a time.
+	virtual std::vector<CL_FontPixelBuffer> get_font_glyphs_standard(const std::vector<unsigned int> &glyphs, bool anti_alias)
+	{
+		std::vector<CL_FontPixelBuffer> font_buffers;
+		font_buffers.reserve(glyphs.size());
+		for (std::vector<unsigned int>::size_type i = 0; i < glyphs.size(); i++)
+			font_buffers.push_back(get_font_glyph_standard(glyphs[i], anti_alias));
+		return font_buffers;
+	}
+
+	/// \brief Constructs pixel buffers for a list of glyphs using subpixel rendering.
+	virtual std::vector<CL_FontPixelBuffer> get_font_glyphs_subpixel(const std::vector<unsigned int> &glyphs)
+	{
+		std::vector<CL_FontPixelBuffer> font_buffers;
+		font_buffers.reserve(glyphs.size());
+		for (std::vector<unsigned int>::size_type i = 0; i < glyphs.size(); i++)
+			font_buffers.push_back(get_font_glyph_subpixel(glyphs[i]));
+		return font_buffers;
+	}
+
+	/// \brief Constructs signed distance field pixel buffers for a list of glyphs.
+	virtual std::vector<CL_FontPixelBuffer> get_font_glyphs_distance_field(const std::vector<unsigned int> &glyphs)
+	{
+		std::vector<CL_FontPixelBuffer> font_buffers;
+		font_buffers.reserve(glyphs.size());
+		for (std::vector<unsigned int>::size_type i = 0; i < glyphs.size(); i++)
+			font_buffers.push_back(get_font_glyph_distance_field(glyphs[i]));
+		return font_buffers;
+	}
 };
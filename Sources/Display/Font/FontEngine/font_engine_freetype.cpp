@@ -36,6 +36,8 @@
 #include "API/Display/Image/pixel_buffer.h"
 #include "API/Display/Image/pixel_format.h"
 #include "API/Display/2D/color.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/system.h"
 
 class CL_FontEngine_Freetype_Library
 {
@@ -80,7 +82,7 @@ CL_FontEngine_Freetype_Library &CL_FontEngine_Freetype_Library::instance()
 /////////////////////////////////////////////////////////////////////////////
 // CL_FontEngine_Freetype Construction:
 
-CL_FontEngine_Freetype::CL_FontEngine_Freetype(CL_IODevice &io_dev, float height, float average_width) : face(0)
+CL_FontEngine_Freetype::CL_FontEngine_Freetype(CL_IODevice &io_dev, float height, float average_width) : face(0), char_width(0), char_height(0), current_batch(0)
 {
 	if (average_width<0.0)
 	{
@@ -108,12 +110,17 @@ CL_FontEngine_Freetype::CL_FontEngine_Freetype(CL_IODevice &io_dev, float height
 	else
 		height = -height;
 
+	char_width = (int)(average_width*64.0f);
+	char_height = (int)(height*64.0f);
+
 	// if the device is 72 DPI then 1 point becomes 1 pixel
-	FT_Set_Char_Size( face, (int)(average_width*64.0f), (int)(height*64.0f), 72, 72 );
+	FT_Set_Char_Size( face, char_width, char_height, 72, 72 );
 }
 
 CL_FontEngine_Freetype::~CL_FontEngine_Freetype()
 {
+	stop_workers();
+
 	if (face)
 	{
 		FT_Done_Face(face);
@@ -215,6 +222,11 @@ CL_Size CL_FontEngine_Freetype::get_size(const CL_StringRef &text, int pos)
 // CL_FontEngine_Freetype Operations:
 
 CL_GlyphOutline *CL_FontEngine_Freetype::load_glyph_outline(int c)
+{
+	return load_glyph_outline(face, c);
+}
+
+CL_GlyphOutline *CL_FontEngine_Freetype::load_glyph_outline(FT_Face face, int c)
 {
 	FT_UInt glyph_index;
 
@@ -295,6 +307,162 @@ CL_GlyphOutline *CL_FontEngine_Freetype::load_glyph_outline(int c)
 }
 
 CL_FontPixelBuffer CL_FontEngine_Freetype::get_font_glyph_standard(int glyph, bool anti_alias)
+{
+	return render_glyph_standard(face, glyph, anti_alias);
+}
+
+CL_FontPixelBuffer CL_FontEngine_Freetype::get_font_glyph_subpixel(int glyph)
+{
+	return render_glyph_subpixel(face, glyph);
+}
+
+std::vector<CL_FontPixelBuffer> CL_FontEngine_Freetype::get_font_glyphs_standard(const std::vector<unsigned int> &glyphs, bool anti_alias)
+{
+	return get_font_glyphs(glyphs, anti_alias, false, false);
+}
+
+std::vector<CL_FontPixelBuffer> CL_FontEngine_Freetype::get_font_glyphs_subpixel(const std::vector<unsigned int> &glyphs)
+{
+	return get_font_glyphs(glyphs, true, true, false);
+}
+
+std::vector<CL_FontPixelBuffer> CL_FontEngine_Freetype::get_font_glyphs_distance_field(const std::vector<unsigned int> &glyphs)
+{
+	return get_font_glyphs(glyphs, true, false, true);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_FontEngine_Freetype Implementation:
+
+std::vector<CL_FontPixelBuffer> CL_FontEngine_Freetype::get_font_glyphs(const std::vector<unsigned int> &glyphs, bool anti_alias, bool subpixel, bool distance_field)
+{
+	CL_FontEngine_Freetype_Batch batch(glyphs, anti_alias, subpixel, distance_field);
+
+	// The calling thread renders with the primary face, so one less worker is needed
+	int num_workers = cl_min(CL_System::get_num_cores(), (int) glyphs.size() / min_glyphs_per_worker) - 1;
+	if (num_workers > 0)
+	{
+		start_workers(num_workers);
+
+		current_batch = &batch;
+		for (int i = 0; i < num_workers; i++)
+			workers[i]->event_start.set();
+
+		process_batch(face, &batch);
+
+		for (int i = 0; i < num_workers; i++)
+		{
+			workers[i]->event_done.wait();
+			workers[i]->event_done.reset();
+		}
+		current_batch = 0;
+	}
+	else
+	{
+		process_batch(face, &batch);
+	}
+
+	if (batch.failed)
+		throw CL_Exception(batch.error_message);
+
+	return batch.font_buffers;
+}
+
+void CL_FontEngine_Freetype::start_workers(int num_workers)
+{
+	while ((int) workers.size() < num_workers)
+	{
+		CL_SharedPtr<CL_FontEngine_Freetype_Worker> worker(new CL_FontEngine_Freetype_Worker);
+
+		FT_Error error = FT_Init_FreeType(&worker->library);
+		if (error)
+			throw CL_Exception("Freetype error: Initializing FreeType library for worker thread failed.");
+		FT_Library_SetLcdFilter(worker->library, FT_LCD_FILTER_DEFAULT);
+
+		// All faces share the font data in data_buffer, which FreeType only reads from
+		error = FT_New_Memory_Face(worker->library, (FT_Byte*)data_buffer.get_data(), data_buffer.get_size(), 0, &worker->face);
+		if (error)
+		{
+			FT_Done_FreeType(worker->library);
+			throw CL_Exception("Freetype error: Font could not be opened for worker thread.");
+		}
+
+		FT_Set_Char_Size(worker->face, char_width, char_height, 72, 72);
+
+		workers.push_back(worker);
+		worker->thread.start(this, &CL_FontEngine_Freetype::worker_main, worker.get());
+	}
+}
+
+void CL_FontEngine_Freetype::stop_workers()
+{
+	stop_workers_event.set();
+	for (std::vector< CL_SharedPtr<CL_FontEngine_Freetype_Worker> >::size_type i = 0; i < workers.size(); i++)
+	{
+		workers[i]->thread.join();
+		FT_Done_Face(workers[i]->face);
+		FT_Done_FreeType(workers[i]->library);
+	}
+	workers.clear();
+	stop_workers_event.reset();
+}
+
+void CL_FontEngine_Freetype::worker_main(CL_FontEngine_Freetype_Worker *worker)
+{
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(worker->event_start, stop_workers_event);
+		if (wakeup_reason != 0)
+			break;
+		worker->event_start.reset();
+
+		process_batch(worker->face, current_batch);
+
+		worker->event_done.set();
+	}
+}
+
+void CL_FontEngine_Freetype::process_batch(FT_Face worker_face, CL_FontEngine_Freetype_Batch *batch)
+{
+	// Any exception is passed on to get_font_glyphs(), which throws it on the calling thread
+	CL_String error_message;
+	try
+	{
+		int num_glyphs = batch->glyphs.size();
+		while (true)
+		{
+			int index = batch->next_glyph.increment() - 1;
+			if (index >= num_glyphs)
+				break;
+
+			if (batch->distance_field)
+				batch->font_buffers[index] = render_glyph_distance_field(worker_face, batch->glyphs[index]);
+			else if (batch->subpixel)
+				batch->font_buffers[index] = render_glyph_subpixel(worker_face, batch->glyphs[index]);
+			else
+				batch->font_buffers[index] = render_glyph_standard(worker_face, batch->glyphs[index], batch->anti_alias);
+		}
+		return;
+	}
+	catch (const CL_Exception &e)
+	{
+		error_message = e.message;
+	}
+	catch (const std::exception &e)
+	{
+		error_message = e.what();
+	}
+	catch (...)
+	{
+		error_message = "Freetype error: Unknown exception while rasterizing glyphs";
+	}
+
+	CL_MutexSection mutex_lock(&batch->mutex);
+	batch->failed = true;
+	batch->error_message = error_message;
+}
+
+CL_FontPixelBuffer CL_FontEngine_Freetype::render_glyph_standard(FT_Face face, int glyph, bool anti_alias)
 {
 	CL_FontPixelBuffer font_buffer;
 	FT_GlyphSlot slot = face->glyph;
@@ -402,7 +570,7 @@ CL_FontPixelBuffer CL_FontEngine_Freetype::get_font_glyph_standard(int glyph, bo
 	return font_buffer;
 }
 
-CL_FontPixelBuffer CL_FontEngine_Freetype::get_font_glyph_subpixel(int glyph)
+CL_FontPixelBuffer CL_FontEngine_Freetype::render_glyph_subpixel(FT_Face face, int glyph)
 {
 	CL_FontPixelBuffer font_buffer;
 	FT_GlyphSlot slot = face->glyph;
@@ -463,8 +631,145 @@ CL_FontPixelBuffer CL_FontEngine_Freetype::get_font_glyph_subpixel(int glyph)
 	return font_buffer;
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// CL_FontEngine_Freetype Implementation:
+CL_FontPixelBuffer CL_FontEngine_Freetype::get_font_glyph_distance_field(int glyph)
+{
+	return render_glyph_distance_field(face, glyph);
+}
+
+CL_FontPixelBuffer CL_FontEngine_Freetype::render_glyph_distance_field(FT_Face face, int glyph)
+{
+	CL_FontPixelBuffer font_buffer;
+
+	CL_GlyphOutline *outline = 0;
+	try
+	{
+		outline = load_glyph_outline(face, glyph);
+	}
+	catch (const CL_Exception &)
+	{
+		return font_buffer;
+	}
+
+	// load_glyph_outline() leaves the glyph in the glyph slot
+	FT_GlyphSlot slot = face->glyph;
+	font_buffer.glyph = glyph;
+	font_buffer.increment.x = (slot->advance.x+32) >> 6;
+	font_buffer.increment.y = (slot->advance.y+32) >> 6;
+
+	// Flip the outline to screen coordinates, which has y pointing down
+	std::vector<std::vector<CL_Pointf> > contours;
+	CL_Rectf bounds;
+	bool first_point = true;
+	const std::vector<CL_GlyphContour*> &glyph_contours = outline->get_contours();
+	for (std::vector<CL_GlyphContour*>::size_type i = 0; i < glyph_contours.size(); i++)
+	{
+		const std::vector<CL_Pointf> &points = glyph_contours[i]->get_contour_points();
+		if (points.size() < 2)
+			continue;
+
+		contours.push_back(std::vector<CL_Pointf>());
+		std::vector<CL_Pointf> &contour = contours.back();
+		contour.reserve(points.size());
+		for (std::vector<CL_Pointf>::size_type j = 0; j < points.size(); j++)
+		{
+			CL_Pointf point(points[j].x, -points[j].y);
+			contour.push_back(point);
+			if (first_point)
+			{
+				bounds = CL_Rectf(point.x, point.y, point.x, point.y);
+				first_point = false;
+			}
+			else
+			{
+				bounds.left = cl_min(bounds.left, point.x);
+				bounds.top = cl_min(bounds.top, point.y);
+				bounds.right = cl_max(bounds.right, point.x);
+				bounds.bottom = cl_max(bounds.bottom, point.y);
+			}
+		}
+	}
+	delete outline;
+
+	if (contours.empty())
+		return font_buffer;
+
+	int left = (int)floor(bounds.left) - distance_field_spread;
+	int top = (int)floor(bounds.top) - distance_field_spread;
+	int right = (int)ceil(bounds.right) + distance_field_spread;
+	int bottom = (int)ceil(bounds.bottom) + distance_field_spread;
+
+	font_buffer.offset.x = left;
+	font_buffer.offset.y = top;
+
+	CL_PixelBuffer pixelbuffer(right - left, bottom - top, cl_rgba8);
+	font_buffer.buffer = pixelbuffer;
+	font_buffer.buffer_rect = pixelbuffer.get_size();
+	font_buffer.empty_buffer = false;
+
+	unsigned char *pixel_data = (unsigned char *) font_buffer.buffer.get_data();
+	int dest_pitch = font_buffer.buffer.get_pitch();
+	for (int y = top; y < bottom; y++)
+	{
+		unsigned char *dest_data = pixel_data;
+		for (int x = left; x < right; x++)
+		{
+			float distance = get_signed_distance(contours, CL_Pointf(x + 0.5f, y + 0.5f));
+			float value = 0.5f + distance / (2.0f * distance_field_spread);
+			value = cl_clamp(value, 0.0f, 1.0f);
+
+			*(dest_data++) = (unsigned char)(value * 255.0f + 0.5f);
+			*(dest_data++) = 255;
+			*(dest_data++) = 255;
+			*(dest_data++) = 255;
+		}
+		pixel_data += dest_pitch;
+	}
+
+	return font_buffer;
+}
+
+float CL_FontEngine_Freetype::get_signed_distance(const std::vector<std::vector<CL_Pointf> > &contours, const CL_Pointf &point)
+{
+	float min_distance_squared = 1e30f;
+	int winding = 0;
+
+	for (std::vector<std::vector<CL_Pointf> >::size_type i = 0; i < contours.size(); i++)
+	{
+		const std::vector<CL_Pointf> &contour = contours[i];
+		std::vector<CL_Pointf>::size_type num_points = contour.size();
+		for (std::vector<CL_Pointf>::size_type j = 0; j < num_points; j++)
+		{
+			const CL_Pointf &p0 = contour[j];
+			const CL_Pointf &p1 = contour[j + 1 < num_points ? j + 1 : 0];
+
+			// Distance to the line segment
+			float dx = p1.x - p0.x;
+			float dy = p1.y - p0.y;
+			float length_squared = dx * dx + dy * dy;
+			float t = 0.0f;
+			if (length_squared > 0.0f)
+				t = cl_clamp(((point.x - p0.x) * dx + (point.y - p0.y) * dy) / length_squared, 0.0f, 1.0f);
+			float ex = p0.x + dx * t - point.x;
+			float ey = p0.y + dy * t - point.y;
+			min_distance_squared = cl_min(min_distance_squared, ex * ex + ey * ey);
+
+			// Non-zero winding rule for the inside test
+			if (p0.y <= point.y)
+			{
+				if (p1.y > point.y && dx * (point.y - p0.y) - (point.x - p0.x) * dy > 0.0f)
+					winding++;
+			}
+			else
+			{
+				if (p1.y <= point.y && dx * (point.y - p0.y) - (point.x - p0.x) * dy < 0.0f)
+					winding--;
+			}
+		}
+	}
+
+	float distance = sqrt(min_distance_squared);
+	return winding != 0 ? distance : -distance;
+}
 
 CL_Pointf CL_FontEngine_Freetype::FT_Vector_to_CL_Pointf(const FT_Vector &vec)
 {
@@ -34,6 +34,11 @@
 #include "API/Display/Font/font.h"
 #include "API/Display/Font/font_description.h"
 #include "API/Core/System/databuffer.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/sharedptr.h"
 
 extern "C"
 {
@@ -45,6 +50,37 @@ extern "C"
 
 class CL_GlyphOutline;
 
+struct CL_FontEngine_Freetype_Batch
+{
+	CL_FontEngine_Freetype_Batch(const std::vector<unsigned int> &glyphs, bool anti_alias, bool subpixel, bool distance_field)
+	: glyphs(glyphs), font_buffers(glyphs.size()), anti_alias(anti_alias), subpixel(subpixel), distance_field(distance_field), failed(false) { }
+
+	const std::vector<unsigned int> &glyphs;
+	std::vector<CL_FontPixelBuffer> font_buffers;
+	bool anti_alias;
+	bool subpixel;
+	bool distance_field;
+
+	/// \brief Index of the next glyph to be claimed by a worker
+	CL_InterlockedVariable next_glyph;
+
+	CL_Mutex mutex;
+	bool failed;
+	CL_String error_message;
+};
+
+/// \brief Persistent worker thread rasterizing glyphs with its own FreeType library and face.
+struct CL_FontEngine_Freetype_Worker
+{
+	CL_FontEngine_Freetype_Worker() : library(0), face(0) { }
+
+	CL_Thread thread;
+	CL_Event event_start;
+	CL_Event event_done;
+	FT_Library library;
+	FT_Face face;
+};
+
 struct CL_TagStruct
 {
 	FT_Tag previous;
@@ -88,6 +124,36 @@ public:
 	/// \param glyph The glyph
 	CL_FontPixelBuffer get_font_glyph_subpixel(int glyph);
 
+	/// \brief Constructs pixel buffers for a list of glyphs, rasterizing them in parallel.
+	///
+	/// Each worker thread renders with its own FT_Face, so the results are identical
+	/// to calling get_font_glyph_standard() for every glyph.
+	///
+	/// \param glyphs The glyphs
+	/// \param anti_alias If anti_aliasing should be used
+	std::vector<CL_FontPixelBuffer> get_font_glyphs_standard(const std::vector<unsigned int> &glyphs, bool anti_alias);
+
+	/// \brief Constructs pixel buffers using subpixel rendering for a list of glyphs, rasterizing them in parallel.
+	///
+	/// \param glyphs The glyphs
+	std::vector<CL_FontPixelBuffer> get_font_glyphs_subpixel(const std::vector<unsigned int> &glyphs);
+
+	/// \brief Constructs a signed distance field pixel buffer from the outline of a Freetype glyph.
+	///
+	/// The distance is stored in the alpha channel. 0.5 is the glyph edge, and 0 and 1 are
+	/// distance_field_spread pixels outside and inside the edge.
+	///
+	/// \param glyph The glyph
+	CL_FontPixelBuffer get_font_glyph_distance_field(int glyph);
+
+	/// \brief Constructs signed distance field pixel buffers for a list of glyphs, rasterizing them in parallel.
+	///
+	/// \param glyphs The glyphs
+	std::vector<CL_FontPixelBuffer> get_font_glyphs_distance_field(const std::vector<unsigned int> &glyphs);
+
+	/// \brief Distance in pixels covered by the distance field on each side of the glyph edge
+	static const int distance_field_spread = 6;
+
 /// \}
 /// \name Operations
 /// \{
@@ -105,8 +171,34 @@ private:
 	int get_index_of_prev_contour_point(int cont, int index, FT_Outline *outline);
 	CL_Pointf FT_Vector_to_CL_Pointf(const FT_Vector &);
 
+	std::vector<CL_FontPixelBuffer> get_font_glyphs(const std::vector<unsigned int> &glyphs, bool anti_alias, bool subpixel, bool distance_field);
+	void start_workers(int num_workers);
+	void stop_workers();
+	void worker_main(CL_FontEngine_Freetype_Worker *worker);
+	void process_batch(FT_Face worker_face, CL_FontEngine_Freetype_Batch *batch);
+
+	static CL_FontPixelBuffer render_glyph_standard(FT_Face face, int glyph, bool anti_alias);
+	static CL_FontPixelBuffer render_glyph_subpixel(FT_Face face, int glyph);
+	CL_FontPixelBuffer render_glyph_distance_field(FT_Face face, int glyph);
+	CL_GlyphOutline *load_glyph_outline(FT_Face face, int glyph);
+	static float get_signed_distance(const std::vector<std::vector<CL_Pointf> > &contours, const CL_Pointf &point);
+
 	FT_Face face;
 
+	// Character size in 26.6 fixed point, as passed to FT_Set_Char_Size
+	FT_F26Dot6 char_width;
+	FT_F26Dot6 char_height;
+
+	// Each worker face has its own library, as a FT_Library may only be used by one thread at a time
+	std::vector< CL_SharedPtr<CL_FontEngine_Freetype_Worker> > workers;
+	CL_Event stop_workers_event;
+
+	/// \brief Batch being rasterized by the workers, set while they are running
+	CL_FontEngine_Freetype_Batch *current_batch;
+
+	/// \brief Minimum number of glyphs given to each worker thread
+	static const int min_glyphs_per_worker = 8;
+
 	std::vector<CL_TaggedPoint> get_contour_points(int cont, FT_Outline *outline);
 
 	CL_DataBuffer data_buffer;
@@ -121,6 +121,11 @@ bool CL_FontDescription::get_subpixel() const
 	return impl->subpixel;
 }
 
+bool CL_FontDescription::get_distance_field() const
+{
+	return impl->distance_field;
+}
+
 CL_FontDescription::Charset CL_FontDescription::get_charset() const
 {
 	return impl->charset;
@@ -132,6 +137,7 @@ bool CL_FontDescription::operator==(const CL_FontDescription &other) const
 	return impl->typeface_name == other.impl->typeface_name && 
 			impl->anti_alias == other.impl->anti_alias && 
 			impl->subpixel == other.impl->subpixel && 
+			impl->distance_field == other.impl->distance_field && 
 			impl->height == other.impl->height && 
 			impl->average_width == other.impl->average_width && 
 			impl->escapement == other.impl->escapement && 
@@ -169,6 +175,7 @@ void CL_FontDescription::clone(const CL_FontDescription &copy)
 		impl->fixed_pitch = copy.impl->fixed_pitch;
 		impl->anti_alias = copy.impl->anti_alias;
 		impl->subpixel = copy.impl->subpixel;
+		impl->distance_field = copy.impl->distance_field;
 		impl->charset = copy.impl->charset;
 	}
 }
@@ -233,6 +240,11 @@ void CL_FontDescription::set_subpixel(bool setting)
 	impl->subpixel = setting;
 }
 
+void CL_FontDescription::set_distance_field(bool setting)
+{
+	impl->distance_field = setting;
+}
+
 void CL_FontDescription::set_charset(Charset new_charset)
 {
 	impl->charset = new_charset;
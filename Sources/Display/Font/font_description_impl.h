@@ -48,6 +48,7 @@ public:
 		fixed_pitch = false;
 		anti_alias = true;
 		subpixel = true;
+		distance_field = false;
 		charset = CL_FontDescription::charset_default;
 	}
 
@@ -71,6 +72,7 @@ public:
 	bool fixed_pitch;
 	bool anti_alias;
 	bool subpixel;
+	bool distance_field;
 	CL_FontDescription::Charset charset;
 
 /// \}
@@ -37,11 +37,35 @@
 #include "API/Core/Text/string_format.h"
 #include "API/Display/2D/color.h"
 #include "API/Core/XML/dom_element.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/weakptr.h"
+#include "API/Core/IOData/iodevice_memory.h"
+#include "API/Core/Math/hash_functions.h"
+#include "API/Display/Render/graphic_context.h"
+#include <map>
+
+// Distance field glyph caches currently in use, by font file contents and reference size
+static CL_Mutex cl_distance_field_mutex;
+static std::map<CL_String, CL_WeakPtr<CL_FontProvider_Freetype_DistanceField> > cl_distance_field_fonts;
+
+CL_FontProvider_Freetype_DistanceField::~CL_FontProvider_Freetype_DistanceField()
+{
+	delete font_engine;
+}
+
+CL_GlyphCache &CL_FontProvider_Freetype_DistanceField::get_glyph_cache(CL_GraphicContext &gc)
+{
+	if (gc_provider == 0)
+		gc_provider = gc.get_provider();
+	else if (gc_provider != gc.get_provider())
+		throw CL_Exception("Distance field fonts of a typeface can only be used with one graphic context");
+	return glyph_cache;
+}
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_FontProvider_Freetype Construction:
 
-CL_FontProvider_Freetype::CL_FontProvider_Freetype() : glyph_cache(), font_engine(0)
+CL_FontProvider_Freetype::CL_FontProvider_Freetype() : glyph_cache(), font_engine(0), distance_field_scale(1.0f)
 {
 }
 
@@ -60,6 +84,8 @@ CL_FontMetrics CL_FontProvider_Freetype::get_font_metrics()
 
 CL_Font_TextureGlyph *CL_FontProvider_Freetype::get_glyph(CL_GraphicContext &gc, unsigned int glyph)
 {
+	if (distance_field)
+		return distance_field->get_glyph_cache(gc).get_glyph(distance_field->font_engine, gc, glyph);
 	return glyph_cache.get_glyph(font_engine, gc, glyph);
 }
 
@@ -68,11 +94,16 @@ CL_Font_TextureGlyph *CL_FontProvider_Freetype::get_glyph(CL_GraphicContext &gc,
 
 void CL_FontProvider_Freetype::draw_text(CL_GraphicContext &gc, float xpos, float ypos, const CL_StringRef &text, const CL_Colorf &color)
 {
-	glyph_cache.draw_text(font_engine, gc, xpos, ypos, text, color);
+	if (distance_field)
+		distance_field->get_glyph_cache(gc).draw_text(distance_field->font_engine, gc, xpos, ypos, text, color, distance_field_scale);
+	else
+		glyph_cache.draw_text(font_engine, gc, xpos, ypos, text, color);
 }
 
 CL_Size CL_FontProvider_Freetype::get_text_size(CL_GraphicContext &gc, const CL_StringRef &text)
 {
+	if (distance_field)
+		return distance_field->get_glyph_cache(gc).get_text_size(distance_field->font_engine, gc, text, distance_field_scale);
 	return glyph_cache.get_text_size(font_engine, gc, text);
 }
 
@@ -83,11 +114,17 @@ void CL_FontProvider_Freetype::set_font_metrics(const CL_FontMetrics &metrics)
 
 void CL_FontProvider_Freetype::set_texture_group(CL_TextureGroup &new_texture_group)
 {
-	glyph_cache.set_texture_group(new_texture_group);
+	// Distance field fonts share their glyph cache with all sizes of the typeface
+	if (distance_field)
+		distance_field->glyph_cache.set_texture_group(new_texture_group);
+	else
+		glyph_cache.set_texture_group(new_texture_group);
 }
 
 int CL_FontProvider_Freetype::get_character_index(CL_GraphicContext &gc, const CL_String &text, const CL_Point &point)
 {
+	if (distance_field)
+		return distance_field->get_glyph_cache(gc).get_character_index(distance_field->font_engine, gc, text, point, distance_field_scale);
 	return glyph_cache.get_character_index(font_engine, gc, text, point);
 }
 
@@ -103,6 +140,12 @@ void CL_FontProvider_Freetype::free_font()
 		delete(font_engine);
 		font_engine = NULL;
 	}
+	if (distance_field)
+	{
+		distance_field.reset();
+		prune_distance_field_fonts();
+	}
+	distance_field_scale = 1.0f;
 }
 
 void CL_FontProvider_Freetype::load_font(const CL_FontDescription &desc)
@@ -151,6 +194,9 @@ void CL_FontProvider_Freetype::load_font(const CL_StringRef &resource_id, CL_Res
 	if (freetype_element.has_attribute("subpixel"))
 		desc.set_subpixel(freetype_element.get_attribute_bool("subpixel", true));
 
+	if (freetype_element.has_attribute("distance_field"))
+		desc.set_distance_field(freetype_element.get_attribute_bool("distance_field", false));
+
 	load_font(desc, resources->get_directory(resource));
 }
 
@@ -158,6 +204,12 @@ void CL_FontProvider_Freetype::load_font(const CL_FontDescription &desc, CL_IODe
 {
 	free_font();
 
+	if (desc.get_distance_field())
+	{
+		load_distance_field_font(desc, io_dev);
+		return;
+	}
+
 	if (desc.get_subpixel())
 	{
 		glyph_cache.enable_subpixel = true;
@@ -177,3 +229,70 @@ void CL_FontProvider_Freetype::load_font(const CL_FontDescription &desc, CL_IODe
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_FontProvider_Freetype Implementation:
+
+void CL_FontProvider_Freetype::load_distance_field_font(const CL_FontDescription &desc, CL_IODevice &io_dev)
+{
+	float height = desc.get_height();
+	if (height == 0.0f)
+		throw CL_Exception("Distance field fonts require a height");
+
+	// All sizes of a typeface share one set of glyphs rasterized at the reference height.
+	// The reference height keeps the sign of the requested height, so both select the same kind of size.
+	distance_field_scale = fabs(height) / distance_field_reference_height;
+	float reference_height = height < 0.0f ? -distance_field_reference_height : distance_field_reference_height;
+	float reference_average_width = desc.get_average_width() / distance_field_scale;
+
+	// Key on the font data rather than the typeface name, as different files may share a name
+	CL_DataBuffer font_data(io_dev.get_size());
+	io_dev.read(font_data.get_data(), font_data.get_size());
+	CL_String key = cl_format("%1|%2|%3|%4", CL_HashFunctions::sha1(font_data), font_data.get_size(), reference_height, reference_average_width);
+
+	CL_MutexSection mutex_lock(&cl_distance_field_mutex);
+	distance_field = cl_distance_field_fonts[key].lock();
+	if (!distance_field)
+	{
+		CL_IODevice_Memory font_file(font_data);
+		CL_FontEngine_Freetype *reference_engine = new CL_FontEngine_Freetype(font_file, reference_height, reference_average_width);
+		distance_field = CL_SharedPtr<CL_FontProvider_Freetype_DistanceField>(new CL_FontProvider_Freetype_DistanceField(reference_engine));
+		distance_field->glyph_cache.enable_distance_field = true;
+		distance_field->glyph_cache.enable_subpixel = false;
+		distance_field->glyph_cache.anti_alias = true;
+		distance_field->glyph_cache.font_metrics = reference_engine->get_metrics();
+		cl_distance_field_fonts[key] = distance_field;
+	}
+
+	glyph_cache.font_metrics = scale_font_metrics(distance_field->glyph_cache.font_metrics, distance_field_scale);
+}
+
+void CL_FontProvider_Freetype::prune_distance_field_fonts()
+{
+	CL_MutexSection mutex_lock(&cl_distance_field_mutex);
+	std::map<CL_String, CL_WeakPtr<CL_FontProvider_Freetype_DistanceField> >::iterator it = cl_distance_field_fonts.begin();
+	while (it != cl_distance_field_fonts.end())
+	{
+		if (it->second.expired())
+			cl_distance_field_fonts.erase(it++);
+		else
+			++it;
+	}
+}
+
+CL_FontMetrics CL_FontProvider_Freetype::scale_font_metrics(const CL_FontMetrics &metrics, float scale)
+{
+	return CL_FontMetrics(
+		metrics.get_height() * scale,
+		metrics.get_ascent() * scale,
+		metrics.get_descent() * scale,
+		metrics.get_internal_leading() * scale,
+		metrics.get_external_leading() * scale,
+		metrics.get_average_character_width() * scale,
+		metrics.get_max_character_width() * scale,
+		metrics.get_weight(),
+		metrics.get_overhang() * scale,
+		metrics.get_digitized_aspect_x(),
+		metrics.get_digitized_aspect_y(),
+		metrics.is_italic(),
+		metrics.is_underlined(),
+		metrics.is_struck_out(),
+		metrics.is_fixed_pitch());
+}
@@ -30,12 +30,30 @@
 
 #include "API/Display/TargetProviders/font_provider.h"
 #include "API/Display/2D/texture_group.h"
+#include "API/Core/System/sharedptr.h"
 #include "glyph_cache.h"
 
 class CL_Colorf;
 
 class CL_FontEngine_Freetype;
 
+/// \brief Distance field glyphs of a typeface, shared by all font sizes using it
+class CL_FontProvider_Freetype_DistanceField
+{
+public:
+	CL_FontProvider_Freetype_DistanceField(CL_FontEngine_Freetype *font_engine) : font_engine(font_engine), gc_provider(0) { }
+	~CL_FontProvider_Freetype_DistanceField();
+
+	/// \brief Returns the glyph cache, throwing if its textures belong to another graphic context
+	CL_GlyphCache &get_glyph_cache(CL_GraphicContext &gc);
+
+	CL_FontEngine_Freetype *font_engine;
+	CL_GlyphCache glyph_cache;
+
+	/// \brief Graphic context the glyph textures were created for, or 0 if not used yet
+	CL_GraphicContextProvider *gc_provider;
+};
+
 class CL_FontProvider_Freetype : public CL_FontProvider
 {
 /// \name Construction
@@ -84,9 +102,20 @@ public:
 /// \{
 private:
 	void free_font();
+	void load_distance_field_font(const CL_FontDescription &desc, CL_IODevice &io_dev);
+	static void prune_distance_field_fonts();
+	static CL_FontMetrics scale_font_metrics(const CL_FontMetrics &metrics, float scale);
 
 	CL_FontEngine_Freetype *font_engine;
 
 	CL_GlyphCache glyph_cache;
+
+	CL_SharedPtr<CL_FontProvider_Freetype_DistanceField> distance_field;
+
+	/// \brief Font size relative to distance_field_reference_height
+	float distance_field_scale;
+
+	/// \brief Height the shared distance field glyphs are rasterized at
+	static const int distance_field_reference_height = 64;
 /// \}
 };
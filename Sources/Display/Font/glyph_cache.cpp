@@ -45,6 +45,7 @@
 #include "API/Core/Text/utf8_reader.h"
 #include "../2D/render_batch2d.h"
 #include "../Render/graphic_context_impl.h"
+#include <algorithm>
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_GlyphCache Construction:
@@ -63,6 +64,7 @@ CL_GlyphCache::CL_GlyphCache()
 
 	anti_alias = true;
 	enable_subpixel = true;
+	enable_distance_field = false;
 }
 
 CL_GlyphCache::~CL_GlyphCache()
@@ -79,7 +81,7 @@ CL_FontMetrics CL_GlyphCache::get_font_metrics()
 	return font_metrics;
 }
 
-CL_Size CL_GlyphCache::get_text_size(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_StringRef &text)
+CL_Size CL_GlyphCache::get_text_size(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_StringRef &text, float scale)
 {
 	int width = 0;
 
@@ -87,9 +89,16 @@ CL_Size CL_GlyphCache::get_text_size(CL_FontEngine *font_engine, CL_GraphicConte
 	while(!reader.is_end())
 	{
 		unsigned int glyph = reader.get_char();
+		CL_String::size_type glyph_pos = reader.get_position();
 		reader.next();
-		CL_Font_TextureGlyph *gptr = get_glyph(font_engine, gc, glyph);
-		if (gptr == NULL) continue;
+		CL_Font_TextureGlyph *gptr = find_glyph(glyph);
+		if (gptr == NULL)
+		{
+			if (is_failed_glyph(glyph)) continue;
+			insert_glyphs(font_engine, gc, text.substr(glyph_pos));
+			gptr = find_glyph(glyph);
+			if (gptr == NULL) continue;
+		}
 		width += gptr->increment.x;
 	}
 	int height;
@@ -102,37 +111,35 @@ CL_Size CL_GlyphCache::get_text_size(CL_FontEngine *font_engine, CL_GraphicConte
 		height = font_metrics.get_ascent() + font_metrics.get_descent();
 	}
 
+	if (scale != 1.0f)
+		return CL_Size((int)(width * scale + 0.5f), (int)(height * scale + 0.5f));
 	return (CL_Size(width, height));
 }
 
 CL_Font_TextureGlyph *CL_GlyphCache::get_glyph(CL_FontEngine *font_engine, CL_GraphicContext &gc, unsigned int glyph)
 {
-	std::vector< CL_Font_TextureGlyph * >::size_type size = glyph_list.size();
-	for (int cnt=0; cnt<size; cnt++)
-	{
-		if (glyph_list[cnt]->glyph == glyph)
-			return &(*glyph_list[cnt]);
-	}
+	CL_Font_TextureGlyph *gptr = find_glyph(glyph);
+	if (gptr)
+		return gptr;
+
+	if (is_failed_glyph(glyph))
+		return NULL;
 
 	// If glyph does not exist, create one automatically
 
 	insert_glyph(font_engine, gc, glyph);
 
 	// Search for the glyph again
-	size = glyph_list.size();
-	for (int cnt=0; cnt<size; cnt++)
-	{
-		if (glyph_list[cnt]->glyph == glyph)
-			return &(*glyph_list[cnt]);
-	}
-
-	return NULL;
+	gptr = find_glyph(glyph);
+	if (gptr == NULL)
+		failed_glyphs.push_back(glyph);
+	return gptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_GlyphCache Operations:
 
-int CL_GlyphCache::get_character_index(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_String &text, const CL_Point &point)
+int CL_GlyphCache::get_character_index(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_String &text, const CL_Point &point, float scale)
 {
 	int dest_x = 0;
 	int dest_y = 0;
@@ -140,9 +147,9 @@ int CL_GlyphCache::get_character_index(CL_FontEngine *font_engine, CL_GraphicCon
 	int character_counter = 0;
 
 	CL_FontMetrics fm = get_font_metrics();
-	int font_height = fm.get_height();
-	int font_ascent = fm.get_ascent();
-	int font_external_leading = fm.get_external_leading();
+	int font_height = (int)(fm.get_height() * scale + 0.5f);
+	int font_ascent = (int)(fm.get_ascent() * scale + 0.5f);
+	int font_external_leading = (int)(fm.get_external_leading() * scale + 0.5f);
 
 	std::vector<CL_String> lines = CL_StringHelp::split_text(text, "\n", false);
 	for (std::vector<CL_String>::size_type i=0; i<lines.size(); i++)
@@ -165,14 +172,18 @@ int CL_GlyphCache::get_character_index(CL_FontEngine *font_engine, CL_GraphicCon
 			CL_Font_TextureGlyph *gptr = get_glyph(font_engine, gc, glyph);
 			if (gptr == NULL) continue;
 
-			CL_Rect position(xpos, ypos - font_ascent, CL_Size(gptr->increment.x, gptr->increment.y + font_height + font_external_leading));
+			CL_Point increment(gptr->increment);
+			if (scale != 1.0f)
+				increment = CL_Point((int)(increment.x * scale + 0.5f), (int)(increment.y * scale + 0.5f));
+
+			CL_Rect position(xpos, ypos - font_ascent, CL_Size(increment.x, increment.y + font_height + font_external_leading));
 			if (position.contains(point))
 			{
 				return glyph_pos + character_counter;
 			}
 		
-			xpos += gptr->increment.x;
-			ypos += gptr->increment.y;
+			xpos += increment.x;
+			ypos += increment.y;
 		}
 
 		dest_y += font_height + font_external_leading;
@@ -221,6 +232,145 @@ void CL_GlyphCache::insert_glyph(CL_FontEngine *font_engine, CL_GraphicContext &
 	}
 }
 
+void CL_GlyphCache::insert_glyphs(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_StringRef &text)
+{
+	std::vector<unsigned int> missing_glyphs;
+
+	CL_UTF8_Reader reader(text);
+	while(!reader.is_end())
+	{
+		unsigned int glyph = reader.get_char();
+		reader.next();
+
+		if (find_glyph(glyph) || is_failed_glyph(glyph))
+			continue;
+		if (std::find(missing_glyphs.begin(), missing_glyphs.end(), glyph) != missing_glyphs.end())
+			continue;
+		missing_glyphs.push_back(glyph);
+	}
+
+	// A single glyph is not worth the batch overhead
+	if (missing_glyphs.size() < 2)
+	{
+		if (!missing_glyphs.empty())
+			get_glyph(font_engine, gc, missing_glyphs[0]);
+		return;
+	}
+
+	std::vector<CL_FontPixelBuffer> font_buffers;
+	if (enable_distance_field)
+		font_buffers = font_engine->get_font_glyphs_distance_field(missing_glyphs);
+	else if (enable_subpixel)
+		font_buffers = font_engine->get_font_glyphs_subpixel(missing_glyphs);
+	else
+		font_buffers = font_engine->get_font_glyphs_standard(missing_glyphs, anti_alias);
+
+	insert_glyphs(gc, font_buffers);
+
+	// Remember the glyphs that could not be loaded, so the text is not batched again for them
+	for (std::vector<unsigned int>::size_type i = 0; i < missing_glyphs.size(); i++)
+	{
+		if (!find_glyph(missing_glyphs[i]))
+			failed_glyphs.push_back(missing_glyphs[i]);
+	}
+}
+
+void CL_GlyphCache::insert_glyphs(CL_GraphicContext &gc, std::vector<CL_FontPixelBuffer> &font_buffers)
+{
+	CL_Size texture_size = texture_group.get_texture_sizes();
+
+	// Sort the glyphs needing texture space tallest first, so the rows waste little space
+	std::vector<CL_PixelBuffer> buffers(font_buffers.size());
+	std::vector< std::pair<int, int> > sorted_glyphs;
+	for (std::vector<CL_FontPixelBuffer>::size_type i = 0; i < font_buffers.size(); i++)
+	{
+		CL_FontPixelBuffer &pb = font_buffers[i];
+		if (pb.glyph == 0 || find_glyph(pb.glyph))	// Ignore invalid and duplicated glyphs
+			continue;
+
+		if (!pb.empty_buffer)
+		{
+			buffers[i] = CL_PixelBufferHelp::add_border(pb.buffer, glyph_border_size, pb.buffer_rect);
+			if (buffers[i].get_width() <= texture_size.width && buffers[i].get_height() <= texture_size.height)
+			{
+				sorted_glyphs.push_back(std::pair<int, int>(-buffers[i].get_height(), i));
+				continue;
+			}
+		}
+
+		insert_glyph(gc, pb);
+	}
+	std::sort(sorted_glyphs.begin(), sorted_glyphs.end());
+
+	// Place the glyphs in rows within blocks no larger than a texture, each block uploaded with a single set_subimage
+	std::vector<int> block_glyphs;
+	std::vector<CL_Point> block_positions;
+	int x = 0, y = 0, row_height = 0, block_width = 0;
+	for (std::vector< std::pair<int, int> >::size_type i = 0; i < sorted_glyphs.size(); i++)
+	{
+		int index = sorted_glyphs[i].second;
+		int width = buffers[index].get_width();
+		int height = buffers[index].get_height();
+
+		if (x + width > texture_size.width)
+		{
+			y += row_height;
+			x = 0;
+			row_height = 0;
+		}
+
+		if (y + height > texture_size.height)
+		{
+			upload_glyph_block(gc, font_buffers, buffers, block_glyphs, block_positions, CL_Size(block_width, y));
+			block_glyphs.clear();
+			block_positions.clear();
+			x = y = row_height = block_width = 0;
+		}
+
+		block_glyphs.push_back(index);
+		block_positions.push_back(CL_Point(x, y));
+		x += width;
+		row_height = cl_max(row_height, height);
+		block_width = cl_max(block_width, x);
+	}
+
+	if (!block_glyphs.empty())
+		upload_glyph_block(gc, font_buffers, buffers, block_glyphs, block_positions, CL_Size(block_width, y + row_height));
+}
+
+void CL_GlyphCache::upload_glyph_block(CL_GraphicContext &gc, std::vector<CL_FontPixelBuffer> &font_buffers, std::vector<CL_PixelBuffer> &buffers, const std::vector<int> &block_glyphs, const std::vector<CL_Point> &block_positions, const CL_Size &block_size)
+{
+	CL_Subtexture block = texture_group.add(gc, block_size);
+	CL_Rect block_geometry = block.get_geometry();
+
+	CL_PixelBuffer block_buffer(block_size.width, block_size.height, cl_rgba8);
+	memset(block_buffer.get_data(), 0, block_buffer.get_pitch() * block_size.height);
+
+	for (std::vector<int>::size_type i = 0; i < block_glyphs.size(); i++)
+	{
+		CL_FontPixelBuffer &pb = font_buffers[block_glyphs[i]];
+		CL_PixelBuffer &buffer_with_border = buffers[block_glyphs[i]];
+		CL_Point position = block_positions[i];
+
+		int row_size = buffer_with_border.get_width() * 4;
+		for (int row = 0; row < buffer_with_border.get_height(); row++)
+			memcpy(block_buffer.get_line_uint8(position.y + row) + position.x * 4, buffer_with_border.get_line_uint8(row), row_size);
+
+		CL_Font_TextureGlyph *font_glyph = new CL_Font_TextureGlyph();
+		glyph_list.push_back(font_glyph);
+		font_glyph->glyph = pb.glyph;
+		font_glyph->empty_buffer = false;
+		font_glyph->offset = pb.offset;
+		font_glyph->increment = pb.increment;
+
+		CL_Rect glyph_rect(block_geometry.left + position.x, block_geometry.top + position.y, buffer_with_border.get_size());
+		font_glyph->subtexture = CL_Subtexture(block.get_texture(), glyph_rect);
+		font_glyph->geometry = CL_Rect(glyph_rect.left + glyph_border_size, glyph_rect.top + glyph_border_size, pb.buffer_rect.get_size());
+	}
+
+	block.get_texture().set_subimage(block_geometry.left, block_geometry.top, block_buffer, block_buffer.get_size());
+}
+
 void CL_GlyphCache::insert_glyph(CL_GraphicContext &gc, CL_Font_System_Position &position, CL_PixelBuffer &pixel_buffer)
 {
 	unsigned int glyph = position.glyph;
@@ -259,7 +409,15 @@ void CL_GlyphCache::insert_glyph(CL_GraphicContext &gc, CL_Font_System_Position
 
 void CL_GlyphCache::insert_glyph(CL_FontEngine *font_engine, CL_GraphicContext &gc, int glyph)
 {
-	if (enable_subpixel)
+	if (enable_distance_field)
+	{
+		CL_FontPixelBuffer pb = font_engine->get_font_glyph_distance_field(glyph);
+		if (pb.glyph)	// Ignore invalid glyphs
+		{
+			insert_glyph(gc, pb);
+		}
+	}
+	else if (enable_subpixel)
 	{
 		CL_FontPixelBuffer pb = font_engine->get_font_glyph_subpixel(glyph);
 		if (pb.glyph)	// Ignore invalid glyphs
@@ -277,7 +435,7 @@ void CL_GlyphCache::insert_glyph(CL_FontEngine *font_engine, CL_GraphicContext &
 	}
 }
 
-void CL_GlyphCache::draw_text(CL_FontEngine *font_engine, CL_GraphicContext &gc, float xpos, float ypos, const CL_StringRef &text, const CL_Colorf &color) 
+void CL_GlyphCache::draw_text(CL_FontEngine *font_engine, CL_GraphicContext &gc, float xpos, float ypos, const CL_StringRef &text, const CL_Colorf &color, float scale)
 {
 	CL_String::size_type string_length = text.length();
 	if (string_length==0)
@@ -292,18 +450,31 @@ void CL_GlyphCache::draw_text(CL_FontEngine *font_engine, CL_GraphicContext &gc,
 	while(!reader.is_end())
 	{
 		unsigned int glyph = reader.get_char();
+		CL_String::size_type glyph_pos = reader.get_position();
 		reader.next();
 
-		CL_Font_TextureGlyph *gptr = get_glyph(font_engine, gc, glyph);
-		if (gptr == NULL) continue;
+		CL_Font_TextureGlyph *gptr = find_glyph(glyph);
+		if (gptr == NULL)
+		{
+			if (is_failed_glyph(glyph)) continue;
+
+			// Rasterize the missing glyphs in the rest of the text in one batch
+			insert_glyphs(font_engine, gc, text.substr(glyph_pos));
+			gptr = find_glyph(glyph);
+			if (gptr == NULL) continue;
+		}
 
 		if (!gptr->empty_buffer)
 		{
-			float xp = xpos + gptr->offset.x;
-			float yp = ypos + gptr->offset.y;
+			float xp = xpos + gptr->offset.x * scale;
+			float yp = ypos + gptr->offset.y * scale;
 
-			CL_Rectf dest_size(xp, yp, CL_Sizef(gptr->geometry.get_size()));
-			if (enable_subpixel)
+			CL_Rectf dest_size(xp, yp, CL_Sizef(gptr->geometry.get_width() * scale, gptr->geometry.get_height() * scale));
+			if (enable_distance_field)
+			{
+				batcher->draw_glyph_distance_field(gc, gptr->geometry, dest_size, color, gptr->subtexture.get_texture());
+			}
+			else if (enable_subpixel)
 			{
 				batcher->draw_glyph_subpixel(gc, gptr->geometry, dest_size, color, gptr->subtexture.get_texture());
 			}else
@@ -311,8 +482,8 @@ void CL_GlyphCache::draw_text(CL_FontEngine *font_engine, CL_GraphicContext &gc,
 				batcher->draw_image(gc, gptr->geometry, dest_size, color, gptr->subtexture.get_texture());
 			}
 		}
-		xpos += gptr->increment.x;
-		ypos += gptr->increment.y;
+		xpos += gptr->increment.x * scale;
+		ypos += gptr->increment.y * scale;
 	}
 }
 
@@ -339,3 +510,19 @@ void CL_GlyphCache::set_font_metrics(const CL_FontMetrics &metrics)
 /////////////////////////////////////////////////////////////////////////////
 // CL_GlyphCache Implementation:
 
+bool CL_GlyphCache::is_failed_glyph(unsigned int glyph) const
+{
+	return std::find(failed_glyphs.begin(), failed_glyphs.end(), glyph) != failed_glyphs.end();
+}
+
+CL_Font_TextureGlyph *CL_GlyphCache::find_glyph(unsigned int glyph)
+{
+	std::vector< CL_Font_TextureGlyph * >::size_type size = glyph_list.size();
+	for (int cnt=0; cnt<size; cnt++)
+	{
+		if (glyph_list[cnt]->glyph == glyph)
+			return glyph_list[cnt];
+	}
+	return NULL;
+}
+
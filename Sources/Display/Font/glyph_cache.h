@@ -67,23 +67,31 @@ public:
 public:
 
 	/// \brief Print text on gc.
-	void draw_text(CL_FontEngine *font_engine,CL_GraphicContext &gc, float xpos, float ypos, const CL_StringRef &text, const CL_Colorf &color);
+	///
+	/// \param scale Size of the glyphs relative to the size they were rasterized at. Only meaningful for distance field glyphs.
+	void draw_text(CL_FontEngine *font_engine,CL_GraphicContext &gc, float xpos, float ypos, const CL_StringRef &text, const CL_Colorf &color, float scale = 1.0f);
 
 	/// \brief Calculate size of text string.
-	CL_Size get_text_size(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_StringRef &text);
+	CL_Size get_text_size(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_StringRef &text, float scale = 1.0f);
 
 	/// \brief Set the font metrics for the bitmap font. This is done automatically if the font is loaded from the system font
 	void set_font_metrics(const CL_FontMetrics &metrics);
 
 	void set_texture_group(CL_TextureGroup &new_texture_group);
 
-	int get_character_index(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_String &text, const CL_Point &point);
+	int get_character_index(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_String &text, const CL_Point &point, float scale = 1.0f);
 
 	void insert_glyph(CL_GraphicContext &gc, CL_Font_System_Position &position, CL_PixelBuffer &pixel_buffer);
 	void insert_glyph(CL_FontEngine *font_engine, CL_GraphicContext &gc, int glyph);
 	void insert_glyph(CL_GraphicContext &gc, CL_FontPixelBuffer &pb);
 	void insert_glyph(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_StringRef &text);
 
+	/// \brief Rasterize all glyphs in text not yet in the cache in one batch.
+	void insert_glyphs(CL_FontEngine *font_engine, CL_GraphicContext &gc, const CL_StringRef &text);
+
+	/// \brief Insert rasterized glyphs, packing them together so each texture is updated once.
+	void insert_glyphs(CL_GraphicContext &gc, std::vector<CL_FontPixelBuffer> &font_buffers);
+
 /// \}
 /// \name Implementation
 /// \{
@@ -91,8 +99,15 @@ private:
 	/// \brief Set the font metrics from the OS font
 	void write_font_metrics(CL_GraphicContext &gc);
 
+	CL_Font_TextureGlyph *find_glyph(unsigned int glyph);
+	bool is_failed_glyph(unsigned int glyph) const;
+	void upload_glyph_block(CL_GraphicContext &gc, std::vector<CL_FontPixelBuffer> &font_buffers, std::vector<CL_PixelBuffer> &buffers, const std::vector<int> &block_glyphs, const std::vector<CL_Point> &block_positions, const CL_Size &block_size);
+
 	std::vector<CL_Font_TextureGlyph* > glyph_list;
 
+	/// \brief Glyphs the font engine could not load, so they are not requested again
+	std::vector<unsigned int> failed_glyphs;
+
 	CL_TextureGroup texture_group;
 
 	static const int glyph_border_size = 1;
@@ -104,6 +119,9 @@ public:
 	// true to enable subpixel rendering setting (implies anti_alias is true)
 	bool enable_subpixel;
 
+	// true to store the glyphs as signed distance fields (overrides enable_subpixel)
+	bool enable_distance_field;
+
 	CL_FontMetrics font_metrics;
 /// \}
 };
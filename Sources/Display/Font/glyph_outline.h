@@ -61,6 +61,8 @@ public:
 
 	CL_GlyphPrimitivesArrayOutline &get_outline();
 
+	const std::vector<CL_GlyphContour*> &get_contours() const { return contours; }
+
 	std::vector<std::vector<CL_Pointf> > joined_outlines; // for debugging triangulator hole support - don't remove!
 
 
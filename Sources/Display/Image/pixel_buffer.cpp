@@ -32,6 +32,7 @@
 #include "API/Display/Image/pixel_buffer.h"
 #include "API/Core/System/cl_platform.h"
 #include "pixel_buffer_impl.h"
+#include "pixel_converter.h"
 #include "API/Core/System/exception.h"
 #include "API/Core/IOData/virtual_file_system.h"
 #include "API/Core/IOData/virtual_directory.h"
@@ -367,23 +368,7 @@ void CL_PixelBuffer::premultiply_alpha()
 			int h = get_height();
 			cl_ubyte32 *p = (cl_ubyte32 *) get_data();
 			for (int y = 0; y < h; y++)
-			{
-				int index = y * w;
-				cl_ubyte32 *line = p + index;
-				for (int x = 0; x < w; x++)
-				{
-					cl_ubyte32 r = ((line[x] >> 24) & 0xff);
-					cl_ubyte32 g = ((line[x] >> 16) & 0xff);
-					cl_ubyte32 b = ((line[x] >> 8) & 0xff);
-					cl_ubyte32 a = (line[x] & 0xff);
-
-					r = r * a / 255;
-					g = g * a / 255;
-					b = b * a / 255;
-
-					line[x] = (r << 24) + (g << 16) + (b << 8) + a;
-				}
-			}
+				CL_PixelConverter::premultiply_rgba8(p + y * w, w);
 		}
 		else if (get_format() == cl_argb8)
 		{
@@ -391,23 +376,7 @@ void CL_PixelBuffer::premultiply_alpha()
 			int h = get_height();
 			cl_ubyte32 *p = (cl_ubyte32 *) get_data();
 			for (int y = 0; y < h; y++)
-			{
-				int index = y * w;
-				cl_ubyte32 *line = p + index;
-				for (int x = 0; x < w; x++)
-				{
-					cl_ubyte32 a = ((line[x] >> 24) & 0xff);
-					cl_ubyte32 r = ((line[x] >> 16) & 0xff);
-					cl_ubyte32 g = ((line[x] >> 8) & 0xff);
-					cl_ubyte32 b = (line[x] & 0xff);
-
-					r = r * a / 255;
-					g = g * a / 255;
-					b = b * a / 255;
-
-					line[x] = (a << 24) + (r << 16) + (g << 8) + b;
-				}
-			}
+				CL_PixelConverter::premultiply_argb8(p + y * w, w);
 		}
 		else
 		{
@@ -28,6 +28,8 @@
 
 #include "Display/precomp.h"
 #include "API/Display/Image/pixel_buffer_help.h"
+#include "API/Core/Math/cl_math.h"
+#include "pixel_buffer_scaler.h"
 
 CL_PixelBuffer CL_PixelBufferHelp::add_border(const CL_PixelBuffer &pb, int border_size, const CL_Rect &rect)
 {
@@ -94,3 +96,36 @@ CL_PixelBuffer CL_PixelBufferHelp::add_border(const CL_PixelBuffer &pb, int bord
 	}
 	return new_pb;
 }
+
+CL_PixelBuffer CL_PixelBufferHelp::scale(const CL_PixelBuffer &pb, int new_width, int new_height, CL_PixelBufferScaleFilter filter, int num_threads)
+{
+	if (new_width <= 0 || new_height <= 0)
+		throw CL_Exception("Invalid size passed to CL_PixelBufferHelp::scale()");
+
+	CL_PixelBuffer work_pb = pb;
+	if (work_pb.get_format() != cl_rgba8)
+		work_pb = pb.to_format(cl_rgba8);
+
+	CL_PixelBuffer new_pb(new_width, new_height, cl_rgba8, NULL);
+	CL_PixelBufferScaler scaler(work_pb, new_pb, filter);
+	scaler.scale(num_threads);
+	return new_pb;
+}
+
+std::vector<CL_PixelBuffer> CL_PixelBufferHelp::generate_mipmaps(const CL_PixelBuffer &pb, CL_PixelBufferScaleFilter filter, int num_threads)
+{
+	CL_PixelBuffer level = pb;
+	if (level.get_format() != cl_rgba8)
+		level = pb.to_format(cl_rgba8);
+
+	std::vector<CL_PixelBuffer> levels;
+	levels.push_back(level);
+	while (level.get_width() > 1 || level.get_height() > 1)
+	{
+		int new_width = cl_max(level.get_width() / 2, 1);
+		int new_height = cl_max(level.get_height() / 2, 1);
+		level = scale(level, new_width, new_height, filter, num_threads);
+		levels.push_back(level);
+	}
+	return levels;
+}
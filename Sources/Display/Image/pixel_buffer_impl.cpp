@@ -32,6 +32,7 @@
 #include "API/Display/Image/pixel_buffer.h"
 #include "API/Core/System/exception.h"
 #include "pixel_buffer_impl.h"
+#include "pixel_converter.h"
 #include "API/Display/Render/graphic_context.h"
 #include "API/Display/TargetProviders/graphic_context_provider.h"
 #include "API/Display/TargetProviders/pixel_buffer_provider.h"
@@ -1040,7 +1041,9 @@ void CL_PixelBuffer_Impl::convert(CL_PixelBuffer &target, const CL_Rect &dest_re
 		throw CL_Exception("Source and destination rects must have same size. Scaled converting not supported.");
 	}
 
-	if (!check_supported_conversion_format())
+	// Formats the generic converter cannot handle may still have a specialized converter:
+	bool has_line_converter = !colorkey_enabled && CL_PixelConverter::find(sized_format, target.get_format());
+	if (!has_line_converter && !check_supported_conversion_format())
 		throw CL_Exception("Converting from this pixelformat type is currently not supported");
 
 	if (!target.impl->check_supported_conversion_format())
@@ -1095,12 +1098,21 @@ void CL_PixelBuffer_Impl::convert(
 	char* in_p = static_cast<char*>(in_buffer);
 	char* out_p = static_cast<char*>(out_buffer);
 
+	CL_PixelConverter::ConvertLineFunc line_converter = 0;
+	if (!colorkey_enabled)
+		line_converter = CL_PixelConverter::find(get_format(), target_buffer.get_format());
+
 	if (get_format() == target_buffer.get_format())
 	{
 		const int in_line_bytes = in_bpp*size.width;
 		for (int y = 0; y < size.height; y++, in_p += in_pitch, out_p += out_pitch)
 			memcpy(out_p, in_p, in_line_bytes);
 	}
+	else if (line_converter)
+	{
+		for (int y = 0; y < size.height; y++, in_p += in_pitch, out_p += out_pitch)
+			line_converter(in_p, out_p, size.width);
+	}
 	else
 	{
 		const int in_r_shift = CL_PixelFormat::get_mask_shift(red_mask);
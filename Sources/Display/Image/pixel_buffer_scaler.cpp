@@ -0,0 +1,295 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Display/precomp.h"
+#include "pixel_buffer_scaler.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/Math/cl_math.h"
+#include <cmath>
+
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_PixelBufferScaler construction:
+
+CL_PixelBufferScaler::CL_PixelBufferScaler(const CL_PixelBuffer &src, CL_PixelBuffer &dest, CL_PixelBufferScaleFilter filter)
+: src_data((const cl_ubyte32 *) src.get_data()), src_width(src.get_width()), src_height(src.get_height()),
+  dest_data((cl_ubyte32 *) dest.get_data()), dest_width(dest.get_width()), dest_height(dest.get_height()), temp_data(0)
+{
+	calc_contributions(src_width, dest_width, filter, horizontal);
+	calc_contributions(src_height, dest_height, filter, vertical);
+}
+
+CL_PixelBufferScaler::~CL_PixelBufferScaler()
+{
+	CL_System::aligned_free(temp_data);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_PixelBufferScaler operations:
+
+void CL_PixelBufferScaler::scale(int num_threads)
+{
+	temp_data = (float *) CL_System::aligned_alloc(sizeof(float) * 4 * dest_width * src_height);
+	run_pass(&CL_PixelBufferScaler::horizontal_pass, src_height, num_threads);
+	run_pass(&CL_PixelBufferScaler::vertical_pass, dest_height, num_threads);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_PixelBufferScaler implementation:
+
+void CL_PixelBufferScaler::calc_contributions(int src_size, int dest_size, CL_PixelBufferScaleFilter filter, Contributions &contributions)
+{
+	// Widen the filter when downscaling so that every source pixel contributes
+	float scale = src_size / (float) dest_size;
+	float filter_scale = cl_max(scale, 1.0f);
+	float support = get_filter_radius(filter) * filter_scale;
+
+	contributions.max_count = (int) ceil(support * 2.0f) + 2;
+	contributions.start.resize(dest_size);
+	contributions.count.resize(dest_size);
+	contributions.weights.resize(dest_size * contributions.max_count);
+
+	std::vector<float> weights(contributions.max_count);
+	for (int i = 0; i < dest_size; i++)
+	{
+		float center = (i + 0.5f) * scale;
+		int first = cl_max((int) floor(center - support), 0);
+		int last = cl_min((int) ceil(center + support), src_size - 1);
+
+		// Source pixels outside the image repeat the edge pixels, adding their weight to them
+		int num_weights = 0;
+		float total = 0.0f;
+		for (int j = (int) floor(center - support); j <= (int) ceil(center + support); j++)
+		{
+			float weight = get_filter_weight(filter, (j + 0.5f - center) / filter_scale);
+			int index = cl_clamp(j, first, last) - first;
+			while (num_weights <= index)
+				weights[num_weights++] = 0.0f;
+			weights[index] += weight;
+			total += weight;
+		}
+
+		// Skip taps that ended up with no weight
+		int skip = 0;
+		while (skip < num_weights - 1 && weights[skip] == 0.0f)
+			skip++;
+		while (num_weights > skip + 1 && weights[num_weights - 1] == 0.0f)
+			num_weights--;
+
+		if (total == 0.0f)
+		{
+			// Filter missed every sample; fall back to the nearest source pixel
+			skip = 0;
+			num_weights = 1;
+			first = cl_clamp((int) center, 0, src_size - 1);
+			weights[0] = total = 1.0f;
+		}
+
+		contributions.start[i] = first + skip;
+		contributions.count[i] = num_weights - skip;
+		float *dest_weights = &contributions.weights[i * contributions.max_count];
+		for (int k = 0; k < contributions.max_count; k++)
+			dest_weights[k] = (k < num_weights - skip) ? weights[k + skip] / total : 0.0f;
+	}
+}
+
+float CL_PixelBufferScaler::get_filter_radius(CL_PixelBufferScaleFilter filter)
+{
+	switch (filter)
+	{
+	case cl_scale_filter_box:
+		return 0.5f;
+	case cl_scale_filter_bilinear:
+		return 1.0f;
+	case cl_scale_filter_lanczos3:
+	default:
+		return 3.0f;
+	}
+}
+
+float CL_PixelBufferScaler::get_filter_weight(CL_PixelBufferScaleFilter filter, float x)
+{
+	switch (filter)
+	{
+	case cl_scale_filter_box:
+		return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+	case cl_scale_filter_bilinear:
+		return cl_max(1.0f - fabs(x), 0.0f);
+	case cl_scale_filter_lanczos3:
+	default:
+		if (x == 0.0f)
+			return 1.0f;
+		if (x <= -3.0f || x >= 3.0f)
+			return 0.0f;
+		{
+			float pi_x = CL_PI * x;
+			return 3.0f * sin(pi_x) * sin(pi_x / 3.0f) / (pi_x * pi_x);
+		}
+	}
+}
+
+void CL_PixelBufferScaler::run_pass(PassFunc pass, int num_rows, int num_threads)
+{
+	if (num_threads <= 0)
+		num_threads = CL_System::get_num_cores();
+	num_threads = cl_max(cl_min(num_threads, num_rows / min_rows_per_thread), 1);
+
+	std::vector<CL_Thread> threads;
+	for (int i = 1; i < num_threads; i++)
+	{
+		CL_Thread thread;
+		thread.start(this, pass, num_rows * i / num_threads, num_rows * (i + 1) / num_threads);
+		threads.push_back(thread);
+	}
+
+	(this->*pass)(0, num_rows / num_threads);
+
+	for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+void CL_PixelBufferScaler::horizontal_pass(int first_row, int end_row)
+{
+	float *row = (float *) CL_System::aligned_alloc(sizeof(float) * 4 * src_width);
+	for (int y = first_row; y < end_row; y++)
+	{
+		const cl_ubyte32 *src_line = src_data + y * src_width;
+		float *temp_line = temp_data + y * dest_width * 4;
+
+		// Unpack the source row to one float per component
+#ifndef CL_DISABLE_SSE2
+		__m128i zero = _mm_setzero_si128();
+		for (int x = 0; x < src_width; x++)
+		{
+			__m128i pixel = _mm_unpacklo_epi8(_mm_cvtsi32_si128(src_line[x]), zero);
+			_mm_store_ps(row + x * 4, _mm_cvtepi32_ps(_mm_unpacklo_epi16(pixel, zero)));
+		}
+
+		for (int x = 0; x < dest_width; x++)
+		{
+			const float *src = row + horizontal.start[x] * 4;
+			const float *weights = &horizontal.weights[x * horizontal.max_count];
+			int count = horizontal.count[x];
+			__m128 sum = _mm_setzero_ps();
+			for (int k = 0; k < count; k++)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(src + k * 4), _mm_set1_ps(weights[k])));
+			_mm_store_ps(temp_line + x * 4, sum);
+		}
+#else
+		for (int x = 0; x < src_width; x++)
+		{
+			for (int c = 0; c < 4; c++)
+				row[x * 4 + c] = (float) ((src_line[x] >> (c * 8)) & 0xff);
+		}
+
+		for (int x = 0; x < dest_width; x++)
+		{
+			const float *src = row + horizontal.start[x] * 4;
+			const float *weights = &horizontal.weights[x * horizontal.max_count];
+			int count = horizontal.count[x];
+			float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (int k = 0; k < count; k++)
+			{
+				for (int c = 0; c < 4; c++)
+					sum[c] += src[k * 4 + c] * weights[k];
+			}
+			for (int c = 0; c < 4; c++)
+				temp_line[x * 4 + c] = sum[c];
+		}
+#endif
+	}
+	CL_System::aligned_free(row);
+}
+
+void CL_PixelBufferScaler::vertical_pass(int first_row, int end_row)
+{
+	int row_size = dest_width * 4;
+	float *row = (float *) CL_System::aligned_alloc(sizeof(float) * row_size);
+	for (int y = first_row; y < end_row; y++)
+	{
+		const float *weights = &vertical.weights[y * vertical.max_count];
+		int count = vertical.count[y];
+		cl_ubyte32 *dest_line = dest_data + y * dest_width;
+
+#ifndef CL_DISABLE_SSE2
+		for (int x = 0; x < row_size; x += 4)
+			_mm_store_ps(row + x, _mm_setzero_ps());
+
+		for (int k = 0; k < count; k++)
+		{
+			const float *temp_line = temp_data + (vertical.start[y] + k) * row_size;
+			__m128 weight = _mm_set1_ps(weights[k]);
+			for (int x = 0; x < row_size; x += 4)
+				_mm_store_ps(row + x, _mm_add_ps(_mm_load_ps(row + x), _mm_mul_ps(_mm_load_ps(temp_line + x), weight)));
+		}
+
+		// Round, clamp to 0-255 and pack the components back into pixels
+		__m128 half = _mm_set1_ps(0.5f);
+		__m128 zero = _mm_setzero_ps();
+		__m128 max_value = _mm_set1_ps(255.0f);
+		int x = 0;
+		for (; x + 4 <= dest_width; x += 4)
+		{
+			__m128i p0 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_load_ps(row + x * 4), half), zero), max_value));
+			__m128i p1 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_load_ps(row + x * 4 + 4), half), zero), max_value));
+			__m128i p2 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_load_ps(row + x * 4 + 8), half), zero), max_value));
+			__m128i p3 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_load_ps(row + x * 4 + 12), half), zero), max_value));
+			_mm_storeu_si128((__m128i *) (dest_line + x), _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+		}
+		for (; x < dest_width; x++)
+		{
+			__m128i p = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_load_ps(row + x * 4), half), zero), max_value));
+			p = _mm_packs_epi32(p, p);
+			dest_line[x] = _mm_cvtsi128_si32(_mm_packus_epi16(p, p));
+		}
+#else
+		for (int x = 0; x < row_size; x++)
+			row[x] = 0.0f;
+
+		for (int k = 0; k < count; k++)
+		{
+			const float *temp_line = temp_data + (vertical.start[y] + k) * row_size;
+			for (int x = 0; x < row_size; x++)
+				row[x] += temp_line[x] * weights[k];
+		}
+
+		for (int x = 0; x < dest_width; x++)
+		{
+			cl_ubyte32 pixel = 0;
+			for (int c = 0; c < 4; c++)
+				pixel |= ((cl_ubyte32) cl_clamp(row[x * 4 + c] + 0.5f, 0.0f, 255.0f)) << (c * 8);
+			dest_line[x] = pixel;
+		}
+#endif
+	}
+	CL_System::aligned_free(row);
+}
@@ -0,0 +1,98 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Display/Image/pixel_buffer.h"
+#include "API/Display/Image/pixel_buffer_help.h"
+#include <vector>
+
+/// \brief Separable two pass resampler for cl_rgba8 pixel buffers.
+///
+/// The horizontal pass filters each source row into a float buffer of the destination
+/// width. The vertical pass then filters those rows into the destination. Both passes
+/// process one RGBA pixel per SSE register and are split into row bands between threads.
+class CL_PixelBufferScaler
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_PixelBufferScaler(const CL_PixelBuffer &src, CL_PixelBuffer &dest, CL_PixelBufferScaleFilter filter);
+
+	~CL_PixelBufferScaler();
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void scale(int num_threads);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	/// \brief Source pixels and weights contributing to each destination pixel along one axis.
+	struct Contributions
+	{
+		std::vector<int> start;
+		std::vector<int> count;
+
+		/// \brief max_count weights for each destination pixel
+		std::vector<float> weights;
+		int max_count;
+	};
+
+	static void calc_contributions(int src_size, int dest_size, CL_PixelBufferScaleFilter filter, Contributions &contributions);
+	static float get_filter_radius(CL_PixelBufferScaleFilter filter);
+	static float get_filter_weight(CL_PixelBufferScaleFilter filter, float x);
+
+	typedef void (CL_PixelBufferScaler::*PassFunc)(int first_row, int end_row);
+	void run_pass(PassFunc pass, int num_rows, int num_threads);
+	void horizontal_pass(int first_row, int end_row);
+	void vertical_pass(int first_row, int end_row);
+
+	const cl_ubyte32 *src_data;
+	int src_width;
+	int src_height;
+
+	cl_ubyte32 *dest_data;
+	int dest_width;
+	int dest_height;
+
+	Contributions horizontal;
+	Contributions vertical;
+
+	/// \brief Horizontally filtered source rows, four floats per pixel.
+	float *temp_data;
+
+	static const int min_rows_per_thread = 32;
+/// \}
+};
@@ -0,0 +1,320 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Display/precomp.h"
+#include "pixel_converter.h"
+
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_PixelConverter dispatch table:
+
+namespace
+{
+	struct CL_PixelConverterEntry
+	{
+		CL_TextureFormat input_format;
+		CL_TextureFormat output_format;
+		CL_PixelConverter::ConvertLineFunc func;
+	};
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_PixelConverter operations:
+
+CL_PixelConverter::ConvertLineFunc CL_PixelConverter::find(CL_TextureFormat input_format, CL_TextureFormat output_format)
+{
+	static const CL_PixelConverterEntry converters[] =
+	{
+		{ cl_rgba8, cl_argb8, &CL_PixelConverter::rgba8_to_argb8 },
+		{ cl_argb8, cl_rgba8, &CL_PixelConverter::argb8_to_rgba8 },
+		{ cl_rgb8, cl_rgba8, &CL_PixelConverter::rgb8_to_rgba8 },
+		{ cl_rgb8, cl_argb8, &CL_PixelConverter::rgb8_to_argb8 },
+		{ cl_bgr8, cl_rgba8, &CL_PixelConverter::bgr8_to_rgba8 },
+		{ cl_bgr8, cl_argb8, &CL_PixelConverter::bgr8_to_argb8 },
+		{ cl_r8, cl_rgba8, &CL_PixelConverter::r8_to_rgba8 },
+		{ cl_r8, cl_argb8, &CL_PixelConverter::r8_to_argb8 },
+		{ cl_rgba32f, cl_rgba8, &CL_PixelConverter::rgba32f_to_rgba8 },
+		{ cl_rgba32f, cl_argb8, &CL_PixelConverter::rgba32f_to_argb8 }
+	};
+
+	for (size_t i = 0; i < sizeof(converters) / sizeof(converters[0]); i++)
+	{
+		if (converters[i].input_format == input_format && converters[i].output_format == output_format)
+			return converters[i].func;
+	}
+	return 0;
+}
+
+void CL_PixelConverter::premultiply_rgba8(cl_ubyte32 *pixels, int count)
+{
+	premultiply(pixels, count, 0);
+}
+
+void CL_PixelConverter::premultiply_argb8(cl_ubyte32 *pixels, int count)
+{
+	premultiply(pixels, count, 24);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_PixelConverter implementation:
+
+void CL_PixelConverter::rgba8_to_argb8(const void *input, void *output, int width)
+{
+	const cl_ubyte32 *in = (const cl_ubyte32 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	int x = 0;
+#ifndef CL_DISABLE_SSE2
+	for (; x + 4 <= width; x += 4)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (in + x));
+		_mm_storeu_si128((__m128i *) (out + x), _mm_or_si128(_mm_srli_epi32(p, 8), _mm_slli_epi32(p, 24)));
+	}
+#endif
+	for (; x < width; x++)
+		out[x] = (in[x] >> 8) | (in[x] << 24);
+}
+
+void CL_PixelConverter::argb8_to_rgba8(const void *input, void *output, int width)
+{
+	const cl_ubyte32 *in = (const cl_ubyte32 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	int x = 0;
+#ifndef CL_DISABLE_SSE2
+	for (; x + 4 <= width; x += 4)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (in + x));
+		_mm_storeu_si128((__m128i *) (out + x), _mm_or_si128(_mm_slli_epi32(p, 8), _mm_srli_epi32(p, 24)));
+	}
+#endif
+	for (; x < width; x++)
+		out[x] = (in[x] << 8) | (in[x] >> 24);
+}
+
+void CL_PixelConverter::rgb8_to_rgba8(const void *input, void *output, int width)
+{
+	// cl_rgb8 is stored as blue, green, red bytes
+	const cl_ubyte8 *in = (const cl_ubyte8 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	for (int x = 0; x < width; x++, in += 3)
+		out[x] = (in[2] << 24) | (in[1] << 16) | (in[0] << 8) | 0xff;
+}
+
+void CL_PixelConverter::rgb8_to_argb8(const void *input, void *output, int width)
+{
+	const cl_ubyte8 *in = (const cl_ubyte8 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	for (int x = 0; x < width; x++, in += 3)
+		out[x] = 0xff000000 | (in[2] << 16) | (in[1] << 8) | in[0];
+}
+
+void CL_PixelConverter::bgr8_to_rgba8(const void *input, void *output, int width)
+{
+	// cl_bgr8 is stored as red, green, blue bytes
+	const cl_ubyte8 *in = (const cl_ubyte8 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	for (int x = 0; x < width; x++, in += 3)
+		out[x] = (in[0] << 24) | (in[1] << 16) | (in[2] << 8) | 0xff;
+}
+
+void CL_PixelConverter::bgr8_to_argb8(const void *input, void *output, int width)
+{
+	const cl_ubyte8 *in = (const cl_ubyte8 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	for (int x = 0; x < width; x++, in += 3)
+		out[x] = 0xff000000 | (in[0] << 16) | (in[1] << 8) | in[2];
+}
+
+void CL_PixelConverter::r8_to_rgba8(const void *input, void *output, int width)
+{
+	const cl_ubyte8 *in = (const cl_ubyte8 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	int x = 0;
+#ifndef CL_DISABLE_SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128i alpha = _mm_set1_epi32(0xff);
+	for (; x + 16 <= width; x += 16)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (in + x));
+		__m128i lo = _mm_unpacklo_epi8(p, zero);
+		__m128i hi = _mm_unpackhi_epi8(p, zero);
+		_mm_storeu_si128((__m128i *) (out + x), _mm_or_si128(_mm_slli_epi32(_mm_unpacklo_epi16(lo, zero), 24), alpha));
+		_mm_storeu_si128((__m128i *) (out + x + 4), _mm_or_si128(_mm_slli_epi32(_mm_unpackhi_epi16(lo, zero), 24), alpha));
+		_mm_storeu_si128((__m128i *) (out + x + 8), _mm_or_si128(_mm_slli_epi32(_mm_unpacklo_epi16(hi, zero), 24), alpha));
+		_mm_storeu_si128((__m128i *) (out + x + 12), _mm_or_si128(_mm_slli_epi32(_mm_unpackhi_epi16(hi, zero), 24), alpha));
+	}
+#endif
+	for (; x < width; x++)
+		out[x] = (in[x] << 24) | 0xff;
+}
+
+void CL_PixelConverter::r8_to_argb8(const void *input, void *output, int width)
+{
+	const cl_ubyte8 *in = (const cl_ubyte8 *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	int x = 0;
+#ifndef CL_DISABLE_SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128i alpha = _mm_set1_epi32(0xff000000);
+	for (; x + 16 <= width; x += 16)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (in + x));
+		__m128i lo = _mm_unpacklo_epi8(p, zero);
+		__m128i hi = _mm_unpackhi_epi8(p, zero);
+		_mm_storeu_si128((__m128i *) (out + x), _mm_or_si128(_mm_slli_epi32(_mm_unpacklo_epi16(lo, zero), 16), alpha));
+		_mm_storeu_si128((__m128i *) (out + x + 4), _mm_or_si128(_mm_slli_epi32(_mm_unpackhi_epi16(lo, zero), 16), alpha));
+		_mm_storeu_si128((__m128i *) (out + x + 8), _mm_or_si128(_mm_slli_epi32(_mm_unpacklo_epi16(hi, zero), 16), alpha));
+		_mm_storeu_si128((__m128i *) (out + x + 12), _mm_or_si128(_mm_slli_epi32(_mm_unpackhi_epi16(hi, zero), 16), alpha));
+	}
+#endif
+	for (; x < width; x++)
+		out[x] = 0xff000000 | (in[x] << 16);
+}
+
+static inline cl_ubyte32 cl_float_to_ubyte(float value)
+{
+	if (value <= 0.0f)
+		return 0;
+	else if (value >= 1.0f)
+		return 255;
+	else
+		return (cl_ubyte32) (value * 255.0f + 0.5f);
+}
+
+void CL_PixelConverter::rgba32f_to_rgba8(const void *input, void *output, int width)
+{
+	const float *in = (const float *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	int x = 0;
+#ifndef CL_DISABLE_SSE2
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 scale = _mm_set1_ps(255.0f);
+	__m128 half = _mm_set1_ps(0.5f);
+	for (; x + 4 <= width; x += 4)
+	{
+		__m128i c[4];
+		for (int i = 0; i < 4; i++)
+		{
+			__m128 p = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + (x + i) * 4), zero), one);
+			c[i] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p, scale), half));
+			// Reverse the components so the bytes end up as 0xRRGGBBAA:
+			c[i] = _mm_shuffle_epi32(c[i], _MM_SHUFFLE(0,1,2,3));
+		}
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]), _mm_packs_epi32(c[2], c[3]));
+		_mm_storeu_si128((__m128i *) (out + x), packed);
+	}
+#endif
+	for (; x < width; x++)
+	{
+		const float *p = in + x * 4;
+		out[x] = (cl_float_to_ubyte(p[0]) << 24) | (cl_float_to_ubyte(p[1]) << 16) | (cl_float_to_ubyte(p[2]) << 8) | cl_float_to_ubyte(p[3]);
+	}
+}
+
+void CL_PixelConverter::rgba32f_to_argb8(const void *input, void *output, int width)
+{
+	const float *in = (const float *) input;
+	cl_ubyte32 *out = (cl_ubyte32 *) output;
+	int x = 0;
+#ifndef CL_DISABLE_SSE2
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 scale = _mm_set1_ps(255.0f);
+	__m128 half = _mm_set1_ps(0.5f);
+	for (; x + 4 <= width; x += 4)
+	{
+		__m128i c[4];
+		for (int i = 0; i < 4; i++)
+		{
+			__m128 p = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + (x + i) * 4), zero), one);
+			c[i] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p, scale), half));
+			// Swap red and blue so the bytes end up as 0xAARRGGBB:
+			c[i] = _mm_shuffle_epi32(c[i], _MM_SHUFFLE(3,0,1,2));
+		}
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]), _mm_packs_epi32(c[2], c[3]));
+		_mm_storeu_si128((__m128i *) (out + x), packed);
+	}
+#endif
+	for (; x < width; x++)
+	{
+		const float *p = in + x * 4;
+		out[x] = (cl_float_to_ubyte(p[3]) << 24) | (cl_float_to_ubyte(p[0]) << 16) | (cl_float_to_ubyte(p[1]) << 8) | cl_float_to_ubyte(p[2]);
+	}
+}
+
+void CL_PixelConverter::premultiply(cl_ubyte32 *pixels, int count, int alpha_shift)
+{
+	int x = 0;
+#ifndef CL_DISABLE_SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128i one = _mm_set1_epi16(1);
+	__m128i alpha_mask = _mm_set1_epi32(0xff << alpha_shift);
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *) (pixels + x));
+		__m128i lo = _mm_unpacklo_epi8(p, zero);
+		__m128i hi = _mm_unpackhi_epi8(p, zero);
+
+		__m128i alpha_lo, alpha_hi;
+		if (alpha_shift == 0)
+		{
+			alpha_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(0,0,0,0)), _MM_SHUFFLE(0,0,0,0));
+			alpha_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(0,0,0,0)), _MM_SHUFFLE(0,0,0,0));
+		}
+		else
+		{
+			alpha_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+			alpha_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+		}
+
+		// c * a / 255, rounded down, computed exactly as (v + 1 + (v >> 8)) >> 8 with v = c * a
+		lo = _mm_mullo_epi16(lo, alpha_lo);
+		hi = _mm_mullo_epi16(hi, alpha_hi);
+		lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+
+		__m128i result = _mm_packus_epi16(lo, hi);
+		result = _mm_or_si128(_mm_andnot_si128(alpha_mask, result), _mm_and_si128(alpha_mask, p));
+		_mm_storeu_si128((__m128i *) (pixels + x), result);
+	}
+#endif
+	for (; x < count; x++)
+	{
+		cl_ubyte32 a = (pixels[x] >> alpha_shift) & 0xff;
+		cl_ubyte32 result = a << alpha_shift;
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			if (shift != alpha_shift)
+				result |= (((pixels[x] >> shift) & 0xff) * a / 255) << shift;
+		}
+		pixels[x] = result;
+	}
+}
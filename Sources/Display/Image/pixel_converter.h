@@ -0,0 +1,65 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "API/Display/Image/texture_format.h"
+
+/// \brief Specialized scanline converters for common pixel format pairs.
+///
+/// CL_PixelBuffer_Impl::convert() falls back to its generic shift and mask loop for
+/// any pair of formats not found here.
+class CL_PixelConverter
+{
+public:
+	/// \brief Converts width pixels from input to output. Neither pointer needs to be aligned.
+	typedef void (*ConvertLineFunc)(const void *input, void *output, int width);
+
+	/// \brief Returns the line converter for a format pair, or 0 if no specialized converter exists.
+	static ConvertLineFunc find(CL_TextureFormat input_format, CL_TextureFormat output_format);
+
+	/// \brief Multiplies the color components of cl_rgba8 pixels with their alpha.
+	static void premultiply_rgba8(cl_ubyte32 *pixels, int count);
+
+	/// \brief Multiplies the color components of cl_argb8 pixels with their alpha.
+	static void premultiply_argb8(cl_ubyte32 *pixels, int count);
+
+private:
+	static void rgba8_to_argb8(const void *input, void *output, int width);
+	static void argb8_to_rgba8(const void *input, void *output, int width);
+	static void rgb8_to_rgba8(const void *input, void *output, int width);
+	static void rgb8_to_argb8(const void *input, void *output, int width);
+	static void bgr8_to_rgba8(const void *input, void *output, int width);
+	static void bgr8_to_argb8(const void *input, void *output, int width);
+	static void r8_to_rgba8(const void *input, void *output, int width);
+	static void r8_to_argb8(const void *input, void *output, int width);
+	static void rgba32f_to_rgba8(const void *input, void *output, int width);
+	static void rgba32f_to_argb8(const void *input, void *output, int width);
+
+	static void premultiply(cl_ubyte32 *pixels, int count, int alpha_shift);
+};
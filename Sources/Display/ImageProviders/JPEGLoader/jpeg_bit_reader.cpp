@@ -31,9 +31,15 @@
 #include "jpeg_file_reader.h"
 
 CL_JPEGBitReader::CL_JPEGBitReader(CL_JPEGFileReader *reader)
-: reader(reader), length(0), pos(0), bitpos(0)
+: reader(reader), data(0), length(0), pos(0), bitpos(0)
 {
 	buffer.resize(16*1024);
+	data = &buffer[0];
+}
+
+CL_JPEGBitReader::CL_JPEGBitReader(const unsigned char *data, int length)
+: reader(0), data(data), length(length), pos(0), bitpos(0)
+{
 }
 
 void CL_JPEGBitReader::reset()
@@ -42,6 +48,7 @@ void CL_JPEGBitReader::reset()
 	pos = 0;
 	bitpos = 0;
 	buffer.resize(16*1024);
+	data = &buffer[0];
 }
 
 unsigned int CL_JPEGBitReader::get_bit()
@@ -53,16 +60,20 @@ unsigned int CL_JPEGBitReader::get_bit()
 	}
 	if (pos == length)
 	{
+		if (reader == 0)
+			throw CL_Exception("Premature end of JPEG entropy data");
+
 		length = reader->read_entropy_data(&buffer[0], buffer.size());
 		if (length == 0)
 		{
 			//JPEGMarker marker = reader->read_marker();
 			throw CL_Exception("Premature end of JPEG entropy data");
 		}
+		data = &buffer[0];
 		pos = 0;
 	}
 
-	unsigned int v = (buffer[pos] >> (7-bitpos)) & 0x01;
+	unsigned int v = (data[pos] >> (7-bitpos)) & 0x01;
 	bitpos++;
 	return v;
 }
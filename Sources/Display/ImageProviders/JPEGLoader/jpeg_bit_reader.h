@@ -35,6 +35,9 @@ class CL_JPEGBitReader
 public:
 	CL_JPEGBitReader(CL_JPEGFileReader *reader);
 
+	/// \brief Reads from entropy data already in memory, with byte stuffing removed
+	CL_JPEGBitReader(const unsigned char *data, int length);
+
 	void reset();
 	unsigned int get_bit();
 	unsigned int get_bits(int count);
@@ -42,6 +45,7 @@ public:
 private:
 	CL_JPEGFileReader *reader;
 	std::vector<unsigned char> buffer;
+	const unsigned char *data;
 	int length;
 	int pos;
 	int bitpos;
@@ -0,0 +1,144 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Display/precomp.h"
+#include "jpeg_component_dcts.h"
+
+/*
+	Compact row format, one record per block:
+
+	  count              1 byte, number of nonzero coefficients
+	  count times:
+	    index            1 byte, natural order position
+	    value            2 bytes, little endian
+
+	An empty row stream means every coefficient in the row is zero.
+*/
+
+void CL_JPEGComponentDCTs::resize(size_t size)
+{
+	if (blocks_per_row != 0)
+	{
+		flush();
+		compact_rows.resize((size + blocks_per_row - 1) / blocks_per_row);
+	}
+	else
+	{
+		dcts.resize(size * 64, 0);
+	}
+}
+
+void CL_JPEGComponentDCTs::set_compact(size_t new_blocks_per_row)
+{
+	blocks_per_row = new_blocks_per_row;
+	window_row = -1;
+	compact_rows.clear();
+	std::vector<short>().swap(dcts);
+}
+
+short *CL_JPEGComponentDCTs::get_compact(size_t index)
+{
+	int row = index / blocks_per_row;
+	if (row != window_row)
+	{
+		flush();
+		if ((size_t) row >= compact_rows.size())
+			compact_rows.resize(row + 1);
+		expand_row(row, dcts);
+		window_row = row;
+	}
+	return &dcts[(index - row * blocks_per_row) * 64];
+}
+
+void CL_JPEGComponentDCTs::flush()
+{
+	if (window_row == -1)
+		return;
+
+	size_t nonzero = 0;
+	for (size_t i = 0; i < dcts.size(); i++)
+	{
+		if (dcts[i] != 0)
+			nonzero++;
+	}
+
+	std::vector<unsigned char> &stream = compact_rows[window_row];
+	window_row = -1;
+
+	if (nonzero == 0)
+	{
+		std::vector<unsigned char>().swap(stream);
+		return;
+	}
+
+	size_t size = blocks_per_row + nonzero * 3;
+	if (stream.capacity() > size + size / 4)
+		std::vector<unsigned char>().swap(stream);
+	stream.resize(size);
+
+	unsigned char *output = &stream[0];
+	for (size_t block = 0; block < blocks_per_row; block++)
+	{
+		const short *coefficients = &dcts[block * 64];
+		unsigned char *count = output++;
+		*count = 0;
+		for (int i = 0; i < 64; i++)
+		{
+			if (coefficients[i] != 0)
+			{
+				unsigned short value = (unsigned short) coefficients[i];
+				output[0] = i;
+				output[1] = value & 0xff;
+				output[2] = value >> 8;
+				output += 3;
+				(*count)++;
+			}
+		}
+	}
+}
+
+void CL_JPEGComponentDCTs::expand_row(size_t row, std::vector<short> &output) const
+{
+	output.assign(blocks_per_row * 64, 0);
+
+	const std::vector<unsigned char> &stream = compact_rows[row];
+	if (stream.empty())
+		return;
+
+	const unsigned char *input = &stream[0];
+	for (size_t block = 0; block < blocks_per_row; block++)
+	{
+		short *coefficients = &output[block * 64];
+		int count = *(input++);
+		for (int i = 0; i < count; i++)
+		{
+			coefficients[input[0]] = (short) (input[1] + (input[2] << 8));
+			input += 3;
+		}
+	}
+}
@@ -28,23 +28,50 @@
 
 #pragma once
 
+/// \brief DCT coefficients of one image component, indexed by block in MCU order.
+///
+/// In compact mode only the nonzero coefficients are kept, one encoded stream per
+/// MCU row. get() then expands a single MCU row into a window and writes it back
+/// when another row is requested, which suits the mostly sequential order in which
+/// scans visit the blocks.
 class CL_JPEGComponentDCTs
 {
 public:
+	CL_JPEGComponentDCTs();
+
 	void resize(size_t size);
 	short *get(size_t index);
 
+	void set_compact(size_t blocks_per_row);
+	bool is_compact() const { return blocks_per_row != 0; }
+	size_t get_blocks_per_row() const { return blocks_per_row; }
+
+	/// \brief Writes the window back into the compact row streams
+	void flush();
+
+	/// \brief Expands a compact MCU row into output. Does not touch the window, so
+	///        several threads may call this at the same time after a flush().
+	void expand_row(size_t row, std::vector<short> &output) const;
+
 private:
+	short *get_compact(size_t index);
+
 	std::vector<short> dcts;
+	size_t blocks_per_row;
+	std::vector<std::vector<unsigned char> > compact_rows;
+	int window_row;
 };
 
-inline void CL_JPEGComponentDCTs::resize(size_t size)
+inline CL_JPEGComponentDCTs::CL_JPEGComponentDCTs()
+: blocks_per_row(0), window_row(-1)
 {
-	dcts.resize(size * 64, 0);
 }
 
 inline short *CL_JPEGComponentDCTs::get(size_t index)
 {
+	if (blocks_per_row != 0)
+		return get_compact(index);
+
 	if (dcts.size() < (index+1) * 64)
 		dcts.resize((index+1) * 64, 0);
 	return &dcts[index * 64];
@@ -32,47 +32,115 @@
 #include "jpeg_huffman_decoder.h"
 #include "jpeg_mcu_decoder.h"
 #include "jpeg_rgb_decoder.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/system.h"
 
-CL_PixelBuffer CL_JPEGLoader::load(CL_IODevice iodevice)
+CL_PixelBuffer CL_JPEGLoader::load(CL_IODevice iodevice, int scale_denominator, int num_threads, bool low_memory, const CL_Callback_v1<CL_PixelBuffer> &preview)
 {
-	CL_JPEGLoader loader(iodevice);
-	CL_JPEGMCUDecoder mcu_decoder(&loader);
-	CL_JPEGRGBDecoder rgb_decoder(&loader);
+	if (num_threads <= 0)
+		num_threads = CL_System::get_num_cores();
 
-	int image_width = loader.start_of_frame.width;
-	int image_height = loader.start_of_frame.height;
-	CL_PixelBuffer image(image_width, image_height, cl_argb8);
-	unsigned int *image_pixels = reinterpret_cast<unsigned int *>(image.get_data());
+	CL_JPEGLoader loader(iodevice, scale_denominator, num_threads, low_memory, preview);
 
-	const unsigned int *block_pixels = rgb_decoder.get_pixels();
-	int block_width = rgb_decoder.get_width();
-	int block_height = rgb_decoder.get_height();
+	CL_PixelBuffer image(loader.get_image_width(), loader.get_image_height(), cl_argb8);
+	loader.decode_image(reinterpret_cast<unsigned int *>(image.get_data()));
+	return image;
+}
+
+int CL_JPEGLoader::get_image_width() const
+{
+	return (start_of_frame.width * block_size + 7) / 8;
+}
+
+int CL_JPEGLoader::get_image_height() const
+{
+	return (start_of_frame.height * block_size + 7) / 8;
+}
 
-	for (int curMcuY = 0, y = 0; curMcuY < loader.mcu_height; curMcuY++, y += block_height)
+int CL_JPEGLoader::get_component_block_size(int component) const
+{
+	// Subsampled components are scaled up by the IDCT rather than upsampled afterwards,
+	// whenever the scaled decode leaves room for the extra resolution.
+	int h = start_of_frame.components[component].horz_sampling_factor;
+	int v = start_of_frame.components[component].vert_sampling_factor;
+	int scale = 1;
+	while (block_size * scale * 2 <= 8 && mcu_x % (h * scale * 2) == 0 && mcu_y % (v * scale * 2) == 0)
+		scale *= 2;
+	return block_size * scale;
+}
+
+void CL_JPEGLoader::decode_image(unsigned int *image_pixels)
+{
+	int thread_count = cl_max(cl_min(num_threads, mcu_height / min_mcu_rows_per_thread), 1);
+
+	std::vector<CL_String> errors(thread_count);
+	std::vector<CL_Thread> threads;
+	for (int i = 1; i < thread_count; i++)
 	{
-		for (int curMcuX = 0, x = 0; curMcuX < loader.mcu_width; curMcuX++, x += block_width)
-		{
-			mcu_decoder.decode(curMcuX + curMcuY * loader.mcu_width);
-			rgb_decoder.decode(&mcu_decoder);
+		CL_Thread thread;
+		thread.start(this, &CL_JPEGLoader::decode_mcu_rows, image_pixels, mcu_height * i / thread_count, mcu_height * (i + 1) / thread_count, &errors[i]);
+		threads.push_back(thread);
+	}
 
-			int w = cl_min(block_width, image_width-x);
-			int h = cl_min(block_height, image_height-y);
-			for (int yy = 0; yy < h; yy++)
+	decode_mcu_rows(image_pixels, 0, mcu_height / thread_count, &errors[0]);
+
+	for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	for (std::vector<CL_String>::size_type i = 0; i < errors.size(); i++)
+	{
+		if (!errors[i].empty())
+			throw CL_Exception(errors[i]);
+	}
+}
+
+void CL_JPEGLoader::decode_mcu_rows(unsigned int *image_pixels, int start_mcu_y, int end_mcu_y, CL_String *error)
+{
+	// Runs on worker threads, so errors are passed back to decode_image instead of thrown.
+	try
+	{
+		CL_JPEGMCUDecoder mcu_decoder(this);
+		CL_JPEGRGBDecoder rgb_decoder(this);
+
+		int image_width = get_image_width();
+		int image_height = get_image_height();
+
+		const unsigned int *block_pixels = rgb_decoder.get_pixels();
+		int block_width = rgb_decoder.get_width();
+		int block_height = rgb_decoder.get_height();
+
+		for (int curMcuY = start_mcu_y, y = start_mcu_y * block_height; curMcuY < end_mcu_y; curMcuY++, y += block_height)
+		{
+			for (int curMcuX = 0, x = 0; curMcuX < mcu_width; curMcuX++, x += block_width)
 			{
-				for (int xx = 0; xx < w; xx++)
-				{
-					image_pixels[x+xx+(y+yy)*image_width] = block_pixels[xx+yy*block_width];
-				}
+				mcu_decoder.decode(curMcuX + curMcuY * mcu_width);
+				rgb_decoder.decode(&mcu_decoder);
+
+				int w = cl_min(block_width, image_width-x);
+				int h = cl_min(block_height, image_height-y);
+				for (int yy = 0; yy < h; yy++)
+					memcpy(image_pixels + x + (y+yy)*image_width, block_pixels + yy*block_width, w * sizeof(unsigned int));
 			}
 		}
 	}
-
-	return image;
+	catch (const CL_Exception &e)
+	{
+		*error = e.message;
+	}
 }
 
-CL_JPEGLoader::CL_JPEGLoader(CL_IODevice iodevice)
-: progressive(false), scan_count(0), mcu_x(0), mcu_y(0), mcu_width(0), mcu_height(0), restart_interval(0), eobrun(0), is_jfif_jpeg(false), is_adobe_jpeg(false), adobe_app14_transform(1)
+CL_JPEGLoader::CL_JPEGLoader(CL_IODevice iodevice, int scale_denominator, int num_threads, bool low_memory, const CL_Callback_v1<CL_PixelBuffer> &preview)
+: progressive(false), scan_count(0), mcu_x(0), mcu_y(0), mcu_width(0), mcu_height(0), restart_interval(0), eobrun(0), block_size(8), num_threads(num_threads), low_memory(low_memory), preview(preview), preview_sent(false), is_jfif_jpeg(false), is_adobe_jpeg(false), adobe_app14_transform(1)
 {
+	switch (scale_denominator)
+	{
+	case 1: block_size = 8; break;
+	case 2: block_size = 4; break;
+	case 4: block_size = 2; break;
+	case 8: block_size = 1; break;
+	default: throw CL_Exception("Unsupported JPEG scale denominator");
+	}
+
 	CL_JPEGFileReader reader(iodevice);
 
 	CL_JPEGMarker marker = reader.read_marker();
@@ -189,9 +257,15 @@ void CL_JPEGLoader::process_sof(CL_JPEGMarker marker, CL_JPEGFileReader &reader)
 		mcu_height = (start_of_frame.height + (mcu_y*8-1)) / (mcu_y*8);
 
 		for (size_t c = 0; c < component_dcts.size(); c++)
-			component_dcts[c].resize(mcu_width*mcu_height*start_of_frame.components[c].horz_sampling_factor*start_of_frame.components[c].vert_sampling_factor);
+		{
+			int blocks_per_mcu = start_of_frame.components[c].horz_sampling_factor*start_of_frame.components[c].vert_sampling_factor;
+			if (low_memory)
+				component_dcts[c].set_compact(mcu_width*blocks_per_mcu);
+			component_dcts[c].resize(mcu_width*mcu_height*blocks_per_mcu);
+		}
 
 		last_dc_values.resize(start_of_frame.components.size());
+		dc_received.resize(start_of_frame.components.size());
 	}
 	else
 	{
@@ -248,6 +322,43 @@ void CL_JPEGLoader::process_sos(CL_JPEGFileReader &reader)
 		process_sos_sequential(start_of_scan, component_to_sof, reader);
 
 	scan_count++;
+
+	for (size_t c = 0; c < component_dcts.size(); c++)
+		component_dcts[c].flush();
+
+	if (progressive && !preview.is_null() && !preview_sent)
+		send_preview(start_of_scan, component_to_sof);
+}
+
+void CL_JPEGLoader::send_preview(const CL_JPEGStartOfScan &start_of_scan, const std::vector<int> &component_to_sof)
+{
+	if (start_of_scan.start_dct_coefficient != 0 || start_of_scan.preceding_point_transform != 0)
+		return;
+
+	for (size_t c = 0; c < component_to_sof.size(); c++)
+		dc_received[component_to_sof[c]] = true;
+	for (size_t c = 0; c < dc_received.size(); c++)
+	{
+		if (!dc_received[c])
+			return;
+	}
+
+	// The DC coefficients are all a 1/8 scale decode needs
+	int saved_block_size = block_size;
+	block_size = 1;
+	try
+	{
+		CL_PixelBuffer image(get_image_width(), get_image_height(), cl_argb8);
+		decode_image(reinterpret_cast<unsigned int *>(image.get_data()));
+		block_size = saved_block_size;
+		preview_sent = true;
+		preview.invoke(image);
+	}
+	catch (...)
+	{
+		block_size = saved_block_size;
+		throw;
+	}
 }
 
 void CL_JPEGLoader::verify_dc_table_selector(const CL_JPEGStartOfScan &start_of_scan)
@@ -298,6 +409,12 @@ void CL_JPEGLoader::process_sos_sequential(CL_JPEGStartOfScan &start_of_scan, st
 	verify_dc_table_selector(start_of_scan);
 	verify_ac_table_selector(start_of_scan);
 
+	if (restart_interval != 0 && num_threads > 1 && !low_memory && mcu_width*mcu_height >= min_parallel_mcus && mcu_width*mcu_height > restart_interval)
+	{
+		process_sos_sequential_parallel(start_of_scan, component_to_sof, reader);
+		return;
+	}
+
 	CL_JPEGBitReader bit_reader(&reader);
 	int restart_counter = 0;
 	for (int mcu_block = 0; mcu_block < mcu_width*mcu_height; mcu_block++)
@@ -317,46 +434,141 @@ void CL_JPEGLoader::process_sos_sequential(CL_JPEGStartOfScan &start_of_scan, st
 		}
 		restart_counter++;
 
-		for (size_t c = 0; c < start_of_scan.components.size(); c++)
+		decode_sequential_mcu(bit_reader, start_of_scan, component_to_sof, mcu_block, last_dc_values);
+	}
+}
+
+void CL_JPEGLoader::process_sos_sequential_parallel(CL_JPEGStartOfScan &start_of_scan, std::vector<int> component_to_sof, CL_JPEGFileReader &reader)
+{
+	// Each restart interval starts with fresh DC predictors and a byte aligned bit stream, which
+	// makes them independent of each other. Read the entropy data for all of them up front and
+	// then decode them in parallel.
+
+	int num_mcus = mcu_width*mcu_height;
+	int num_intervals = (num_mcus + restart_interval - 1) / restart_interval;
+
+	entropy_segments.clear();
+	entropy_segments.resize(num_intervals);
+	std::vector<unsigned char> buffer(16*1024);
+	for (int i = 0; i < num_intervals; i++)
+	{
+		if (i > 0)
+		{
+			CL_JPEGMarker marker = reader.read_marker();
+			if (marker < marker_rst0 || marker > marker_rst7)
+				throw CL_Exception("Restart marker missing between JPEG entropy data");
+		}
+
+		while (true)
+		{
+			int length = reader.read_entropy_data(&buffer[0], buffer.size());
+			if (length == 0)
+				break;
+			entropy_segments[i].insert(entropy_segments[i].end(), buffer.begin(), buffer.begin() + length);
+		}
+	}
+
+	// Make sure no worker thread needs to grow the coefficient arrays
+	for (size_t c = 0; c < component_to_sof.size(); c++)
+	{
+		int c_sof = component_to_sof[c];
+		int blocks_per_mcu = start_of_frame.components[c_sof].horz_sampling_factor * start_of_frame.components[c_sof].vert_sampling_factor;
+		component_dcts[c_sof].get(num_mcus * blocks_per_mcu - 1);
+	}
+
+	int thread_count = cl_min(num_threads, num_intervals);
+	std::vector<CL_String> errors(thread_count);
+	std::vector<CL_Thread> threads;
+	for (int i = 1; i < thread_count; i++)
+	{
+		CL_Thread thread;
+		thread.start(this, &CL_JPEGLoader::decode_restart_intervals, (const CL_JPEGStartOfScan *) &start_of_scan, (const std::vector<int> *) &component_to_sof, num_intervals * i / thread_count, num_intervals * (i + 1) / thread_count, &errors[i]);
+		threads.push_back(thread);
+	}
+
+	decode_restart_intervals(&start_of_scan, &component_to_sof, 0, num_intervals / thread_count, &errors[0]);
+
+	for (std::vector<CL_Thread>::size_type i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	entropy_segments.clear();
+
+	for (std::vector<CL_String>::size_type i = 0; i < errors.size(); i++)
+	{
+		if (!errors[i].empty())
+			throw CL_Exception(errors[i]);
+	}
+
+	for (size_t i = 0; i < last_dc_values.size(); i++)
+		last_dc_values[i] = 0;
+}
+
+void CL_JPEGLoader::decode_restart_intervals(const CL_JPEGStartOfScan *start_of_scan, const std::vector<int> *component_to_sof, int start_interval, int end_interval, CL_String *error)
+{
+	// Runs on worker threads, so errors are passed back instead of thrown.
+	try
+	{
+		std::vector<short> dc_values(last_dc_values.size());
+		int num_mcus = mcu_width*mcu_height;
+		for (int interval = start_interval; interval < end_interval; interval++)
 		{
-			int c_sof = component_to_sof[c];
-			const CL_JPEGHuffmanTable &dc_table = huffman_dc_tables[start_of_scan.components[c].dc_table_selector];
-			const CL_JPEGHuffmanTable &ac_table = huffman_ac_tables[start_of_scan.components[c].ac_table_selector];
-			int scale_x = start_of_frame.components[c_sof].horz_sampling_factor;
-			int scale_y = start_of_frame.components[c_sof].vert_sampling_factor;
-			for (int i = 0; i < scale_x * scale_y; i++)
+			const std::vector<unsigned char> &segment = entropy_segments[interval];
+			CL_JPEGBitReader bit_reader(segment.empty() ? 0 : &segment[0], segment.size());
+			for (size_t i = 0; i < dc_values.size(); i++)
+				dc_values[i] = 0;
+
+			int end_mcu = cl_min((interval + 1) * restart_interval, num_mcus);
+			for (int mcu_block = interval * restart_interval; mcu_block < end_mcu; mcu_block++)
+				decode_sequential_mcu(bit_reader, *start_of_scan, *component_to_sof, mcu_block, dc_values);
+		}
+	}
+	catch (const CL_Exception &e)
+	{
+		*error = e.message;
+	}
+}
+
+void CL_JPEGLoader::decode_sequential_mcu(CL_JPEGBitReader &bit_reader, const CL_JPEGStartOfScan &start_of_scan, const std::vector<int> &component_to_sof, int mcu_block, std::vector<short> &dc_values)
+{
+	for (size_t c = 0; c < start_of_scan.components.size(); c++)
+	{
+		int c_sof = component_to_sof[c];
+		const CL_JPEGHuffmanTable &dc_table = huffman_dc_tables[start_of_scan.components[c].dc_table_selector];
+		const CL_JPEGHuffmanTable &ac_table = huffman_ac_tables[start_of_scan.components[c].ac_table_selector];
+		int scale_x = start_of_frame.components[c_sof].horz_sampling_factor;
+		int scale_y = start_of_frame.components[c_sof].vert_sampling_factor;
+		for (int i = 0; i < scale_x * scale_y; i++)
+		{
+			short *dct = component_dcts[c_sof].get(mcu_block*scale_x*scale_y+i);
+			for (int j = start_of_scan.start_dct_coefficient; j <= start_of_scan.end_dct_coefficient; j++)
 			{
-				short *dct = component_dcts[c_sof].get(mcu_block*scale_x*scale_y+i);
-				for (int j = start_of_scan.start_dct_coefficient; j <= start_of_scan.end_dct_coefficient; j++)
+				if (j == 0) // DCT DC coefficient
 				{
-					if (j == 0) // DCT DC coefficient
-					{
-						unsigned int code = CL_JPEGHuffmanDecoder::decode(bit_reader, dc_table);
-						if (code != huffman_eob)
-							dct[0] = CL_JPEGHuffmanDecoder::decode_number(bit_reader, code);
-						dct[0] <<= start_of_scan.point_transform;
+					unsigned int code = CL_JPEGHuffmanDecoder::decode(bit_reader, dc_table);
+					if (code != huffman_eob)
+						dct[0] = CL_JPEGHuffmanDecoder::decode_number(bit_reader, code);
+					dct[0] <<= start_of_scan.point_transform;
 
-						dct[0] += last_dc_values[c_sof];
-						last_dc_values[c_sof] = dct[0];
-					}
-					else // DCT AC coefficient
+					dct[0] += dc_values[c_sof];
+					dc_values[c_sof] = dct[0];
+				}
+				else // DCT AC coefficient
+				{
+					unsigned int code = CL_JPEGHuffmanDecoder::decode(bit_reader, ac_table);
+					if (code != huffman_eob)
 					{
-						unsigned int code = CL_JPEGHuffmanDecoder::decode(bit_reader, ac_table);
-						if (code != huffman_eob)
-						{
-							unsigned int zeros = (code>>4);
-							j += zeros;
-							if (j <= start_of_scan.end_dct_coefficient)
-							{
-								dct[zigzag_map[j]] = CL_JPEGHuffmanDecoder::decode_number(bit_reader, code & 0x0f);
-								dct[zigzag_map[j]] <<= start_of_scan.point_transform;
-							}
-						}
-						else
+						unsigned int zeros = (code>>4);
+						j += zeros;
+						if (j <= start_of_scan.end_dct_coefficient)
 						{
-							break;
+							dct[zigzag_map[j]] = CL_JPEGHuffmanDecoder::decode_number(bit_reader, code & 0x0f);
+							dct[zigzag_map[j]] <<= start_of_scan.point_transform;
 						}
 					}
+					else
+					{
+						break;
+					}
 				}
 			}
 		}
@@ -30,6 +30,7 @@
 
 #include "API/Core/IOData/iodevice.h"
 #include "API/Display/Image/pixel_buffer.h"
+#include "API/Core/Signals/callback_v1.h"
 #include "jpeg_file_reader.h"
 #include "jpeg_start_of_frame.h"
 #include "jpeg_start_of_scan.h"
@@ -43,7 +44,13 @@ class CL_JPEGBitReader;
 class CL_JPEGLoader
 {
 public:
-	static CL_PixelBuffer load(CL_IODevice iodevice);
+	/// \brief Decodes a JPEG image into a cl_argb8 pixel buffer.
+	///
+	/// \param scale_denominator Output is scaled by 1/scale_denominator (1, 2, 4 or 8) directly in the IDCT.
+	/// \param num_threads Number of threads used for decoding. 0 uses one per core.
+	/// \param low_memory Keep coefficients in compact form until the image is converted.
+	/// \param preview Receives a 1/8 scale image once the DC scans of a progressive image have been read.
+	static CL_PixelBuffer load(CL_IODevice iodevice, int scale_denominator = 1, int num_threads = 0, bool low_memory = false, const CL_Callback_v1<CL_PixelBuffer> &preview = CL_Callback_v1<CL_PixelBuffer>());
 
 private:
 	enum ColorSpace
@@ -55,13 +62,16 @@ private:
 		colorspace_grayscale
 	};
 
-	CL_JPEGLoader(CL_IODevice iodevice);
+	CL_JPEGLoader(CL_IODevice iodevice, int scale_denominator, int num_threads, bool low_memory, const CL_Callback_v1<CL_PixelBuffer> &preview);
 
 	void process_app0(CL_JPEGFileReader &reader);
 	void process_app14(CL_JPEGFileReader &reader);
 	void process_dnl(CL_JPEGFileReader &reader);
 	void process_sos(CL_JPEGFileReader &reader);
 	void process_sos_sequential(CL_JPEGStartOfScan &start_of_scan, std::vector<int> component_to_sof, CL_JPEGFileReader &reader);
+	void process_sos_sequential_parallel(CL_JPEGStartOfScan &start_of_scan, std::vector<int> component_to_sof, CL_JPEGFileReader &reader);
+	void decode_restart_intervals(const CL_JPEGStartOfScan *start_of_scan, const std::vector<int> *component_to_sof, int start_interval, int end_interval, CL_String *error);
+	void decode_sequential_mcu(CL_JPEGBitReader &bit_reader, const CL_JPEGStartOfScan &start_of_scan, const std::vector<int> &component_to_sof, int mcu_block, std::vector<short> &dc_values);
 	void process_sos_progressive(CL_JPEGStartOfScan &start_of_scan, std::vector<int> component_to_sof, CL_JPEGFileReader &reader);
 	void process_dqt(CL_JPEGFileReader &reader);
 	void process_dht(CL_JPEGFileReader &reader);
@@ -69,6 +79,12 @@ private:
 	void verify_dc_table_selector(const CL_JPEGStartOfScan &start_of_scan);
 	void verify_ac_table_selector(const CL_JPEGStartOfScan &start_of_scan);
 	ColorSpace get_colorspace() const;
+	int get_image_width() const;
+	int get_image_height() const;
+	int get_component_block_size(int component) const;
+	void decode_image(unsigned int *image_pixels);
+	void send_preview(const CL_JPEGStartOfScan &start_of_scan, const std::vector<int> &component_to_sof);
+	void decode_mcu_rows(unsigned int *image_pixels, int start_mcu_y, int end_mcu_y, CL_String *error);
 
 	CL_JPEGStartOfFrame start_of_frame;
 	CL_JPEGHuffmanTable huffman_dc_tables[4];
@@ -85,6 +101,21 @@ private:
 	int eobrun;
 	std::vector<short> last_dc_values;
 
+	/// \brief Pixels per side produced from an 8x8 block of luma coefficients (8, 4, 2 or 1)
+	int block_size;
+	int num_threads;
+	std::vector<std::vector<unsigned char> > entropy_segments;
+	bool low_memory;
+	CL_Callback_v1<CL_PixelBuffer> preview;
+	std::vector<bool> dc_received;
+	bool preview_sent;
+
+	/// \brief Minimum number of MCUs in a scan before restart intervals are decoded in parallel
+	static const int min_parallel_mcus = 1024;
+
+	/// \brief Minimum number of MCU rows per thread for IDCT and color conversion
+	static const int min_mcu_rows_per_thread = 4;
+
 	bool is_jfif_jpeg;
 	bool is_adobe_jpeg;
 	int adobe_app14_transform;
@@ -29,6 +29,8 @@
 #include "Display/precomp.h"
 #include "jpeg_mcu_decoder.h"
 #include "jpeg_loader.h"
+#include "API/Core/Math/cl_math.h"
+#include <cmath>
 
 #ifndef CL_DISABLE_SSE2
 #ifndef CL_ARM_PLATFORM
@@ -40,10 +42,34 @@
 CL_JPEGMCUDecoder::CL_JPEGMCUDecoder(CL_JPEGLoader *loader)
 : loader(loader)
 {
+	/* A scaled decode computes an N point IDCT (N = 4, 2 or 1) from the N lowest
+	 * frequency coefficients, which equals sampling the 8 point basis functions
+	 * at the centers of each group of 8/N output pixels:
+	 *   out[i] = 1/2 * sum(k<N) c(k) * coef[k] * cos((2i+1)*k*PI/(2N))
+	 *   c(0) = 1/sqrt(2), c(k) = 1 otherwise
+	 */
+	for (int table = 0; table < 3; table++)
+	{
+		int size = 1 << table;
+		for (int i = 0; i < 4; i++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				float ck = (k == 0) ? 0.707106781f : 1.0f;
+				reduced_tables[table][i*4+k] = 0.5f * ck * (float) cos((2*i+1)*k*CL_PI/(2*size));
+			}
+		}
+	}
+
+	for (size_t c = 0; c < loader->start_of_frame.components.size(); c++)
+		block_sizes.push_back(loader->get_component_block_size(c));
+	row_dcts.resize(block_sizes.size());
+	row_indexes.resize(block_sizes.size(), -1);
+
 	try
 	{
 		for (size_t c = 0; c < loader->start_of_frame.components.size(); c++)
-			channels.push_back((unsigned char *) CL_System::aligned_alloc(loader->mcu_x*loader->mcu_y*64, 16));
+			channels.push_back((unsigned char *) CL_System::aligned_alloc(loader->mcu_x*loader->mcu_y*loader->block_size*loader->block_size, 16));
 
 		/* For float AA&N IDCT method, divisors are equal to quantization
 		 * coefficients scaled by scalefactor[row]*scalefactor[col], where
@@ -61,8 +87,15 @@ CL_JPEGMCUDecoder::CL_JPEGMCUDecoder(CL_JPEGLoader *loader)
 			quant.push_back((float*) CL_System::aligned_alloc(64*sizeof(float), 16));
 			const CL_JPEGQuantizationTable &qtable = loader->quantization_tables[loader->start_of_frame.components[c].quantization_table_selector];
 			for (int y = 0; y < 8; y++)
+			{
 				for (int x = 0; x < 8; x++)
-					quant[c][x+y*8] = aanscalefactor[x] * aanscalefactor[y] * qtable.values[x+y*8];
+				{
+					if (block_sizes[c] == 8)
+						quant[c][x+y*8] = aanscalefactor[x] * aanscalefactor[y] * qtable.values[x+y*8];
+					else
+						quant[c][x+y*8] = (float) qtable.values[x+y*8];
+				}
+			}
 		}
 	}
 	catch (...)
@@ -89,31 +122,87 @@ void CL_JPEGMCUDecoder::decode(int block)
 	{
 		int scale_x = loader->start_of_frame.components[c].horz_sampling_factor;
 		int scale_y = loader->start_of_frame.components[c].vert_sampling_factor;
-		int block_size = scale_x * scale_y;
+		int blocks_per_mcu = scale_x * scale_y;
+		int block_size = block_sizes[c];
 		for (int dct_y = 0; dct_y < scale_y; dct_y++)
 		{
 			for (int dct_x = 0; dct_x < scale_x; dct_x++)
 			{
-				short *dct = loader->component_dcts[c].get(block * block_size + dct_x + dct_y * scale_x);
+				const short *dct = get_dct(c, block * blocks_per_mcu + dct_x + dct_y * scale_x);
+				int pitch = scale_x*block_size;
+				unsigned char *output = channels[c]+dct_x*block_size+dct_y*pitch*block_size;
+
+				if (block_size != 8)
+				{
+					idct_reduced(dct, output, pitch, quant[c], block_size);
+					continue;
+				}
 
 #ifdef CL_DISABLE_SSE2
-				idct(dct, channels[c]+dct_x*8+dct_y*scale_x*64, scale_x*8, quant[c]);
+				idct(dct, output, pitch, quant[c]);
 #else
 
 #ifndef CL_ARM_PLATFORM
-				idct_sse(dct, channels[c]+dct_x*8+dct_y*scale_x*64, scale_x*8, quant[c]);
+				idct_sse(dct, output, pitch, quant[c]);
 #else
-				idct(dct, channels[c]+dct_x*8+dct_y*scale_x*64, scale_x*8, quant[c]);
+				idct(dct, output, pitch, quant[c]);
 #endif
 #endif // not CL_DISABLE_SSE2
+			}
+		}
+	}
+}
 
+const short *CL_JPEGMCUDecoder::get_dct(int component, int index)
+{
+	CL_JPEGComponentDCTs &dcts = loader->component_dcts[component];
+	if (!dcts.is_compact())
+		return dcts.get(index);
 
-			}
+	int blocks_per_row = dcts.get_blocks_per_row();
+	int row = index / blocks_per_row;
+	if (row != row_indexes[component])
+	{
+		dcts.expand_row(row, row_dcts[component]);
+		row_indexes[component] = row;
+	}
+	return &row_dcts[component][(index - row * blocks_per_row) * 64];
+}
+
+void CL_JPEGMCUDecoder::idct_reduced(const short *inptr, unsigned char *outptr, int pitch, float *quantptr, int size)
+{
+	const float *reduced_table = reduced_tables[size == 4 ? 2 : size - 1];
+	float workspace[4*4];
+
+	/* Pass 1: process the low frequency columns, store into work array. */
+
+	for (int u = 0; u < size; u++)
+	{
+		for (int y = 0; y < size; y++)
+		{
+			float sum = 0.0f;
+			for (int v = 0; v < size; v++)
+				sum += reduced_table[y*4+v] * inptr[u+v*8] * quantptr[u+v*8];
+			workspace[u+y*4] = sum;
 		}
 	}
+
+	/* Pass 2: process rows from work array, store into output array. */
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			float sum = 0.0f;
+			for (int u = 0; u < size; u++)
+				sum += reduced_table[x*4+u] * workspace[u+y*4];
+			outptr[x] = float_to_int(sum);
+		}
+		outptr += pitch;
+	}
 }
 
-void CL_JPEGMCUDecoder::idct(short *inptr, unsigned char *outptr, int pitch, float *quantptr)
+void CL_JPEGMCUDecoder::idct(const short *inptr, unsigned char *outptr, int pitch, float *quantptr)
 {
 	float tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
 	float tmp10, tmp11, tmp12, tmp13;
@@ -254,7 +343,7 @@ void CL_JPEGMCUDecoder::idct(short *inptr, unsigned char *outptr, int pitch, flo
 #ifndef CL_DISABLE_SSE2
 
 #ifndef CL_ARM_PLATFORM
-void CL_JPEGMCUDecoder::idct_sse(short *inptr, unsigned char *outptr, int pitch, float *quantptr)
+void CL_JPEGMCUDecoder::idct_sse(const short *inptr, unsigned char *outptr, int pitch, float *quantptr)
 {
 	__m128 tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
 	__m128 tmp10, tmp11, tmp12, tmp13;
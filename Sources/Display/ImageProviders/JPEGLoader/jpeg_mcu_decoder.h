@@ -41,11 +41,21 @@ public:
 	const unsigned char *get_channel(int c) const { return channels[c]; }
 
 private:
-	void idct(short *inptr, unsigned char *outptr, int pitch, float *quantptr);
-	void idct_sse(short *inptr, unsigned char *outptr, int pitch, float *quantptr);
+	const short *get_dct(int component, int index);
+	void idct(const short *inptr, unsigned char *outptr, int pitch, float *quantptr);
+	void idct_sse(const short *inptr, unsigned char *outptr, int pitch, float *quantptr);
+	void idct_reduced(const short *inptr, unsigned char *outptr, int pitch, float *quantptr, int size);
 	static inline unsigned char float_to_int(float v);
 
 	CL_JPEGLoader *loader;
 	std::vector<unsigned char *> channels;
 	std::vector<float *> quant;
+	std::vector<int> block_sizes;
+
+	/// \brief Expanded MCU row for components stored in compact form
+	std::vector<std::vector<short> > row_dcts;
+	std::vector<int> row_indexes;
+
+	/// \brief Basis functions for the 1, 2 and 4 point IDCTs, indexed [log2(size)][output_sample*4+coefficient]
+	float reduced_tables[3][4*4];
 };
@@ -40,15 +40,16 @@
 #endif
 
 CL_JPEGRGBDecoder::CL_JPEGRGBDecoder(CL_JPEGLoader *loader)
-: loader(loader), mcu_x(0), mcu_y(0), pixels(0)
+: loader(loader), mcu_x(0), mcu_y(0), block_size(0), pixels(0)
 {
 	mcu_x = loader->mcu_x;
 	mcu_y = loader->mcu_y;
+	block_size = loader->block_size;
 	try
 	{
-		pixels = (unsigned int *) CL_System::aligned_alloc(mcu_x*mcu_y*64*4, 16);
+		pixels = (unsigned int *) CL_System::aligned_alloc(mcu_x*mcu_y*block_size*block_size*4, 16);
 		for (size_t c = 0; c < loader->start_of_frame.components.size(); c++)
-			channels.push_back((unsigned char *) CL_System::aligned_alloc(mcu_x*mcu_y*64, 16));
+			channels.push_back((unsigned char *) CL_System::aligned_alloc(mcu_x*mcu_y*block_size*block_size, 16));
 	}
 	catch (...)
 	{
@@ -76,8 +77,16 @@ void CL_JPEGRGBDecoder::decode(CL_JPEGMCUDecoder *mcu_decoder)
 		convert_monochrome();
 		break;
 	case CL_JPEGLoader::colorspace_ycrcb:
+#ifdef CL_DISABLE_SSE2
 		convert_ycrcb_float();
-//		convert_ycrcb_sse();
+#else
+
+#ifndef CL_ARM_PLATFORM
+		convert_ycrcb_sse();
+#else
+		convert_ycrcb_float();
+#endif
+#endif // not CL_DISABLE_SSE2
 		break;
 	case CL_JPEGLoader::colorspace_rgb:
 		convert_rgb();
@@ -91,28 +100,29 @@ void CL_JPEGRGBDecoder::decode(CL_JPEGMCUDecoder *mcu_decoder)
 
 void CL_JPEGRGBDecoder::upsample(CL_JPEGMCUDecoder *mcu_decoder)
 {
-	int height = mcu_y*8;
-	int width = mcu_x*8;
+	int height = get_height();
+	int width = get_width();
 
 	for (size_t c = 0; c < channels.size(); c++)
 	{
-		int h = loader->start_of_frame.components[c].horz_sampling_factor;
-		int v = loader->start_of_frame.components[c].vert_sampling_factor;
+		int component_block_size = loader->get_component_block_size(c);
+		int input_width = loader->start_of_frame.components[c].horz_sampling_factor*component_block_size;
+		int input_height = loader->start_of_frame.components[c].vert_sampling_factor*component_block_size;
 		const unsigned char *input = mcu_decoder->get_channel(c);
 		unsigned char *output = channels[c];
 
-		if (mcu_x == h && mcu_y == v)
+		if (input_width == width && input_height == height)
 		{
 			memcpy(output, input, width*height);
 		}
 		else
 		{
-			int step_sx = (h<<16)/mcu_x;
-			int step_sy = (v<<16)/mcu_y;
+			int step_sx = (input_width<<16)/width;
+			int step_sy = (input_height<<16)/height;
 			int sy = step_sy>>1;
 			for (int y = 0; y < height; y++)
 			{
-				const unsigned char *input_line = input+(sy>>16)*v*8;
+				const unsigned char *input_line = input+(sy>>16)*input_width;
 				int sx = step_sx>>1;
 				for (int x = 0; x < width; x++)
 				{
@@ -127,8 +137,8 @@ void CL_JPEGRGBDecoder::upsample(CL_JPEGMCUDecoder *mcu_decoder)
 
 void CL_JPEGRGBDecoder::convert_monochrome()
 {
-	int height = mcu_y*8;
-	int width = mcu_x*8;
+	int height = get_height();
+	int width = get_width();
 
 	for (int y = 0; y < height; y++)
 	{
@@ -164,89 +174,70 @@ void CL_JPEGRGBDecoder::convert_ycrcb_sse()
 	__m128 centerjsample = _mm_set1_ps((float) 128);
 	__m128 min_value = _mm_set1_ps(0.0f);
 	__m128 max_value = _mm_set1_ps(255.0f);
-	__m128i ypack8, cbpack8, crpack8, ypack4, cbpack4, crpack4;
-	__m128 y, cb, cr, r, g, b, zero;
-
-#ifdef WIN32
-	__declspec(align(16)) unsigned char temp[32];
-#else
-	__attribute__ ((aligned (16))) unsigned char temp[32];
-#endif
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128i alpha = _mm_set1_epi32(0xff000000);
+	__m128i ypack8, cbpack8, crpack8;
+	__m128 y, cb, cr, r, g, b;
 
-	int height = mcu_y*8;
-	int width = mcu_x*8;
+	int height = get_height();
+	int width = get_width();
 	for (int row = 0; row < height; row++)
 	{
-		unsigned char *outptr = (unsigned char*) (pixels+row*width);
+		unsigned int *outptr = pixels+row*width;
 		unsigned char *inptr0 = channels[0]+row*width;
 		unsigned char *inptr1 = channels[1]+row*width;
 		unsigned char *inptr2 = channels[2]+row*width;
 
-		for (int x = 0; x+7 < width; x+=8)
+		int x = 0;
+		for (; x+7 < width; x+=8)
 		{
 			ypack8 = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*) (&inptr0[x])), _mm_setzero_si128());
 			cbpack8 = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*) (&inptr1[x])), _mm_setzero_si128());
 			crpack8 = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*) (&inptr2[x])), _mm_setzero_si128());
-			
-			ypack4 = _mm_unpacklo_epi16(ypack8, _mm_setzero_si128());
-			cbpack4 = _mm_unpacklo_epi16(cbpack8, _mm_setzero_si128());
-			crpack4 = _mm_unpacklo_epi16(crpack8, _mm_setzero_si128());
-
-			y = _mm_cvtepi32_ps(ypack4);
-			cb = _mm_sub_ps(_mm_cvtepi32_ps(cbpack4), centerjsample);
-			cr = _mm_sub_ps(_mm_cvtepi32_ps(crpack4), centerjsample);
-
-			r = _mm_add_ps(y, _mm_mul_ps(constant_r_cr, cr));
-			g = _mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(constant_g_cb, cb)), _mm_mul_ps(constant_g_cr, cr));
-			b = _mm_add_ps(y, _mm_mul_ps(cb, constant_b_cb));
-			zero = _mm_setzero_ps();
-
-			r = _mm_max_ps(_mm_min_ps(r, max_value), min_value);
-			g = _mm_max_ps(_mm_min_ps(g, max_value), min_value);
-			b = _mm_max_ps(_mm_min_ps(b, max_value), min_value);
-
-			_mm_store_si128((__m128i*)temp, _mm_packus_epi16(
-				_mm_packs_epi32(_mm_cvtps_epi32(r), _mm_cvtps_epi32(g)),
-				_mm_packs_epi32(_mm_cvtps_epi32(b), _mm_cvtps_epi32(zero))));
-
-			ypack4 = _mm_unpackhi_epi16(ypack8, _mm_setzero_si128());
-			cbpack4 = _mm_unpackhi_epi16(cbpack8, _mm_setzero_si128());
-			crpack4 = _mm_unpackhi_epi16(crpack8, _mm_setzero_si128());
-
-			y = _mm_cvtepi32_ps(ypack4);
-			cb = _mm_sub_ps(_mm_cvtepi32_ps(cbpack4), centerjsample);
-			cr = _mm_sub_ps(_mm_cvtepi32_ps(crpack4), centerjsample);
-
-			r = _mm_add_ps(y, _mm_mul_ps(constant_r_cr, cr));
-			g = _mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(constant_g_cb, cb)), _mm_mul_ps(constant_g_cr, cr));
-			b = _mm_add_ps(y, _mm_mul_ps(cb, constant_b_cb));
-			zero = _mm_setzero_ps();
-
-			r = _mm_max_ps(_mm_min_ps(r, max_value), min_value);
-			g = _mm_max_ps(_mm_min_ps(g, max_value), min_value);
-			b = _mm_max_ps(_mm_min_ps(b, max_value), min_value);
-
-			_mm_store_si128((__m128i*)(temp+16), _mm_packus_epi16(
-				_mm_packs_epi32(_mm_cvtps_epi32(r), _mm_cvtps_epi32(g)),
-				_mm_packs_epi32(_mm_cvtps_epi32(b), _mm_cvtps_epi32(zero))));
-
-			for (int i = 0; i < 4; i++)
-			{
-				outptr[0] = temp[i+8];
-				outptr[1] = temp[i+4];
-				outptr[2] = temp[i];
-				outptr[3] = 0xff;
-				outptr += 4;
-			}
-			for (int i = 0; i < 4; i++)
+
+			for (int half_index = 0; half_index < 2; half_index++)
 			{
-				outptr[0] = temp[i+16+8];
-				outptr[1] = temp[i+16+4];
-				outptr[2] = temp[i+16];
-				outptr[3] = 0xff;
-				outptr += 4;
+				__m128i ypack4 = _mm_unpacklo_epi16(ypack8, _mm_setzero_si128());
+				__m128i cbpack4 = _mm_unpacklo_epi16(cbpack8, _mm_setzero_si128());
+				__m128i crpack4 = _mm_unpacklo_epi16(crpack8, _mm_setzero_si128());
+
+				y = _mm_cvtepi32_ps(ypack4);
+				cb = _mm_sub_ps(_mm_cvtepi32_ps(cbpack4), centerjsample);
+				cr = _mm_sub_ps(_mm_cvtepi32_ps(crpack4), centerjsample);
+
+				r = _mm_add_ps(y, _mm_mul_ps(constant_r_cr, cr));
+				g = _mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(constant_g_cb, cb)), _mm_mul_ps(constant_g_cr, cr));
+				b = _mm_add_ps(y, _mm_mul_ps(cb, constant_b_cb));
+
+				// Clamp and round the same way as convert_ycrcb_float
+				r = _mm_add_ps(_mm_max_ps(_mm_min_ps(r, max_value), min_value), half);
+				g = _mm_add_ps(_mm_max_ps(_mm_min_ps(g, max_value), min_value), half);
+				b = _mm_add_ps(_mm_max_ps(_mm_min_ps(b, max_value), min_value), half);
+
+				__m128i pixel = _mm_or_si128(
+					_mm_or_si128(_mm_cvttps_epi32(b), _mm_slli_epi32(_mm_cvttps_epi32(g), 8)),
+					_mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(r), 16), alpha));
+				_mm_storeu_si128((__m128i*) (outptr+x+half_index*4), pixel);
+
+				ypack8 = _mm_srli_si128(ypack8, 8);
+				cbpack8 = _mm_srli_si128(cbpack8, 8);
+				crpack8 = _mm_srli_si128(crpack8, 8);
 			}
 		}
+
+		// Scaled decodes can produce rows narrower than 8 pixels
+		for (; x < width; x++)
+		{
+			float Y = inptr0[x];
+			float Cb = inptr1[x] - 128.0f;
+			float Cr = inptr2[x] - 128.0f;
+
+			float R = cl_clamp(Y + 1.40200f * Cr, 0.0f, 255.0f) + 0.5f;
+			float G = cl_clamp(Y - 0.34414f * Cb - 0.71414f * Cr, 0.0f, 255.0f) + 0.5f;
+			float B = cl_clamp(Y + 1.77200f * Cb, 0.0f, 255.0f) + 0.5f;
+
+			outptr[x] = 0xff000000 + ((unsigned int)B) + (((unsigned int)G)<<8) + (((unsigned int)R)<<16);
+		}
 	}
 }
 #endif
@@ -254,8 +245,8 @@ void CL_JPEGRGBDecoder::convert_ycrcb_sse()
 
 void CL_JPEGRGBDecoder::convert_ycrcb_float()
 {
-	int height = mcu_y*8;
-	int width = mcu_x*8;
+	int height = get_height();
+	int width = get_width();
 	for (int y = 0; y < height; y++)
 	{
 		for (int x = 0; x < width; x++)
@@ -288,8 +279,8 @@ void CL_JPEGRGBDecoder::convert_ycrcb_float()
 
 void CL_JPEGRGBDecoder::convert_rgb()
 {
-	int height = mcu_y*8;
-	int width = mcu_x*8;
+	int height = get_height();
+	int width = get_width();
 	for (int y = 0; y < height; y++)
 	{
 		for (int x = 0; x < width; x++)
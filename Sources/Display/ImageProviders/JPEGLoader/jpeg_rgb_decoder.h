@@ -39,8 +39,8 @@ public:
 
 	void decode(CL_JPEGMCUDecoder *mcu_decoder);
 
-	int get_width() const { return mcu_x*8; }
-	int get_height() const { return mcu_y*8; }
+	int get_width() const { return mcu_x*block_size; }
+	int get_height() const { return mcu_y*block_size; }
 	const unsigned int *get_pixels() const { return pixels; }
 
 private:
@@ -52,6 +52,7 @@ private:
 
 	CL_JPEGLoader *loader;
 	int mcu_x, mcu_y;
+	int block_size;
 	unsigned int *pixels;
 	std::vector<unsigned char *> channels;
 };
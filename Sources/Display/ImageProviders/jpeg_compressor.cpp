@@ -61,7 +61,7 @@ class CL_JPEGCompressor_Impl
 {
 public:
 	CL_JPEGCompressor_Impl()
-	: quality(95), size(0, 0), in_color_space(CL_JPEGCompressor::rgb), in_components(3),
+	: quality(95), size(0, 0), restart_interval(0), progressive(false), in_color_space(CL_JPEGCompressor::rgb), in_components(3),
 	  out_color_space(CL_JPEGCompressor::ycbcr), out_components(3)
 	{
 		memset(&cinfo, 0, sizeof(jpeg_compress_struct));
@@ -161,6 +161,8 @@ public:
 	int quality;
 	CL_IODevice output;
 	CL_Size size;
+	int restart_interval;
+	bool progressive;
 	CL_JPEGCompressor::ColorSpace in_color_space;
 	int in_components;
 	CL_JPEGCompressor::ColorSpace out_color_space;
@@ -198,6 +200,16 @@ void CL_JPEGCompressor::set_size(int width, int height)
 	impl->size = CL_Size(width, height);
 }
 
+void CL_JPEGCompressor::set_restart_interval(int mcus)
+{
+	impl->restart_interval = mcus;
+}
+
+void CL_JPEGCompressor::set_progressive(bool enable)
+{
+	impl->progressive = enable;
+}
+
 void CL_JPEGCompressor::set_color_space(ColorSpace in_color_space, int in_components, ColorSpace out_color_space, int out_components)
 {
 	impl->in_color_space = in_color_space;
@@ -219,6 +231,9 @@ void CL_JPEGCompressor::start(bool raw_data)
 	jpeg_set_colorspace(&impl->cinfo, impl->to_jpeg_color_space(impl->out_color_space));
 	impl->cinfo.num_components = impl->out_components;
 	jpeg_set_quality(&impl->cinfo, impl->quality, TRUE);
+	impl->cinfo.restart_interval = impl->restart_interval;
+	if (impl->progressive)
+		jpeg_simple_progression(&impl->cinfo);
 	impl->cinfo.raw_data_in = raw_data ? TRUE : FALSE;
 	jpeg_start_compress(&impl->cinfo, TRUE);
 }
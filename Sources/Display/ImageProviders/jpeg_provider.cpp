@@ -64,6 +64,53 @@ CL_PixelBuffer CL_JPEGProvider::load(
 	return CL_JPEGProvider::load(filename, vfs.get_root_directory());
 }
 
+CL_PixelBuffer CL_JPEGProvider::load_scaled(
+	const CL_String &filename,
+	const CL_VirtualDirectory &directory,
+	int scale_denominator,
+	int num_threads)
+{
+	return CL_JPEGLoader::load(directory.open_file_read(filename), scale_denominator, num_threads);
+}
+
+CL_PixelBuffer CL_JPEGProvider::load_scaled(
+	CL_IODevice &file,
+	int scale_denominator,
+	int num_threads)
+{
+	return CL_JPEGLoader::load(file, scale_denominator, num_threads);
+}
+
+CL_PixelBuffer CL_JPEGProvider::load_scaled(
+	const CL_String &fullname,
+	int scale_denominator,
+	int num_threads)
+{
+	CL_String path = CL_PathHelp::get_fullpath(fullname, CL_PathHelp::path_type_file);
+	CL_String filename = CL_PathHelp::get_filename(fullname, CL_PathHelp::path_type_file);
+	CL_VirtualFileSystem vfs(path);
+	return CL_JPEGProvider::load_scaled(filename, vfs.get_root_directory(), scale_denominator, num_threads);
+}
+
+CL_PixelBuffer CL_JPEGProvider::load_low_memory(
+	CL_IODevice &file,
+	const CL_Callback_v1<CL_PixelBuffer> &preview,
+	int scale_denominator)
+{
+	return CL_JPEGLoader::load(file, scale_denominator, 0, true, preview);
+}
+
+CL_PixelBuffer CL_JPEGProvider::load_low_memory(
+	const CL_String &fullname,
+	const CL_Callback_v1<CL_PixelBuffer> &preview,
+	int scale_denominator)
+{
+	CL_String path = CL_PathHelp::get_fullpath(fullname, CL_PathHelp::path_type_file);
+	CL_String filename = CL_PathHelp::get_filename(fullname, CL_PathHelp::path_type_file);
+	CL_VirtualFileSystem vfs(path);
+	return CL_JPEGLoader::load(vfs.get_root_directory().open_file_read(filename), scale_denominator, 0, true, preview);
+}
+
 void CL_JPEGProvider::save(
 	CL_PixelBuffer buffer,
 	const CL_String &fullname,
@@ -35,6 +35,7 @@
 #include "Display/2D/render_batch2d.h"
 #include "Display/2D/render_batch3d.h"
 #include "Display/2D/render_batch_sprite.h"
+#include "Display/2D/render_batch_primitives.h"
 #include "API/Display/Render/blend_mode.h"
 #include "API/Display/Render/pen.h"
 #include "API/Display/Render/polygon_rasterizer.h"
@@ -76,7 +77,11 @@ public:
 	CL_FrameBuffer selected_read_frame_buffer;
 	CL_FrameBuffer selected_write_frame_buffer;
 
+	/// \brief Returns the batcher used by CL_Draw for points, lines and triangles
+	CL_RenderBatchPrimitives *get_primitives_batcher() { return &render_batcher_primitives; }
+
 private:
 	CL_RenderBatch2D render_batcher_2d;
 	CL_RenderBatch3D render_batcher_3d;
+	CL_RenderBatchPrimitives render_batcher_primitives;
 };
@@ -121,6 +121,20 @@ const CL_String::char_type *cl_glsl15_fragment_sprite =
 	"highp vec4 sampleTexture(int index, highp vec2 pos) { if (index == 0) return texture2D(Texture0, TexCoord); else if (index == 1) return texture2D(Texture1, TexCoord); else if (index == 2) return texture2D(Texture2, TexCoord); else if (index == 3) return texture2D(Texture3, TexCoord); else return vec4(1.0,1.0,1.0,1.0); }"
 	"void main(void) { cl_FragColor = Color*sampleTexture(int(TexIndex), TexCoord); } ";
 
+const CL_String::char_type *cl_glsl15_fragment_distance_field =
+	"#version 150\n"
+	"uniform sampler2D Texture0; "
+	"uniform sampler2D Texture1; "
+	"uniform sampler2D Texture2; "
+	"uniform sampler2D Texture3; "
+	"in vec4 Color; "
+	"in vec2 TexCoord; "
+	"in float TexIndex; "
+	"out vec4 cl_FragColor;"
+	"highp vec4 sampleTexture(int index, highp vec2 pos) { if (index == 0) return texture2D(Texture0, TexCoord); else if (index == 1) return texture2D(Texture1, TexCoord); else if (index == 2) return texture2D(Texture2, TexCoord); else if (index == 3) return texture2D(Texture3, TexCoord); else return vec4(1.0,1.0,1.0,1.0); }"
+	"void main(void) { float distance = sampleTexture(int(TexIndex), TexCoord).a; float smoothing = clamp(fwidth(distance)*0.7, 0.001, 0.5); "
+	"cl_FragColor = vec4(Color.rgb, Color.a*smoothstep(0.5-smoothing, 0.5+smoothing, distance)); } ";
+
 const CL_String::char_type *cl_glsl_vertex_color_only = 
 	"attribute vec4 Position, Color0; "
 	"uniform mat4 cl_ModelViewProjectionMatrix;"
@@ -166,6 +180,18 @@ const CL_String::char_type *cl_glsl_fragment_sprite =
 	"vec4 sampleTexture(int index, vec2 pos) { if (index == 0) return texture2D(Texture0, TexCoord); else if (index == 1) return texture2D(Texture1, TexCoord); else if (index == 2) return texture2D(Texture2, TexCoord); else if (index == 3) return texture2D(Texture3, TexCoord); else return vec4(1.0,1.0,1.0,1.0); }"
 	"void main(void) { gl_FragColor = Color*sampleTexture(int(TexIndex), TexCoord); } ";
 
+const CL_String::char_type *cl_glsl_fragment_distance_field =
+	"uniform sampler2D Texture0; "
+	"uniform sampler2D Texture1; "
+	"uniform sampler2D Texture2; "
+	"uniform sampler2D Texture3; "
+	"varying vec4 Color; "
+	"varying vec2 TexCoord; "
+	"varying float TexIndex; "
+	"vec4 sampleTexture(int index, vec2 pos) { if (index == 0) return texture2D(Texture0, TexCoord); else if (index == 1) return texture2D(Texture1, TexCoord); else if (index == 2) return texture2D(Texture2, TexCoord); else if (index == 3) return texture2D(Texture3, TexCoord); else return vec4(1.0,1.0,1.0,1.0); }"
+	"void main(void) { float distance = sampleTexture(int(TexIndex), TexCoord).a; float smoothing = clamp(fwidth(distance)*0.7, 0.001, 0.5); "
+	"gl_FragColor = vec4(Color.rgb, Color.a*smoothstep(0.5-smoothing, 0.5+smoothing, distance)); } ";
+
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_OpenGLGraphicContextProvider Construction:
@@ -242,6 +268,10 @@ CL_OpenGLGraphicContextProvider::CL_OpenGLGraphicContextProvider(const CL_Render
 	if(!fragment_sprite_shader.compile())
 		throw CL_Exception("Unable to compile the standard shader program: 'fragment sprite' Error:" + fragment_sprite_shader.get_info_log());
 
+	CL_ShaderObject fragment_distance_field_shader(this, cl_shadertype_fragment, use_glsl_1_50 ? cl_glsl15_fragment_distance_field : cl_glsl_fragment_distance_field);
+	if(!fragment_distance_field_shader.compile())
+		throw CL_Exception("Unable to compile the standard shader program: 'fragment distance field' Error:" + fragment_distance_field_shader.get_info_log());
+
 	CL_ProgramObject color_only_program(this);
 	color_only_program.attach(vertex_color_only_shader);
 	color_only_program.attach(fragment_color_only_shader);
@@ -282,9 +312,27 @@ CL_OpenGLGraphicContextProvider::CL_OpenGLGraphicContextProvider(const CL_Render
 	sprite_program.set_uniform1i("Texture2", 2);
 	sprite_program.set_uniform1i("Texture3", 3);
 
+	CL_ProgramObject distance_field_program(this);
+	distance_field_program.attach(vertex_sprite_shader);
+	distance_field_program.attach(fragment_distance_field_shader);
+	distance_field_program.bind_attribute_location(0, "Position");
+	distance_field_program.bind_attribute_location(1, "Color0");
+	distance_field_program.bind_attribute_location(2, "TexCoord0");
+	distance_field_program.bind_attribute_location(3, "TexIndex0");
+	if (use_glsl_1_50)
+		distance_field_program.bind_frag_data_location(0, "cl_FragColor");
+	if (!distance_field_program.link())
+		throw CL_Exception("Unable to link the standard shader program: 'distance field' Error:" + distance_field_program.get_info_log());
+
+	distance_field_program.set_uniform1i("Texture0", 0);
+	distance_field_program.set_uniform1i("Texture1", 1);
+	distance_field_program.set_uniform1i("Texture2", 2);
+	distance_field_program.set_uniform1i("Texture3", 3);
+
 	standard_programs.push_back(color_only_program);
 	standard_programs.push_back(single_texture_program);
 	standard_programs.push_back(sprite_program);
+	standard_programs.push_back(distance_field_program);
 
 	reset_program_object();
 }
@@ -79,7 +79,7 @@ public:
 CL_GL1GraphicContextProvider::CL_GL1GraphicContextProvider(const CL_RenderWindowProvider * const render_window)
 : render_window(render_window), map_mode(cl_map_2d_upper_left), projection(CL_Mat4f::identity()), modelview(CL_Mat4f::identity()),
   framebuffer_bound(false), prim_arrays_set(false), cur_prim_array(0), num_set_tex_arrays(0),
-  primitives_array_texture_set(false), primitives_array_texindex_set(false)
+  primitives_array_texture_set(false), primitives_array_texindex_set(false), blend_color_alpha(1.0f)
 {
 	check_opengl_version();
 	max_texture_coords = get_max_texture_coords();
@@ -547,6 +547,19 @@ void CL_GL1GraphicContextProvider::reset_frame_buffer()
 
 void CL_GL1GraphicContextProvider::set_program_object(CL_StandardProgram standard_program)
 {
+	set_active();
+
+	// Without shaders, distance fields are drawn by alpha testing the distance at the glyph edge.
+	// The texture alpha is modulated by the text alpha, which the render batcher passes as the blend color.
+	if (standard_program == cl_program_distance_field)
+	{
+		cl1Enable(GL_ALPHA_TEST);
+		cl1AlphaFunc(GL_GEQUAL, 0.5f * blend_color_alpha);
+	}
+	else
+	{
+		cl1Disable(GL_ALPHA_TEST);
+	}
 }
 
 void CL_GL1GraphicContextProvider::set_program_object(const CL_ProgramObject &program, int program_matrix_flags)
@@ -556,6 +569,8 @@ void CL_GL1GraphicContextProvider::set_program_object(const CL_ProgramObject &pr
 
 void CL_GL1GraphicContextProvider::reset_program_object()
 {
+	set_active();
+	cl1Disable(GL_ALPHA_TEST);
 }
 
 void CL_GL1GraphicContextProvider::set_light_model(const CL_LightModel_GL1 &light_model)
@@ -1391,6 +1406,7 @@ void CL_GL1GraphicContextProvider::set_blend_mode(const CL_BlendMode &mode)
 		cl1Disable(GL_BLEND);
 
 	const CL_Colorf &col = mode.get_blend_color();
+	blend_color_alpha = col.get_alpha();
 
 	if (cl1BlendColor)
 	{
@@ -241,5 +241,8 @@ private:
 
 	std::vector<float> transformed_coords;
 	std::vector<CL_DisposableObject *> disposable_objects;
+
+	/// \brief Alpha of the current blend color, which is the text alpha when drawing distance field glyphs
+	float blend_color_alpha;
 /// \}
 };
@@ -34,6 +34,7 @@
 #include "API/Core/System/system.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/IOData/file.h"
+#include "API/Core/Math/cl_math.h"
 #include "dns_resolver_impl.h"
 #ifdef WIN32
 #include <iphlpapi.h>
@@ -120,6 +121,14 @@ CL_DNSResolver::CL_DNSResolver()
 #endif
 }
 
+CL_DNSResolver::CL_DNSResolver(const std::vector<CL_SocketName> &dns_servers)
+: impl(new CL_DNSResolver_Impl)
+{
+	if (dns_servers.empty())
+		throw CL_Exception("No dns servers specified");
+	impl->dns_servers = dns_servers;
+}
+
 CL_DNSResolver::~CL_DNSResolver()
 {
 }
@@ -135,7 +144,83 @@ std::vector<CL_DNSResourceRecord> CL_DNSResolver::lookup_resource(
 		const CL_String &resource_type,
 		int timeout)
 {
-	CL_String dns_server = impl->dns_servers[0].get_address();
+	CL_String key = resource_type + " " + CL_StringHelp::text_to_lower(domain_name);
+
+	CL_MutexSection mutex_lock(&impl->mutex);
+	unsigned int current_time = CL_System::get_time();
+	std::map<CL_String, CL_DNSResolver_CacheEntry>::iterator it_cache = impl->cache.find(key);
+	if (it_cache != impl->cache.end())
+	{
+		if ((int)(it_cache->second.expire_time - current_time) > 0)
+		{
+			if (!it_cache->second.error_message.empty())
+				throw CL_Exception(it_cache->second.error_message);
+			return it_cache->second.records;
+		}
+		impl->cache.erase(it_cache);
+	}
+
+	// Wait for the answer if someone else is already looking up this resource
+	std::map<CL_String, CL_SharedPtr<CL_DNSResolver_PendingLookup> >::iterator it_pending = impl->pending_lookups.find(key);
+	if (it_pending != impl->pending_lookups.end())
+	{
+		CL_SharedPtr<CL_DNSResolver_PendingLookup> pending = it_pending->second;
+		mutex_lock.unlock();
+		if (!pending->event_done.wait(timeout))
+			throw CL_Exception("Unable to perform lookup");
+		if (!pending->error_message.empty())
+			throw CL_Exception(pending->error_message);
+		return pending->records;
+	}
+
+	CL_SharedPtr<CL_DNSResolver_PendingLookup> pending(new CL_DNSResolver_PendingLookup);
+	impl->pending_lookups[key] = pending;
+	mutex_lock.unlock();
+
+	int ttl = 0;
+	bool negative = false;
+	try
+	{
+		pending->records = lookup_resource_uncached(domain_name, resource_type, timeout, ttl, negative);
+	}
+	catch (const CL_Exception &e)
+	{
+		pending->error_message = e.message;
+		if (pending->error_message.empty())
+			pending->error_message = "Unable to lookup DNS resource";
+	}
+
+	mutex_lock.lock();
+	impl->pending_lookups.erase(key);
+	if (ttl > 0 && (pending->error_message.empty() || negative))
+	{
+		CL_DNSResolver_CacheEntry &entry = impl->cache[key];
+		entry.records = pending->records;
+		entry.error_message = pending->error_message;
+		entry.expire_time = CL_System::get_time() + (unsigned int) ttl * 1000;
+	}
+	mutex_lock.unlock();
+	pending->event_done.set();
+
+	if (!pending->error_message.empty())
+		throw CL_Exception(pending->error_message);
+	return pending->records;
+}
+
+void CL_DNSResolver::clear_cache()
+{
+	CL_MutexSection mutex_lock(&impl->mutex);
+	impl->cache.clear();
+}
+
+std::vector<CL_DNSResourceRecord> CL_DNSResolver::lookup_resource_uncached(
+		const CL_String &domain_name,
+		const CL_String &resource_type,
+		int timeout,
+		int &out_ttl,
+		bool &out_negative)
+{
+	CL_SocketName dns_server = impl->dns_servers[0];
 
 	for (int i=0; i<25; i++)
 	{
@@ -154,6 +239,8 @@ std::vector<CL_DNSResourceRecord> CL_DNSResolver::lookup_resource(
 		case CL_DNSPacket::response_server_failure:
 			throw CL_Exception("Unable to lookup DNS resource; server failure");
 		case CL_DNSPacket::response_name_error:
+			out_ttl = get_negative_ttl(packet);
+			out_negative = true;
 			throw CL_Exception("Unable to lookup DNS resource; name error");
 		case CL_DNSPacket::response_not_implemented:
 			throw CL_Exception("Unable to lookup DNS resource; not implemented");
@@ -188,7 +275,10 @@ std::vector<CL_DNSResourceRecord> CL_DNSResolver::lookup_resource(
 				results.push_back(record);
 		}
 		if (!results.empty())
+		{
+			out_ttl = get_ttl(results);
 			return results;
+		}
 
 		// Check for CNAME redirected answers:
 		if (!domain_name_cname.empty())
@@ -206,20 +296,30 @@ std::vector<CL_DNSResourceRecord> CL_DNSResolver::lookup_resource(
 					results.push_back(record);
 			}
 			if (!results.empty())
+			{
+				out_ttl = get_ttl(results);
 				return results;
+			}
 		}
 
 		// Does it know someone who does?
 		if (packet.get_nameserver_count() > 0)
 		{
 			CL_DNSResourceRecord rr = packet.get_nameserver(0);
-			if (rr.get_type() != "NS")
+			if (rr.get_type() == "NS")
+			{
+				dns_server = CL_SocketName(rr.get_ns_nsdname(), "53");
+				continue;
+			}
+			else if (rr.get_type() != "SOA")
+			{
 				throw CL_Exception("Unable to lookup DNS resource");
-			dns_server = rr.get_ns_nsdname();
-			continue;
+			}
 		}
 
 		// Looks like this resource does not exist.
+		out_ttl = get_negative_ttl(packet);
+		out_negative = true;
 		throw CL_Exception("DNS resource data not found");
 	}
 
@@ -231,42 +331,46 @@ CL_DNSPacket CL_DNSResolver::perform_query(
 	CL_DNSPacket &packet,
 	int timeout,
 	const CL_String &dns_server_name)
+{
+	return perform_query(packet, timeout, CL_SocketName(dns_server_name, "53"));
+}
+
+CL_DNSPacket CL_DNSResolver::perform_query(
+	CL_DNSPacket &packet,
+	int timeout,
+	const CL_SocketName &dns_server)
 {
 	CL_MutexSection mutex_lock(&impl->mutex);
 	int query_id = impl->query_id++;
 	if (impl->query_id > 0xffff)
 		impl->query_id = 0;
 	packet.set_query_id(query_id);
-	impl->queries[query_id] = packet;
+	CL_DNSResolver_Query &query = impl->queries[query_id];
+	query.question = packet;
+	CL_Event event_answered = query.event_answered;
 	mutex_lock.unlock();
 
+	// Resend the query every second until the answer arrives
 	for (int i = 0; i < timeout; i += 1000)
 	{
-		CL_SocketName dns_server(dns_server_name, "53");
 		impl->udp_socket.send(
 			packet.get_data().get_data(),
 			packet.get_data().get_size(),
 			dns_server);
 		impl->event_bound.set();
 
-		for (int j = 0; j < 10; j++)
+		if (event_answered.wait(cl_min(1000, timeout - i)))
 		{
-			CL_System::sleep(100);
 			mutex_lock.lock();
-			std::map<int, CL_DNSPacket>::iterator it;
-			it = impl->answers.find(query_id);
-			if (it != impl->answers.end())
-			{
-				CL_DNSPacket result = it->second;
-				impl->answers.erase(it);
-				impl->queries.erase(impl->queries.find(query_id));
-				return result;
-			}
-			mutex_lock.unlock();
+			std::map<int, CL_DNSResolver_Query>::iterator it = impl->queries.find(query_id);
+			CL_DNSPacket result = it->second.answer;
+			impl->queries.erase(it);
+			return result;
 		}
 	}
 
-	impl->queries.erase(impl->queries.find(query_id));
+	mutex_lock.lock();
+	impl->queries.erase(query_id);
 	throw CL_Exception("Unable to perform lookup");
 	return CL_DNSPacket();
 }
@@ -276,6 +380,15 @@ CL_DNSPacket CL_DNSResolver::perform_query(
 	const CL_String &resource_type,
 	int timeout,
 	const CL_String &dns_server_name)
+{
+	return perform_query(domain_name, resource_type, timeout, CL_SocketName(dns_server_name, "53"));
+}
+
+CL_DNSPacket CL_DNSResolver::perform_query(
+	const CL_String &domain_name,
+	const CL_String &resource_type,
+	int timeout,
+	const CL_SocketName &dns_server)
 {
 	CL_DNSPacket packet(
 		0,
@@ -284,8 +397,28 @@ CL_DNSPacket CL_DNSResolver::perform_query(
 		domain_name,
 		CL_DNSResourceRecord::type_to_int(resource_type),
 		CL_DNSResourceRecord::class_to_int("IN"));
-	return perform_query(packet, timeout, dns_server_name);
+	return perform_query(packet, timeout, dns_server);
 }
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_DNSResolver Implementation:
+
+int CL_DNSResolver::get_ttl(const std::vector<CL_DNSResourceRecord> &records)
+{
+	int ttl = records[0].get_ttl();
+	for (std::vector<CL_DNSResourceRecord>::size_type i = 1; i < records.size(); i++)
+		ttl = cl_min(ttl, records[i].get_ttl());
+	return ttl;
+}
+
+int CL_DNSResolver::get_negative_ttl(const CL_DNSPacket &packet)
+{
+	// RFC 2308: negative answers may be cached for the smaller of the SOA record's TTL and minimum field
+	for (int i = 0; i < packet.get_nameserver_count(); i++)
+	{
+		CL_DNSResourceRecord record = packet.get_nameserver(i);
+		if (record.get_type() == "SOA")
+			return cl_min(record.get_ttl(), (int) record.get_soa_minimum());
+	}
+	return CL_DNSResolver_Impl::negative_cache_ttl;
+}
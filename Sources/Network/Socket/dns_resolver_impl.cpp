@@ -35,7 +35,7 @@
 // CL_DNSResolver_Impl Construction:
 
 CL_DNSResolver_Impl::CL_DNSResolver_Impl()
-: query_id(0)
+: query_id(0), receive_buffer(64*1024)
 {
 	thread.start(this, &CL_DNSResolver_Impl::thread_main);
 }
@@ -66,17 +66,20 @@ void CL_DNSResolver_Impl::thread_main()
 		if (result != 0)
 		{
 			CL_SocketName from;
-			CL_DataBuffer buffer(64*1024);
-			int bytes_read = udp_socket.receive(buffer.get_data(), buffer.get_size(), from);
-			buffer.set_size(bytes_read);
+			int bytes_read = udp_socket.receive(receive_buffer.get_data(), receive_buffer.get_size(), from);
 			try
 			{
-				CL_DNSPacket packet(buffer);
+				// The packet keeps its data, so only the datagram itself is copied out of the receive buffer
+				CL_DNSPacket packet(CL_DataBuffer(receive_buffer.get_data(), bytes_read));
 				CL_MutexSection mutex_lock(&mutex);
 				int query_id = packet.get_query_id();
-				std::map<int, CL_DNSPacket>::iterator it = queries.find(query_id);
-				if (it != queries.end())
-					answers[query_id] = packet;
+				std::map<int, CL_DNSResolver_Query>::iterator it = queries.find(query_id);
+				if (it != queries.end() && !it->second.answered)
+				{
+					it->second.answer = packet;
+					it->second.answered = true;
+					it->second.event_answered.set();
+				}
 			}
 			catch (const CL_Exception& e)
 			{
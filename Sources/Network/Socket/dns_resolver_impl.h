@@ -35,9 +35,41 @@
 #include "API/Network/Socket/socket_name.h"
 #include "API/Network/Socket/udp_socket.h"
 #include "API/Network/Socket/dns_packet.h"
+#include "API/Network/Socket/dns_resource_record.h"
+#include "API/Core/System/databuffer.h"
+#include "API/Core/System/sharedptr.h"
 #include <vector>
 #include <map>
 
+/// \brief A query sent to a DNS server, waiting for its answer
+struct CL_DNSResolver_Query
+{
+	CL_DNSResolver_Query() : answered(false) { }
+
+	CL_DNSPacket question;
+	CL_DNSPacket answer;
+	bool answered;
+	CL_Event event_answered;
+};
+
+/// \brief Cached result of a lookup_resource call
+///
+/// An entry with an error message is a negative answer.
+struct CL_DNSResolver_CacheEntry
+{
+	std::vector<CL_DNSResourceRecord> records;
+	CL_String error_message;
+	unsigned int expire_time;
+};
+
+/// \brief A lookup in progress that other callers looking up the same resource wait for
+struct CL_DNSResolver_PendingLookup
+{
+	std::vector<CL_DNSResourceRecord> records;
+	CL_String error_message;
+	CL_Event event_done;
+};
+
 class CL_DNSResolver_Impl
 {
 /// \name Construction
@@ -58,9 +90,14 @@ public:
 
 	std::vector<CL_SocketName> dns_servers;
 
-	std::map<int, CL_DNSPacket> queries;
+	std::map<int, CL_DNSResolver_Query> queries;
+
+	std::map<CL_String, CL_DNSResolver_CacheEntry> cache;
+
+	std::map<CL_String, CL_SharedPtr<CL_DNSResolver_PendingLookup> > pending_lookups;
 
-	std::map<int, CL_DNSPacket> answers;
+	/// \brief Time to live, in seconds, of negative answers without a SOA record
+	static const int negative_cache_ttl = 60;
 
 	CL_UDPSocket udp_socket;
 
@@ -84,6 +121,7 @@ public:
 /// \{
 
 private:
+	CL_DataBuffer receive_buffer;
 /// \}
 };
 
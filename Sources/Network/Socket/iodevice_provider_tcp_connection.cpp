@@ -33,19 +33,20 @@
 #include "API/Core/Text/string_format.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/Text/logger.h"
+#include "API/Core/Math/cl_math.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_IODeviceProvider_TCPConnection Construction:
 
 CL_IODeviceProvider_TCPConnection::CL_IODeviceProvider_TCPConnection()
-: timeout(15000)
+: timeout(15000), buffered(false), read_pos(0), read_end(0), write_pos(0)
 {
 	socket.create_tcp();
 	create_events();
 }
 	
 CL_IODeviceProvider_TCPConnection::CL_IODeviceProvider_TCPConnection(const CL_SocketName &remote)
-: timeout(15000)
+: timeout(15000), buffered(false), read_pos(0), read_end(0), write_pos(0)
 {
 	socket.create_tcp();
 	create_events();
@@ -53,7 +54,7 @@ CL_IODeviceProvider_TCPConnection::CL_IODeviceProvider_TCPConnection(const CL_So
 }
 	
 CL_IODeviceProvider_TCPConnection::CL_IODeviceProvider_TCPConnection(const CL_SocketName &remote, const CL_SocketName &local)
-: timeout(15000)
+: timeout(15000), buffered(false), read_pos(0), read_end(0), write_pos(0)
 {
 	socket.create_tcp();
 	create_events();
@@ -61,7 +62,7 @@ CL_IODeviceProvider_TCPConnection::CL_IODeviceProvider_TCPConnection(const CL_So
 }
 	
 CL_IODeviceProvider_TCPConnection::CL_IODeviceProvider_TCPConnection(int handle, bool close_socket)
-: timeout(15000)
+: timeout(15000), buffered(false), read_pos(0), read_end(0), write_pos(0)
 {
 	socket.set_handle(handle, close_socket);
 	create_events();
@@ -69,6 +70,14 @@ CL_IODeviceProvider_TCPConnection::CL_IODeviceProvider_TCPConnection(int handle,
 
 CL_IODeviceProvider_TCPConnection::~CL_IODeviceProvider_TCPConnection()
 {
+	// Send what is left in the write buffer. Errors are ignored, as the connection is going away anyway
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+	}
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -129,6 +138,7 @@ void CL_IODeviceProvider_TCPConnection::disconnect_abortive()
 
 void CL_IODeviceProvider_TCPConnection::disconnect_graceful()
 {
+	flush();
 	socket.disconnect_graceful(timeout);
 }
 
@@ -142,9 +152,41 @@ void CL_IODeviceProvider_TCPConnection::set_keep_alive(bool enable, int timeout,
 	socket.set_keep_alive(enable, timeout, interval);
 }
 
+void CL_IODeviceProvider_TCPConnection::set_buffered(bool enable)
+{
+	CL_MutexSection mutex_lock(&write_mutex);
+	if (buffered && !enable)
+	{
+		flush();
+		if (read_pos != read_end)
+			throw CL_Exception("Cannot disable buffering while received data is still buffered");
+	}
+
+	buffered = enable;
+	if (buffered && read_buffer.get_size() == 0)
+	{
+		read_buffer = CL_DataBuffer(buffer_size);
+		write_buffer = CL_DataBuffer(buffer_size);
+	}
+}
+
+void CL_IODeviceProvider_TCPConnection::flush()
+{
+	CL_MutexSection mutex_lock(&write_mutex);
+	int pos = 0;
+	while (pos < write_pos)
+		pos += send_direct(write_buffer.get_data() + pos, write_pos - pos);
+	write_pos = 0;
+}
+
 int CL_IODeviceProvider_TCPConnection::send(const void *data, int len, bool send_all)
 {
-	if (!send_all)
+	if (buffered)
+	{
+		send_buffered(data, len);
+		return len;
+	}
+	else if (!send_all)
 	{
 		return socket.send(data, len);
 	}
@@ -153,18 +195,55 @@ int CL_IODeviceProvider_TCPConnection::send(const void *data, int len, bool send
 		const char *d = (const char *) data;
 		int pos = 0;
 		while (pos < len)
-		{
-			if (!write_event.wait(timeout))
-				throw CL_Exception("Send timed out");
-			pos += socket.send(d+pos, len-pos);
-		}
+			pos += send_direct(d+pos, len-pos);
 		return pos;
 	}
 }
 
 int CL_IODeviceProvider_TCPConnection::receive(void *data, int len, bool receive_all)
 {
-	if (!receive_all)
+	if (buffered)
+	{
+		char *d = (char *) data;
+		int pos = 0;
+		while (pos < len)
+		{
+			if (read_pos == read_end)
+			{
+				// Whatever the peer is waiting for must be sent before we wait for its reply
+				flush();
+
+				// Large reads go straight to the destination
+				if (len - pos >= buffer_size)
+				{
+					if (!receive_all && pos > 0)
+						break;
+					int received = receive_direct(d+pos, len-pos);
+					if (received == 0)
+						break;
+					pos += received;
+					if (!receive_all)
+						break;
+					continue;
+				}
+
+				if (!receive_all && pos > 0)
+					break;
+				if (fill_read_buffer(true) == 0)
+					break;
+			}
+
+			int available = cl_min(read_end - read_pos, len - pos);
+			memcpy(d+pos, read_buffer.get_data() + read_pos, available);
+			read_pos += available;
+			pos += available;
+		}
+
+		if (receive_all && pos < len)
+			throw CL_Exception("Unable to receive all data: connection closed by peer");
+		return pos;
+	}
+	else if (!receive_all)
 	{
 		return socket.receive(data, len);
 	}
@@ -174,9 +253,7 @@ int CL_IODeviceProvider_TCPConnection::receive(void *data, int len, bool receive
 		int pos = 0;
 		while (pos < len)
 		{
-			if (!read_event.wait(timeout))
-				throw CL_Exception("Receive timed out");
-			int received = socket.receive(d+pos, len-pos);
+			int received = receive_direct(d+pos, len-pos);
 			if (received == 0)
 				throw CL_Exception("Unable to receive all data: connection closed by peer");
 			pos += received;
@@ -187,6 +264,15 @@ int CL_IODeviceProvider_TCPConnection::receive(void *data, int len, bool receive
 
 int CL_IODeviceProvider_TCPConnection::peek(void *data, int len)
 {
+	if (buffered)
+	{
+		if (read_end - read_pos < len)
+			fill_read_buffer(false);
+
+		int available = cl_min(read_end - read_pos, len);
+		memcpy(data, read_buffer.get_data() + read_pos, available);
+		return available;
+	}
 	return socket.peek(data, len);
 }
 
@@ -211,3 +297,103 @@ void CL_IODeviceProvider_TCPConnection::create_events()
 	except_event = CL_Event(new CL_EventProvider_UnixSocket(socket.get_handle(), CL_EventProvider::type_fd_exception));
 #endif
 }
+
+int CL_IODeviceProvider_TCPConnection::send_direct(const void *data, int len)
+{
+	// Try the send first and only wait for the socket when its send buffer is full
+	while (true)
+	{
+		int sent = socket.send(data, len);
+		if (sent > 0 || len == 0)
+			return sent;
+		if (!write_event.wait(timeout))
+			throw CL_Exception("Send timed out");
+	}
+}
+
+int CL_IODeviceProvider_TCPConnection::receive_direct(void *data, int len)
+{
+	// Try the receive first and only wait for the socket when no data has arrived yet
+	while (true)
+	{
+		int received = socket.try_receive(data, len);
+		if (received != -1)
+			return received;
+		if (!read_event.wait(timeout))
+			throw CL_Exception("Receive timed out");
+	}
+}
+
+void CL_IODeviceProvider_TCPConnection::send_buffered(const void *data, int len)
+{
+	CL_MutexSection mutex_lock(&write_mutex);
+	if (write_pos + len <= buffer_size)
+	{
+		memcpy(write_buffer.get_data() + write_pos, data, len);
+		write_pos += len;
+		return;
+	}
+
+	// Send the buffered data and the new data together in one gather write
+	const char *d = (const char *) data;
+	int pos = 0;
+	while (write_pos > 0)
+	{
+		int sent = socket.send_gather(write_buffer.get_data(), write_pos, d, len);
+		if (sent == 0)
+		{
+			if (!write_event.wait(timeout))
+				throw CL_Exception("Send timed out");
+		}
+		else if (sent < write_pos)
+		{
+			memmove(write_buffer.get_data(), write_buffer.get_data() + sent, write_pos - sent);
+			write_pos -= sent;
+		}
+		else
+		{
+			pos = sent - write_pos;
+			write_pos = 0;
+		}
+	}
+
+	if (len - pos <= buffer_size)
+	{
+		memcpy(write_buffer.get_data(), d+pos, len-pos);
+		write_pos = len-pos;
+	}
+	else
+	{
+		while (pos < len)
+			pos += send_direct(d+pos, len-pos);
+	}
+}
+
+int CL_IODeviceProvider_TCPConnection::fill_read_buffer(bool wait)
+{
+	if (read_pos == read_end)
+	{
+		read_pos = 0;
+		read_end = 0;
+	}
+	else if (read_pos > 0)
+	{
+		memmove(read_buffer.get_data(), read_buffer.get_data() + read_pos, read_end - read_pos);
+		read_end -= read_pos;
+		read_pos = 0;
+	}
+
+	int received;
+	if (wait)
+	{
+		received = receive_direct(read_buffer.get_data() + read_end, buffer_size - read_end);
+	}
+	else
+	{
+		received = socket.try_receive(read_buffer.get_data() + read_end, buffer_size - read_end);
+		if (received == -1)
+			return 0;
+	}
+	read_end += received;
+	return received;
+}
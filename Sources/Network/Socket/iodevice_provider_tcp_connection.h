@@ -31,6 +31,8 @@
 
 #include "API/Core/System/event.h"
 #include "API/Core/IOData/iodevice_provider.h"
+#include "API/Core/System/databuffer.h"
+#include "API/Core/System/mutex.h"
 #ifdef WIN32
 #include "event_provider_win32socket.h"
 #include "win32_socket.h"
@@ -65,6 +67,7 @@ public:
 	CL_SocketName get_remote_name() const;
 	CL_Event get_read_event();
 	CL_Event get_write_event();
+	bool is_buffered() const { return buffered; }
 
 /// \}
 /// \name Operations
@@ -78,6 +81,8 @@ public:
 	void disconnect_abortive();
 	void set_nodelay(bool enable);
 	void set_keep_alive(bool enable, int timeout, int interval);
+	void set_buffered(bool enable);
+	void flush();
 	int send(const void *data, int len, bool send_all);
 	int receive(void *data, int len, bool receive_all);
 	int peek(void *data, int len);
@@ -89,6 +94,10 @@ public:
 
 private:
 	void create_events();
+	int send_direct(const void *data, int len);
+	int receive_direct(void *data, int len);
+	void send_buffered(const void *data, int len);
+	int fill_read_buffer(bool wait);
 
 #ifdef WIN32
 	CL_Win32Socket socket;
@@ -99,6 +108,18 @@ private:
 	CL_Event write_event;
 	CL_Event except_event;
 	int timeout;
+
+	bool buffered;
+	CL_DataBuffer read_buffer;
+	int read_pos, read_end;
+	CL_DataBuffer write_buffer;
+	int write_pos;
+
+	/// \brief Guards write_buffer and write_pos, as a receive may flush while another thread sends
+	CL_Mutex write_mutex;
+
+	/// \brief Size of the read and write buffers in buffered mode
+	static const int buffer_size = 16*1024;
 /// \}
 };
 
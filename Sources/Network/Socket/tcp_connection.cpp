@@ -93,6 +93,12 @@ CL_Event CL_TCPConnection::get_write_event()
 	return provider->get_write_event();
 }
 
+bool CL_TCPConnection::is_buffered() const
+{
+	const CL_IODeviceProvider_TCPConnection *provider = dynamic_cast<const CL_IODeviceProvider_TCPConnection*>(impl->provider);
+	return provider->is_buffered();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_TCPConnection Operations:
 
@@ -138,5 +144,17 @@ void CL_TCPConnection::set_keep_alive(bool enable, int timeout, int interval)
 	provider->set_keep_alive(enable, timeout, interval);
 }
 
+void CL_TCPConnection::set_buffered(bool enable)
+{
+	CL_IODeviceProvider_TCPConnection *provider = dynamic_cast<CL_IODeviceProvider_TCPConnection*>(impl->provider);
+	provider->set_buffered(enable);
+}
+
+void CL_TCPConnection::flush()
+{
+	CL_IODeviceProvider_TCPConnection *provider = dynamic_cast<CL_IODeviceProvider_TCPConnection*>(impl->provider);
+	provider->flush();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_TCPConnection Implementation:
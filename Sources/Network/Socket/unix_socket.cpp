@@ -34,6 +34,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -64,6 +65,7 @@ void CL_UnixSocket::set_handle(SOCKET new_handle, bool new_close_handle)
 	close_handle();
 	handle = new_handle;
 	close_handle_flag = new_close_handle;
+	set_nonblocking();
 }
 
 void CL_UnixSocket::create_tcp()
@@ -238,6 +240,19 @@ int CL_UnixSocket::peek(void *data, int size)
 	return result;
 }
 
+int CL_UnixSocket::try_receive(void *data, int size)
+{
+	int result = ::recv(handle, (char *) data, size, 0);
+	if (result == -1)
+	{
+		int errorcode = errno;
+		if (errorcode == EWOULDBLOCK || errorcode == EAGAIN)
+			return -1;
+		throw CL_Exception(error_to_string(errorcode));
+	}
+	return result;
+}
+
 int CL_UnixSocket::receive_from(void *data, int size, CL_SocketName &out_socketname)
 {
 	sockaddr_in new_addr;
@@ -281,6 +296,33 @@ int CL_UnixSocket::send(const void *data, int size)
 	}
 }
 
+int CL_UnixSocket::send_gather(const void *data1, int size1, const void *data2, int size2)
+{
+	iovec buffers[2];
+	buffers[0].iov_base = (void *) data1;
+	buffers[0].iov_len = size1;
+	buffers[1].iov_base = (void *) data2;
+	buffers[1].iov_len = size2;
+
+	int result = ::writev(handle, buffers, 2);
+	if (result == -1)
+	{
+		int errorcode = errno;
+		if (errorcode == EWOULDBLOCK || errorcode == EAGAIN)
+		{
+			return 0;
+		}
+		else
+		{
+			throw CL_Exception(error_to_string(errorcode));
+		}
+	}
+	else
+	{
+		return result;
+	}
+}
+
 int CL_UnixSocket::send_to(const void *data, int size, const CL_SocketName &socketname)
 {
 	sockaddr_in addr;
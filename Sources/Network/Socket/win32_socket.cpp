@@ -252,6 +252,23 @@ int CL_Win32Socket::receive(void *data, int size)
 	return result;
 }
 
+int CL_Win32Socket::try_receive(void *data, int size)
+{
+	int result = ::recv(handle, (char *) data, size, 0);
+	if (result == SOCKET_ERROR)
+	{
+		int errorcode = WSAGetLastError();
+		if (errorcode == WSAEWOULDBLOCK)
+		{
+			reset_receive();
+			return -1;
+		}
+		throw CL_Exception(error_to_string(errorcode));
+	}
+	reset_receive();
+	return result;
+}
+
 int CL_Win32Socket::receive_from(void *data, int size, CL_SocketName &out_socketname)
 {
 	sockaddr_in new_addr;
@@ -306,6 +323,35 @@ int CL_Win32Socket::send(const void *data, int size)
 	}
 }
 
+int CL_Win32Socket::send_gather(const void *data1, int size1, const void *data2, int size2)
+{
+	WSABUF buffers[2];
+	buffers[0].buf = (char *) data1;
+	buffers[0].len = size1;
+	buffers[1].buf = (char *) data2;
+	buffers[1].len = size2;
+
+	DWORD bytes_sent = 0;
+	int result = WSASend(handle, buffers, 2, &bytes_sent, 0, 0, 0);
+	if (result == SOCKET_ERROR)
+	{
+		int errorcode = WSAGetLastError();
+		if (errorcode == WSAEWOULDBLOCK)
+		{
+			reset_send();
+			return 0;
+		}
+		else
+		{
+			throw CL_Exception(error_to_string(errorcode));
+		}
+	}
+	else
+	{
+		return bytes_sent;
+	}
+}
+
 int CL_Win32Socket::send_to(const void *data, int size, const CL_SocketName &socketname)
 {
 	sockaddr_in addr;
@@ -61,6 +61,12 @@ public:
 	int receive(void *data, int size);
 	int peek(void *data, int size);
 	int send(const void *data, int size);
+
+	/// \brief Receives without waiting. Returns -1 if no data is available yet, 0 if the connection was closed.
+	int try_receive(void *data, int size);
+
+	/// \brief Sends two blocks of data with a single system call. Returns 0 if the send would block.
+	int send_gather(const void *data1, int size1, const void *data2, int size2);
 	void close_send();
 
 	int receive_from(void *data, int size, CL_SocketName &out_socketname);
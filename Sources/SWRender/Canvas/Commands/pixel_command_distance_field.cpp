@@ -0,0 +1,189 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "SWRender/precomp.h"
+#include "pixel_command_distance_field.h"
+#include "API/SWRender/pixel_thread_context.h"
+
+CL_PixelCommandDistanceField::CL_PixelCommandDistanceField(const CL_Vec2f init_points[3], const CL_Vec4f init_primcolor, const CL_Vec2f init_texcoords[3], int init_sampler)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		points[i] = init_points[i];
+		texcoords[i] = init_texcoords[i];
+	}
+	primcolor = init_primcolor;
+	sampler = init_sampler;
+}
+
+void CL_PixelCommandDistanceField::run(CL_PixelThreadContext *context)
+{
+	if (sampler < 0 || sampler >= CL_PixelThreadContext::max_samplers)
+		return;
+
+	const CL_PixelBufferData &texture = context->samplers[sampler];
+	if (texture.data == 0)
+		return;
+
+	CL_Rect box = get_dest_rect(context);
+	if (box.left >= box.right || box.top >= box.bottom)
+		return;
+
+	// The sprite is the parallelogram spanned by points[0], points[1] and points[2].
+	// Invert the mapping to find the sprite coordinates (u,v) of each pixel center.
+	CL_Vec2f axis_u = points[1] - points[0];
+	CL_Vec2f axis_v = points[2] - points[0];
+	float determinant = axis_u.x * axis_v.y - axis_u.y * axis_v.x;
+	if (determinant == 0.0f)
+		return;
+
+	float du_dx = axis_v.y / determinant;
+	float du_dy = -axis_v.x / determinant;
+	float dv_dx = -axis_u.y / determinant;
+	float dv_dy = axis_u.x / determinant;
+
+	CL_Vec2f tex_u = texcoords[1] - texcoords[0];
+	CL_Vec2f tex_v = texcoords[2] - texcoords[0];
+
+	// Texture coordinate steps (in texels) for one pixel in x and y
+	float width = (float)texture.size.width;
+	float height = (float)texture.size.height;
+	float dtx_dx = (tex_u.x * du_dx + tex_v.x * dv_dx) * width;
+	float dty_dx = (tex_u.y * du_dx + tex_v.y * dv_dx) * height;
+	float dtx_dy = (tex_u.x * du_dy + tex_v.x * dv_dy) * width;
+	float dty_dy = (tex_u.y * du_dy + tex_v.y * dv_dy) * height;
+
+	int red = (int)(primcolor.r * 255.0f + 0.5f);
+	int green = (int)(primcolor.g * 255.0f + 0.5f);
+	int blue = (int)(primcolor.b * 255.0f + 0.5f);
+	float alpha = primcolor.a;
+
+	int skip_lines = find_first_line_for_core(box.top, context->core, context->num_cores)-box.top;
+	for (int y = box.top + skip_lines; y < box.bottom; y += context->num_cores)
+	{
+		unsigned int *dest = context->colorbuffer0.data + y * context->colorbuffer0.size.width;
+
+		float px = box.left + 0.5f - points[0].x;
+		float py = y + 0.5f - points[0].y;
+		float u = px * du_dx + py * du_dy;
+		float v = px * dv_dx + py * dv_dy;
+
+		for (int x = box.left; x < box.right; x++, u += du_dx, v += dv_dx)
+		{
+			if (u < 0.0f || u >= 1.0f || v < 0.0f || v >= 1.0f)
+				continue;
+
+			float tx = (texcoords[0].x + tex_u.x * u + tex_v.x * v) * width;
+			float ty = (texcoords[0].y + tex_u.y * u + tex_v.y * v) * height;
+
+			// Screen space derivative of the distance, like fwidth() in the GLSL version
+			float distance = sample_distance(texture, tx, ty);
+			float distance_dx = sample_distance(texture, tx + dtx_dx, ty + dty_dx) - distance;
+			float distance_dy = sample_distance(texture, tx + dtx_dy, ty + dty_dy) - distance;
+			float smoothing = cl_clamp((fabs(distance_dx) + fabs(distance_dy)) * 0.7f, 0.001f, 0.5f);
+
+			float coverage;
+			if (distance <= 0.5f - smoothing)
+				continue;
+			else if (distance >= 0.5f + smoothing)
+				coverage = 1.0f;
+			else
+			{
+				float t = (distance - (0.5f - smoothing)) / (2.0f * smoothing);
+				coverage = t * t * (3.0f - 2.0f * t);
+			}
+
+			int src_alpha = (int)(alpha * coverage * 256.0f + 0.5f);
+			int dest_alpha = 256 - src_alpha;
+
+			unsigned int dest_pixel = dest[x];
+			int dest_a = (dest_pixel >> 24) & 0xff;
+			int dest_r = (dest_pixel >> 16) & 0xff;
+			int dest_g = (dest_pixel >> 8) & 0xff;
+			int dest_b = dest_pixel & 0xff;
+
+			int out_a = (255 * src_alpha + dest_a * dest_alpha) >> 8;
+			int out_r = (red * src_alpha + dest_r * dest_alpha) >> 8;
+			int out_g = (green * src_alpha + dest_g * dest_alpha) >> 8;
+			int out_b = (blue * src_alpha + dest_b * dest_alpha) >> 8;
+
+			dest[x] = (out_a << 24) | (out_r << 16) | (out_g << 8) | out_b;
+		}
+	}
+}
+
+float CL_PixelCommandDistanceField::sample_distance(const CL_PixelBufferData &texture, float tx, float ty)
+{
+	// Bilinear filtering of the alpha channel, clamped to the edge of the texture
+	tx -= 0.5f;
+	ty -= 0.5f;
+	int x0 = (int)floor(tx);
+	int y0 = (int)floor(ty);
+	float fx = tx - x0;
+	float fy = ty - y0;
+
+	int max_x = texture.size.width - 1;
+	int max_y = texture.size.height - 1;
+	int x1 = cl_clamp(x0 + 1, 0, max_x);
+	int y1 = cl_clamp(y0 + 1, 0, max_y);
+	x0 = cl_clamp(x0, 0, max_x);
+	y0 = cl_clamp(y0, 0, max_y);
+
+	const unsigned int *line0 = texture.data + y0 * texture.size.width;
+	const unsigned int *line1 = texture.data + y1 * texture.size.width;
+	float a00 = (float)(line0[x0] >> 24);
+	float a10 = (float)(line0[x1] >> 24);
+	float a01 = (float)(line1[x0] >> 24);
+	float a11 = (float)(line1[x1] >> 24);
+
+	float top = a00 + (a10 - a00) * fx;
+	float bottom = a01 + (a11 - a01) * fx;
+	return (top + (bottom - top) * fy) * (1.0f / 255.0f);
+}
+
+CL_Rect CL_PixelCommandDistanceField::get_dest_rect(CL_PixelThreadContext *context) const
+{
+	CL_Vec2f point3 = points[1] + points[2] - points[0];
+	float x0 = cl_min(cl_min(points[0].x, points[1].x), cl_min(points[2].x, point3.x));
+	float x1 = cl_max(cl_max(points[0].x, points[1].x), cl_max(points[2].x, point3.x));
+	float y0 = cl_min(cl_min(points[0].y, points[1].y), cl_min(points[2].y, point3.y));
+	float y1 = cl_max(cl_max(points[0].y, points[1].y), cl_max(points[2].y, point3.y));
+
+	CL_Rect dest;
+	dest.left = (int)(x0 + 0.5f);
+	dest.right = (int)(x1 - 0.5f) + 1;
+	dest.top = (int)(y0 + 0.5f);
+	dest.bottom = (int)(y1 - 0.5f) + 1;
+
+	dest.left = cl_max(cl_min(dest.left, context->clip_rect.right), context->clip_rect.left);
+	dest.right = cl_max(cl_min(dest.right, context->clip_rect.right), context->clip_rect.left);
+	dest.top = cl_max(cl_min(dest.top, context->clip_rect.bottom), context->clip_rect.top);
+	dest.bottom = cl_max(cl_min(dest.bottom, context->clip_rect.bottom), context->clip_rect.top);
+
+	return dest;
+}
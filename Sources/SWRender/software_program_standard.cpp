@@ -30,11 +30,12 @@
 #include "software_program_standard.h"
 #include "Canvas/pixel_canvas.h"
 #include "Canvas/Commands/pixel_command_sprite.h"
+#include "Canvas/Commands/pixel_command_distance_field.h"
 #include "Canvas/Commands/pixel_command_triangle.h"
 #include "Canvas/Commands/pixel_command_line.h"
 
 CL_SoftwareProgram_Standard::CL_SoftwareProgram_Standard()
-: modelview(CL_Mat4f::identity()), projection(CL_Mat4f::identity()), modelview_projection(CL_Mat4f::identity()), modelview_projection_invalid(false)
+: modelview(CL_Mat4f::identity()), projection(CL_Mat4f::identity()), modelview_projection(CL_Mat4f::identity()), modelview_projection_invalid(false), distance_field(false)
 {
 }
 
@@ -100,6 +101,8 @@ CL_PixelCommand *CL_SoftwareProgram_Standard::draw_sprite(CL_PixelPipeline *pipe
 	CL_Vec4f init_primcolor[3] = { attribute_values[3], attribute_values[4], attribute_values[5] };
 	CL_Vec2f init_texcoords[3] = { attribute_values[6], attribute_values[7], attribute_values[8] };
 	int init_sampler = (int)attribute_values[9].x;
+	if (distance_field)
+		return new(pipeline) CL_PixelCommandDistanceField(init_points, init_primcolor[0], init_texcoords, init_sampler);
 	return new(pipeline) CL_PixelCommandSprite(init_points, init_primcolor[0], init_texcoords, init_sampler);
 }
 
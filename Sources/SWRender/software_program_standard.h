@@ -47,6 +47,8 @@ public:
 
 	CL_Vec2f transform(const CL_Vec4f &vertex) const;
 
+	void set_distance_field(bool enable) { distance_field = enable; }
+
 private:
 	const CL_Mat4f &get_modelview() const { return modelview; }
 	const CL_Mat4f &get_projection() const { return projection; }
@@ -57,4 +59,5 @@ private:
 	CL_Mat4f projection;
 	mutable CL_Mat4f modelview_projection;
 	mutable bool modelview_projection_invalid;
+	bool distance_field;
 };
@@ -156,7 +156,8 @@ CL_PixelBufferProvider *CL_SWRenderGraphicContextProvider::alloc_pixel_buffer()
 void CL_SWRenderGraphicContextProvider::set_program_object(CL_StandardProgram standard_program)
 {
 	set_program_object(program_object_standard, cl_program_matrix_all_standard);
-	is_sprite_program = (standard_program == cl_program_sprite);
+	is_sprite_program = (standard_program == cl_program_sprite || standard_program == cl_program_distance_field);
+	cl_software_program_standard.set_distance_field(standard_program == cl_program_distance_field);
 }
 
 void CL_SWRenderGraphicContextProvider::set_program_object(const CL_ProgramObject &program, int program_matrix_flags)
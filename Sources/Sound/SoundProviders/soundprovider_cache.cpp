@@ -0,0 +1,237 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "API/Sound/SoundProviders/soundprovider_cache.h"
+#include "API/Core/System/mutex.h"
+#include <list>
+#include <map>
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProviderCacheData construction:
+
+CL_SoundProviderCacheData::CL_SoundProviderCacheData(int num_channels, int frequency)
+: frequency(frequency), channels(num_channels)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProviderCacheData operations:
+
+void CL_SoundProviderCacheData::append(float **data_ptr, int offset, int num_samples)
+{
+	for (size_t chan = 0; chan < channels.size(); chan++)
+		channels[chan].insert(channels[chan].end(), data_ptr[chan] + offset, data_ptr[chan] + offset + num_samples);
+}
+
+int CL_SoundProviderCacheData::get_data(int position, float **data_ptr, int offset, int data_requested) const
+{
+	int available = get_num_samples() - position;
+	if (available <= 0)
+		return 0;
+	if (data_requested > available)
+		data_requested = available;
+
+	for (size_t chan = 0; chan < channels.size(); chan++)
+		memcpy(data_ptr[chan] + offset, &channels[chan][position], data_requested * sizeof(float));
+	return data_requested;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProviderCache_Impl class:
+
+class CL_SoundProviderCache_Impl
+{
+public:
+	CL_SoundProviderCache_Impl()
+	: memory_budget(32*1024*1024), memory_used(0), hits(0), misses(0),
+	  stream_threshold(1024*1024), stream_buffer_length(2000)
+	{
+	}
+
+	void evict(int max_memory_used)
+	{
+		while (memory_used > max_memory_used && !lru.empty())
+		{
+			std::map<const void *, Entry>::iterator it = entries.find(lru.back());
+			memory_used -= it->second.memory_size;
+			entries.erase(it);
+			lru.pop_back();
+		}
+	}
+
+	struct Entry
+	{
+		CL_SharedPtr<CL_SoundProviderCacheData> data;
+		std::list<const void *>::iterator lru_it;
+		int memory_size;
+	};
+
+	CL_Mutex mutex;
+	std::map<const void *, Entry> entries;
+
+	/// \brief Keys ordered from most to least recently used.
+	std::list<const void *> lru;
+
+	int memory_budget;
+	int memory_used;
+	int hits;
+	int misses;
+	int stream_threshold;
+	int stream_buffer_length;
+};
+
+static CL_SoundProviderCache_Impl cl_sound_provider_cache;
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProviderCache attributes:
+
+int CL_SoundProviderCache::get_memory_budget()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	return cl_sound_provider_cache.memory_budget;
+}
+
+int CL_SoundProviderCache::get_memory_used()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	return cl_sound_provider_cache.memory_used;
+}
+
+int CL_SoundProviderCache::get_hits()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	return cl_sound_provider_cache.hits;
+}
+
+int CL_SoundProviderCache::get_misses()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	return cl_sound_provider_cache.misses;
+}
+
+int CL_SoundProviderCache::get_stream_threshold()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	return cl_sound_provider_cache.stream_threshold;
+}
+
+int CL_SoundProviderCache::get_stream_buffer_length()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	return cl_sound_provider_cache.stream_buffer_length;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProviderCache operations:
+
+CL_SharedPtr<CL_SoundProviderCacheData> CL_SoundProviderCache::find(const void *key)
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	std::map<const void *, CL_SoundProviderCache_Impl::Entry>::iterator it = cl_sound_provider_cache.entries.find(key);
+	if (it == cl_sound_provider_cache.entries.end())
+	{
+		cl_sound_provider_cache.misses++;
+		return CL_SharedPtr<CL_SoundProviderCacheData>();
+	}
+
+	cl_sound_provider_cache.hits++;
+	cl_sound_provider_cache.lru.splice(cl_sound_provider_cache.lru.begin(), cl_sound_provider_cache.lru, it->second.lru_it);
+	return it->second.data;
+}
+
+bool CL_SoundProviderCache::insert(const void *key, const CL_SharedPtr<CL_SoundProviderCacheData> &data)
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	int memory_size = data->get_memory_size();
+	if (memory_size > cl_sound_provider_cache.memory_budget)
+		return false;
+
+	std::map<const void *, CL_SoundProviderCache_Impl::Entry>::iterator it = cl_sound_provider_cache.entries.find(key);
+	if (it != cl_sound_provider_cache.entries.end())
+	{
+		cl_sound_provider_cache.memory_used -= it->second.memory_size;
+		cl_sound_provider_cache.lru.erase(it->second.lru_it);
+		cl_sound_provider_cache.entries.erase(it);
+	}
+
+	cl_sound_provider_cache.evict(cl_sound_provider_cache.memory_budget - memory_size);
+
+	CL_SoundProviderCache_Impl::Entry &entry = cl_sound_provider_cache.entries[key];
+	entry.data = data;
+	entry.memory_size = memory_size;
+	entry.lru_it = cl_sound_provider_cache.lru.insert(cl_sound_provider_cache.lru.begin(), key);
+	cl_sound_provider_cache.memory_used += memory_size;
+	return true;
+}
+
+void CL_SoundProviderCache::remove(const void *key)
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	std::map<const void *, CL_SoundProviderCache_Impl::Entry>::iterator it = cl_sound_provider_cache.entries.find(key);
+	if (it != cl_sound_provider_cache.entries.end())
+	{
+		cl_sound_provider_cache.memory_used -= it->second.memory_size;
+		cl_sound_provider_cache.lru.erase(it->second.lru_it);
+		cl_sound_provider_cache.entries.erase(it);
+	}
+}
+
+void CL_SoundProviderCache::clear()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	cl_sound_provider_cache.entries.clear();
+	cl_sound_provider_cache.lru.clear();
+	cl_sound_provider_cache.memory_used = 0;
+}
+
+void CL_SoundProviderCache::set_memory_budget(int bytes)
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	cl_sound_provider_cache.memory_budget = bytes;
+	cl_sound_provider_cache.evict(bytes);
+}
+
+void CL_SoundProviderCache::reset_statistics()
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	cl_sound_provider_cache.hits = 0;
+	cl_sound_provider_cache.misses = 0;
+}
+
+void CL_SoundProviderCache::set_stream_threshold(int bytes)
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	cl_sound_provider_cache.stream_threshold = bytes;
+}
+
+void CL_SoundProviderCache::set_stream_buffer_length(int milliseconds)
+{
+	CL_MutexSection mutex_lock(&cl_sound_provider_cache.mutex);
+	cl_sound_provider_cache.stream_buffer_length = milliseconds;
+}
@@ -49,7 +49,7 @@ CL_SoundProvider_Wave::CL_SoundProvider_Wave(
 {
 	CL_VirtualDirectory new_directory = virtual_directory;
 	CL_IODevice source = new_directory.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_read);
-	impl->load(source);
+	impl->load(source, stream);
 }
 
 CL_SoundProvider_Wave::CL_SoundProvider_Wave(
@@ -61,14 +61,14 @@ CL_SoundProvider_Wave::CL_SoundProvider_Wave(
 	CL_VirtualFileSystem vfs(path);
 	CL_VirtualDirectory dir = vfs.get_root_directory();
 	CL_IODevice input = dir.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_all);
-	impl->load(input);
+	impl->load(input, stream);
 }
 
 CL_SoundProvider_Wave::CL_SoundProvider_Wave(
 	CL_IODevice &file, bool stream)
 : impl(new CL_SoundProvider_Wave_Impl)
 {
-	impl->load(file);
+	impl->load(file, stream);
 }
 
 CL_SoundProvider_Wave::~CL_SoundProvider_Wave()
@@ -91,7 +91,7 @@ void CL_SoundProvider_Wave::end_session(CL_SoundProvider_Session *session)
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_Wave implementation:
 
-void CL_SoundProvider_Wave_Impl::load(CL_IODevice &source)
+void CL_SoundProvider_Wave_Impl::load(CL_IODevice &source, bool stream_from_source)
 {
 	source.set_little_endian_mode();
 
@@ -125,10 +125,27 @@ void CL_SoundProvider_Wave_Impl::load(CL_IODevice &source)
 
 	cl_ubyte32 subchunk2_size = find_subchunk("data", source, subchunk_pos, chunk_size);
 
-	data = new char[subchunk2_size];
-	source.read(data, subchunk2_size);
-
+	this->block_align = block_align;
 	num_samples = subchunk2_size / block_align;
+
+	stream = stream_from_source;
+	if (stream)
+	{
+		stream_source = source;
+		data_offset = source.get_position();
+	}
+	else
+	{
+		data = new char[subchunk2_size];
+		source.read(data, subchunk2_size);
+	}
+}
+
+int CL_SoundProvider_Wave_Impl::read_samples(int position, int num_samples, char *dest)
+{
+	CL_MutexSection mutex_lock(&stream_mutex);
+	stream_source.seek(data_offset + position * block_align);
+	return stream_source.read(dest, num_samples * block_align) / block_align;
 }
 
 unsigned int CL_SoundProvider_Wave_Impl::find_subchunk(const char *chunk, CL_IODevice &source, unsigned int file_offset, unsigned int max_offset )
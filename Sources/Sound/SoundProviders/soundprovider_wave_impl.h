@@ -29,15 +29,16 @@
 #pragma once
 
 #include "API/Sound/soundformat.h"
+#include "API/Core/IOData/iodevice.h"
+#include "API/Core/System/mutex.h"
 
 class CL_InputSourceProvider;
-class CL_IODevice;
 
 class CL_SoundProvider_Wave_Impl
 {
 public:
 	CL_SoundProvider_Wave_Impl()
-	: data(0)
+	: data(0), stream(false), data_offset(0), block_align(0)
 	{
 	}
 
@@ -46,7 +47,10 @@ public:
 		delete[] data;
 	}
 
-	void load(CL_IODevice &source);
+	void load(CL_IODevice &source, bool stream);
+
+	/// \brief Reads samples from the file when streaming. Returns the number of samples read.
+	int read_samples(int position, int num_samples, char *dest);
 
 /// \name Attributes
 /// \{
@@ -57,6 +61,14 @@ public:
 	int num_channels;
 	int num_samples;
 	int frequency;
+
+	/// \brief True if samples are read from the file on demand instead of being held in data.
+	bool stream;
+
+	CL_IODevice stream_source;
+	CL_Mutex stream_mutex;
+	int data_offset;
+	int block_align;
 /// \}
 
 private:
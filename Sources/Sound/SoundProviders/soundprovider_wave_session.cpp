@@ -31,19 +31,41 @@
 #include "soundprovider_wave_impl.h"
 #include "API/Sound/soundformat.h"
 #include "API/Sound/sound_sse.h"
+#include "API/Sound/SoundProviders/soundprovider_cache.h"
+#include "API/Core/Math/cl_math.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_Wave_Session construction:
 
 CL_SoundProvider_Wave_Session::CL_SoundProvider_Wave_Session(CL_SoundProvider_Wave &source) :
-	source(source), position(0)
+	source(source), position(0), stream_ring_size(0), stream_read_pos(0), stream_fill(0),
+	stream_load_position(0), stream_generation(0), stream_head_samples(0)
 {
 	frequency = source.impl->frequency;
 	end_position = num_samples = source.impl->num_samples;
+
+	if (source.impl->stream)
+	{
+		int block_align = source.impl->block_align;
+		stream_ring_size = cl_max(frequency * CL_SoundProviderCache::get_stream_buffer_length() / 1000, stream_block_size * 2);
+		stream_ring.resize(stream_ring_size * block_align);
+
+		// Sessions are started by the application, so the first block is read here rather than on the mixer thread
+		stream_head.resize(stream_block_size * block_align);
+		stream_head_samples = source.impl->read_samples(0, cl_min(stream_block_size, num_samples), &stream_head[0]);
+		restart_stream(0);
+
+		stream_thread.start(this, &CL_SoundProvider_Wave_Session::stream_thread_main);
+	}
 }
 
 CL_SoundProvider_Wave_Session::~CL_SoundProvider_Wave_Session()
 {
+	if (source.impl->stream)
+	{
+		stream_event_stop.set();
+		stream_thread.join();
+	}
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -89,6 +111,8 @@ bool CL_SoundProvider_Wave_Session::play()
 bool CL_SoundProvider_Wave_Session::set_position(int pos)
 {
 	position = pos;
+	if (source.impl->stream)
+		restart_stream(pos);
 	return true;
 }
 
@@ -109,37 +133,111 @@ int CL_SoundProvider_Wave_Session::get_data(float **data_ptr, int data_requested
 		block_end = end_position;
 
 	int retrieved = block_end-block_start;
+	if (retrieved <= 0)
+		return 0;
+
+	if (source.impl->stream)
+		retrieved = get_streamed_data(data_ptr, retrieved);
+	else
+		unpack_samples(source.impl->data + position * source.impl->block_align, retrieved, data_ptr, 0);
+
+	position += retrieved;
+	return retrieved;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Wave_Session implementation:
 
-	if (source.impl->format == sf_16bit_signed)
+void CL_SoundProvider_Wave_Session::unpack_samples(const char *data, int num_samples, float **data_ptr, int offset)
+{
+	if (source.impl->num_channels == 2)
 	{
-		if (source.impl->num_channels == 2)
-		{
-			short *src = ((short *) source.impl->data) + position * 2;
-			CL_SoundSSE::unpack_16bit_stereo(src, retrieved*2, data_ptr);
-		}
+		float *output[2] = { data_ptr[0] + offset, data_ptr[1] + offset };
+		if (source.impl->format == sf_16bit_signed)
+			CL_SoundSSE::unpack_16bit_stereo((short *) data, num_samples*2, output);
 		else
-		{
-			short *src = ((short *) source.impl->data) + position;
-			CL_SoundSSE::unpack_16bit_mono(src, retrieved, data_ptr[0]);
-		}
+			CL_SoundSSE::unpack_8bit_stereo((unsigned char *) data, num_samples*2, output);
 	}
 	else
 	{
-		if (source.impl->num_channels == 2)
-		{
-			unsigned char *src = ((unsigned char *) source.impl->data) + position * 2;
-			CL_SoundSSE::unpack_8bit_stereo(src, retrieved*2, data_ptr);
-		}
+		if (source.impl->format == sf_16bit_signed)
+			CL_SoundSSE::unpack_16bit_mono((short *) data, num_samples, data_ptr[0] + offset);
 		else
-		{
-			unsigned char *src = ((unsigned char *) source.impl->data) + position;
-			CL_SoundSSE::unpack_8bit_mono(src, retrieved, data_ptr[0]);
-		}
+			CL_SoundSSE::unpack_8bit_mono((unsigned char *) data, num_samples, data_ptr[0] + offset);
 	}
+}
 
-	position += retrieved;
-	return retrieved;
+int CL_SoundProvider_Wave_Session::get_streamed_data(float **data_ptr, int data_requested)
+{
+	int block_align = source.impl->block_align;
+
+	CL_MutexSection mutex_lock(&stream_mutex);
+	int received = cl_min(data_requested, stream_fill);
+	int first = cl_min(received, stream_ring_size - stream_read_pos);
+	unpack_samples(&stream_ring[stream_read_pos * block_align], first, data_ptr, 0);
+	unpack_samples(&stream_ring[0], received - first, data_ptr, first);
+	stream_read_pos = (stream_read_pos + received) % stream_ring_size;
+	stream_fill -= received;
+	stream_event_space.set();
+	return received;
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// CL_SoundProvider_Wave_Session implementation:
+void CL_SoundProvider_Wave_Session::restart_stream(int pos)
+{
+	int block_align = source.impl->block_align;
+
+	CL_MutexSection mutex_lock(&stream_mutex);
+	stream_generation++;
+	stream_read_pos = 0;
+	stream_fill = 0;
+	stream_load_position = pos;
+	if (pos >= 0 && pos < stream_head_samples)
+	{
+		stream_fill = stream_head_samples - pos;
+		memcpy(&stream_ring[0], &stream_head[pos * block_align], stream_fill * block_align);
+		stream_load_position = stream_head_samples;
+	}
+	stream_event_space.set();
+}
+
+void CL_SoundProvider_Wave_Session::stream_thread_main()
+{
+	int block_align = source.impl->block_align;
+	std::vector<char> block(stream_block_size * block_align);
+
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(stream_event_stop, stream_event_space);
+		if (wakeup_reason != 1)
+			break;
+
+		int load_position, generation, block_samples;
+		{
+			CL_MutexSection mutex_lock(&stream_mutex);
+			load_position = stream_load_position;
+			generation = stream_generation;
+			block_samples = cl_min(stream_block_size, num_samples - load_position);
+			if (block_samples <= 0 || stream_ring_size - stream_fill < block_samples)
+			{
+				stream_event_space.reset();
+				continue;
+			}
+		}
+
+		// Read without holding the lock so the mixer is never blocked by the file:
+		int read = source.impl->read_samples(load_position, block_samples, &block[0]);
+
+		CL_MutexSection mutex_lock(&stream_mutex);
+		if (generation != stream_generation)
+			continue;
+
+		int write_pos = (stream_read_pos + stream_fill) % stream_ring_size;
+		int first = cl_min(read, stream_ring_size - write_pos);
+		memcpy(&stream_ring[write_pos * block_align], &block[0], first * block_align);
+		memcpy(&stream_ring[0], &block[first * block_align], (read - first) * block_align);
+		stream_fill += read;
+
+		// A short read means the file is shorter than its header claims
+		stream_load_position = (read < block_samples) ? num_samples : load_position + read;
+	}
+}
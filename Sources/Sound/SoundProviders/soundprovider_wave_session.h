@@ -30,6 +30,10 @@
 
 #include "API/Sound/SoundProviders/soundprovider_session.h"
 #include "API/Sound/SoundProviders/soundprovider_wave.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/event.h"
+#include <vector>
 
 class CL_SoundProvider_Wave_Session : public CL_SoundProvider_Session
 {
@@ -68,12 +72,41 @@ public:
 /// \{
 
 private:
+	void unpack_samples(const char *data, int num_samples, float **data_ptr, int offset);
+	int get_streamed_data(float **data_ptr, int data_requested);
+	void restart_stream(int pos);
+	void stream_thread_main();
+
 	CL_SoundProvider_Wave source;
 
 	int position;
 	int end_position;
 	int num_samples;
 	int frequency;
+
+	/// \brief Reads ahead from the file into the stream ring when the provider is streamed.
+	///
+	/// The mixer thread only copies from the ring, so it never waits for the file.
+	CL_Thread stream_thread;
+	CL_Mutex stream_mutex;
+	CL_Event stream_event_space;
+	CL_Event stream_event_stop;
+	std::vector<char> stream_ring;
+	int stream_ring_size;
+	int stream_read_pos;
+	int stream_fill;
+
+	/// \brief Sample position in the file of the next block read by the stream thread.
+	int stream_load_position;
+
+	/// \brief Incremented by each seek, so blocks read for an earlier position are dropped.
+	int stream_generation;
+
+	/// \brief First samples of the file, so looping back to the start never waits for the stream thread.
+	std::vector<char> stream_head;
+	int stream_head_samples;
+
+	static const int stream_block_size = 4096;
 /// \}
 };
 
@@ -165,6 +165,35 @@ bool CL_SoundBuffer_Session::is_playing()
 	}
 }
 
+CL_SoundResampleQuality CL_SoundBuffer_Session::get_resample_quality() const
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		return impl->resample_quality;
+	}
+	else
+	{
+		return cl_resample_linear;
+	}
+}
+
+int CL_SoundBuffer_Session::get_priority() const
+{
+	if (impl)
+		return impl->priority;
+	else
+		return 0;
+}
+
+float CL_SoundBuffer_Session::get_attenuation() const
+{
+	if (impl)
+		return impl->attenuation;
+	else
+		return 1.0f;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundBuffer_Session operations:
 
@@ -229,6 +258,27 @@ void CL_SoundBuffer_Session::set_frequency(int new_frequency)
 		impl->frequency = new_frequency;
 }
 
+void CL_SoundBuffer_Session::set_resample_quality(CL_SoundResampleQuality quality)
+{
+	if (impl)
+	{
+		CL_MutexSection mutex_lock(&impl->mutex);
+		impl->resample_quality = quality;
+	}
+}
+
+void CL_SoundBuffer_Session::set_priority(int priority)
+{
+	if (impl)
+		impl->priority = priority;
+}
+
+void CL_SoundBuffer_Session::set_attenuation(float attenuation)
+{
+	if (impl)
+		impl->attenuation = attenuation;
+}
+
 void CL_SoundBuffer_Session::set_pan(float new_pan)
 {
 	if (impl)
@@ -35,12 +35,21 @@
 #include "API/Sound/SoundProviders/soundprovider.h"
 #include "API/Sound/SoundProviders/soundprovider_session.h"
 #include "API/Core/Text/logger.h"
+#include "API/Core/Math/cl_math.h"
+#include <cmath>
+#include <cstring>
+
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
 
 /////////////////////////////////////////////////////////////////////////////
 //! Construction:
 
 CL_SoundBuffer_Session_Impl::CL_SoundBuffer_Session_Impl(CL_SoundBuffer &soundbuffer, bool looping, CL_SoundOutput &output)
-: soundbuffer(soundbuffer), provider_session(0), output(output), volume(1.0f), pan(0.0f), looping(looping), playing(false)
+: soundbuffer(soundbuffer), provider_session(0), output(output), volume(1.0f), pan(0.0f), looping(looping), playing(false),
+  resample_quality(cl_resample_linear), priority(0), attenuation(1.0f),
+  buffer_eof_padded(false), virtual_samples(0.0), sinc_table_cutoff(0.0f)
 {
 	volume = soundbuffer.get_volume();
 	pan = soundbuffer.get_pan();
@@ -50,11 +59,14 @@ CL_SoundBuffer_Session_Impl::CL_SoundBuffer_Session_Impl(CL_SoundBuffer &soundbu
 
 	num_buffer_samples = 16*1024;
 	num_buffer_channels = provider_session->get_num_channels();
-	buffer_position = 0.0;
-	buffer_samples_written = 0;
+
+	// Room for the silence padded after the end of the stream
+	int buffer_size = num_buffer_samples + sinc_taps;
 
 	float_buffer_data = new float*[num_buffer_channels];
-	for (int i=0; i<num_buffer_channels; i++) float_buffer_data[i] = new float[num_buffer_samples];
+	for (int i=0; i<num_buffer_channels; i++)
+		float_buffer_data[i] = new float[buffer_size];
+	reset_buffer();
 
 	float_buffer_data_offsetted.resize(num_buffer_channels);
 }
@@ -80,15 +92,81 @@ CL_SoundBuffer_Session_Impl::~CL_SoundBuffer_Session_Impl()
 bool CL_SoundBuffer_Session_Impl::mix_to(float **sample_data, float **temp_data, int num_samples, int num_channels)
 {
 	CL_MutexSection mutex_lock(&mutex);
+	if (virtual_samples > 0.0)
+		apply_virtual_samples();
 	get_data_in_mixer_frequency(num_samples, temp_data);
 	run_filters(temp_data, num_samples);
 	mix_channels(num_channels, num_samples, sample_data, temp_data);
 	return playing;
 }
 
+bool CL_SoundBuffer_Session_Impl::advance(int num_samples)
+{
+	CL_MutexSection mutex_lock(&mutex);
+	if (!playing)
+		return false;
+
+	virtual_samples += num_samples * (frequency / double(output.get_mixing_frequency()));
+
+	// Sessions with a known length end, or wrap around when looping, while virtual:
+	int length = provider_session->get_num_samples();
+	if (length > 0 && get_stream_position() + virtual_samples >= length)
+	{
+		if (looping)
+		{
+			apply_virtual_samples();
+		}
+		else
+		{
+			playing = false;
+		}
+	}
+	return playing;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundBuffer_Session_Impl implementation:
 
+void CL_SoundBuffer_Session_Impl::reset_buffer()
+{
+	// The buffers start with silence so the filters have history for the first samples
+	for (int chan = 0; chan < num_buffer_channels; chan++)
+		memset(float_buffer_data[chan], 0, (num_buffer_samples + sinc_taps) * sizeof(float));
+	buffer_position = resample_history;
+	buffer_samples_written = resample_history;
+	buffer_eof_padded = false;
+}
+
+double CL_SoundBuffer_Session_Impl::get_stream_position() const
+{
+	int buffered_end = buffer_samples_written - (buffer_eof_padded ? resample_lookahead : 0);
+	return provider_session->get_position() - (buffered_end - buffer_position);
+}
+
+void CL_SoundBuffer_Session_Impl::apply_virtual_samples()
+{
+	if (buffer_position + virtual_samples < buffer_samples_written - resample_lookahead)
+	{
+		// Still inside the buffered data
+		buffer_position += virtual_samples;
+	}
+	else
+	{
+		int length = provider_session->get_num_samples();
+		double target = get_stream_position() + virtual_samples;
+		if (looping && length > 0)
+			target = fmod(target, double(length));
+
+		if (provider_session->set_position(int(target)))
+		{
+			reset_buffer();
+			buffer_position += target - floor(target);
+		}
+	}
+	virtual_samples = 0.0;
+}
+
+
 void CL_SoundBuffer_Session_Impl::get_data()
 {
 	int num_session_channels = provider_session->get_num_channels();
@@ -100,8 +178,8 @@ void CL_SoundBuffer_Session_Impl::get_data()
 
 	if (num_session_channels > 0)
 	{
-		// Copy stream data to working buffer:
-		int samples_left = num_buffer_samples;
+		// Append stream data to working buffer:
+		int samples_left = num_buffer_samples - buffer_samples_written;
 		while (samples_left > 0)
 		{
 			for (int i = 0; i < num_session_channels; i++)
@@ -141,49 +219,215 @@ void CL_SoundBuffer_Session_Impl::get_data()
 	}
 }
 
+bool CL_SoundBuffer_Session_Impl::fill_buffer()
+{
+	if (buffer_eof_padded)
+	{
+		if (provider_session->eof())
+			return false;
+
+		// Stream was restarted after reaching its end. Drop the silence padding.
+		buffer_samples_written -= resample_lookahead;
+		buffer_eof_padded = false;
+	}
+
+	// Move the unconsumed samples, and the history needed by the filters, to the beginning of the buffers:
+	int discard = cl_min(int(buffer_position) - resample_history, buffer_samples_written);
+	if (discard > 0)
+	{
+		for (int chan = 0; chan < num_buffer_channels; chan++)
+			memmove(float_buffer_data[chan], float_buffer_data[chan] + discard, (buffer_samples_written - discard) * sizeof(float));
+		buffer_samples_written -= discard;
+		buffer_position -= discard;
+	}
+
+	int samples_before = buffer_samples_written;
+	get_data();
+	if (buffer_samples_written == samples_before)
+	{
+		if (!provider_session->eof())
+			return false;
+
+		// Pad with silence so the last samples of the stream can be interpolated
+		for (int chan = 0; chan < num_buffer_channels; chan++)
+			memset(float_buffer_data[chan] + buffer_samples_written, 0, resample_lookahead * sizeof(float));
+		buffer_samples_written += resample_lookahead;
+		buffer_eof_padded = true;
+	}
+	return true;
+}
+
+int CL_SoundBuffer_Session_Impl::get_resample_block_size(double speed, int max_samples) const
+{
+	// Each output sample at position p reads input samples up to int(p) + resample_lookahead
+	double available = buffer_samples_written - resample_lookahead - buffer_position;
+	if (available <= 0.0)
+		return 0;
+	if (speed <= 0.0)
+		return max_samples;
+
+	int block_size = cl_min(int(ceil(available / speed)), max_samples);
+	while (block_size > 0 && int(buffer_position + (block_size - 1) * speed) + resample_lookahead >= buffer_samples_written)
+		block_size--;
+	return block_size;
+}
+
 void CL_SoundBuffer_Session_Impl::get_data_in_mixer_frequency(int num_samples, float **temp_data)
 {
 	// Convert from session frequency to mixer frequency:
-	// This is done by copying data from the temporary session buffers (buffer_data) to
-	// the temporary mixing buffers (temp_data), and if buffer_data is exhausted, calling
-	// get_data() to fill it with new data from the soundprovider session object.
+	// This is done by resampling data from the temporary session buffers (buffer_data) to
+	// the temporary mixing buffers (temp_data) one block at a time. When buffer_data runs
+	// out, fill_buffer() calls get_data() to fetch new data from the soundprovider session object.
 	double speed = frequency / double(output.get_mixing_frequency());
-	int sample_count;
-	for (sample_count = 0; sample_count < num_samples; sample_count++)
+	int sample_count = 0;
+	while (sample_count < num_samples)
 	{
-		if (buffer_position < buffer_samples_written)
+		int block_size = get_resample_block_size(speed, num_samples - sample_count);
+		if (block_size == 0)
 		{
-			for (int chan = 0; chan < num_buffer_channels; chan++)
+			if (!fill_buffer())
 			{
-				temp_data[chan][sample_count] = float_buffer_data[chan][int(buffer_position)];
-			}
-		}
-		else
-		{
-			if (provider_session->eof())
-			{
-				playing = false;
+				if (provider_session->eof())
+					playing = false;
 				break;
 			}
-
-			// Out of data, get more from provider:
-			buffer_position -= buffer_samples_written;
-			get_data();
-			sample_count--;
 			continue;
 		}
 
-		buffer_position += speed;
+		for (int chan = 0; chan < num_buffer_channels; chan++)
+		{
+			float *output_data = temp_data[chan] + sample_count;
+			if (speed == 1.0 && buffer_position == floor(buffer_position))
+				CL_SoundSSE::copy_float(float_buffer_data[chan] + int(buffer_position), block_size, output_data);
+			else if (resample_quality == cl_resample_sinc)
+				resample_sinc(float_buffer_data[chan], buffer_position, speed, block_size, output_data);
+			else
+				resample_linear(float_buffer_data[chan], buffer_position, speed, block_size, output_data);
+		}
+
+		buffer_position += block_size * speed;
+		sample_count += block_size;
 	}
 
 	// Clear the remaining samples (if any)
-	for (; sample_count < num_samples; sample_count++)
+	for (int chan = 0; chan < num_buffer_channels; chan++)
+		CL_SoundSSE::set_float(temp_data[chan] + sample_count, num_samples - sample_count, 0.0f);
+}
+
+void CL_SoundBuffer_Session_Impl::resample_linear(const float *input, double position, double speed, int num_samples, float *output)
+{
+	int i = 0;
+#ifndef CL_DISABLE_SSE2
+	int sse_size = (num_samples/4)*4;
+
+	__m128d position0 = _mm_set1_pd(position);
+	__m128d speed0 = _mm_set1_pd(speed);
+	__m128d offset01 = _mm_set_pd(1.0, 0.0);
+	__m128d offset23 = _mm_set_pd(3.0, 2.0);
+	for (; i < sse_size; i+=4)
 	{
-		for (int chan = 0; chan < num_buffer_channels; chan++)
+		__m128d index = _mm_set1_pd(i);
+		__m128d pos01 = _mm_add_pd(position0, _mm_mul_pd(_mm_add_pd(index, offset01), speed0));
+		__m128d pos23 = _mm_add_pd(position0, _mm_mul_pd(_mm_add_pd(index, offset23), speed0));
+		__m128i ipos01 = _mm_cvttpd_epi32(pos01);
+		__m128i ipos23 = _mm_cvttpd_epi32(pos23);
+		__m128 frac01 = _mm_cvtpd_ps(_mm_sub_pd(pos01, _mm_cvtepi32_pd(ipos01)));
+		__m128 frac23 = _mm_cvtpd_ps(_mm_sub_pd(pos23, _mm_cvtepi32_pd(ipos23)));
+		__m128 frac = _mm_movelh_ps(frac01, frac23);
+
+		int i0 = _mm_cvtsi128_si32(ipos01);
+		int i1 = _mm_cvtsi128_si32(_mm_srli_si128(ipos01, 4));
+		int i2 = _mm_cvtsi128_si32(ipos23);
+		int i3 = _mm_cvtsi128_si32(_mm_srli_si128(ipos23, 4));
+
+		__m128 a = _mm_set_ps(input[i3], input[i2], input[i1], input[i0]);
+		__m128 b = _mm_set_ps(input[i3+1], input[i2+1], input[i1+1], input[i0+1]);
+		_mm_storeu_ps(output+i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), frac)));
+	}
+#endif
+
+	for (; i < num_samples; i++)
+	{
+		double pos = position + i * speed;
+		int ipos = int(pos);
+		float frac = float(pos - ipos);
+		output[i] = input[ipos] + (input[ipos+1] - input[ipos]) * frac;
+	}
+}
+
+void CL_SoundBuffer_Session_Impl::resample_sinc(const float *input, double position, double speed, int num_samples, float *output)
+{
+	// Lower the cutoff when downsampling to avoid aliasing
+	update_sinc_table(speed > 1.0 ? float(1.0 / speed) : 1.0f);
+	const float *table = &sinc_table[0];
+
+	for (int i = 0; i < num_samples; i++)
+	{
+		double pos = position + i * speed;
+		int ipos = int(pos);
+		float phase_pos = float(pos - ipos) * sinc_phases;
+		int phase = cl_min(int(phase_pos), sinc_phases - 1);
+		float phase_frac = phase_pos - phase;
+
+		const float *coefficients0 = table + phase * sinc_taps;
+		const float *coefficients1 = coefficients0 + sinc_taps;
+		const float *window = input + ipos - resample_history;
+
+#ifndef CL_DISABLE_SSE2
+		__m128 frac0 = _mm_set1_ps(phase_frac);
+		__m128 sum = _mm_setzero_ps();
+		for (int tap = 0; tap < sinc_taps; tap += 4)
+		{
+			__m128 c0 = _mm_loadu_ps(coefficients0 + tap);
+			__m128 c1 = _mm_loadu_ps(coefficients1 + tap);
+			__m128 c = _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(c1, c0), frac0));
+			sum = _mm_add_ps(sum, _mm_mul_ps(c, _mm_loadu_ps(window + tap)));
+		}
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1,1,1,1)));
+		_mm_store_ss(output + i, sum);
+#else
+		float sum = 0.0f;
+		for (int tap = 0; tap < sinc_taps; tap++)
 		{
-			temp_data[chan][sample_count] = 0.0f;
+			float c = coefficients0[tap] + (coefficients1[tap] - coefficients0[tap]) * phase_frac;
+			sum += c * window[tap];
 		}
+		output[i] = sum;
+#endif
+	}
+}
+
+void CL_SoundBuffer_Session_Impl::update_sinc_table(float cutoff)
+{
+	if (cutoff == sinc_table_cutoff)
+		return;
+
+	const double pi = 3.14159265358979323846;
+	const double half_width = sinc_taps / 2;
+
+	sinc_table.resize((sinc_phases + 1) * sinc_taps);
+	for (int phase = 0; phase <= sinc_phases; phase++)
+	{
+		float *coefficients = &sinc_table[phase * sinc_taps];
+		double frac = phase / double(sinc_phases);
+		double total = 0.0;
+		for (int tap = 0; tap < sinc_taps; tap++)
+		{
+			// Distance from the interpolated position to input sample 'tap'
+			double x = (tap - resample_history) - frac;
+			double sinc = (x == 0.0) ? 1.0 : sin(pi * cutoff * x) / (pi * cutoff * x);
+			double t = x / half_width;
+			double blackman = (fabs(t) < 1.0) ? 0.42 + 0.5 * cos(pi * t) + 0.08 * cos(2.0 * pi * t) : 0.0;
+			coefficients[tap] = float(sinc * blackman);
+			total += coefficients[tap];
+		}
+
+		// Normalize to unity gain
+		for (int tap = 0; tap < sinc_taps; tap++)
+			coefficients[tap] = float(coefficients[tap] / total);
 	}
+	sinc_table_cutoff = cutoff;
 }
 
 void CL_SoundBuffer_Session_Impl::run_filters(float **temp_data, int num_samples)
@@ -205,8 +449,8 @@ void CL_SoundBuffer_Session_Impl::get_channel_volume(float *channel_volume)
 	if (volume < 0.0f) volume = 0.0f;
 	if (volume > 1.0f) volume = 1.0f;
 
-	float left_volume = volume * left_pan;
-	float right_volume = volume * right_pan;
+	float left_volume = volume * attenuation * left_pan;
+	float right_volume = volume * attenuation * right_pan;
 
 	channel_volume[0] = left_volume;
 	channel_volume[1] = right_volume;
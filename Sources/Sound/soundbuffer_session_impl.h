@@ -34,6 +34,7 @@
 #include "API/Sound/soundformat.h"
 #include "API/Sound/soundoutput.h"
 #include "API/Sound/soundbuffer.h"
+#include "API/Sound/soundbuffer_session.h"
 
 class CL_SoundFilter;
 class CL_SoundBuffer_Impl;
@@ -67,6 +68,9 @@ public:
 	float pan;
 	bool looping;
 	bool playing;
+	CL_SoundResampleQuality resample_quality;
+	int priority;
+	float attenuation;
 	std::vector<CL_SoundFilter> filters;
 	mutable CL_Mutex mutex;
 
@@ -78,6 +82,14 @@ public:
 public:
 	bool mix_to(float **sample_data, float **temp_data, int num_samples, int num_channels);
 
+	/// \brief Advances the playback position without mixing, used while the session is virtual.
+	///
+	/// \return false if the session reached its end.
+	bool advance(int num_samples);
+
+	/// \brief Returns how loud the session is, ignoring panning and filters.
+	float get_audibility() const { return volume * attenuation; }
+
 /// \}
 /// \name Implementation
 /// \{
@@ -98,6 +110,33 @@ private:
 	/// \brief Fills temporary buffers with data from provider.
 	void get_data();
 
+	/// \brief Empties the temporary buffers, leaving only silent filter history.
+	void reset_buffer();
+
+	/// \brief Returns the provider position of the sample currently being played.
+	double get_stream_position() const;
+
+	/// \brief Applies the position advanced while virtual before mixing again.
+	void apply_virtual_samples();
+
+	/// \brief Discards consumed samples and reads more data from the provider.
+	///
+	/// Pads the buffers with silence when the end of the stream is reached.
+	/// \return false if no more data could be added.
+	bool fill_buffer();
+
+	/// \brief Returns how many output samples can be produced before the buffers must be refilled.
+	int get_resample_block_size(double speed, int max_samples) const;
+
+	/// \brief Resamples a block from the temporary buffers using linear interpolation.
+	void resample_linear(const float *input, double position, double speed, int num_samples, float *output);
+
+	/// \brief Resamples a block from the temporary buffers using the windowed sinc filter.
+	void resample_sinc(const float *input, double position, double speed, int num_samples, float *output);
+
+	/// \brief Recalculates sinc_table if the filter cutoff changed.
+	void update_sinc_table(float cutoff);
+
 	/// \brief Temporary channel buffers containing sound data in provider frequency.
 	float **float_buffer_data;
 
@@ -114,6 +153,30 @@ private:
 
 	/// \brief Number of samples currently written to buffer_data.
 	int buffer_samples_written;
+
+	/// \brief True if buffer_data has been padded with silence after the end of the stream.
+	bool buffer_eof_padded;
+
+	/// \brief Provider samples skipped while the session was virtual, not yet applied.
+	double virtual_samples;
+
+	/// \brief Number of sinc filter taps.
+	static const int sinc_taps = 16;
+
+	/// \brief Number of filter phases stored in sinc_table.
+	static const int sinc_phases = 32;
+
+	/// \brief Samples kept before the playback position for the interpolation filters.
+	static const int resample_history = sinc_taps/2 - 1;
+
+	/// \brief Samples required after the playback position for the interpolation filters.
+	static const int resample_lookahead = sinc_taps/2;
+
+	/// \brief Windowed sinc coefficients, sinc_taps for each of sinc_phases+1 phases.
+	std::vector<float> sinc_table;
+
+	/// \brief Filter cutoff (relative to the session nyquist frequency) sinc_table was built for.
+	float sinc_table_cutoff;
 /// \}
 };
 
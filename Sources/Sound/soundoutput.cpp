@@ -97,6 +97,8 @@ CL_SoundOutput::CL_SoundOutput(const CL_SoundOutput_Description &desc)
 #endif
 #endif
 #endif
+	impl->set_mixer_threads(desc.get_mixer_threads());
+	impl->set_max_real_voices(desc.get_max_real_voices());
 	CL_Sound::select_output(*this);
 }
 
@@ -152,24 +154,20 @@ float CL_SoundOutput::get_global_pan() const
 
 void CL_SoundOutput::stop_all()
 {
+	if (impl)
+		impl->stop_all();
 }
 	
 void CL_SoundOutput::set_global_volume(float volume)
 {
 	if (impl)
-	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		impl->volume = volume;
-	}
+		impl->set_volume(volume);
 }
 
 void CL_SoundOutput::set_global_pan(float pan)
 {
 	if (impl)
-	{
-		CL_MutexSection mutex_lock(&impl->mutex);
-		impl->pan = pan;
-	}
+		impl->set_pan(pan);
 }
 
 void CL_SoundOutput::add_filter(CL_SoundFilter &filter)
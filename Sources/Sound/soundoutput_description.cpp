@@ -39,6 +39,10 @@ public:
 	int mixing_frequency;
 
 	int mixing_latency;
+
+	int mixer_threads;
+
+	int max_real_voices;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -48,6 +52,8 @@ CL_SoundOutput_Description::CL_SoundOutput_Description() : impl(new CL_SoundOutp
 {
 	impl->mixing_frequency = 44100;
 	impl->mixing_latency = 50;
+	impl->mixer_threads = 1;
+	impl->max_real_voices = 0;
 }
 
 CL_SoundOutput_Description::~CL_SoundOutput_Description()
@@ -67,6 +73,16 @@ int CL_SoundOutput_Description::get_mixing_latency() const
 	return impl->mixing_latency;
 }
 
+int CL_SoundOutput_Description::get_mixer_threads() const
+{
+	return impl->mixer_threads;
+}
+
+int CL_SoundOutput_Description::get_max_real_voices() const
+{
+	return impl->max_real_voices;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundOutput_Description operations:
 
@@ -80,5 +96,15 @@ void CL_SoundOutput_Description::set_mixing_latency(int latency)
 	impl->mixing_latency = latency;
 }
 
+void CL_SoundOutput_Description::set_mixer_threads(int num_threads)
+{
+	impl->mixer_threads = num_threads;
+}
+
+void CL_SoundOutput_Description::set_max_real_voices(int max_voices)
+{
+	impl->max_real_voices = max_voices;
+}
+
 // CL_SoundOutput_Description implementation:
 /////////////////////////////////////////////////////////////////////////////
@@ -32,6 +32,7 @@
 #include "API/Sound/soundfilter.h"
 #include <algorithm>
 #include "API/Sound/sound_sse.h"
+#include "API/Core/System/system.h"
 
 CL_Mutex CL_SoundOutput_Impl::singleton_mutex;
 CL_SoundOutput_Impl *CL_SoundOutput_Impl::instance = 0;
@@ -41,7 +42,7 @@ CL_SoundOutput_Impl *CL_SoundOutput_Impl::instance = 0;
 
 CL_SoundOutput_Impl::CL_SoundOutput_Impl(int mixing_frequency, int latency)
 : mixing_frequency(mixing_frequency), mixing_latency(latency), volume(1.0f),
-  pan(0.0f), mix_buffer_size(0)
+  pan(0.0f), max_real_voices(0), mix_buffer_size(0), command_reader_index(0), mixer_thread_running(false), mixer_threads(1), worker_buffer_size(0)
 {
  	mix_buffers[0] = 0;
 	mix_buffers[1] = 0;
@@ -49,6 +50,10 @@ CL_SoundOutput_Impl::CL_SoundOutput_Impl(int mixing_frequency, int latency)
 	temp_buffers[1] = 0;
 	stereo_buffer = 0;
 
+	command_sequence.resize(command_queue_size);
+	for (int i = 0; i < command_queue_size; i++)
+		command_sequence[i].set(i);
+
 	CL_MutexSection lock(&singleton_mutex);
 	if (instance)
 		throw CL_Exception("Only a single instance of CL_SoundOutput is allowed");
@@ -58,6 +63,8 @@ CL_SoundOutput_Impl::CL_SoundOutput_Impl(int mixing_frequency, int latency)
 
 CL_SoundOutput_Impl::~CL_SoundOutput_Impl()
 {
+	stop_mixer_workers();
+
 	CL_SoundSSE::aligned_free(stereo_buffer);
 	CL_SoundSSE::aligned_free(mix_buffers[0]);
 	CL_SoundSSE::aligned_free(mix_buffers[1]);
@@ -77,27 +84,44 @@ CL_SoundOutput_Impl::~CL_SoundOutput_Impl()
 
 void CL_SoundOutput_Impl::play_session(CL_SoundBuffer_Session &session)
 {
-	CL_MutexSection mutex_lock(&mutex);
-	sessions.push_back(session);
+	queue_command(CL_SoundOutput_Command(CL_SoundOutput_Command::type_play, session));
 }
 
 void CL_SoundOutput_Impl::stop_session(CL_SoundBuffer_Session &session)
 {
-	CL_MutexSection mutex_lock(&mutex);
+	queue_command(CL_SoundOutput_Command(CL_SoundOutput_Command::type_stop, session));
+}
 
-	for (std::vector<CL_SoundBuffer_Session>::iterator it = sessions.begin(); it != sessions.end(); ++it)
-	{
-		if (session.impl.get() == it->impl.get())
-		{
-			sessions.erase(it);
-			break;
-		}
-	}
+void CL_SoundOutput_Impl::stop_all()
+{
+	queue_command(CL_SoundOutput_Command(CL_SoundOutput_Command::type_stop_all));
+}
+
+void CL_SoundOutput_Impl::set_volume(float new_volume)
+{
+	queue_command(CL_SoundOutput_Command(CL_SoundOutput_Command::type_set_volume, new_volume));
+}
+
+void CL_SoundOutput_Impl::set_pan(float new_pan)
+{
+	queue_command(CL_SoundOutput_Command(CL_SoundOutput_Command::type_set_pan, new_pan));
+}
+
+void CL_SoundOutput_Impl::set_mixer_threads(int num_threads)
+{
+	queue_command(CL_SoundOutput_Command(CL_SoundOutput_Command::type_set_mixer_threads, (float) num_threads));
+}
+
+void CL_SoundOutput_Impl::set_max_real_voices(int max_voices)
+{
+	queue_command(CL_SoundOutput_Command(CL_SoundOutput_Command::type_set_max_real_voices, (float) max_voices));
 }
 
 void CL_SoundOutput_Impl::start_mixer_thread()
 {
+	CL_MutexSection mutex_lock(&mutex);
 	thread.start(this, &CL_SoundOutput_Impl::mixer_thread);
+	mixer_thread_running = true;
 //	thread.set_priority(cl_priority_highest);
 }
 
@@ -108,6 +132,8 @@ void CL_SoundOutput_Impl::stop_mixer_thread()
 	mutex_lock.unlock();
 	thread.join();
 	thread = CL_Thread();
+	mutex_lock.lock();
+	mixer_thread_running = false;
 }
 
 void CL_SoundOutput_Impl::mix_fragment()
@@ -184,19 +210,287 @@ void CL_SoundOutput_Impl::clear_mix_buffers()
 
 void CL_SoundOutput_Impl::fill_mix_buffers()
 {
-	CL_MutexSection mutex_lock(&mutex);
+	process_commands();
+	update_mixer_workers();
+
 	std::vector< CL_SoundBuffer_Session > ended_sessions;
-	std::vector< CL_SoundBuffer_Session >::iterator it;
-	for (it = sessions.begin(); it != sessions.end(); ++it)
+	select_real_sessions(ended_sessions);
+
+	if (mixer_workers.empty())
 	{
-		CL_SoundBuffer_Session session = *it;
-		bool playing = session.impl->mix_to(mix_buffers, temp_buffers, mix_buffer_size, 2);
-		if (!playing) ended_sessions.push_back(session);
+		mix_sessions(0, 1, mix_buffers, temp_buffers, ended_sessions);
+	}
+	else
+	{
+		// The mixer thread takes the first share of the sessions and the workers take the rest:
+		for (std::vector< CL_SharedPtr<CL_SoundOutput_MixerWorker> >::size_type i = 0; i < mixer_workers.size(); i++)
+			mixer_workers[i]->event_start.set();
+
+		mix_sessions(0, mixer_workers.size() + 1, mix_buffers, temp_buffers, ended_sessions);
+
+		for (std::vector< CL_SharedPtr<CL_SoundOutput_MixerWorker> >::size_type i = 0; i < mixer_workers.size(); i++)
+		{
+			CL_SoundOutput_MixerWorker *worker = mixer_workers[i].get();
+			worker->event_done.wait();
+			worker->event_done.reset();
+
+			CL_SoundSSE::mix_one_to_one(worker->mix_buffers[0], mix_buffer_size, mix_buffers[0], 1.0f);
+			CL_SoundSSE::mix_one_to_one(worker->mix_buffers[1], mix_buffer_size, mix_buffers[1], 1.0f);
+			ended_sessions.insert(ended_sessions.end(), worker->ended_sessions.begin(), worker->ended_sessions.end());
+			worker->ended_sessions.clear();
+		}
 	}
+	real_sessions.clear();
 
 	// Release any sessions pending for removal:
-	int size_ended_sessions = ended_sessions.size();
-	for (int i = 0; i < size_ended_sessions; i++) stop_session(ended_sessions[i]);
+	for (std::vector< CL_SoundBuffer_Session >::size_type i = 0; i < ended_sessions.size(); i++)
+		remove_session(ended_sessions[i]);
+}
+
+void CL_SoundOutput_Impl::select_real_sessions(std::vector<CL_SoundBuffer_Session> &ended_sessions)
+{
+	int num_sessions = sessions.size();
+	real_sessions.clear();
+	if (max_real_voices <= 0 || num_sessions <= max_real_voices)
+	{
+		for (int i = 0; i < num_sessions; i++)
+			real_sessions.push_back(i);
+		return;
+	}
+
+	// Application threads may change the priority and volume at any time, so sort a snapshot of them
+	session_keys.clear();
+	for (int i = 0; i < num_sessions; i++)
+	{
+		CL_SoundBuffer_Session_Impl *impl = sessions[i].impl.get();
+		CL_MutexSection session_lock(&impl->mutex);
+		session_keys.push_back(CL_SoundOutput_SessionKey(impl->priority, impl->get_audibility(), i));
+	}
+
+	// Keep the most important sessions, and only advance the position of the rest:
+	std::sort(session_keys.begin(), session_keys.end(), &CL_SoundOutput_Impl::is_more_important);
+	for (int i = 0; i < max_real_voices; i++)
+		real_sessions.push_back(session_keys[i].index);
+	for (int i = max_real_voices; i < num_sessions; i++)
+	{
+		CL_SoundBuffer_Session &session = sessions[session_keys[i].index];
+		if (!session.impl->advance(mix_buffer_size))
+			ended_sessions.push_back(session);
+	}
+}
+
+bool CL_SoundOutput_Impl::is_more_important(const CL_SoundOutput_SessionKey &a, const CL_SoundOutput_SessionKey &b)
+{
+	if (a.priority != b.priority)
+		return a.priority > b.priority;
+	return a.audibility > b.audibility;
+}
+
+void CL_SoundOutput_Impl::mix_sessions(int first, int stride, float **target_buffers, float **target_temp_buffers, std::vector<CL_SoundBuffer_Session> &ended_sessions)
+{
+	int num_sessions = real_sessions.size();
+	for (int i = first; i < num_sessions; i += stride)
+	{
+		CL_SoundBuffer_Session &session = sessions[real_sessions[i]];
+		bool playing = session.impl->mix_to(target_buffers, target_temp_buffers, mix_buffer_size, 2);
+		if (!playing)
+			ended_sessions.push_back(session);
+	}
+}
+
+void CL_SoundOutput_Impl::remove_session(const CL_SoundBuffer_Session &session)
+{
+	for (std::vector<CL_SoundBuffer_Session>::iterator it = sessions.begin(); it != sessions.end(); ++it)
+	{
+		if (session.impl.get() == it->impl.get())
+		{
+			sessions.erase(it);
+			break;
+		}
+	}
+}
+
+void CL_SoundOutput_Impl::queue_command(const CL_SoundOutput_Command &command)
+{
+	// Commands queue behind any overflowed ones to keep them in order
+	if (command_overflow_pending.get() == 0 && try_queue_command(command))
+		return;
+
+	CL_MutexSection mutex_lock(&mutex);
+	if (mixer_thread_running)
+	{
+		command_overflow.push_back(command);
+		command_overflow_pending.set(1);
+	}
+	else
+	{
+		// Nothing drains the queue without a mixer thread, so apply the commands here
+		process_commands();
+		execute_command(command);
+	}
+}
+
+bool CL_SoundOutput_Impl::try_queue_command(const CL_SoundOutput_Command &command)
+{
+	while (true)
+	{
+		unsigned int ticket = (unsigned int) command_writer_index.get();
+		int slot = ticket % command_queue_size;
+		unsigned int sequence = (unsigned int) command_sequence[slot].get();
+		if (sequence == ticket)
+		{
+			// Claim the ticket unless another writer got it first
+			if (command_writer_index.compare_and_swap((int) ticket, (int) (ticket + 1)))
+			{
+				command_queue[slot] = command;
+				command_sequence[slot].set((int) (ticket + 1));
+				return true;
+			}
+		}
+		else if ((int) (sequence - ticket) < 0)
+		{
+			// The slot still holds a command from the previous lap
+			return false;
+		}
+	}
+}
+
+void CL_SoundOutput_Impl::process_commands()
+{
+	while (true)
+	{
+		int slot = command_reader_index % command_queue_size;
+		if (command_sequence[slot].get() != (int) (command_reader_index + 1))
+			break;
+
+		CL_SoundOutput_Command command = command_queue[slot];
+		command_queue[slot].session = CL_SoundBuffer_Session();
+		command_sequence[slot].set((int) (command_reader_index + command_queue_size));
+		command_reader_index++;
+
+		execute_command(command);
+	}
+
+	if (command_overflow_pending.get() != 0)
+	{
+		std::vector<CL_SoundOutput_Command> commands;
+		CL_MutexSection mutex_lock(&mutex);
+		commands.swap(command_overflow);
+		command_overflow_pending.set(0);
+		mutex_lock.unlock();
+
+		for (std::vector<CL_SoundOutput_Command>::size_type i = 0; i < commands.size(); i++)
+			execute_command(commands[i]);
+	}
+}
+
+void CL_SoundOutput_Impl::execute_command(const CL_SoundOutput_Command &command)
+{
+	switch (command.type)
+	{
+	case CL_SoundOutput_Command::type_play:
+		sessions.push_back(command.session);
+		break;
+	case CL_SoundOutput_Command::type_stop:
+		remove_session(command.session);
+		break;
+	case CL_SoundOutput_Command::type_stop_all:
+		for (std::vector<CL_SoundBuffer_Session>::size_type i = 0; i < sessions.size(); i++)
+		{
+			CL_MutexSection session_lock(&sessions[i].impl->mutex);
+			sessions[i].impl->playing = false;
+		}
+		sessions.clear();
+		break;
+	case CL_SoundOutput_Command::type_set_volume:
+		volume = command.value;
+		break;
+	case CL_SoundOutput_Command::type_set_pan:
+		pan = command.value;
+		break;
+	case CL_SoundOutput_Command::type_set_mixer_threads:
+		mixer_threads = (int) command.value;
+		break;
+	case CL_SoundOutput_Command::type_set_max_real_voices:
+		max_real_voices = (int) command.value;
+		break;
+	}
+}
+
+void CL_SoundOutput_Impl::update_mixer_workers()
+{
+	int num_threads = (mixer_threads > 0) ? mixer_threads : CL_System::get_num_cores();
+	int num_workers = num_threads - 1;
+	if (num_workers != (int) mixer_workers.size())
+	{
+		stop_mixer_workers();
+		for (int i = 0; i < num_workers; i++)
+		{
+			CL_SharedPtr<CL_SoundOutput_MixerWorker> worker(new CL_SoundOutput_MixerWorker);
+			mixer_workers.push_back(worker);
+		}
+		for (int i = 0; i < num_workers; i++)
+			mixer_workers[i]->thread.start(this, &CL_SoundOutput_Impl::mixer_worker_main, mixer_workers[i].get(), i + 1, num_workers + 1);
+	}
+
+	if (worker_buffer_size != mix_buffer_size)
+	{
+		for (std::vector< CL_SharedPtr<CL_SoundOutput_MixerWorker> >::size_type i = 0; i < mixer_workers.size(); i++)
+		{
+			CL_SoundOutput_MixerWorker *worker = mixer_workers[i].get();
+			free_worker_buffers(worker);
+			for (int chan = 0; chan < 2; chan++)
+			{
+				worker->mix_buffers[chan] = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * mix_buffer_size);
+				worker->temp_buffers[chan] = (float *) CL_SoundSSE::aligned_alloc(sizeof(float) * mix_buffer_size);
+			}
+		}
+		worker_buffer_size = mix_buffer_size;
+	}
+}
+
+void CL_SoundOutput_Impl::stop_mixer_workers()
+{
+	if (mixer_workers.empty())
+		return;
+
+	stop_mixer_workers_event.set();
+	for (std::vector< CL_SharedPtr<CL_SoundOutput_MixerWorker> >::size_type i = 0; i < mixer_workers.size(); i++)
+	{
+		mixer_workers[i]->thread.join();
+		free_worker_buffers(mixer_workers[i].get());
+	}
+	mixer_workers.clear();
+	stop_mixer_workers_event.reset();
+	worker_buffer_size = 0;
+}
+
+void CL_SoundOutput_Impl::mixer_worker_main(CL_SoundOutput_MixerWorker *worker, int first, int stride)
+{
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(worker->event_start, stop_mixer_workers_event);
+		if (wakeup_reason != 0)
+			break;
+		worker->event_start.reset();
+
+		CL_SoundSSE::set_float(worker->mix_buffers[0], mix_buffer_size, 0.0f);
+		CL_SoundSSE::set_float(worker->mix_buffers[1], mix_buffer_size, 0.0f);
+		mix_sessions(first, stride, worker->mix_buffers, worker->temp_buffers, worker->ended_sessions);
+
+		worker->event_done.set();
+	}
+}
+
+void CL_SoundOutput_Impl::free_worker_buffers(CL_SoundOutput_MixerWorker *worker)
+{
+	for (int chan = 0; chan < 2; chan++)
+	{
+		CL_SoundSSE::aligned_free(worker->mix_buffers[chan]);
+		CL_SoundSSE::aligned_free(worker->temp_buffers[chan]);
+		worker->mix_buffers[chan] = 0;
+		worker->temp_buffers[chan] = 0;
+	}
 }
 
 void CL_SoundOutput_Impl::filter_mix_buffers()
@@ -35,10 +35,69 @@
 #include "API/Core/System/mutex.h"
 #include "API/Core/System/event.h"
 #include "API/Core/System/sharedptr.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Sound/soundbuffer_session.h"
 
 class CL_SoundFilter;
 class CL_SoundBuffer_Session_Impl;
-class CL_SoundBuffer_Session;
+
+/// \brief Request from an application thread to the mixer thread.
+class CL_SoundOutput_Command
+{
+public:
+	enum Type
+	{
+		type_play,
+		type_stop,
+		type_stop_all,
+		type_set_volume,
+		type_set_pan,
+		type_set_mixer_threads,
+		type_set_max_real_voices
+	};
+
+	CL_SoundOutput_Command() : type(type_play), value(0.0f) { }
+	CL_SoundOutput_Command(Type type, float value = 0.0f) : type(type), value(value) { }
+	CL_SoundOutput_Command(Type type, const CL_SoundBuffer_Session &session) : type(type), session(session), value(0.0f) { }
+
+	Type type;
+	CL_SoundBuffer_Session session;
+	float value;
+};
+
+/// \brief Snapshot of the values deciding which sessions are mixed, taken under the session mutex.
+class CL_SoundOutput_SessionKey
+{
+public:
+	CL_SoundOutput_SessionKey() : priority(0), audibility(0.0f), index(0) { }
+	CL_SoundOutput_SessionKey(int priority, float audibility, int index) : priority(priority), audibility(audibility), index(index) { }
+
+	int priority;
+	float audibility;
+
+	/// \brief Index of the session in CL_SoundOutput_Impl::sessions.
+	int index;
+};
+
+/// \brief Helper thread mixing a share of the playing sessions into its own buffers.
+class CL_SoundOutput_MixerWorker
+{
+public:
+	CL_SoundOutput_MixerWorker()
+	{
+		mix_buffers[0] = 0;
+		mix_buffers[1] = 0;
+		temp_buffers[0] = 0;
+		temp_buffers[1] = 0;
+	}
+
+	CL_Thread thread;
+	CL_Event event_start;
+	CL_Event event_done;
+	float *mix_buffers[2];
+	float *temp_buffers[2];
+	std::vector<CL_SoundBuffer_Session> ended_sessions;
+};
 
 class CL_SoundOutput_Impl
 {
@@ -72,8 +131,18 @@ public:
 
 	CL_Event stop_mixer;
 
+	/// \brief Playing sessions. Only accessed by the mixer thread.
 	std::vector< CL_SoundBuffer_Session > sessions;
 
+	/// \brief Indices into sessions of the sessions mixed in the current fragment. The others are virtual.
+	std::vector<int> real_sessions;
+
+	/// \brief Priority snapshot of the playing sessions, sorted when voices must be dropped.
+	std::vector<CL_SoundOutput_SessionKey> session_keys;
+
+	/// \brief Maximum number of sessions mixed per fragment, or 0 for no limit.
+	int max_real_voices;
+
 	mutable CL_Mutex mutex;
 
 	int mix_buffer_size;
@@ -95,6 +164,23 @@ public:
 
 	void stop_session(CL_SoundBuffer_Session &session);
 
+	/// \brief Stops all playing sessions.
+	void stop_all();
+
+	/// \brief Sets the master volume.
+	void set_volume(float volume);
+
+	/// \brief Sets the master panning.
+	void set_pan(float pan);
+
+	/// \brief Sets the number of threads mixing sessions.
+	///
+	/// 1 mixes all sessions on the mixer thread, 0 uses one thread per core.
+	void set_mixer_threads(int num_threads);
+
+	/// \brief Sets the maximum number of sessions mixed per fragment (0 for no limit).
+	void set_max_real_voices(int max_voices);
+
 protected:
 	/// \brief Called when we have no samples to play - and wants to tell the soundcard
 	/// \brief about this possible event.
@@ -153,6 +239,79 @@ private:
 	/// \brief Clamp mixing buffer values to the -1 to 1 range
 	void clamp_mix_buffers();
 
+	/// \brief Adds a command to the command queue. Safe to call from any thread, and never blocks on the mixer.
+	void queue_command(const CL_SoundOutput_Command &command);
+
+	/// \brief Adds a command to the ring buffer. Returns false if the ring buffer is full.
+	bool try_queue_command(const CL_SoundOutput_Command &command);
+
+	/// \brief Executes the commands queued since the last fragment
+	void process_commands();
+
+	/// \brief Applies a single command to the mixer state
+	void execute_command(const CL_SoundOutput_Command &command);
+
+	/// \brief Removes a session from the list of playing sessions
+	void remove_session(const CL_SoundBuffer_Session &session);
+
+	/// \brief Picks the sessions to mix into real_sessions and advances the virtual ones
+	void select_real_sessions(std::vector<CL_SoundBuffer_Session> &ended_sessions);
+
+	/// \brief Sort predicate placing the most important sessions first
+	static bool is_more_important(const CL_SoundOutput_SessionKey &a, const CL_SoundOutput_SessionKey &b);
+
+	/// \brief Mixes every 'stride' session starting at 'first' into the given buffers
+	void mix_sessions(int first, int stride, float **target_buffers, float **target_temp_buffers, std::vector<CL_SoundBuffer_Session> &ended_sessions);
+
+	/// \brief Starts or stops worker threads to match the requested mixer thread count
+	void update_mixer_workers();
+
+	/// \brief Stops and frees all worker threads
+	void stop_mixer_workers();
+
+	/// \brief Main loop of a worker thread
+	void mixer_worker_main(CL_SoundOutput_MixerWorker *worker, int first, int stride);
+
+	/// \brief Frees the buffers of a worker thread
+	static void free_worker_buffers(CL_SoundOutput_MixerWorker *worker);
+
+	enum { command_queue_size = 1024 };
+
+	/// \brief Ring buffer of commands from application threads to the mixer thread.
+	CL_SoundOutput_Command command_queue[command_queue_size];
+
+	/// \brief Sequence number of each command slot.
+	///
+	/// A slot is free for ticket t when its sequence is t, and holds a command
+	/// for reader position r when its sequence is r+1.
+	std::vector<CL_InterlockedVariable> command_sequence;
+
+	/// \brief Next ticket handed out to a writer.
+	CL_InterlockedVariable command_writer_index;
+
+	/// \brief Next command slot to read. Only accessed by the mixer thread.
+	unsigned int command_reader_index;
+
+	/// \brief Commands queued while the ring buffer was full, in order. Guarded by mutex.
+	std::vector<CL_SoundOutput_Command> command_overflow;
+
+	/// \brief Non-zero while command_overflow holds commands, so new commands queue behind them.
+	CL_InterlockedVariable command_overflow_pending;
+
+	/// \brief True while the mixer thread is running. Guarded by mutex.
+	bool mixer_thread_running;
+
+	/// \brief Requested number of mixer threads.
+	int mixer_threads;
+
+	std::vector< CL_SharedPtr<CL_SoundOutput_MixerWorker> > mixer_workers;
+
+	/// \brief Set to stop the worker threads.
+	CL_Event stop_mixer_workers_event;
+
+	/// \brief Fragment size the worker buffers were allocated for.
+	int worker_buffer_size;
+
 	static CL_Mutex singleton_mutex;
 	static CL_SoundOutput_Impl *instance;
 /// \}
@@ -0,0 +1,106 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "API/Sound/soundoutput_offline.h"
+#include "API/Sound/soundoutput_description.h"
+#include "API/Sound/sound.h"
+#include "soundoutput_offline_impl.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline construction:
+
+CL_SoundOutput_Offline::CL_SoundOutput_Offline()
+{
+}
+
+CL_SoundOutput_Offline::CL_SoundOutput_Offline(const CL_SoundOutput_Description &desc)
+{
+	impl = CL_SharedPtr<CL_SoundOutput_Impl>(new CL_SoundOutput_Offline_Impl(desc.get_mixing_frequency(), desc.get_mixing_latency()));
+	impl->set_mixer_threads(desc.get_mixer_threads());
+	impl->set_max_real_voices(desc.get_max_real_voices());
+	CL_Sound::select_output(*this);
+}
+
+CL_SoundOutput_Offline::CL_SoundOutput_Offline(const CL_SoundOutput_Description &desc, CL_IODevice &wave_file)
+{
+	impl = CL_SharedPtr<CL_SoundOutput_Impl>(new CL_SoundOutput_Offline_Impl(desc.get_mixing_frequency(), desc.get_mixing_latency(), wave_file));
+	impl->set_mixer_threads(desc.get_mixer_threads());
+	impl->set_max_real_voices(desc.get_max_real_voices());
+	CL_Sound::select_output(*this);
+}
+
+CL_SoundOutput_Offline::~CL_SoundOutput_Offline()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline attributes:
+
+int CL_SoundOutput_Offline::get_fragment_size() const
+{
+	return get_offline_impl()->frag_size;
+}
+
+int CL_SoundOutput_Offline::get_rendered_samples() const
+{
+	return get_offline_impl()->rendered_samples;
+}
+
+const float *CL_SoundOutput_Offline::get_data() const
+{
+	CL_SoundOutput_Offline_Impl *offline_impl = get_offline_impl();
+	return offline_impl->data.empty() ? 0 : &offline_impl->data[0];
+}
+
+int CL_SoundOutput_Offline::get_data_size() const
+{
+	return (int) get_offline_impl()->data.size() / 2;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline operations:
+
+int CL_SoundOutput_Offline::render(int num_samples)
+{
+	return get_offline_impl()->render(num_samples);
+}
+
+void CL_SoundOutput_Offline::clear()
+{
+	get_offline_impl()->data.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline implementation:
+
+CL_SoundOutput_Offline_Impl *CL_SoundOutput_Offline::get_offline_impl() const
+{
+	throw_if_null();
+	return static_cast<CL_SoundOutput_Offline_Impl *>(impl.get());
+}
@@ -0,0 +1,147 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#include "Sound/precomp.h"
+#include "soundoutput_offline_impl.h"
+#include "API/Core/IOData/cl_endian.h"
+#include "API/Core/Math/cl_math.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline_Impl construction:
+
+CL_SoundOutput_Offline_Impl::CL_SoundOutput_Offline_Impl(int mixing_frequency, int mixing_latency)
+: CL_SoundOutput_Impl(mixing_frequency, mixing_latency), rendered_samples(0), wave_header_position(0)
+{
+	name = "Offline";
+
+	// Round the fragment up to a multiple of 4 samples so the SSE mixing never needs a tail loop:
+	frag_size = (cl_max(mixing_frequency * mixing_latency / 1000, 4) + 3) & ~3;
+}
+
+CL_SoundOutput_Offline_Impl::CL_SoundOutput_Offline_Impl(int mixing_frequency, int mixing_latency, CL_IODevice &wave_file)
+: CL_SoundOutput_Impl(mixing_frequency, mixing_latency), rendered_samples(0), wave_file(wave_file), wave_header_position(0)
+{
+	name = "Offline";
+	frag_size = (cl_max(mixing_frequency * mixing_latency / 1000, 4) + 3) & ~3;
+	write_wave_header();
+}
+
+CL_SoundOutput_Offline_Impl::~CL_SoundOutput_Offline_Impl()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline_Impl operations:
+
+int CL_SoundOutput_Offline_Impl::render(int num_samples)
+{
+	// Commands queued while the queue is full are applied by the queueing thread under the mutex,
+	// as there is no mixer thread to drain them
+	CL_MutexSection mutex_lock(&mutex);
+
+	int samples_rendered = 0;
+	while (samples_rendered < num_samples)
+	{
+		mix_fragment();
+		write_fragment(stereo_buffer);
+		samples_rendered += frag_size;
+	}
+
+	if (!wave_file.is_null())
+		update_wave_header();
+
+	return samples_rendered;
+}
+
+void CL_SoundOutput_Offline_Impl::silence()
+{
+}
+
+int CL_SoundOutput_Offline_Impl::get_fragment_size()
+{
+	return frag_size;
+}
+
+void CL_SoundOutput_Offline_Impl::write_fragment(float *fragment)
+{
+	if (wave_file.is_null())
+	{
+		data.insert(data.end(), fragment, fragment + frag_size * 2);
+	}
+	else
+	{
+		wave_buffer.resize(frag_size * 2);
+		for (int i = 0; i < frag_size * 2; i++)
+			wave_buffer[i] = (cl_byte16) (fragment[i] * 32767.0f);
+		if (CL_Endian::is_system_big())
+			CL_Endian::swap(&wave_buffer[0], 2, frag_size * 2);
+		wave_file.write(&wave_buffer[0], frag_size * 2 * sizeof(cl_byte16));
+	}
+	rendered_samples += frag_size;
+}
+
+void CL_SoundOutput_Offline_Impl::wait()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundOutput_Offline_Impl implementation:
+
+void CL_SoundOutput_Offline_Impl::write_wave_header()
+{
+	wave_file.set_little_endian_mode();
+	wave_header_position = wave_file.get_position();
+
+	wave_file.write("RIFF", 4);
+	wave_file.write_uint32(36);
+	wave_file.write("WAVE", 4);
+
+	wave_file.write("fmt ", 4);
+	wave_file.write_uint32(16);
+	wave_file.write_uint16(1);	// PCM
+	wave_file.write_uint16(2);	// Channels
+	wave_file.write_uint32(mixing_frequency);
+	wave_file.write_uint32(mixing_frequency * 4);	// Byte rate
+	wave_file.write_uint16(4);	// Block align
+	wave_file.write_uint16(16);	// Bits per sample
+
+	wave_file.write("data", 4);
+	wave_file.write_uint32(0);
+}
+
+void CL_SoundOutput_Offline_Impl::update_wave_header()
+{
+	cl_ubyte32 data_size = rendered_samples * 4;
+	int end_position = wave_file.get_position();
+
+	wave_file.seek(wave_header_position + 4);
+	wave_file.write_uint32(36 + data_size);
+	wave_file.seek(wave_header_position + 40);
+	wave_file.write_uint32(data_size);
+	wave_file.seek(end_position);
+}
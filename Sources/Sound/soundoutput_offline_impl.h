@@ -0,0 +1,100 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Magnus Norddahl
+*/
+
+#pragma once
+
+#include "soundoutput_impl.h"
+#include "API/Core/IOData/iodevice.h"
+#include <vector>
+
+class CL_SoundOutput_Offline_Impl : public CL_SoundOutput_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CL_SoundOutput_Offline_Impl(int mixing_frequency, int mixing_latency);
+
+	CL_SoundOutput_Offline_Impl(int mixing_frequency, int mixing_latency, CL_IODevice &wave_file);
+
+	~CL_SoundOutput_Offline_Impl();
+
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	int frag_size;
+
+	int rendered_samples;
+
+	/// \brief Interleaved stereo samples rendered into memory.
+	std::vector<float> data;
+
+	/// \brief Wave file being written, or a null device when rendering into memory.
+	CL_IODevice wave_file;
+
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Mixes whole fragments until at least num_samples samples have been rendered.
+	int render(int num_samples);
+
+	/// \brief Called when we have no samples to play - and wants to tell the soundcard
+	/// \brief about this possible event.
+	virtual void silence();
+
+	/// \brief Returns the buffer size used by device (returned as num [stereo] samples).
+	virtual int get_fragment_size();
+
+	/// \brief Writes a fragment to memory or the wave file.
+	virtual void write_fragment(float *data);
+
+	/// \brief Returns immediately; offline rendering never waits for a device.
+	virtual void wait();
+
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	void write_wave_header();
+
+	/// \brief Patches the RIFF and data chunk sizes to match the samples written so far.
+	void update_wave_header();
+
+	int wave_header_position;
+
+	std::vector<cl_byte16> wave_buffer;
+/// \}
+};
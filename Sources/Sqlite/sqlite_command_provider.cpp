@@ -30,8 +30,12 @@
 #include "sqlite_command_provider.h"
 #include "sqlite_connection_provider.h"
 #include "sqlite_reader_provider.h"
+#include "sqlite_transaction_provider.h"
 #include "API/Core/System/databuffer.h"
 #include "API/Core/Text/string_help.h"
+#include "API/Core/System/datetime.h"
+#include "API/Sqlite/sqlite_connection.h"
+#include <algorithm>
 #include "API/Database/db_command_provider.h"
 #include "sqlite3.h"
 
@@ -39,38 +43,26 @@
 // CL_SqliteCommandProvider Construction:
 
 CL_SqliteCommandProvider::CL_SqliteCommandProvider(CL_SqliteConnectionProvider *connection, const CL_StringRef &text)
-: connection(connection), text(text), vm(0), last_insert_rowid(-1)
+: connection(connection), text(text), vm(0), last_insert_rowid(-1), batch_rows(0), batch_transaction(0)
 {
-	CL_String t = text;
-	if (t.empty() || t[t.length()-1] != ';')
-		t += ";";
-	const CL_String::char_type *tail = 0;
-	int result;
-	for (int i = 0; i < 1000; i++)
-	{
-		result = sqlite3_prepare(connection->db, t.data(), t.length()*sizeof(CL_String::char_type), &vm, (const char **) &tail);
-		if (result != SQLITE_BUSY)
-			break;
-		CL_System::sleep(1);
-	}
-	throw_if_failed(result);
+	vm = connection->acquire_statement(this->text, column_indexes);
 }
 
 CL_SqliteCommandProvider::~CL_SqliteCommandProvider()
 {
+	// Rolls back a batch that was never committed
+	end_batch();
+
 	if (connection->active_reader && connection->active_reader->vm == vm)
 	{
 		connection->active_reader->destroy_command = true;
+		connection->active_reader->command = 0;
+		connection->active_reader->command_text = text;
+		connection->active_reader->command_column_indexes.swap(column_indexes);
 	}
 	else
 	{
-		int result = sqlite3_finalize(vm);
-		if (result != SQLITE_OK)
-		{
-			const char *err = sqlite3_errmsg(connection->db);
-			CL_StringRef8 error = (err == 0) ? "Unknown error" : err;
-			throw CL_Exception(CL_StringHelp::local8_to_text(error));
-		}
+		connection->release_statement(text, vm, column_indexes);
 	}
 }
 
@@ -87,6 +79,26 @@ int CL_SqliteCommandProvider::get_output_last_insert_rowid() const
 	return last_insert_rowid;
 }
 
+int CL_SqliteCommandProvider::find_column(const CL_StringRef &name)
+{
+	// The statement may have been recompiled with a different result set after a schema change
+	if (column_indexes.size() != (std::vector<ColumnIndex>::size_type) sqlite3_column_count(vm))
+		build_column_indexes();
+
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		std::vector<ColumnIndex>::iterator it = std::lower_bound(column_indexes.begin(), column_indexes.end(), name, ColumnIndexLess());
+		if (it != column_indexes.end() && it->name == name)
+		{
+			const char *col_name = sqlite3_column_name(vm, it->index);
+			if (col_name != 0 && col_name == name)
+				return it->index;
+		}
+		build_column_indexes();
+	}
+	return -1;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteCommandProvider Operations:
 
@@ -116,7 +128,15 @@ void CL_SqliteCommandProvider::set_input_parameter_double(int index, double valu
 
 void CL_SqliteCommandProvider::set_input_parameter_datetime(int index, const CL_DateTime &value)
 {
-	set_input_parameter_string(index, CL_SqliteConnectionProvider::to_sql_datetime(value));
+	if (connection->datetime_storage == CL_SqliteConnection::datetime_ticks)
+	{
+		int result = sqlite3_bind_int64(vm, index, value.to_ticks());
+		throw_if_failed(result);
+	}
+	else
+	{
+		set_input_parameter_string(index, CL_SqliteConnectionProvider::to_sql_datetime(value));
+	}
 }
 
 void CL_SqliteCommandProvider::set_input_parameter_binary(int index, const CL_DataBuffer &value)
@@ -128,6 +148,30 @@ void CL_SqliteCommandProvider::set_input_parameter_binary(int index, const CL_Da
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteCommandProvider Implementation:
 
+void CL_SqliteCommandProvider::build_column_indexes()
+{
+	int count = sqlite3_column_count(vm);
+	column_indexes.clear();
+	column_indexes.reserve(count);
+	for (int index = 0; index < count; index++)
+	{
+		const char *col_name = sqlite3_column_name(vm, index);
+		ColumnIndex column;
+		column.name = (col_name != 0) ? col_name : "";
+		column.index = index;
+		column_indexes.push_back(column);
+	}
+	// Stable so that the first of several columns with the same name is found, as with a linear search
+	std::stable_sort(column_indexes.begin(), column_indexes.end(), ColumnIndexLess());
+}
+
+void CL_SqliteCommandProvider::end_batch()
+{
+	delete batch_transaction;
+	batch_transaction = 0;
+	batch_rows = 0;
+}
+
 void CL_SqliteCommandProvider::throw_if_failed(int result) const
 {
 	if (result != SQLITE_OK)
@@ -35,8 +35,10 @@
 
 #include "sqlite3.h"
 #include "API/Database/db_command_provider.h"
+#include <vector>
 
 class CL_SqliteConnectionProvider;
+class CL_SqliteTransactionProvider;
 
 /// \brief Sqlite database command provider.
 class CL_SqliteCommandProvider : public CL_DBCommandProvider
@@ -53,6 +55,15 @@ public:
 public:
 	int get_input_parameter_column(const CL_StringRef &name) const;
 	int get_output_last_insert_rowid() const;
+
+	/// \brief Returns the result column index for a column name, or -1 if there is no such column
+	int find_column(const CL_StringRef &name);
+
+	struct ColumnIndex
+	{
+		CL_String name;
+		int index;
+	};
 /// \}
 
 /// \name Operations
@@ -70,13 +81,25 @@ public:
 /// \{
 private:
 	void throw_if_failed(int result) const;
+	void end_batch();
+	void build_column_indexes();
+
+	struct ColumnIndexLess
+	{
+		bool operator()(const ColumnIndex &a, const ColumnIndex &b) const { return a.name < b.name; }
+		bool operator()(const ColumnIndex &a, const CL_StringRef &b) const { return a.name < b; }
+	};
 
 	CL_SqliteConnectionProvider *connection;
 	CL_String text;
 	sqlite3_stmt *vm;
+	std::vector<ColumnIndex> column_indexes;	// Sorted by name, kept with the statement in the statement cache
 	int last_insert_rowid;
+	int batch_rows;
+	CL_SqliteTransactionProvider *batch_transaction;
 
 	friend class CL_SqliteReaderProvider;
+	friend class CL_SqliteConnectionProvider;
 /// \}
 };
 
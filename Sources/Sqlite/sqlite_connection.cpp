@@ -29,6 +29,9 @@
 #include "Sqlite/precomp.h"
 #include "API/Sqlite/sqlite_connection.h"
 #include "sqlite_connection_provider.h"
+#include "API/Database/db_command.h"
+#include "API/Core/Text/string_help.h"
+#include "API/Core/Text/string_format.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteConnection Construction:
@@ -43,10 +46,84 @@ CL_SqliteConnection::~CL_SqliteConnection()
 }
 
 /////////////////////////////////////////////////////////////////////////////
-// CL_DBConnection Attributes:
+// CL_SqliteConnection Attributes:
+
+int CL_SqliteConnection::get_statement_cache_size() const
+{
+	return get_sqlite_provider()->get_statement_cache_size();
+}
+
+cl_ubyte64 CL_SqliteConnection::get_statement_cache_hits() const
+{
+	return get_sqlite_provider()->get_statement_cache_hits();
+}
+
+cl_ubyte64 CL_SqliteConnection::get_statement_cache_misses() const
+{
+	return get_sqlite_provider()->get_statement_cache_misses();
+}
+
+CL_SqliteConnection::DateTimeStorage CL_SqliteConnection::get_datetime_storage() const
+{
+	return get_sqlite_provider()->get_datetime_storage();
+}
 
 /////////////////////////////////////////////////////////////////////////////
-// CL_DBConnection Operations:
+// CL_SqliteConnection Operations:
+
+void CL_SqliteConnection::set_statement_cache_size(int size)
+{
+	get_sqlite_provider()->set_statement_cache_size(size);
+}
+
+void CL_SqliteConnection::clear_statement_cache()
+{
+	get_sqlite_provider()->clear_statement_cache();
+}
+
+void CL_SqliteConnection::set_datetime_storage(DateTimeStorage storage)
+{
+	get_sqlite_provider()->set_datetime_storage(storage);
+}
+
+void CL_SqliteConnection::set_journal_mode(JournalMode mode)
+{
+	static const char *modes[] = { "delete", "truncate", "persist", "memory", "wal", "off" };
+	CL_DBCommand command = create_command(cl_format("PRAGMA journal_mode=%1", modes[mode]));
+	CL_String result = execute_scalar_string(command);
+	if (CL_StringHelp::compare(result, modes[mode], true) != 0)
+		throw CL_Exception(cl_format("Unable to set journal mode %1, database uses %2", modes[mode], result));
+}
+
+void CL_SqliteConnection::set_synchronous(SynchronousLevel level)
+{
+	static const char *levels[] = { "OFF", "NORMAL", "FULL" };
+	CL_DBCommand command = create_command(cl_format("PRAGMA synchronous=%1", levels[level]));
+	execute_non_query(command);
+}
+
+void CL_SqliteConnection::set_cache_size(int kilobytes)
+{
+	// Negative values are in kibibytes rather than pages
+	CL_DBCommand command = create_command(cl_format("PRAGMA cache_size=-%1", kilobytes));
+	execute_non_query(command);
+}
+
+void CL_SqliteConnection::set_mmap_size(cl_byte64 size)
+{
+	CL_DBCommand command = create_command("PRAGMA mmap_size=" + CL_StringHelp::ll_to_text(size));
+	execute_non_query(command);
+}
+
+void CL_SqliteConnection::set_busy_timeout(int milliseconds)
+{
+	get_sqlite_provider()->set_busy_timeout(milliseconds);
+}
 
 /////////////////////////////////////////////////////////////////////////////
-// CL_DBConnection Implementation:
+// CL_SqliteConnection Implementation:
+
+CL_SqliteConnectionProvider *CL_SqliteConnection::get_sqlite_provider() const
+{
+	return static_cast<CL_SqliteConnectionProvider *>(const_cast<CL_SqliteConnection *>(this)->get_provider());
+}
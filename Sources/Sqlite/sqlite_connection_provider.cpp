@@ -36,12 +36,14 @@
 #include "API/Core/System/uniqueptr.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/Text/string_format.h"
+#include "API/Core/System/system.h"
+#include "API/Core/Math/cl_math.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteConnectionProvider Construction:
 
 CL_SqliteConnectionProvider::CL_SqliteConnectionProvider(const CL_StringRef &db_filename)
-: active_transaction(0), active_reader(0), db(0)
+: statement_cache_size(64), statement_cache_hits(0), statement_cache_misses(0), datetime_storage(CL_SqliteConnection::datetime_text), active_transaction(0), active_reader(0), db(0)
 {
 	int result = sqlite3_open(CL_StringHelp::text_to_utf8(db_filename).c_str(), &db);
 	if (result != SQLITE_OK)
@@ -59,6 +61,7 @@ CL_SqliteConnectionProvider::~CL_SqliteConnectionProvider()
 	if (active_transaction)
 		active_transaction->connection = 0;
 
+	clear_statement_cache();
 	sqlite3_close(db);
 }
 
@@ -120,9 +123,128 @@ void CL_SqliteConnectionProvider::execute_non_query(CL_DBCommandProvider *comman
 	reader->close();
 }
 
+void CL_SqliteConnectionProvider::execute_batch_row(CL_DBCommandProvider *command)
+{
+	CL_SqliteCommandProvider *sqlite_command = dynamic_cast<CL_SqliteCommandProvider*>(command);
+	if (active_reader)
+		throw CL_Exception("Only one database reader may be active for a connection");
+
+	if (sqlite_command->batch_rows == 0 && !active_transaction)
+		sqlite_command->batch_transaction = new CL_SqliteTransactionProvider(this, CL_DBTransaction::immediate);
+
+	try
+	{
+		CL_SqliteReaderProvider reader(this, sqlite_command);
+		reader.retrieve_row();
+		reader.close();
+	}
+	catch (const CL_Exception &)
+	{
+		sqlite3_clear_bindings(sqlite_command->vm);
+		sqlite_command->end_batch();
+		throw;
+	}
+
+	sqlite3_clear_bindings(sqlite_command->vm);
+	sqlite_command->batch_rows++;
+}
+
+int CL_SqliteConnectionProvider::commit_batch(CL_DBCommandProvider *command)
+{
+	CL_SqliteCommandProvider *sqlite_command = dynamic_cast<CL_SqliteCommandProvider*>(command);
+	if (sqlite_command->batch_transaction)
+		sqlite_command->batch_transaction->commit();
+	int rows = sqlite_command->batch_rows;
+	sqlite_command->end_batch();
+	return rows;
+}
+
+void CL_SqliteConnectionProvider::set_busy_timeout(int milliseconds)
+{
+	sqlite3_busy_timeout(db, milliseconds);
+}
+
+void CL_SqliteConnectionProvider::set_statement_cache_size(int size)
+{
+	statement_cache_size = cl_max(size, 0);
+	evict_statements(statement_cache_size);
+}
+
+void CL_SqliteConnectionProvider::clear_statement_cache()
+{
+	evict_statements(0);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteConnectionProvider Implementation:
 
+sqlite3_stmt *CL_SqliteConnectionProvider::acquire_statement(const CL_String &text, std::vector<CL_SqliteCommandProvider::ColumnIndex> &column_indexes)
+{
+	std::map<CL_String, std::list<CachedStatement>::iterator>::iterator it = cached_statements_lookup.find(text);
+	if (it != cached_statements_lookup.end())
+	{
+		sqlite3_stmt *vm = it->second->vm;
+		column_indexes.swap(it->second->column_indexes);
+		cached_statements.erase(it->second);
+		cached_statements_lookup.erase(it);
+		statement_cache_hits++;
+		return vm;
+	}
+
+	statement_cache_misses++;
+
+	CL_String t = text;
+	if (t.empty() || t[t.length()-1] != ';')
+		t += ";";
+	sqlite3_stmt *vm = 0;
+	const CL_String::char_type *tail = 0;
+	int result;
+	for (int i = 0; i < 1000; i++)
+	{
+		// sqlite3_prepare_v2 recompiles the statement if the schema changes while it sits in the cache
+		result = sqlite3_prepare_v2(db, t.data(), t.length()*sizeof(CL_String::char_type), &vm, (const char **) &tail);
+		if (result != SQLITE_BUSY)
+			break;
+		CL_System::sleep(1);
+	}
+	if (result != SQLITE_OK)
+	{
+		CL_String8 error = sqlite3_errmsg(db);
+		throw CL_Exception(CL_StringHelp::local8_to_text(error));
+	}
+	return vm;
+}
+
+void CL_SqliteConnectionProvider::release_statement(const CL_String &text, sqlite3_stmt *vm, std::vector<CL_SqliteCommandProvider::ColumnIndex> &column_indexes)
+{
+	if (statement_cache_size == 0 || cached_statements_lookup.find(text) != cached_statements_lookup.end())
+	{
+		sqlite3_finalize(vm);
+		return;
+	}
+
+	sqlite3_reset(vm);
+	sqlite3_clear_bindings(vm);
+
+	CachedStatement cached;
+	cached.text = text;
+	cached.vm = vm;
+	cached_statements.push_front(cached);
+	cached_statements.front().column_indexes.swap(column_indexes);
+	cached_statements_lookup[text] = cached_statements.begin();
+	evict_statements(statement_cache_size);
+}
+
+void CL_SqliteConnectionProvider::evict_statements(int max_size)
+{
+	while (cached_statements.size() > (std::list<CachedStatement>::size_type) max_size)
+	{
+		sqlite3_finalize(cached_statements.back().vm);
+		cached_statements_lookup.erase(cached_statements.back().text);
+		cached_statements.pop_back();
+	}
+}
+
 CL_String CL_SqliteConnectionProvider::to_sql_datetime(const CL_DateTime &value)
 {
 	return value.to_short_datetime_string();
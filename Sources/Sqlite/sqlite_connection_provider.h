@@ -35,6 +35,10 @@
 
 #include "sqlite3.h"
 #include "API/Database/db_connection_provider.h"
+#include "API/Sqlite/sqlite_connection.h"
+#include "sqlite_command_provider.h"
+#include <list>
+#include <map>
 
 class CL_SqliteTransactionProvider;
 class CL_SqliteReaderProvider;
@@ -52,6 +56,10 @@ public:
 /// \name Attributes
 /// \{
 public:
+	int get_statement_cache_size() const { return statement_cache_size; }
+	cl_ubyte64 get_statement_cache_hits() const { return statement_cache_hits; }
+	cl_ubyte64 get_statement_cache_misses() const { return statement_cache_misses; }
+	CL_SqliteConnection::DateTimeStorage get_datetime_storage() const { return datetime_storage; }
 /// \}
 
 /// \name Operations
@@ -63,6 +71,12 @@ public:
 	CL_String execute_scalar_string(CL_DBCommandProvider *command);
 	int execute_scalar_int(CL_DBCommandProvider *command);
 	void execute_non_query(CL_DBCommandProvider *command);
+	void execute_batch_row(CL_DBCommandProvider *command);
+	int commit_batch(CL_DBCommandProvider *command);
+	void set_statement_cache_size(int size);
+	void clear_statement_cache();
+	void set_datetime_storage(CL_SqliteConnection::DateTimeStorage storage) { datetime_storage = storage; }
+	void set_busy_timeout(int milliseconds);
 /// \}
 
 /// \name Implementation
@@ -73,6 +87,25 @@ private:
 	static CL_String int_to_string(int value, int length);
 	static int string_to_int(const CL_String &str, int offset, int length);
 
+	sqlite3_stmt *acquire_statement(const CL_String &text, std::vector<CL_SqliteCommandProvider::ColumnIndex> &column_indexes);
+	void release_statement(const CL_String &text, sqlite3_stmt *vm, std::vector<CL_SqliteCommandProvider::ColumnIndex> &column_indexes);
+	void evict_statements(int max_size);
+
+	struct CachedStatement
+	{
+		CL_String text;
+		sqlite3_stmt *vm;
+		std::vector<CL_SqliteCommandProvider::ColumnIndex> column_indexes;
+	};
+
+	// Prepared statements not currently owned by a command, most recently used first
+	std::list<CachedStatement> cached_statements;
+	std::map<CL_String, std::list<CachedStatement>::iterator> cached_statements_lookup;
+	int statement_cache_size;
+	cl_ubyte64 statement_cache_hits;
+	cl_ubyte64 statement_cache_misses;
+	CL_SqliteConnection::DateTimeStorage datetime_storage;
+
 	CL_SqliteTransactionProvider *active_transaction;
 	CL_SqliteReaderProvider *active_reader;
 	sqlite3 *db;
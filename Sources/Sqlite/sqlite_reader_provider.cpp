@@ -65,6 +65,14 @@ CL_String CL_SqliteReaderProvider::get_column_name(int index) const
 
 int CL_SqliteReaderProvider::get_name_index(const CL_StringRef &name) const
 {
+	if (command)
+	{
+		int index = command->find_column(name);
+		if (index != -1)
+			return index;
+		throw CL_Exception(cl_format("No such column name %1", name));
+	}
+
 	int count = get_column_count();
 	for (int index = 0; index < count; index++)
 	{
@@ -82,11 +90,20 @@ CL_String CL_SqliteReaderProvider::get_column_string(int index) const
 {
 	CL_String8::char_type *str = (CL_String8::char_type *) sqlite3_column_text(vm, index);
 	if (str != 0)
-		return str;
+		return CL_String(str, sqlite3_column_bytes(vm, index));
 	else
 		return CL_String();
 }
 
+CL_StringRef CL_SqliteReaderProvider::get_column_string_ref(int index) const
+{
+	CL_String8::char_type *str = (CL_String8::char_type *) sqlite3_column_text(vm, index);
+	if (str != 0)
+		return CL_StringRef(str, sqlite3_column_bytes(vm, index), true);
+	else
+		return CL_StringRef();
+}
+
 bool CL_SqliteReaderProvider::get_column_bool(int index) const
 {
 	return sqlite3_column_int(vm, index) != 0;
@@ -104,7 +121,11 @@ double CL_SqliteReaderProvider::get_column_double(int index) const
 
 CL_DateTime CL_SqliteReaderProvider::get_column_datetime(int index) const
 {
-	return CL_SqliteConnectionProvider::from_sql_datetime(get_column_string(index));
+	// Values stored with CL_SqliteConnection::datetime_ticks are integers, everything else is text
+	if (sqlite3_column_type(vm, index) == SQLITE_INTEGER)
+		return CL_DateTime::get_utc_time_from_ticks(sqlite3_column_int64(vm, index));
+	else
+		return CL_SqliteConnectionProvider::from_sql_datetime(get_column_string(index));
 }
 
 CL_DataBuffer CL_SqliteReaderProvider::get_column_binary(int index) const
@@ -114,6 +135,16 @@ CL_DataBuffer CL_SqliteReaderProvider::get_column_binary(int index) const
 	return CL_DataBuffer(blob, size);
 }
 
+const void *CL_SqliteReaderProvider::get_column_binary_data(int index) const
+{
+	return sqlite3_column_blob(vm, index);
+}
+
+int CL_SqliteReaderProvider::get_column_binary_size(int index) const
+{
+	return sqlite3_column_bytes(vm, index);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CL_SqliteReaderProvider Operations:
 
@@ -137,6 +168,15 @@ bool CL_SqliteReaderProvider::retrieve_row()
 				finished = true;
 				return false;
 			case SQLITE_ERROR:
+			// Statements from sqlite3_prepare_v2 report the specific error code directly
+			case SQLITE_CONSTRAINT:
+			case SQLITE_MISMATCH:
+			case SQLITE_SCHEMA:
+			case SQLITE_READONLY:
+			case SQLITE_LOCKED:
+			case SQLITE_IOERR:
+			case SQLITE_CORRUPT:
+			case SQLITE_FULL:
 				{
 					finished = true;
 					sqlite3_reset(vm);
@@ -174,13 +214,11 @@ void CL_SqliteReaderProvider::close()
 
 		if (destroy_command)
 		{
-			int result = sqlite3_finalize(vm);
-			if (result != SQLITE_OK)
-			{
-				const char *err = sqlite3_errmsg(connection->db);
-				CL_StringRef8 error = (err == 0) ? "Unknown error" : err;
-				throw CL_Exception(CL_StringHelp::local8_to_text(error));
-			}
+			// The command was destroyed while this reader was active
+			if (connection)
+				connection->release_statement(command_text, vm, command_column_indexes);
+			else
+				sqlite3_finalize(vm);
 		}
 	}
 }
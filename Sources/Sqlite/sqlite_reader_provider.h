@@ -35,6 +35,7 @@
 
 #include "sqlite3.h"
 #include "API/Database/db_reader_provider.h"
+#include "sqlite_command_provider.h"
 
 class CL_SqliteCommandProvider;
 class CL_SqliteConnectionProvider;
@@ -61,6 +62,9 @@ public:
 	double get_column_double(int index) const;
 	CL_DateTime get_column_datetime(int index) const;
 	CL_DataBuffer get_column_binary(int index) const;
+	CL_StringRef get_column_string_ref(int index) const;
+	const void *get_column_binary_data(int index) const;
+	int get_column_binary_size(int index) const;
 /// \}
 
 /// \name Operations
@@ -75,6 +79,8 @@ public:
 private:
 	CL_SqliteConnectionProvider *connection;
 	CL_SqliteCommandProvider *command;
+	CL_String command_text;
+	std::vector<CL_SqliteCommandProvider::ColumnIndex> command_column_indexes;
 	sqlite3_stmt *vm;
 	bool finished;
 	bool closed;
@@ -48,7 +48,7 @@ CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
 {
 	CL_VirtualDirectory new_directory = directory;
 	CL_IODevice input = new_directory.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_all);
-	impl->load(input);
+	impl->load(input, stream);
 }
 
 CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
@@ -60,14 +60,14 @@ CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
 	CL_VirtualFileSystem vfs(path);
 	CL_VirtualDirectory dir = vfs.get_root_directory();
 	CL_IODevice input = dir.open_file(filename, CL_File::open_existing, CL_File::access_read, CL_File::share_all);
-	impl->load(input);
+	impl->load(input, stream);
 }
 
 CL_SoundProvider_Vorbis::CL_SoundProvider_Vorbis(
 	CL_IODevice &file, bool stream)
 : impl(new CL_SoundProvider_Vorbis_Impl)
 {
-	impl->load(file);
+	impl->load(file, stream);
 }
 
 CL_SoundProvider_Vorbis::~CL_SoundProvider_Vorbis()
@@ -90,10 +90,13 @@ void CL_SoundProvider_Vorbis::end_session(CL_SoundProvider_Session *session)
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_Vorbis implementation:
 
-void CL_SoundProvider_Vorbis_Impl::load(CL_IODevice &input)
+void CL_SoundProvider_Vorbis_Impl::load(CL_IODevice &input, bool stream_requested)
 {
 	int size = input.get_size();
 	buffer = CL_DataBuffer(size);
 	int bytes_read = input.read(buffer.get_data(), buffer.get_size());
 	buffer.set_size(bytes_read);
+
+	// Long music is decoded ahead while playing rather than kept fully decoded in memory:
+	stream = stream_requested || bytes_read > CL_SoundProviderCache::get_stream_threshold();
 }
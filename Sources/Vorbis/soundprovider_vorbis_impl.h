@@ -32,17 +32,39 @@
 #include "API/Sound/soundformat.h"
 #include "API/Core/System/databuffer.h"
 #include "API/Core/IOData/virtual_directory.h"
+#include "API/Sound/SoundProviders/soundprovider_cache.h"
+#include "API/Core/System/interlocked_variable.h"
 #include <string>
 
 class CL_SoundProvider_Vorbis_Impl
 {
+/// \name Construction
+/// \{
+public:
+	CL_SoundProvider_Vorbis_Impl()
+	: stream(false)
+	{
+	}
+
+	~CL_SoundProvider_Vorbis_Impl()
+	{
+		CL_SoundProviderCache::remove(this);
+	}
+
+/// \}
 /// \name Attributes
 /// \{
 public:
-	void load(CL_IODevice &input);
+	void load(CL_IODevice &input, bool stream);
 
 public:
 	CL_DataBuffer buffer;
+
+	/// \brief True if sessions decode ahead on a background thread instead of using the decoded sample cache.
+	bool stream;
+
+	/// \brief Non-zero while a session records the decoded samples for the cache. Other sessions only decode.
+	CL_InterlockedVariable recording;
 /// \}
 };
 
@@ -34,12 +34,14 @@
 #include "API/Core/IOData/iodevice.h"
 #include "API/Core/IOData/iodevice_memory.h"
 #include "API/Core/System/exception.h"
+#include "API/Core/Math/cl_math.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CL_SoundProvider_Vorbis_Session construction:
 
 CL_SoundProvider_Vorbis_Session::CL_SoundProvider_Vorbis_Session(CL_SoundProvider_Vorbis &source) :
-	source(source), num_samples(0), position(0), input(0), stream_eof(false)
+	source(source), num_samples(0), position(0), input(0), stream_eof(false), memory_budget(0),
+	stream_thread_running(false), stream_ring_size(0), stream_read_pos(0), stream_fill(0), stream_decoder_eof(false)
 {
 	input = new CL_IODevice_Memory(source.impl->buffer);
 
@@ -168,10 +170,26 @@ CL_SoundProvider_Vorbis_Session::CL_SoundProvider_Vorbis_Session(CL_SoundProvide
 
 	if ( (vi.channels == 0) || (vi.rate == 0) )
 		throw CL_Exception("something is wrong with the vorbis stream");
+
+	if (source.impl->stream)
+	{
+		start_stream_thread();
+	}
+	else
+	{
+		memory_budget = CL_SoundProviderCache::get_memory_budget();
+		cached_data = CL_SoundProviderCache::find(source.impl.get());
+		if (cached_data)
+			num_samples = cached_data->get_num_samples();
+		else
+			start_recording();
+	}
 }
 
 CL_SoundProvider_Vorbis_Session::~CL_SoundProvider_Vorbis_Session()
 {
+	stop_stream_thread();
+	stop_recording();
 	delete input;
 
 	/* clean up this logical bitstream; before exit we see if we're
@@ -219,6 +237,15 @@ int CL_SoundProvider_Vorbis_Session::get_position() const
 
 bool CL_SoundProvider_Vorbis_Session::eof() const
 {
+	if (cached_data)
+		return position >= cached_data->get_num_samples();
+
+	if (source.impl->stream)
+	{
+		CL_MutexSection mutex_lock(&stream_mutex);
+		return stream_decoder_eof && stream_fill == 0;
+	}
+
 	return stream_eof;
 }
 
@@ -233,18 +260,73 @@ bool CL_SoundProvider_Vorbis_Session::play()
 	
 bool CL_SoundProvider_Vorbis_Session::set_position(int pos)
 {
-	// Currently only support seeking to beginning of stream.
+	if (cached_data)
+	{
+		if (pos < 0 || pos > cached_data->get_num_samples())
+			return false;
+		position = pos;
+		return true;
+	}
+
+	// Without the decoded samples we only support seeking to beginning of stream.
 	if (pos != 0) return false;
 
-	input->seek(0, CL_IODevice::seek_set);
-	stream_eof = false;
+	if (source.impl->stream)
+	{
+		stop_stream_thread();
+		restart_decoder();
+		start_stream_thread();
+	}
+	else
+	{
+		// Another session may have finished decoding in the meantime
+		restart_decoder();
+		stop_recording();
+		cached_data = CL_SoundProviderCache::find(source.impl.get());
+		if (cached_data)
+			num_samples = cached_data->get_num_samples();
+		else
+			start_recording();
+	}
+	position = 0;
 	return true;
 }
 
 int CL_SoundProvider_Vorbis_Session::get_data(float **channels, int data_requested)
+{
+	int received;
+	if (cached_data)
+	{
+		received = cached_data->get_data(position, channels, 0, data_requested);
+	}
+	else if (source.impl->stream)
+	{
+		received = get_streamed_data(channels, data_requested);
+	}
+	else
+	{
+		received = decode_data(channels, 0, data_requested);
+		record_data(channels, received);
+	}
+
+	position += received;
+	if (num_samples < position) num_samples = position;
+	return received;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CL_SoundProvider_Vorbis_Session implementation:
+
+void CL_SoundProvider_Vorbis_Session::restart_decoder()
+{
+	input->seek(0, CL_IODevice::seek_set);
+	stream_eof = false;
+}
+
+int CL_SoundProvider_Vorbis_Session::decode_data(float **channels, int offset, int data_requested)
 {
 	int data_left = data_requested;
-	while (!eof() && data_left > 0)
+	while (!stream_eof && data_left > 0)
 	{
 		float **pcm;
 
@@ -257,7 +339,7 @@ int CL_SoundProvider_Vorbis_Session::get_data(float **channels, int data_request
 		
 		if (samples > data_left) samples = data_left;
 
-		int buffer_pos = data_requested-data_left;
+		int buffer_pos = offset + data_requested - data_left;
 		for (int j=0; j<vi.channels; j++)
 		{
 			memcpy(channels[j]+buffer_pos, pcm[j], samples*sizeof(float));
@@ -265,20 +347,137 @@ int CL_SoundProvider_Vorbis_Session::get_data(float **channels, int data_request
 
 		vorbis_synthesis_read(&vd, samples);
 		data_left -= samples;
-
-		position += samples;
-		if (num_samples < position) num_samples = position;
 	}
 	
 	return data_requested - data_left;
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// CL_SoundProvider_Vorbis_Session implementation:
+void CL_SoundProvider_Vorbis_Session::start_recording()
+{
+	if (!recorded_data && source.impl->recording.compare_and_swap(0, 1))
+		recorded_data = CL_SharedPtr<CL_SoundProviderCacheData>(new CL_SoundProviderCacheData(vi.channels, vi.rate));
+}
+
+void CL_SoundProvider_Vorbis_Session::stop_recording()
+{
+	if (recorded_data)
+	{
+		recorded_data.reset();
+		source.impl->recording.set(0);
+	}
+}
+
+void CL_SoundProvider_Vorbis_Session::record_data(float **channels, int num_decoded)
+{
+	if (!recorded_data)
+		return;
+
+	recorded_data->append(channels, 0, num_decoded);
+	if (recorded_data->get_memory_size() > memory_budget)
+	{
+		// Too large to ever fit in the cache; stop recording.
+		stop_recording();
+	}
+	else if (stream_eof)
+	{
+		// Fully decoded. Share the samples with future sessions and play the rest from memory as well.
+		if (CL_SoundProviderCache::insert(source.impl.get(), recorded_data))
+			cached_data = recorded_data;
+		stop_recording();
+	}
+}
+
+int CL_SoundProvider_Vorbis_Session::get_streamed_data(float **channels, int data_requested)
+{
+	CL_MutexSection mutex_lock(&stream_mutex);
+	int received = cl_min(data_requested, stream_fill);
+	int first = cl_min(received, stream_ring_size - stream_read_pos);
+	for (int j=0; j<vi.channels; j++)
+	{
+		memcpy(channels[j], &stream_ring[j][stream_read_pos], first*sizeof(float));
+		memcpy(channels[j]+first, &stream_ring[j][0], (received-first)*sizeof(float));
+	}
+	stream_read_pos = (stream_read_pos + received) % stream_ring_size;
+	stream_fill -= received;
+	stream_event_space.set();
+	return received;
+}
+
+void CL_SoundProvider_Vorbis_Session::start_stream_thread()
+{
+	stream_ring_size = cl_max(vi.rate * CL_SoundProviderCache::get_stream_buffer_length() / 1000, stream_block_size * 2);
+	stream_ring.resize(vi.channels);
+	for (int j=0; j<vi.channels; j++)
+		stream_ring[j].resize(stream_ring_size);
+	stream_read_pos = 0;
+	stream_fill = 0;
+	stream_decoder_eof = false;
+
+	stream_event_stop.reset();
+	stream_event_space.set();
+	stream_thread.start(this, &CL_SoundProvider_Vorbis_Session::stream_thread_main);
+	stream_thread_running = true;
+}
+
+void CL_SoundProvider_Vorbis_Session::stop_stream_thread()
+{
+	if (stream_thread_running)
+	{
+		stream_event_stop.set();
+		stream_thread.join();
+		stream_thread_running = false;
+	}
+}
+
+void CL_SoundProvider_Vorbis_Session::stream_thread_main()
+{
+	std::vector< std::vector<float> > block(vi.channels);
+	std::vector<float *> block_ptrs(vi.channels);
+	for (int j=0; j<vi.channels; j++)
+	{
+		block[j].resize(stream_block_size);
+		block_ptrs[j] = &block[j][0];
+	}
+
+	while (true)
+	{
+		int wakeup_reason = CL_Event::wait(stream_event_stop, stream_event_space);
+		if (wakeup_reason != 1)
+			break;
+
+		{
+			CL_MutexSection mutex_lock(&stream_mutex);
+			if (stream_ring_size - stream_fill < stream_block_size)
+			{
+				stream_event_space.reset();
+				continue;
+			}
+		}
+
+		// Decode without holding the lock so the mixer is never blocked by the decoder:
+		int decoded = decode_data(&block_ptrs[0], 0, stream_block_size);
+
+		CL_MutexSection mutex_lock(&stream_mutex);
+		int write_pos = (stream_read_pos + stream_fill) % stream_ring_size;
+		int first = cl_min(decoded, stream_ring_size - write_pos);
+		for (int j=0; j<vi.channels; j++)
+		{
+			memcpy(&stream_ring[j][write_pos], block_ptrs[j], first*sizeof(float));
+			memcpy(&stream_ring[j][0], block_ptrs[j]+first, (decoded-first)*sizeof(float));
+		}
+		stream_fill += decoded;
+
+		if (stream_eof)
+		{
+			stream_decoder_eof = true;
+			break;
+		}
+	}
+}
 
 void CL_SoundProvider_Vorbis_Session::stream_data()
 {
-	while (!eof())
+	while (!stream_eof)
 	{
 		int result=ogg_stream_packetout(&os,&op);
 		if (result > 0)
@@ -288,7 +487,7 @@ void CL_SoundProvider_Vorbis_Session::stream_data()
 			break;
 		}
 		
-		while (!eof())
+		while (!stream_eof)
 		{
 			int result = ogg_sync_pageout(&oy,&og);
 			if (result == -1) continue; // corrupt data at this page position. Read next.
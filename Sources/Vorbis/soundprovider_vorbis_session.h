@@ -30,8 +30,13 @@
 #pragma once
 
 #include "API/Sound/SoundProviders/soundprovider_session.h"
+#include "API/Sound/SoundProviders/soundprovider_cache.h"
 #include "API/Vorbis/soundprovider_vorbis.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/event.h"
 #include "vorbis/codec.h"
+#include <vector>
 
 class CL_IODevice;
 
@@ -72,6 +77,15 @@ public:
 
 private:
 	void stream_data();
+	void restart_decoder();
+	int decode_data(float **channels, int offset, int data_requested);
+	void start_recording();
+	void stop_recording();
+	void record_data(float **channels, int num_decoded);
+	int get_streamed_data(float **channels, int data_requested);
+	void start_stream_thread();
+	void stop_stream_thread();
+	void stream_thread_main();
 
 	CL_SoundProvider_Vorbis source;
 	int num_samples;
@@ -79,6 +93,31 @@ private:
 	CL_IODevice *input;
 	bool stream_eof;
 
+	/// \brief Fully decoded samples shared with other sessions, or null if this session decodes itself.
+	CL_SharedPtr<CL_SoundProviderCacheData> cached_data;
+
+	/// \brief Samples decoded so far, inserted into the cache once the end of the stream is reached.
+	///
+	/// Only one session of a provider records at a time.
+	CL_SharedPtr<CL_SoundProviderCacheData> recorded_data;
+
+	/// \brief Cache memory budget when the session began. Larger recordings are abandoned.
+	int memory_budget;
+
+	/// \brief Decodes ahead into the stream ring when the provider is streamed.
+	CL_Thread stream_thread;
+	bool stream_thread_running;
+	mutable CL_Mutex stream_mutex;
+	CL_Event stream_event_space;
+	CL_Event stream_event_stop;
+	std::vector< std::vector<float> > stream_ring;
+	int stream_ring_size;
+	int stream_read_pos;
+	int stream_fill;
+	bool stream_decoder_eof;
+
+	static const int stream_block_size = 4096;
+
 	/// \brief Sync and verify incoming physical bitstream.
 	ogg_sync_state oy;
 
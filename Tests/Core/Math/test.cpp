@@ -83,6 +83,8 @@ int TestApp::main(const std::vector<CL_String> &args)
 		test_line_segment2();
 		test_line_segment3();
 		test_triangle();
+		test_delauney();
+		test_ear_clip();
 	
 		CL_Console::write_line("All Tests Complete");
 		console.display_close_message();
@@ -88,9 +88,12 @@ private:
 	void test_line_segment2();
 	void test_line_segment3();
 	void test_triangle();
+	void test_delauney();
+	void test_ear_clip();
 	void test_matrix_mat2();
 	void test_matrix_mat3();
 	void test_matrix_mat4();
+	void test_matrix_transform();
 
 	void fail(void);
 
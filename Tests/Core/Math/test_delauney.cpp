@@ -0,0 +1,135 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+static unsigned int delauney_random_seed = 1;
+
+static float delauney_random()
+{
+	delauney_random_seed = delauney_random_seed * 1103515245 + 12345;
+	return ((delauney_random_seed >> 8) & 0xffff) / 65536.0f * 1000.0f;
+}
+
+static double delauney_orientation(const CL_DelauneyTriangulator_Triangle &triangle)
+{
+	return
+		(double(triangle.vertex_B->x) - triangle.vertex_A->x) * (double(triangle.vertex_C->y) - triangle.vertex_A->y) -
+		(double(triangle.vertex_B->y) - triangle.vertex_A->y) * (double(triangle.vertex_C->x) - triangle.vertex_A->x);
+}
+
+void TestApp::test_delauney()
+{
+	CL_Console::write_line(" Header: delauney_triangulator.h");
+	CL_Console::write_line("  Class: CL_DelauneyTriangulator");
+
+	CL_Console::write_line("   Function: generate() with random vertices");
+	{
+		CL_DelauneyTriangulator triangulator;
+		for (int i = 0; i < 500; i++)
+			triangulator.add_vertex(delauney_random(), delauney_random(), 0);
+		triangulator.generate();
+
+		const std::vector<CL_DelauneyTriangulator_Vertex> &vertices = triangulator.get_vertices();
+		const std::vector<CL_DelauneyTriangulator_Triangle> &triangles = triangulator.get_triangles();
+		if (triangles.size() < vertices.size())
+			fail();
+
+		// No vertex may be inside the circumcircle of a triangle:
+		for (size_t index_triangle = 0; index_triangle < triangles.size(); index_triangle++)
+		{
+			const CL_DelauneyTriangulator_Triangle &triangle = triangles[index_triangle];
+			if (delauney_orientation(triangle) <= 0.0)
+				fail();
+
+			double ax = triangle.vertex_A->x, ay = triangle.vertex_A->y;
+			double bx = triangle.vertex_B->x, by = triangle.vertex_B->y;
+			double cx = triangle.vertex_C->x, cy = triangle.vertex_C->y;
+			for (size_t index_vertex = 0; index_vertex < vertices.size(); index_vertex++)
+			{
+				double dx = vertices[index_vertex].x, dy = vertices[index_vertex].y;
+				double adx = ax - dx, ady = ay - dy;
+				double bdx = bx - dx, bdy = by - dy;
+				double cdx = cx - dx, cdy = cy - dy;
+				double det =
+					(adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) +
+					(bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) +
+					(cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+				if (det > 1e-3)
+					fail();
+			}
+		}
+	}
+
+	CL_Console::write_line("   Function: generate() with cocircular and duplicate vertices");
+	{
+		const int grid_size = 20;
+		CL_DelauneyTriangulator triangulator;
+		for (int copy = 0; copy < 2; copy++)
+		{
+			for (int y = 0; y < grid_size; y++)
+			{
+				for (int x = 0; x < grid_size; x++)
+					triangulator.add_vertex((float) x, (float) y, 0);
+			}
+		}
+		triangulator.generate();
+
+		// The grid must be covered exactly by non-overlapping triangles:
+		const std::vector<CL_DelauneyTriangulator_Triangle> &triangles = triangulator.get_triangles();
+		if (triangles.size() != 2 * (grid_size - 1) * (grid_size - 1))
+			fail();
+		double area = 0.0;
+		for (size_t index_triangle = 0; index_triangle < triangles.size(); index_triangle++)
+		{
+			double orientation = delauney_orientation(triangles[index_triangle]);
+			if (orientation != 1.0)
+				fail();
+			area += orientation * 0.5;
+		}
+		if (area != (grid_size - 1) * (grid_size - 1))
+			fail();
+	}
+
+	CL_Console::write_line("  Benchmark: generate()");
+	{
+		int counts[] = { 1000, 10000, 100000, 200000 };
+		for (int index_count = 0; index_count < 4; index_count++)
+		{
+			CL_DelauneyTriangulator triangulator;
+			for (int i = 0; i < counts[index_count]; i++)
+				triangulator.add_vertex(delauney_random(), delauney_random(), 0);
+
+			unsigned int start_time = CL_System::get_time();
+			triangulator.generate();
+			unsigned int time = CL_System::get_time() - start_time;
+			CL_Console::write_line("   %1 vertices: %2 triangles in %3 ms", counts[index_count], (int) triangulator.get_triangles().size(), (int) time);
+		}
+	}
+}
@@ -0,0 +1,105 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// Adds a circle approximated by num_points vertices, in the given orientation.
+static void ear_clip_add_circle(CL_EarClipTriangulator &triangulator, float x, float y, float radius, int num_points, float direction)
+{
+	for (int i = 0; i < num_points; i++)
+	{
+		float angle = direction * i * 2.0f * CL_PI / num_points;
+		triangulator.add_vertex(x + cos(angle) * radius, y + sin(angle) * radius);
+	}
+}
+
+// Builds a circle with a grid of circular holes and checks that the triangles cover it.
+static bool ear_clip_test_holes(int num_points, int holes_per_side, int points_per_hole, unsigned int *time)
+{
+	const float radius = 1000.0f;
+	const float hole_spacing = 1200.0f / holes_per_side;
+	const float hole_radius = hole_spacing * 0.3f;
+
+	CL_EarClipTriangulator triangulator;
+	ear_clip_add_circle(triangulator, 0.0f, 0.0f, radius, num_points, 1.0f);
+	for (int y = 0; y < holes_per_side; y++)
+	{
+		for (int x = 0; x < holes_per_side; x++)
+		{
+			triangulator.begin_hole();
+			ear_clip_add_circle(triangulator, -600.0f + (x + 0.5f) * hole_spacing, -600.0f + (y + 0.5f) * hole_spacing, hole_radius, points_per_hole, -1.0f);
+			triangulator.end_hole();
+		}
+	}
+
+	unsigned int start_time = CL_System::get_time();
+	CL_EarClipResult result = triangulator.triangulate();
+	if (time)
+		*time = CL_System::get_time() - start_time;
+
+	// Each hole adds its vertices plus two bridge vertices:
+	int num_holes = holes_per_side * holes_per_side;
+	std::vector<CL_EarClipTriangulator_Triangle> &triangles = result.get_triangles();
+	if (triangles.size() != num_points + num_holes * (points_per_hole + 2) - 2)
+		return false;
+
+	double area = 0.0;
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		const CL_EarClipTriangulator_Triangle &t = triangles[i];
+		area += fabs((double(t.x2) - t.x1) * (double(t.y3) - t.y1) - (double(t.x3) - t.x1) * (double(t.y2) - t.y1)) * 0.5;
+	}
+
+	double expected_area =
+		0.5 * num_points * radius * radius * sin(2.0 * CL_PI / num_points) -
+		num_holes * 0.5 * points_per_hole * hole_radius * hole_radius * sin(2.0 * CL_PI / points_per_hole);
+	return fabs(area - expected_area) < expected_area * 0.0001;
+}
+
+void TestApp::test_ear_clip()
+{
+	CL_Console::write_line(" Header: ear_clip_triangulator.h");
+	CL_Console::write_line("  Class: CL_EarClipTriangulator");
+
+	CL_Console::write_line("   Function: triangulate()");
+	{
+		if (!ear_clip_test_holes(60, 1, 20, 0))
+			fail();
+		if (!ear_clip_test_holes(1000, 3, 40, 0))
+			fail();
+	}
+
+	CL_Console::write_line("  Benchmark: triangulate() with holes");
+	{
+		unsigned int time = 0;
+		if (!ear_clip_test_holes(50000, 10, 40, &time))
+			fail();
+		CL_Console::write_line("   50000 vertices, 100 holes: %1 ms", (int) time);
+	}
+}
@@ -35,6 +35,7 @@ void TestApp::test_matrix(void)
 	test_matrix_mat2();
 	test_matrix_mat3();
 	test_matrix_mat4();
+	test_matrix_transform();
 }
 
 void TestApp::test_matrix_mat3()
@@ -273,3 +274,143 @@ void TestApp::test_matrix_mat2()
 
 }
 
+void TestApp::test_matrix_transform()
+{
+	CL_Console::write_line("  Class: CL_Mat4 (batch transform)");
+
+	CL_Mat4f matrix = CL_Mat4f::rotate(CL_Angle(30, cl_degrees), 0.2f, 0.3f, 1.0f, true);
+	matrix.multiply(CL_Mat4f::scale(2.0f, 3.0f, 0.5f));
+	matrix.multiply(CL_Mat4f::translate(10.0f, -20.0f, 5.0f));
+
+	const int max_count = 11;
+	CL_Vec4f vec4[max_count];
+	CL_Vec3f vec3[max_count];
+	CL_Vec2f vec2[max_count];
+	float x[max_count], y[max_count], z[max_count];
+	for (int i = 0; i < max_count; i++)
+	{
+		x[i] = i * 1.5f - 4.0f;
+		y[i] = i * -2.25f + 3.0f;
+		z[i] = i * 0.75f;
+		vec4[i] = CL_Vec4f(x[i], y[i], z[i], 1.0f - i * 0.1f);
+		vec3[i] = CL_Vec3f(x[i], y[i], z[i]);
+		vec2[i] = CL_Vec2f(x[i], y[i]);
+	}
+
+	CL_Console::write_line("   Function: transform() with CL_Vec4f, CL_Vec3f and CL_Vec2f arrays");
+	for (int count = 0; count <= max_count; count++)
+	{
+		CL_Vec4f dest4[max_count];
+		CL_Vec3f dest3[max_count];
+		CL_Vec2f dest2[max_count];
+		matrix.transform(vec4, dest4, count);
+		matrix.transform(vec3, dest3, count);
+		matrix.transform(vec2, dest2, count);
+		for (int i = 0; i < max_count; i++)
+		{
+			CL_Vec4f expected4 = (i < count) ? matrix * vec4[i] : CL_Vec4f();
+			CL_Vec4f expected3 = (i < count) ? matrix * CL_Vec4f(x[i], y[i], z[i], 1.0f) : CL_Vec4f();
+			CL_Vec4f expected2 = (i < count) ? matrix * CL_Vec4f(x[i], y[i], 0.0f, 1.0f) : CL_Vec4f();
+			check_float(dest4[i].x, expected4.x);
+			check_float(dest4[i].y, expected4.y);
+			check_float(dest4[i].z, expected4.z);
+			check_float(dest4[i].w, expected4.w);
+			check_float(dest3[i].x, expected3.x);
+			check_float(dest3[i].y, expected3.y);
+			check_float(dest3[i].z, expected3.z);
+			check_float(dest2[i].x, expected2.x);
+			check_float(dest2[i].y, expected2.y);
+		}
+	}
+
+	CL_Console::write_line("   Function: transform() with separate x, y and z arrays");
+	for (int count = 0; count <= max_count; count++)
+	{
+		float dest_x[max_count], dest_y[max_count], dest_z[max_count];
+		float dest2_x[max_count], dest2_y[max_count];
+		for (int i = 0; i < max_count; i++)
+			dest_x[i] = dest_y[i] = dest_z[i] = dest2_x[i] = dest2_y[i] = 0.0f;
+
+		matrix.transform(x, y, z, dest_x, dest_y, dest_z, count);
+		matrix.transform(x, y, dest2_x, dest2_y, count);
+		for (int i = 0; i < max_count; i++)
+		{
+			CL_Vec4f expected = (i < count) ? matrix * CL_Vec4f(x[i], y[i], z[i], 1.0f) : CL_Vec4f();
+			CL_Vec4f expected2 = (i < count) ? matrix * CL_Vec4f(x[i], y[i], 0.0f, 1.0f) : CL_Vec4f();
+			check_float(dest_x[i], expected.x);
+			check_float(dest_y[i], expected.y);
+			check_float(dest_z[i], expected.z);
+			check_float(dest2_x[i], expected2.x);
+			check_float(dest2_y[i], expected2.y);
+		}
+	}
+
+	CL_Console::write_line("   Function: transform() in place");
+	{
+		CL_Vec2f in_place[max_count];
+		for (int i = 0; i < max_count; i++)
+			in_place[i] = vec2[i];
+		matrix.transform(in_place, in_place, max_count);
+
+		float in_place_x[max_count], in_place_y[max_count];
+		for (int i = 0; i < max_count; i++)
+		{
+			in_place_x[i] = x[i];
+			in_place_y[i] = y[i];
+		}
+		matrix.transform(in_place_x, in_place_y, in_place_x, in_place_y, max_count);
+
+		for (int i = 0; i < max_count; i++)
+		{
+			CL_Vec4f expected = matrix * CL_Vec4f(x[i], y[i], 0.0f, 1.0f);
+			check_float(in_place[i].x, expected.x);
+			check_float(in_place[i].y, expected.y);
+			check_float(in_place_x[i], expected.x);
+			check_float(in_place_y[i], expected.y);
+		}
+	}
+
+	CL_Console::write_line("  Benchmark: transform() of 1M points");
+	{
+		const int num_points = 1000000;
+		const int iterations = 10;
+		std::vector<CL_Vec4f> points4(num_points);
+		std::vector<CL_Vec2f> points2(num_points);
+		std::vector<float> points_x(num_points), points_y(num_points);
+		for (int i = 0; i < num_points; i++)
+		{
+			points4[i] = CL_Vec4f(i * 0.001f, i * -0.002f, 0.0f, 1.0f);
+			points2[i] = CL_Vec2f(i * 0.001f, i * -0.002f);
+			points_x[i] = points2[i].x;
+			points_y[i] = points2[i].y;
+		}
+
+		unsigned int start_time = CL_System::get_time();
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			for (int i = 0; i < num_points; i++)
+				points4[i] = matrix * points4[i];
+		}
+		unsigned int operator_time = CL_System::get_time() - start_time;
+
+		start_time = CL_System::get_time();
+		for (int iteration = 0; iteration < iterations; iteration++)
+			matrix.transform(&points4[0], &points4[0], num_points);
+		unsigned int vec4_time = CL_System::get_time() - start_time;
+
+		start_time = CL_System::get_time();
+		for (int iteration = 0; iteration < iterations; iteration++)
+			matrix.transform(&points2[0], &points2[0], num_points);
+		unsigned int vec2_time = CL_System::get_time() - start_time;
+
+		start_time = CL_System::get_time();
+		for (int iteration = 0; iteration < iterations; iteration++)
+			matrix.transform(&points_x[0], &points_y[0], &points_x[0], &points_y[0], num_points);
+		unsigned int soa_time = CL_System::get_time() - start_time;
+
+		CL_Console::write_line("   CL_Vec4f with operator *: %1 ms", (int) (operator_time / iterations));
+		CL_Console::write_line("   CL_Vec4f array: %1 ms", (int) (vec4_time / iterations));
+		CL_Console::write_line("   CL_Vec2f array: %1 ms", (int) (vec2_time / iterations));
+		CL_Console::write_line("   x and y arrays: %1 ms", (int) (soa_time / iterations));
+	}
+}
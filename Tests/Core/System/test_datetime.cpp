@@ -168,6 +168,22 @@ void TestApp::test_datetime()
 
 	if (ticks != ticks_b) fail();
 
+	CL_Console::write_line("   Function: get_utc_time_from_ticks()");
+	CL_DateTime datetime_from_ticks = CL_DateTime::get_utc_time_from_ticks(ticks_b);
+	if (datetime_from_ticks.get_year() != 2009) fail();
+	if (datetime_from_ticks.get_month() != 2) fail();
+	if (datetime_from_ticks.get_day() != 4) fail();
+	if (datetime_from_ticks.get_hour() != 17) fail();
+	if (datetime_from_ticks.get_minutes() != 45) fail();
+	if (datetime_from_ticks.get_seconds() != 33) fail();
+	if (datetime_from_ticks.get_nanoseconds() != 123456700) fail();
+	if (datetime_from_ticks.to_ticks() != ticks_b) fail();
+
+	datetime = CL_DateTime(1970, 1, 1, 0, 0, 0, 0);
+	if (CL_DateTime::get_utc_time_from_ticks(datetime.to_ticks()).get_year() != 1970) fail();
+	datetime = CL_DateTime(2037, 12, 31, 23, 59, 59, 0);
+	if (CL_DateTime::get_utc_time_from_ticks(datetime.to_ticks()).to_ticks() != datetime.to_ticks()) fail();
+
 
 	CL_Console::write_line("   Function: get_current_utc_time(), to_utc(), to_local()");
 
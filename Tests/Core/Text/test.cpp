@@ -71,6 +71,7 @@ int TestApp::main(const std::vector<CL_String> &args)
 		CL_Console::write_line(" - %1", test_stringref());
 		
 		test_string();
+		test_utf8();
 
 		CL_Console::write_line("All Tests Complete");
 		console.display_close_message();
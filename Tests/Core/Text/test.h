@@ -74,6 +74,7 @@ private:
 	CL_StringRef test_stringref();
 	CL_String str;
 	void test_string();
+	void test_utf8();
 
 	void fail();
 };
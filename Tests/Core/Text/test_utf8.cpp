@@ -0,0 +1,131 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+static CL_String16 make_corpus(const CL_String16 &pattern, CL_String16::size_type length)
+{
+	CL_String16 corpus;
+	while (corpus.length() < length)
+		corpus.append(pattern);
+	return corpus;
+}
+
+static void benchmark_utf8(const char *name, const CL_String16 &corpus)
+{
+	const int iterations = 20;
+
+	CL_String8 utf8 = CL_StringHelp::ucs2_to_utf8(corpus);
+
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		CL_StringHelp::utf8_to_ucs2(utf8);
+	cl_ubyte64 decode_time = CL_System::get_microseconds() - start_time;
+
+	start_time = CL_System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		CL_StringHelp::ucs2_to_utf8(corpus);
+	cl_ubyte64 encode_time = CL_System::get_microseconds() - start_time;
+
+	start_time = CL_System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		CL_StringHelp::utf8_verify(utf8);
+	cl_ubyte64 verify_time = CL_System::get_microseconds() - start_time;
+
+	double bytes = (double) utf8.length() * iterations;
+	CL_Console::write_line("   %1: utf8_to_ucs2 %2 GB/s, ucs2_to_utf8 %3 GB/s, utf8_verify %4 GB/s", name,
+		bytes / cl_max(decode_time, (cl_ubyte64) 1) / 1000.0,
+		bytes / cl_max(encode_time, (cl_ubyte64) 1) / 1000.0,
+		bytes / cl_max(verify_time, (cl_ubyte64) 1) / 1000.0);
+}
+
+void TestApp::test_utf8()
+{
+	CL_Console::write_line(" Header: string_help.h");
+	CL_Console::write_line("  Class: CL_StringHelp");
+
+	CL_String16 ascii_pattern = L"The quick brown fox jumps over the lazy dog. 0123456789\n";
+	CL_String16 latin_pattern = L"Sch\x00f6ne Gr\x00fc\x00df" L"e aus K\x00f8" L"benhavn, caf\x00e9 cr\x00e8me br\x00fbl\x00e9" L"e. ";
+	CL_String16 cjk_pattern = L"\x65e5\x672c\x8a9e\x306e\x6587\x7ae0\x3002\x4e2d\x6587\x6587\x672c\x3002\xd55c\xad6d\xc5b4 ";
+
+	CL_Console::write_line("   Function: utf8_to_ucs2 / ucs2_to_utf8 round trip");
+
+	const CL_String16 patterns[] = { ascii_pattern, latin_pattern, cjk_pattern, ascii_pattern + cjk_pattern + latin_pattern };
+	for (int p = 0; p < 4; p++)
+	{
+		// Cover every SSE block alignment and every tail length
+		for (CL_String16::size_type length = 0; length < 100; length++)
+		{
+			CL_String16 text = make_corpus(patterns[p], length).substr(0, length);
+			CL_String8 utf8 = CL_StringHelp::ucs2_to_utf8(text);
+			if (CL_StringHelp::utf8_to_ucs2(utf8) != text)
+				fail();
+			if (!CL_StringHelp::utf8_verify(utf8))
+				fail();
+
+			CL_UTF8_Reader reader(utf8);
+			CL_String16::size_type pos = 0;
+			while (!reader.is_end())
+			{
+				if (pos >= text.length() || reader.get_char() != (unsigned int) text[pos])
+					fail();
+				reader.next();
+				pos++;
+			}
+			if (pos != text.length())
+				fail();
+		}
+	}
+
+	CL_Console::write_line("   Function: utf8_to_ucs2 with embedded null and malformed sequences");
+
+	CL_String8 malformed("abcdefghijklmnopqrstuvwxyz", 26);
+	malformed[20] = 0;
+	malformed[3] = (char) 0xc3;
+	CL_String16 decoded = CL_StringHelp::utf8_to_ucs2(malformed);
+	if (decoded.length() != 25 || decoded[4] != L'f' || decoded[19] != L'?')
+		fail();
+
+	CL_Console::write_line("   Function: utf8_verify");
+
+	const char *invalid[] = { "\xc0\xaf", "\xe0\x80\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\x80", "abc\xe2\x82", "\xf8\x88\x80\x80\x80" };
+	for (int i = 0; i < 7; i++)
+	{
+		if (CL_StringHelp::utf8_verify(invalid[i]))
+			fail();
+	}
+	if (!CL_StringHelp::utf8_verify("\xf0\x9f\x98\x80 \xe2\x82\xac"))
+		fail();
+
+	CL_Console::write_line("   Benchmark: 4 MB corpora");
+
+	benchmark_utf8("ASCII", make_corpus(ascii_pattern, 4*1024*1024));
+	benchmark_utf8("Latin", make_corpus(latin_pattern, 2*1024*1024));
+	benchmark_utf8("CJK", make_corpus(cjk_pattern, 1536*1024));
+}
@@ -0,0 +1,708 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanSqlite");
+
+		test_statement_cache();
+		test_statement_cache_eviction();
+		test_statement_cache_reuse();
+		benchmark_statement_cache();
+		test_batch();
+		test_batch_failure();
+		benchmark_batch();
+		test_column_access();
+		test_datetime_storage();
+		benchmark_reader();
+		test_connection_pool();
+		benchmark_connection_pool();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_statement_cache()
+{
+	CL_Console::write_line(" Header: sqlite_connection.h");
+	CL_Console::write_line("  Function: set_statement_cache_size()");
+
+	CL_SqliteConnection db(":memory:");
+	create_test_table(db, 10);
+
+	cl_ubyte64 misses = db.get_statement_cache_misses();
+	cl_ubyte64 hits = db.get_statement_cache_hits();
+	for (int i = 0; i < 10; i++)
+	{
+		CL_DBCommand command = db.create_command("SELECT name FROM items WHERE id=?1", i);
+		if (db.execute_scalar_string(command) != cl_format("item %1", i))
+			fail();
+	}
+	if (db.get_statement_cache_misses() - misses != 1)
+		fail();
+	if (db.get_statement_cache_hits() - hits != 9)
+		fail();
+
+	// Two commands alive at the same time may not share a statement
+	CL_DBCommand command1 = db.create_command("SELECT name FROM items WHERE id=?1", 1);
+	CL_DBCommand command2 = db.create_command("SELECT name FROM items WHERE id=?1", 2);
+	if (db.execute_scalar_string(command1) != "item 1" || db.execute_scalar_string(command2) != "item 2")
+		fail();
+
+	db.set_statement_cache_size(0);
+	misses = db.get_statement_cache_misses();
+	for (int i = 0; i < 10; i++)
+	{
+		CL_DBCommand command = db.create_command("SELECT name FROM items WHERE id=?1", i);
+		db.execute_scalar_string(command);
+	}
+	if (db.get_statement_cache_misses() - misses != 10)
+		fail();
+}
+
+void TestApp::test_statement_cache_eviction()
+{
+	CL_Console::write_line("  Function: set_statement_cache_size() eviction");
+
+	CL_SqliteConnection db(":memory:");
+	create_test_table(db, 10);
+	db.set_statement_cache_size(2);
+
+	const char *queries[3] =
+	{
+		"SELECT name FROM items WHERE id=1",
+		"SELECT name FROM items WHERE id=2",
+		"SELECT name FROM items WHERE id=3"
+	};
+
+	// Cycling through more statements than the cache holds always evicts the one needed next
+	cl_ubyte64 hits = db.get_statement_cache_hits();
+	for (int i = 0; i < 9; i++)
+	{
+		CL_DBCommand command = db.create_command(queries[i % 3]);
+		db.execute_scalar_string(command);
+	}
+	if (db.get_statement_cache_hits() != hits)
+		fail();
+
+	// The two most recently used statements stay cached
+	CL_DBCommand command1 = db.create_command(queries[2]);
+	CL_DBCommand command2 = db.create_command(queries[1]);
+	if (db.get_statement_cache_hits() - hits != 2)
+		fail();
+}
+
+void TestApp::test_statement_cache_reuse()
+{
+	CL_Console::write_line("  Function: create_command() with a cached statement");
+
+	CL_SqliteConnection db(":memory:");
+	create_test_table(db, 3);
+
+	// Bindings from the previous use must be cleared
+	{
+		CL_DBCommand command = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)", 100, "bound");
+		db.execute_non_query(command);
+	}
+	{
+		CL_DBCommand command = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)");
+		command.set_input_parameter_int(1, 101);
+		db.execute_non_query(command);
+	}
+	CL_DBCommand null_check = db.create_command("SELECT COUNT(*) FROM items WHERE id=101 AND name IS NULL");
+	if (db.execute_scalar_int(null_check) != 1)
+		fail();
+
+	// Cached statements must survive schema changes
+	CL_DBCommand select = db.create_command("SELECT * FROM items WHERE id=1");
+	CL_DBReader columns = db.execute_reader(select);
+	if (!columns.retrieve_row() || columns.get_column_count() != 2)
+		fail();
+	columns.close();
+	select = CL_DBCommand();
+	CL_DBCommand alter = db.create_command("ALTER TABLE items ADD COLUMN extra INTEGER");
+	db.execute_non_query(alter);
+	select = db.create_command("SELECT * FROM items WHERE id=1");
+	columns = db.execute_reader(select);
+	if (!columns.retrieve_row() || columns.get_column_count() != 3)
+		fail();
+	columns.close();
+	select = CL_DBCommand();
+
+	// A command destroyed while its reader is still open hands its statement back when the reader closes
+	CL_DBReader reader;
+	{
+		CL_DBCommand command = db.create_command("SELECT name FROM items ORDER BY id");
+		reader = db.execute_reader(command);
+	}
+	int count = 0;
+	while (reader.retrieve_row())
+		count++;
+	reader.close();
+	if (count != 5)
+		fail();
+	cl_ubyte64 hits = db.get_statement_cache_hits();
+	CL_DBCommand command = db.create_command("SELECT name FROM items ORDER BY id");
+	if (db.get_statement_cache_hits() - hits != 1)
+		fail();
+}
+
+void TestApp::benchmark_statement_cache()
+{
+	CL_Console::write_line("  Benchmark: repeated query");
+
+	CL_SqliteConnection db(":memory:");
+	create_test_table(db, 1000);
+
+	const int iterations = 100000;
+	for (int cache_size = 0; cache_size <= 64; cache_size += 64)
+	{
+		db.set_statement_cache_size(cache_size);
+		unsigned int start_time = CL_System::get_time();
+		for (int i = 0; i < iterations; i++)
+		{
+			CL_DBCommand command = db.create_command("SELECT name FROM items WHERE id=?1", i % 1000);
+			db.execute_scalar_string(command);
+		}
+		unsigned int time = CL_System::get_time() - start_time;
+		CL_Console::write_line("   cache size %1: %2 queries in %3 ms", cache_size, iterations, (int)time);
+	}
+}
+
+void TestApp::test_batch()
+{
+	CL_Console::write_line(" Header: db_connection.h");
+	CL_Console::write_line("  Function: execute_batch_row()");
+
+	CL_SqliteConnection db(":memory:");
+	create_test_table(db, 0);
+
+	CL_DBCommand command = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)");
+	for (int i = 0; i < 100; i++)
+		db.execute_batch_row(command, i, cl_format("row %1", i));
+
+	// Parameters are cleared between rows
+	command.set_input_parameter_int(1, 100);
+	db.execute_batch_row(command);
+
+	if (db.commit_batch(command) != 101)
+		fail();
+	if (db.commit_batch(command) != 0)
+		fail();
+
+	CL_DBCommand count = db.create_command("SELECT COUNT(*) FROM items");
+	if (db.execute_scalar_int(count) != 101)
+		fail();
+	CL_DBCommand check = db.create_command("SELECT name FROM items WHERE id=?1", 42);
+	if (db.execute_scalar_string(check) != "row 42")
+		fail();
+	CL_DBCommand null_check = db.create_command("SELECT COUNT(*) FROM items WHERE id=100 AND name IS NULL");
+	if (db.execute_scalar_int(null_check) != 1)
+		fail();
+
+	// A batch that is never committed is rolled back
+	{
+		CL_DBCommand uncommitted = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)");
+		for (int i = 200; i < 210; i++)
+			db.execute_batch_row(uncommitted, i, "uncommitted");
+	}
+	if (db.execute_scalar_int(count) != 101)
+		fail();
+
+	// Inside an explicit transaction the batch does not commit on its own
+	CL_DBTransaction transaction = db.begin_transaction();
+	for (int i = 300; i < 310; i++)
+		db.execute_batch_row(command, i, "explicit");
+	if (db.commit_batch(command) != 10)
+		fail();
+	transaction.rollback();
+	if (db.execute_scalar_int(count) != 101)
+		fail();
+}
+
+void TestApp::test_batch_failure()
+{
+	CL_Console::write_line("  Function: execute_batch_row() failure");
+
+	CL_SqliteConnection db(":memory:");
+	create_test_table(db, 0);
+
+	CL_DBCommand command = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)");
+	db.execute_batch_row(command, 1, "first");
+	db.execute_batch_row(command, 2, "second");
+
+	bool thrown = false;
+	try
+	{
+		db.execute_batch_row(command, 1, "duplicate");
+	}
+	catch (CL_Exception &)
+	{
+		thrown = true;
+	}
+	if (!thrown)
+		fail();
+
+	// The failed batch was rolled back and a new one can start
+	CL_DBCommand count = db.create_command("SELECT COUNT(*) FROM items");
+	if (db.execute_scalar_int(count) != 0)
+		fail();
+	db.execute_batch_row(command, 3, "third");
+	if (db.commit_batch(command) != 1)
+		fail();
+	if (db.execute_scalar_int(count) != 1)
+		fail();
+}
+
+void TestApp::benchmark_batch()
+{
+	CL_Console::write_line("  Benchmark: bulk insert");
+
+	CL_String filename = "sqlite_batch_benchmark.db";
+	delete_database(filename);
+	{
+		CL_SqliteConnection db(filename);
+		create_test_table(db, 0);
+
+		const int autocommit_rows = 1000;
+		unsigned int start_time = CL_System::get_time();
+		for (int i = 0; i < autocommit_rows; i++)
+		{
+			CL_DBCommand command = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)", i, "telemetry");
+			db.execute_non_query(command);
+		}
+		unsigned int time = CL_System::get_time() - start_time;
+		CL_Console::write_line("   execute_non_query: %1 rows per second", (int)(autocommit_rows * 1000.0 / cl_max(time, 1u)));
+
+		const int batch_rows = 200000;
+		start_time = CL_System::get_time();
+		CL_DBCommand command = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)");
+		for (int i = 0; i < batch_rows; i++)
+			db.execute_batch_row(command, autocommit_rows + i, "telemetry");
+		db.commit_batch(command);
+		time = CL_System::get_time() - start_time;
+		CL_Console::write_line("   execute_batch_row: %1 rows per second", (int)(batch_rows * 1000.0 / cl_max(time, 1u)));
+	}
+	delete_database(filename);
+}
+
+void TestApp::test_column_access()
+{
+	CL_Console::write_line(" Header: db_reader.h");
+	CL_Console::write_line("  Function: get_column_string_ref()");
+
+	CL_SqliteConnection db(":memory:");
+	CL_DBCommand create = db.create_command("CREATE TABLE blobs (id INTEGER PRIMARY KEY, name TEXT, data BLOB)");
+	db.execute_non_query(create);
+
+	CL_DataBuffer blob(256);
+	for (int i = 0; i < blob.get_size(); i++)
+		blob.get_data()[i] = (char)i;
+	CL_DBCommand insert = db.create_command("INSERT INTO blobs (id, name, data) VALUES (?1, ?2, ?3)", 1, "first", blob);
+	db.execute_non_query(insert);
+	CL_DBCommand insert_null = db.create_command("INSERT INTO blobs (id) VALUES (2)");
+	db.execute_non_query(insert_null);
+
+	CL_DBCommand select = db.create_command("SELECT id, name, data, id AS name FROM blobs ORDER BY id");
+	CL_DBReader reader = db.execute_reader(select);
+	if (!reader.retrieve_row())
+		fail();
+	if (reader.get_column_string_ref(1) != "first" || reader.get_column_string_ref(1).length() != 5)
+		fail();
+	if (reader.get_column_binary_size(2) != 256 || memcmp(reader.get_column_binary_data(2), blob.get_data(), 256) != 0)
+		fail();
+
+	CL_Console::write_line("  Function: get_name_index()");
+	if (reader.get_name_index("id") != 0 || reader.get_name_index("data") != 2)
+		fail();
+	// With duplicate column names the first one wins, as with a linear search
+	if (reader.get_name_index("name") != 1)
+		fail();
+	bool thrown = false;
+	try
+	{
+		reader.get_name_index("missing");
+	}
+	catch (CL_Exception &)
+	{
+		thrown = true;
+	}
+	if (!thrown)
+		fail();
+
+	if (!reader.retrieve_row())
+		fail();
+	if (!reader.get_column_string_ref(1).empty() || reader.get_column_binary_size(2) != 0)
+		fail();
+	reader.close();
+	select = CL_DBCommand();
+
+	// The cached column lookup follows schema changes of a reused statement
+	CL_DBCommand star = db.create_command("SELECT * FROM blobs");
+	reader = db.execute_reader(star);
+	reader.retrieve_row();
+	if (reader.get_name_index("data") != 2)
+		fail();
+	reader.close();
+	star = CL_DBCommand();
+	CL_DBCommand alter = db.create_command("ALTER TABLE blobs ADD COLUMN extra TEXT");
+	db.execute_non_query(alter);
+	star = db.create_command("SELECT * FROM blobs");
+	reader = db.execute_reader(star);
+	reader.retrieve_row();
+	if (reader.get_name_index("extra") != 3)
+		fail();
+	reader.close();
+}
+
+void TestApp::test_datetime_storage()
+{
+	CL_Console::write_line(" Header: sqlite_connection.h");
+	CL_Console::write_line("  Function: set_datetime_storage()");
+
+	CL_SqliteConnection db(":memory:");
+	CL_DBCommand create = db.create_command("CREATE TABLE events (id INTEGER PRIMARY KEY, time DATETIME)");
+	db.execute_non_query(create);
+
+	CL_DateTime time(2011, 6, 15, 12, 30, 45, 0, CL_DateTime::utc_timezone);
+
+	CL_DBCommand insert_text = db.create_command("INSERT INTO events (id, time) VALUES (?1, ?2)", 1, time);
+	db.execute_non_query(insert_text);
+
+	db.set_datetime_storage(CL_SqliteConnection::datetime_ticks);
+	if (db.get_datetime_storage() != CL_SqliteConnection::datetime_ticks)
+		fail();
+	CL_DBCommand insert_ticks = db.create_command("INSERT INTO events (id, time) VALUES (?1, ?2)", 2, time);
+	db.execute_non_query(insert_ticks);
+
+	CL_DBCommand type_check = db.create_command("SELECT typeof(time) FROM events WHERE id=2");
+	if (db.execute_scalar_string(type_check) != "integer")
+		fail();
+
+	// Both representations read back as the same time
+	CL_DBCommand select = db.create_command("SELECT time FROM events ORDER BY id");
+	CL_DBReader reader = db.execute_reader(select);
+	std::vector<CL_DateTime> times;
+	while (reader.retrieve_row())
+		times.push_back(reader.get_column_datetime(0));
+	reader.close();
+	if (times.size() != 2)
+		fail();
+	if (times[0].to_short_datetime_string() != time.to_short_datetime_string())
+		fail();
+	if (times[1] != time)
+		fail();
+}
+
+void TestApp::benchmark_reader()
+{
+	CL_Console::write_line("  Benchmark: reading a large result set");
+
+	CL_SqliteConnection db(":memory:");
+	CL_DBCommand create = db.create_command("CREATE TABLE telemetry (id INTEGER PRIMARY KEY, source TEXT, message TEXT, value REAL, time DATETIME)");
+	db.execute_non_query(create);
+
+	const int num_rows = 200000;
+	CL_DateTime now = CL_DateTime::get_current_utc_time();
+	for (int storage = 0; storage < 2; storage++)
+	{
+		db.set_datetime_storage(storage == 0 ? CL_SqliteConnection::datetime_text : CL_SqliteConnection::datetime_ticks);
+
+		CL_DBCommand clear = db.create_command("DELETE FROM telemetry");
+		db.execute_non_query(clear);
+		CL_DBCommand insert = db.create_command("INSERT INTO telemetry (id, source, message, value, time) VALUES (?1, ?2, ?3, ?4, ?5)");
+		for (int i = 0; i < num_rows; i++)
+			db.execute_batch_row(insert, i, "sensor", "a telemetry message of moderate length", i * 0.5, now);
+		db.commit_batch(insert);
+
+		for (int mode = 0; mode < 2; mode++)
+		{
+			unsigned int start_time = CL_System::get_time();
+			CL_DBCommand select = db.create_command("SELECT id, source, message, value, time FROM telemetry");
+			CL_DBReader reader = db.execute_reader(select);
+			int total_length = 0;
+			while (reader.retrieve_row())
+			{
+				if (mode == 0)
+				{
+					total_length += reader.get_column_string("source").length();
+					total_length += reader.get_column_string("message").length();
+				}
+				else
+				{
+					total_length += reader.get_column_string_ref(reader.get_name_index("source")).length();
+					total_length += reader.get_column_string_ref(reader.get_name_index("message")).length();
+				}
+				reader.get_column_datetime(4);
+			}
+			reader.close();
+			unsigned int time = CL_System::get_time() - start_time;
+			CL_Console::write_line("   %1, %2: %3 rows in %4 ms",
+				storage == 0 ? "text datetimes" : "tick datetimes",
+				mode == 0 ? "get_column_string" : "get_column_string_ref",
+				num_rows, (int)time);
+		}
+	}
+}
+
+void TestApp::test_connection_pool()
+{
+	CL_Console::write_line(" Header: db_connection_pool.h");
+	CL_Console::write_line("  Function: get_connection()");
+
+	pool_filename = "sqlite_pool_test.db";
+	delete_database(pool_filename);
+	{
+		CL_DBConnectionPool pool(CL_Callback_0<CL_DBConnection>(this, &TestApp::open_pool_connection));
+
+		CL_DBConnection connection = pool.get_connection();
+		CL_DBCommand journal_mode = connection.create_command("PRAGMA journal_mode");
+		if (connection.execute_scalar_string(journal_mode) != "wal")
+			fail();
+		journal_mode = CL_DBCommand();
+
+		// The same thread always gets the same connection
+		if (pool.get_connection().get_provider() != connection.get_provider())
+			fail();
+
+		// Another thread gets its own connection, which returns to the pool when the thread ends
+		CL_DBConnectionProvider *thread_provider = 0;
+		CL_Thread thread;
+		thread.start(this, &TestApp::pool_connection_worker, &pool, &thread_provider);
+		thread.join();
+		if (thread_provider == 0 || thread_provider == connection.get_provider())
+			fail();
+		if (pool.get_connection_count() != 2 || pool.get_idle_connection_count() != 1)
+			fail();
+
+		// Released connections are reused
+		pool.release_connection();
+		if (pool.get_idle_connection_count() != 2)
+			fail();
+		if (pool.get_connection().get_provider() != connection.get_provider() && pool.get_connection().get_provider() != thread_provider)
+			fail();
+		if (pool.get_connection_count() != 2 || pool.get_idle_connection_count() != 1)
+			fail();
+
+		pool.close_idle_connections();
+		if (pool.get_connection_count() != 1 || pool.get_idle_connection_count() != 0)
+			fail();
+		pool.release_connection();
+	}
+	delete_database(pool_filename);
+}
+
+void TestApp::benchmark_connection_pool()
+{
+	CL_Console::write_line("  Benchmark: concurrent reads");
+
+	pool_filename = "sqlite_pool_benchmark.db";
+	delete_database(pool_filename);
+	{
+		CL_DBConnectionPool pool(CL_Callback_0<CL_DBConnection>(this, &TestApp::open_pool_connection));
+
+		CL_DBConnection db = pool.get_connection();
+		CL_DBCommand create = db.create_command("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+		db.execute_non_query(create);
+		CL_DBCommand insert = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)");
+		for (int i = 0; i < 100000; i++)
+			db.execute_batch_row(insert, i, cl_format("item %1", i));
+		db.commit_batch(insert);
+		insert = CL_DBCommand();
+		create = CL_DBCommand();
+		db = CL_DBConnection();
+		pool.release_connection();
+
+		const int queries_per_thread = 50000;
+		for (int with_writer = 0; with_writer < 2; with_writer++)
+		{
+			for (int num_threads = 1; num_threads <= 4; num_threads *= 2)
+			{
+				std::vector<CL_Thread> threads(num_threads);
+				std::vector<CL_String> errors(num_threads);
+				CL_Thread writer;
+				CL_String writer_error;
+				volatile bool stop_writer = false;
+
+				unsigned int start_time = CL_System::get_time();
+				if (with_writer)
+					writer.start(this, &TestApp::pool_writer_worker, &pool, &stop_writer, &writer_error);
+				for (int i = 0; i < num_threads; i++)
+					threads[i].start(this, &TestApp::pool_reader_worker, &pool, queries_per_thread, &errors[i]);
+				for (int i = 0; i < num_threads; i++)
+					threads[i].join();
+				unsigned int time = CL_System::get_time() - start_time;
+				stop_writer = true;
+				if (with_writer)
+					writer.join();
+
+				for (int i = 0; i < num_threads; i++)
+				{
+					if (!errors[i].empty())
+						throw CL_Exception(errors[i]);
+				}
+				if (!writer_error.empty())
+					throw CL_Exception(writer_error);
+
+				CL_Console::write_line("   %1 reader threads%2: %3 queries per second", num_threads, with_writer ? " and a writer" : "",
+					(int)(num_threads * queries_per_thread * 1000.0 / cl_max(time, 1u)));
+			}
+		}
+	}
+	delete_database(pool_filename);
+}
+
+CL_DBConnection TestApp::open_pool_connection()
+{
+	CL_SqliteConnection connection(pool_filename);
+	connection.set_journal_mode(CL_SqliteConnection::journal_wal);
+	connection.set_synchronous(CL_SqliteConnection::synchronous_normal);
+	connection.set_cache_size(16*1024);
+	connection.set_mmap_size(64*1024*1024);
+	connection.set_busy_timeout(5000);
+	return connection;
+}
+
+void TestApp::pool_connection_worker(CL_DBConnectionPool *pool, CL_DBConnectionProvider **provider)
+{
+	*provider = pool->get_connection().get_provider();
+}
+
+void TestApp::pool_reader_worker(CL_DBConnectionPool *pool, int num_queries, CL_String *error)
+{
+	try
+	{
+		CL_DBConnection db = pool->get_connection();
+		for (int i = 0; i < num_queries; i++)
+		{
+			CL_DBCommand command = db.create_command("SELECT name FROM items WHERE id=?1", (i * 7919) % 100000);
+			CL_DBReader reader = db.execute_reader(command);
+			if (!reader.retrieve_row() || reader.get_column_string_ref(0).empty())
+				throw CL_Exception("Row not found");
+			reader.close();
+		}
+	}
+	catch (CL_Exception &e)
+	{
+		*error = e.message;
+	}
+}
+
+void TestApp::pool_writer_worker(CL_DBConnectionPool *pool, volatile bool *stop, CL_String *error)
+{
+	try
+	{
+		CL_DBConnection db = pool->get_connection();
+		CL_DBCommand command = db.create_command("UPDATE items SET name=?2 WHERE id=?1");
+		int row = 0;
+		while (!*stop)
+		{
+			for (int i = 0; i < 100; i++, row++)
+				db.execute_batch_row(command, row % 100000, cl_format("updated %1", row));
+			db.commit_batch(command);
+		}
+	}
+	catch (CL_Exception &e)
+	{
+		*error = e.message;
+	}
+}
+
+void TestApp::create_test_table(CL_SqliteConnection &db, int num_rows)
+{
+	CL_DBCommand create = db.create_command("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+	db.execute_non_query(create);
+
+	CL_DBTransaction transaction = db.begin_transaction();
+	for (int i = 0; i < num_rows; i++)
+	{
+		CL_DBCommand command = db.create_command("INSERT INTO items (id, name) VALUES (?1, ?2)", i, cl_format("item %1", i));
+		db.execute_non_query(command);
+	}
+	transaction.commit();
+}
+
+void TestApp::delete_database(const CL_String &filename)
+{
+	const char *suffixes[] = { "", "-wal", "-shm", "-journal" };
+	for (int i = 0; i < 4; i++)
+	{
+		if (CL_FileHelp::file_exists(filename + suffixes[i]))
+			CL_FileHelp::delete_file(filename + suffixes[i]);
+	}
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}
@@ -0,0 +1,64 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/database.h>
+#include <ClanLib/sqlite.h>
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	void test_statement_cache();
+	void test_statement_cache_eviction();
+	void test_statement_cache_reuse();
+	void benchmark_statement_cache();
+	void test_batch();
+	void test_batch_failure();
+	void benchmark_batch();
+	void test_column_access();
+	void test_datetime_storage();
+	void benchmark_reader();
+	void test_connection_pool();
+	void benchmark_connection_pool();
+
+	void create_test_table(CL_SqliteConnection &db, int num_rows);
+	void delete_database(const CL_String &filename);
+	void fail();
+
+	CL_DBConnection open_pool_connection();
+	void pool_connection_worker(CL_DBConnectionPool *pool, CL_DBConnectionProvider **provider);
+	void pool_reader_worker(CL_DBConnectionPool *pool, int num_queries, CL_String *error);
+	void pool_writer_worker(CL_DBConnectionPool *pool, volatile bool *stop, CL_String *error);
+
+	CL_String pool_filename;
+};
@@ -0,0 +1,479 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanDisplay collision outline");
+
+		random_seed = 1;
+		test_intersections();
+		test_threads();
+		test_save_load();
+		test_load_invalid();
+		benchmark();
+		benchmark_load();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_intersections()
+{
+	CL_Console::write_line(" Intersections match testing every pair of line segments");
+
+	int total_intersections = 0;
+	for (int test = 0; test < 200; test++)
+	{
+		CL_CollisionOutline outline1 = create_outline(0.0f, 0.0f, 20.0f + random(200.0f), 3 + (int) random(500.0f));
+		CL_CollisionOutline outline2 = create_outline(random(300.0f) - 150.0f, random(300.0f) - 150.0f, 20.0f + random(200.0f), 3 + (int) random(500.0f));
+		outline1.rotate(CL_Angle(random(360.0f), cl_degrees));
+		outline2.rotate(CL_Angle(random(360.0f), cl_degrees));
+
+		std::vector<Intersection> expected = find_intersections_brute_force(outline1, outline2);
+		std::vector<Intersection> intersections = find_intersections(outline1, outline2);
+		if (intersections.size() != expected.size())
+			fail();
+		for (size_t i = 0; i < intersections.size(); i++)
+		{
+			const Intersection &a = intersections[i];
+			const Intersection &b = expected[i];
+			if (a.contour1 != b.contour1 || a.contour2 != b.contour2 || a.line1 != b.line1 || a.line2 != b.line2 || a.point != b.point)
+				fail();
+		}
+
+		outline1.enable_collision_info(false, false, false, false);
+		if (outline1.collide(outline2) != !expected.empty())
+			fail();
+
+		total_intersections += expected.size();
+	}
+
+	if (total_intersections == 0)
+		fail();
+}
+
+void TestApp::test_threads()
+{
+	CL_Console::write_line(" One outline collides with others from several threads at once");
+
+	shared_outline = create_outline(0.0f, 0.0f, 200.0f, 1000);
+	shared_outline.enable_collision_info(false, false, false, false);
+	thread_outlines.clear();
+	thread_expected.clear();
+	for (int i = 0; i < 64; i++)
+	{
+		CL_CollisionOutline outline = create_outline(random(500.0f) - 250.0f, random(500.0f) - 250.0f, 20.0f + random(100.0f), 3 + (int) random(500.0f));
+		thread_outlines.push_back(outline);
+		thread_expected.push_back(shared_outline.collide(outline));
+	}
+
+	const int num_threads = 4;
+	thread_mismatches.assign(num_threads, 0);
+	std::vector<CL_Thread> threads(num_threads);
+	for (int i = 0; i < num_threads; i++)
+		threads[i].start(this, &TestApp::collide_thread, i);
+	for (int i = 0; i < num_threads; i++)
+		threads[i].join();
+
+	for (int i = 0; i < num_threads; i++)
+	{
+		if (thread_mismatches[i] != 0)
+			fail();
+	}
+}
+
+void TestApp::collide_thread(int thread_index)
+{
+	for (int repeat = 0; repeat < 50; repeat++)
+	{
+		for (size_t i = thread_index; i < thread_outlines.size(); i++)
+		{
+			if (shared_outline.collide(thread_outlines[i]) != thread_expected[i])
+				thread_mismatches[thread_index]++;
+		}
+	}
+}
+
+void TestApp::benchmark()
+{
+	CL_Console::write_line(" Benchmark: outlines with 2000 points");
+
+	CL_CollisionOutline outline1 = create_outline(0.0f, 0.0f, 300.0f, 2000);
+	CL_CollisionOutline outline2 = create_outline(0.0f, 0.0f, 300.0f, 2000);
+
+	const int iterations = 200;
+	cl_ubyte64 collide_time = 0;
+	cl_ubyte64 collision_info_time = 0;
+	int collisions = 0;
+	for (int i = 0; i < iterations; i++)
+	{
+		outline2.set_translation(1200.0f * i / iterations - 600.0f, 100.0f);
+		outline2.rotate(CL_Angle(5.0f, cl_degrees));
+
+		outline1.enable_collision_info(false, false, false, false);
+		cl_ubyte64 start_time = CL_System::get_microseconds();
+		if (outline1.collide(outline2))
+			collisions++;
+		collide_time += CL_System::get_microseconds() - start_time;
+
+		outline1.enable_collision_info(true, true, true, false);
+		start_time = CL_System::get_microseconds();
+		outline1.collide(outline2);
+		collision_info_time += CL_System::get_microseconds() - start_time;
+	}
+
+	if (collisions == 0)
+		fail();
+
+	CL_Console::write_line("   collide: %1 us per test", (int) (collide_time / iterations));
+	CL_Console::write_line("   collide with collision info: %1 us per test", (int) (collision_info_time / iterations));
+}
+
+void TestApp::test_save_load()
+{
+	CL_Console::write_line(" Saved outlines load with their sub circles");
+
+	CL_CollisionOutline outline = create_outline(10.0f, 20.0f, 100.0f, 300);
+	outline.rotate(CL_Angle(30.0f, cl_degrees));
+
+	CL_IODevice_Memory file;
+	outline.save(file);
+	CL_CollisionOutline loaded = load(file.get_data());
+
+	if (loaded.get_width() != outline.get_width() || loaded.get_height() != outline.get_height())
+		fail();
+	if (loaded.get_minimum_enclosing_disc().position != outline.get_minimum_enclosing_disc().position ||
+		loaded.get_minimum_enclosing_disc().radius != outline.get_minimum_enclosing_disc().radius)
+		fail();
+
+	const std::vector<CL_Contour> &contours = outline.get_contours();
+	const std::vector<CL_Contour> &loaded_contours = loaded.get_contours();
+	if (loaded_contours.size() != contours.size())
+		fail();
+	for (size_t c = 0; c < contours.size(); c++)
+	{
+		if (loaded_contours[c].get_points() != contours[c].get_points())
+			fail();
+		if (loaded_contours[c].is_inside_contour() != contours[c].is_inside_contour())
+			fail();
+
+		const std::vector<CL_OutlineCircle> &sub_circles = contours[c].get_sub_circles();
+		const std::vector<CL_OutlineCircle> &loaded_sub_circles = loaded_contours[c].get_sub_circles();
+		if (loaded_sub_circles.size() != sub_circles.size())
+			fail();
+		for (size_t i = 0; i < sub_circles.size(); i++)
+		{
+			if (loaded_sub_circles[i].position != sub_circles[i].position || loaded_sub_circles[i].radius != sub_circles[i].radius ||
+				loaded_sub_circles[i].start != sub_circles[i].start || loaded_sub_circles[i].end != sub_circles[i].end)
+				fail();
+		}
+	}
+
+	// Version 1 files have no sub circles, so they are calculated when loading
+	CL_CollisionOutline loaded_version1 = load(save_version1(outline));
+	const std::vector<CL_Contour> &version1_contours = loaded_version1.get_contours();
+	if (version1_contours.size() != contours.size())
+		fail();
+	for (size_t c = 0; c < contours.size(); c++)
+	{
+		if (version1_contours[c].get_points() != contours[c].get_points() || version1_contours[c].get_sub_circles().empty())
+			fail();
+	}
+	if (loaded_version1.get_minimum_enclosing_disc().radius <= 0.0f)
+		fail();
+}
+
+void TestApp::test_load_invalid()
+{
+	CL_Console::write_line(" Corrupt sub circles are rejected when loading");
+
+	CL_CollisionOutline outline = create_outline(0.0f, 0.0f, 100.0f, 40);
+	CL_IODevice_Memory file;
+	outline.save(file);
+	CL_DataBuffer data = file.get_data();
+
+	// Offsets in a version 2 file: the first contour starts after the 32 byte header and contour count
+	const int num_points = outline.get_contours()[0].get_points().size();
+	const int num_points_offset = 36;
+	const int sub_circle_offset = 44 + num_points * 8;
+	const int end_offset = sub_circle_offset + 16;
+
+	const std::vector<CL_OutlineCircle> &sub_circles = outline.get_contours()[0].get_sub_circles();
+	if (sub_circles.size() < 2 || sub_circles[1].start == 0)
+		fail();
+
+	load(data);
+	if (!load_fails(data, end_offset, sub_circles[0].start))
+		fail();
+	if (!load_fails(data, end_offset + 20, sub_circles[1].start - 1))
+		fail();
+	if (!load_fails(data, end_offset, num_points + 1))
+		fail();
+	if (!load_fails(data, num_points_offset, 1))
+		fail();
+}
+
+void TestApp::benchmark_load()
+{
+	CL_Console::write_line(" Benchmark: loading outlines with 2000 points");
+
+	CL_CollisionOutline outline = create_outline(0.0f, 0.0f, 300.0f, 2000);
+	CL_IODevice_Memory file;
+	outline.save(file);
+	CL_DataBuffer data = file.get_data();
+	CL_DataBuffer data_version1 = save_version1(outline);
+
+	const int iterations = 100;
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		load(data_version1);
+	cl_ubyte64 version1_time = CL_System::get_microseconds() - start_time;
+
+	start_time = CL_System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		load(data);
+	cl_ubyte64 version2_time = CL_System::get_microseconds() - start_time;
+
+	CL_Console::write_line("   version 1: %1 us per outline", (int) (version1_time / iterations));
+	CL_Console::write_line("   version 2: %1 us per outline", (int) (version2_time / iterations));
+}
+
+CL_DataBuffer TestApp::save_version1(const CL_CollisionOutline &outline)
+{
+	CL_IODevice_Memory file;
+	file.write_uint32(0x16082004);
+	file.write_uint8(1);
+	file.write_int32(outline.get_width());
+	file.write_int32(outline.get_height());
+	file.write_float(outline.get_minimum_enclosing_disc().position.x);
+	file.write_float(outline.get_minimum_enclosing_disc().position.y);
+	file.write_float(outline.get_minimum_enclosing_disc().radius);
+
+	const std::vector<CL_Contour> &contours = outline.get_contours();
+	file.write_uint32(contours.size());
+	for (size_t c = 0; c < contours.size(); c++)
+	{
+		const std::vector<CL_Pointf> &points = contours[c].get_points();
+		file.write_uint32(points.size());
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			file.write_float(points[i].x);
+			file.write_float(points[i].y);
+		}
+	}
+	return file.get_data();
+}
+
+CL_CollisionOutline TestApp::load(const CL_DataBuffer &data)
+{
+	CL_DataBuffer copy(data);
+	CL_IODevice_Memory file(copy);
+	CL_CollisionOutline outline;
+	outline.load(file);
+	return outline;
+}
+
+bool TestApp::load_fails(const CL_DataBuffer &data, int offset, cl_ubyte32 value)
+{
+	CL_DataBuffer copy(data);
+	CL_IODevice_Memory file(copy);
+	file.seek(offset);
+	file.write_uint32(value);
+	try
+	{
+		load(file.get_data());
+	}
+	catch (CL_Exception &)
+	{
+		return true;
+	}
+	return false;
+}
+
+std::vector<TestApp::Intersection> TestApp::find_intersections(CL_CollisionOutline &outline1, CL_CollisionOutline &outline2)
+{
+	outline1.enable_collision_info(true, false, true, false);
+	outline1.collide(outline2);
+
+	const std::vector<CL_Contour> &contours1 = outline1.get_contours();
+	const std::vector<CL_Contour> &contours2 = outline2.get_contours();
+
+	std::vector<Intersection> intersections;
+	const std::vector<CL_CollidingContours> &info = outline1.get_collision_info();
+	for (size_t i = 0; i < info.size(); i++)
+	{
+		for (size_t j = 0; j < info[i].points.size(); j++)
+		{
+			Intersection intersection;
+			intersection.contour1 = std::find(contours1.begin(), contours1.end(), *info[i].contour1) - contours1.begin();
+			intersection.contour2 = std::find(contours2.begin(), contours2.end(), *info[i].contour2) - contours2.begin();
+			intersection.line1 = info[i].points[j].contour1_line_start;
+			intersection.line2 = info[i].points[j].contour2_line_start;
+			intersection.point = info[i].points[j].point;
+			intersections.push_back(intersection);
+		}
+	}
+	std::sort(intersections.begin(), intersections.end());
+	return intersections;
+}
+
+std::vector<TestApp::Intersection> TestApp::find_intersections_brute_force(const CL_CollisionOutline &outline1, const CL_CollisionOutline &outline2)
+{
+	const std::vector<CL_Contour> &contours1 = outline1.get_contours();
+	const std::vector<CL_Contour> &contours2 = outline2.get_contours();
+
+	std::vector<Intersection> intersections;
+	for (size_t c1 = 0; c1 < contours1.size(); c1++)
+	{
+		const std::vector<CL_Pointf> &points1 = contours1[c1].get_points();
+		for (size_t c2 = 0; c2 < contours2.size(); c2++)
+		{
+			const std::vector<CL_Pointf> &points2 = contours2[c2].get_points();
+			for (size_t i = 0; i < points1.size(); i++)
+			{
+				CL_LineSegment2f line1(points1[i], points1[(i + 1) % points1.size()]);
+				for (size_t j = 0; j < points2.size(); j++)
+				{
+					CL_LineSegment2f line2(points2[j], points2[(j + 1) % points2.size()]);
+					if (cl_min(line2.p.x, line2.q.x) > cl_max(line1.p.x, line1.q.x) || cl_max(line2.p.x, line2.q.x) < cl_min(line1.p.x, line1.q.x) ||
+						cl_min(line2.p.y, line2.q.y) > cl_max(line1.p.y, line1.q.y) || cl_max(line2.p.y, line2.q.y) < cl_min(line1.p.y, line1.q.y))
+						continue;
+
+					bool did_intersect;
+					CL_Pointf point = line1.get_intersection(line2, did_intersect);
+					if (did_intersect)
+					{
+						Intersection intersection;
+						intersection.contour1 = c1;
+						intersection.contour2 = c2;
+						intersection.line1 = i;
+						intersection.line2 = j;
+						intersection.point = point;
+						intersections.push_back(intersection);
+					}
+				}
+			}
+		}
+	}
+	std::sort(intersections.begin(), intersections.end());
+	return intersections;
+}
+
+CL_CollisionOutline TestApp::create_outline(float x, float y, float radius, int num_points)
+{
+	// Wobbly ring with a hole, to get many concave and convex corners
+	std::vector<CL_Contour> contours;
+	for (int c = 0; c < 2; c++)
+	{
+		CL_Contour contour;
+		int contour_points = (c == 0) ? num_points : cl_max(num_points / 4, 3);
+		float contour_radius = (c == 0) ? radius : radius * 0.4f;
+		for (int i = 0; i < contour_points; i++)
+		{
+			float angle = i * 2.0f * CL_PI / contour_points;
+			float point_radius = contour_radius * (0.85f + 0.1f * sin(angle * 7.0f) + random(0.05f));
+			contour.get_points().push_back(CL_Pointf(cos(angle) * point_radius, sin(angle) * point_radius));
+		}
+		contour.set_inside_contour(c == 1);
+		contours.push_back(contour);
+	}
+
+	CL_CollisionOutline outline(contours, (int) (radius * 2.0f), (int) (radius * 2.0f));
+	outline.calculate_radius();
+	outline.calculate_sub_circles();
+	outline.set_translation(x, y);
+	return outline;
+}
+
+bool TestApp::Intersection::operator<(const Intersection &other) const
+{
+	if (contour1 != other.contour1)
+		return contour1 < other.contour1;
+	if (contour2 != other.contour2)
+		return contour2 < other.contour2;
+	if (line1 != other.line1)
+		return line1 < other.line1;
+	return line2 < other.line2;
+}
+
+float TestApp::random(float max_value)
+{
+	random_seed = random_seed * 1103515245 + 12345;
+	return ((random_seed >> 8) & 0xffff) / 65536.0f * max_value;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
@@ -0,0 +1,72 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+#include <algorithm>
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	struct Intersection
+	{
+		int contour1, contour2;
+		int line1, line2;
+		CL_Pointf point;
+		bool operator<(const Intersection &other) const;
+	};
+
+	void test_intersections();
+	void test_threads();
+	void test_save_load();
+	void test_load_invalid();
+	void benchmark();
+	void benchmark_load();
+
+	void collide_thread(int thread_index);
+	std::vector<Intersection> find_intersections(CL_CollisionOutline &outline1, CL_CollisionOutline &outline2);
+	std::vector<Intersection> find_intersections_brute_force(const CL_CollisionOutline &outline1, const CL_CollisionOutline &outline2);
+	CL_CollisionOutline create_outline(float x, float y, float radius, int num_points);
+	CL_DataBuffer save_version1(const CL_CollisionOutline &outline);
+	CL_CollisionOutline load(const CL_DataBuffer &data);
+	bool load_fails(const CL_DataBuffer &data, int offset, cl_ubyte32 value);
+	float random(float max_value);
+	void fail();
+
+	unsigned int random_seed;
+
+	CL_CollisionOutline shared_outline;
+	std::vector<CL_CollisionOutline> thread_outlines;
+	std::vector<bool> thread_expected;
+	std::vector<int> thread_mismatches;
+};
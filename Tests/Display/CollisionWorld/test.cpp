@@ -0,0 +1,290 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanDisplay collision world");
+
+		random_seed = 1;
+		test_add_remove();
+		test_candidate_pairs();
+		test_collisions();
+		benchmark();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_add_remove()
+{
+	CL_Console::write_line(" Outline ids are reused after removal");
+
+	CL_CollisionWorld world;
+	int id1 = world.add(create_outline(0.0f, 0.0f, 10.0f, 8));
+	int id2 = world.add(create_outline(12.0f, 0.0f, 10.0f, 8));
+	int id3 = world.add(create_outline(100.0f, 0.0f, 10.0f, 8));
+	if (world.get_outline_count() != 3 || id1 == id2 || id2 == id3)
+		fail();
+
+	std::vector<CL_CollisionPair> pairs = world.find_collisions();
+	if (pairs.size() != 1 || pairs[0].outline1 != id1 || pairs[0].outline2 != id2)
+		fail();
+
+	world.remove(id2);
+	if (world.get_outline_count() != 2 || !world.find_collisions().empty())
+		fail();
+
+	int id4 = world.add(create_outline(95.0f, 0.0f, 10.0f, 8));
+	if (id4 != id2)
+		fail();
+
+	pairs = world.find_collisions();
+	if (pairs.size() != 1 || pairs[0].outline1 != id4 || pairs[0].outline2 != id3)
+		fail();
+
+	world.clear();
+	if (world.get_outline_count() != 0 || !world.find_candidate_pairs().empty())
+		fail();
+}
+
+void TestApp::test_candidate_pairs()
+{
+	CL_Console::write_line(" Candidate pairs match a brute force enclosing disc test");
+
+	for (int cell_size = 0; cell_size <= 50; cell_size += 50)
+	{
+		CL_CollisionWorld world;
+		world.set_cell_size((float) cell_size);
+		std::vector<CL_CollisionOutline> outlines;
+		create_random_outlines(world, outlines, 1000, 2000.0f);
+
+		// A few outlines larger than the grid cells:
+		for (int i = 0; i < 3; i++)
+		{
+			outlines.push_back(create_outline(random(2000.0f), random(2000.0f), 400.0f, 32));
+			world.add(outlines.back());
+		}
+
+		std::vector<CL_CollisionPair> expected;
+		for (size_t i = 0; i < outlines.size(); i++)
+		{
+			CL_Circlef disc1 = outlines[i].get_minimum_enclosing_disc();
+			for (size_t j = i + 1; j < outlines.size(); j++)
+			{
+				CL_Circlef disc2 = outlines[j].get_minimum_enclosing_disc();
+				float dx = disc1.position.x - disc2.position.x;
+				float dy = disc1.position.y - disc2.position.y;
+				float radius = disc1.radius + disc2.radius;
+				if (dx * dx + dy * dy <= radius * radius)
+				{
+					CL_CollisionPair pair;
+					pair.outline1 = i;
+					pair.outline2 = j;
+					expected.push_back(pair);
+				}
+			}
+		}
+
+		std::vector<CL_CollisionPair> pairs = world.find_candidate_pairs();
+		if (pairs.size() != expected.size())
+			fail();
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			if (pairs[i].outline1 != expected[i].outline1 || pairs[i].outline2 != expected[i].outline2)
+				fail();
+		}
+	}
+}
+
+void TestApp::test_collisions()
+{
+	CL_Console::write_line(" Collisions match testing every pair, with and without threads");
+
+	CL_CollisionWorld world;
+	std::vector<CL_CollisionOutline> outlines;
+	create_random_outlines(world, outlines, 1000, 1500.0f);
+
+	std::vector<CL_CollisionPair> expected;
+	for (size_t i = 0; i < outlines.size(); i++)
+	{
+		for (size_t j = i + 1; j < outlines.size(); j++)
+		{
+			if (outlines[i].collide(outlines[j]))
+			{
+				CL_CollisionPair pair;
+				pair.outline1 = i;
+				pair.outline2 = j;
+				expected.push_back(pair);
+			}
+		}
+	}
+	if (expected.empty())
+		fail();
+
+	for (int num_threads = 1; num_threads <= 4; num_threads += 3)
+	{
+		std::vector<CL_CollisionPair> pairs = world.find_collisions(num_threads);
+		if (pairs.size() != expected.size())
+			fail();
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			if (pairs[i].outline1 != expected[i].outline1 || pairs[i].outline2 != expected[i].outline2)
+				fail();
+		}
+	}
+}
+
+void TestApp::benchmark()
+{
+	CL_Console::write_line(" Benchmark: 5000 moving outlines");
+
+	CL_CollisionWorld world;
+	std::vector<CL_CollisionOutline> outlines;
+	create_random_outlines(world, outlines, 5000, 5000.0f);
+
+	const int frames = 10;
+	unsigned int brute_force_time = 0;
+	unsigned int world_time = 0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		for (size_t i = 0; i < outlines.size(); i++)
+		{
+			CL_Pointf position = outlines[i].get_translation();
+			outlines[i].set_translation(position.x + random(10.0f) - 5.0f, position.y + random(10.0f) - 5.0f);
+		}
+
+		unsigned int start_time = CL_System::get_time();
+		int brute_force_collisions = 0;
+		for (size_t i = 0; i < outlines.size(); i++)
+		{
+			for (size_t j = i + 1; j < outlines.size(); j++)
+			{
+				if (outlines[i].collide(outlines[j]))
+					brute_force_collisions++;
+			}
+		}
+		brute_force_time += CL_System::get_time() - start_time;
+
+		start_time = CL_System::get_time();
+		int world_collisions = world.find_collisions(0).size();
+		world_time += CL_System::get_time() - start_time;
+
+		if (world_collisions != brute_force_collisions)
+			fail();
+	}
+
+	CL_Console::write_line("   Every pair: %1 ms per frame", (int) (brute_force_time / frames));
+	CL_Console::write_line("   Collision world: %1 ms per frame", (int) (world_time / frames));
+}
+
+void TestApp::create_random_outlines(CL_CollisionWorld &world, std::vector<CL_CollisionOutline> &outlines, int count, float world_size)
+{
+	for (int i = 0; i < count; i++)
+	{
+		outlines.push_back(create_outline(random(world_size), random(world_size), 5.0f + random(20.0f), 6 + (int) random(20.0f)));
+		world.add(outlines.back());
+	}
+}
+
+CL_CollisionOutline TestApp::create_outline(float x, float y, float radius, int num_points)
+{
+	// Star shaped contour, to get both concave and convex corners
+	CL_Contour contour;
+	for (int i = 0; i < num_points; i++)
+	{
+		float angle = i * 2.0f * CL_PI / num_points;
+		float point_radius = (i % 2) ? radius : radius * 0.6f;
+		contour.get_points().push_back(CL_Pointf(cos(angle) * point_radius, sin(angle) * point_radius));
+	}
+
+	std::vector<CL_Contour> contours;
+	contours.push_back(contour);
+
+	CL_CollisionOutline outline(contours, (int) (radius * 2.0f), (int) (radius * 2.0f));
+	outline.calculate_radius();
+	outline.calculate_sub_circles();
+	outline.set_translation(x, y);
+	return outline;
+}
+
+float TestApp::random(float max_value)
+{
+	random_seed = random_seed * 1103515245 + 12345;
+	return ((random_seed >> 8) & 0xffff) / 65536.0f * max_value;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed Test");
+}
@@ -0,0 +1,333 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanDisplay JPEG decoding");
+
+		test_restart_intervals();
+		test_scaled_sizes();
+		test_scaled_content();
+		test_low_memory();
+		test_preview();
+		benchmark();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_restart_intervals()
+{
+	CL_Console::write_line(" Restart intervals decoded in parallel match the sequential decoder");
+
+	CL_PixelBuffer image = create_test_image(1031, 517);
+	CL_PixelBuffer reference = decode(encode(image, 0), 1, 1);
+
+	const int intervals[] = { 1, 7, 64, 1000 };
+	for (int i = 0; i < 4; i++)
+	{
+		CL_DataBuffer jpeg = encode(image, intervals[i]);
+		for (int threads = 1; threads <= 5; threads += 2)
+		{
+			CL_PixelBuffer result = decode(jpeg, 1, threads);
+			if (result.get_width() != 1031 || result.get_height() != 517)
+				fail();
+			if (memcmp(result.get_data(), reference.get_data(), 1031 * 517 * 4) != 0)
+				fail();
+		}
+	}
+}
+
+void TestApp::test_scaled_sizes()
+{
+	CL_Console::write_line(" Scaled decoding rounds the image size up");
+
+	CL_DataBuffer jpeg = encode(create_test_image(101, 37), 0);
+	const int denominators[] = { 1, 2, 4, 8 };
+	const int widths[] = { 101, 51, 26, 13 };
+	const int heights[] = { 37, 19, 10, 5 };
+	for (int i = 0; i < 4; i++)
+	{
+		CL_PixelBuffer result = decode(jpeg, denominators[i], 0);
+		if (result.get_width() != widths[i] || result.get_height() != heights[i])
+			fail();
+	}
+}
+
+void TestApp::test_scaled_content()
+{
+	CL_Console::write_line(" Scaled decoding matches a box filtered full size decode");
+
+	CL_DataBuffer jpeg = encode(create_test_image(640, 480), 0);
+	CL_PixelBuffer full = decode(jpeg, 1, 0);
+	const cl_ubyte32 *full_data = (const cl_ubyte32 *) full.get_data();
+
+	for (int scale = 2; scale <= 8; scale *= 2)
+	{
+		CL_PixelBuffer scaled = decode(jpeg, scale, 0);
+		const cl_ubyte32 *scaled_data = (const cl_ubyte32 *) scaled.get_data();
+
+		// Sharp edges ring a bit since only the low frequencies are used
+		int total_error = 0;
+		for (int y = 0; y < scaled.get_height(); y++)
+		{
+			for (int x = 0; x < scaled.get_width(); x++)
+			{
+				cl_ubyte32 pixel = scaled_data[x + y * scaled.get_width()];
+				if ((pixel >> 24) != 0xff)
+					fail();
+
+				for (int shift = 0; shift < 24; shift += 8)
+				{
+					int sum = 0;
+					for (int yy = 0; yy < scale; yy++)
+						for (int xx = 0; xx < scale; xx++)
+							sum += (full_data[x * scale + xx + (y * scale + yy) * 640] >> shift) & 0xff;
+					int average = (sum + scale * scale / 2) / (scale * scale);
+					int error = abs((int) ((pixel >> shift) & 0xff) - average);
+					if (error > 64)
+						fail();
+					total_error += error;
+				}
+			}
+		}
+
+		if (total_error > scaled.get_width() * scaled.get_height() * 3 * 3)
+			fail();
+	}
+}
+
+void TestApp::test_low_memory()
+{
+	CL_Console::write_line(" Low memory decoding matches normal decoding");
+
+	CL_PixelBuffer image = create_test_image(703, 411);
+	for (int progressive = 0; progressive < 2; progressive++)
+	{
+		CL_DataBuffer jpeg = encode(image, progressive ? 0 : 17, progressive != 0);
+		for (int scale = 1; scale <= 8; scale *= 2)
+		{
+			if (!equal(decode(jpeg, scale, 0), decode_low_memory(jpeg, scale)))
+				fail();
+		}
+	}
+}
+
+void TestApp::test_preview()
+{
+	CL_Console::write_line(" Preview is delivered once for progressive images");
+
+	CL_PixelBuffer image = create_test_image(703, 411);
+
+	previews.clear();
+	decode_low_memory(encode(image, 0, false), 1);
+	if (!previews.empty())
+		fail();
+
+	CL_DataBuffer jpeg = encode(image, 0, true);
+	decode_low_memory(jpeg, 1);
+	if (previews.size() != 1)
+		fail();
+	if (previews[0].get_width() != 88 || previews[0].get_height() != 52)
+		fail();
+
+	// Without AC coefficients the preview lacks detail, but the block averages are right
+	CL_PixelBuffer final_image = decode(jpeg, 8, 0);
+	const unsigned char *preview_data = (const unsigned char *) previews[0].get_data();
+	const unsigned char *final_data = (const unsigned char *) final_image.get_data();
+	for (int c = 0; c < 4; c++)
+	{
+		int preview_sum = 0;
+		int final_sum = 0;
+		for (int i = 0; i < 88 * 52; i++)
+		{
+			preview_sum += preview_data[i * 4 + c];
+			final_sum += final_data[i * 4 + c];
+		}
+		if (abs(preview_sum - final_sum) > 88 * 52 * 2)
+			fail();
+	}
+}
+
+void TestApp::benchmark()
+{
+	CL_Console::write_line("Decoding a 4096x3072 JPEG with restart markers:");
+
+	CL_PixelBuffer image = create_test_image(4096, 3072);
+	CL_DataBuffer jpeg = encode(image, 256);
+	for (int scale = 1; scale <= 8; scale *= 2)
+	{
+		for (int threads = 1; threads >= 0; threads--)
+		{
+			cl_ubyte64 start_time = CL_System::get_microseconds();
+			decode(jpeg, scale, threads);
+			cl_ubyte64 end_time = CL_System::get_microseconds();
+			CL_Console::write_line(cl_format("  1/%1 scale, %2: %3 ms", scale, threads == 1 ? "1 thread" : "all cores", (int) (end_time - start_time) / 1000));
+		}
+	}
+
+	CL_Console::write_line("Decoding a 4096x3072 progressive JPEG:");
+
+	jpeg = encode(image, 0, true);
+	for (int low_memory = 0; low_memory < 2; low_memory++)
+	{
+		cl_ubyte64 start_time = CL_System::get_microseconds();
+		if (low_memory)
+			decode_low_memory(jpeg, 1);
+		else
+			decode(jpeg, 1, 0);
+		cl_ubyte64 end_time = CL_System::get_microseconds();
+		CL_Console::write_line(cl_format("  %1: %2 ms", low_memory ? "low memory" : "normal", (int) (end_time - start_time) / 1000));
+	}
+}
+
+CL_PixelBuffer TestApp::create_test_image(int width, int height)
+{
+	// Gradients with a few sharp edges, to get both smooth and high frequency blocks
+	CL_PixelBuffer buffer(width, height, cl_rgba8);
+	cl_ubyte32 *data = (cl_ubyte32 *) buffer.get_data();
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			int red = x * 255 / width;
+			int green = y * 255 / height;
+			int blue = ((x / 37 + y / 23) & 1) ? 200 : 40;
+			data[x + y * width] = (red << 24) + (green << 16) + (blue << 8) + 0xff;
+		}
+	}
+	return buffer;
+}
+
+CL_DataBuffer TestApp::encode(CL_PixelBuffer image, int restart_interval, bool progressive)
+{
+	CL_IODevice_Memory file;
+
+	CL_JPEGCompressor compressor;
+	compressor.set_output(file);
+	compressor.set_size(image.get_width(), image.get_height());
+	compressor.set_quality(90);
+	compressor.set_restart_interval(restart_interval);
+	compressor.set_progressive(progressive);
+	compressor.start();
+
+	std::vector<unsigned char> line(image.get_width() * 3);
+	const cl_ubyte32 *data = (const cl_ubyte32 *) image.get_data();
+	for (int y = 0; y < image.get_height(); y++)
+	{
+		for (int x = 0; x < image.get_width(); x++)
+		{
+			cl_ubyte32 pixel = data[x + y * image.get_width()];
+			line[x * 3 + 0] = pixel >> 24;
+			line[x * 3 + 1] = (pixel >> 16) & 0xff;
+			line[x * 3 + 2] = (pixel >> 8) & 0xff;
+		}
+		const unsigned char *row = &line[0];
+		compressor.write_scanlines(&row, 1);
+	}
+	compressor.finish();
+
+	return file.get_data();
+}
+
+CL_PixelBuffer TestApp::decode(CL_DataBuffer jpeg, int scale_denominator, int num_threads)
+{
+	CL_IODevice_Memory file(jpeg);
+	CL_IODevice device = file;
+	return CL_JPEGProvider::load_scaled(device, scale_denominator, num_threads);
+}
+
+CL_PixelBuffer TestApp::decode_low_memory(CL_DataBuffer jpeg, int scale_denominator)
+{
+	CL_IODevice_Memory file(jpeg);
+	CL_IODevice device = file;
+	return CL_JPEGProvider::load_low_memory(device, CL_Callback_v1<CL_PixelBuffer>(this, &TestApp::on_preview), scale_denominator);
+}
+
+void TestApp::on_preview(CL_PixelBuffer preview)
+{
+	previews.push_back(preview);
+}
+
+bool TestApp::equal(CL_PixelBuffer a, CL_PixelBuffer b)
+{
+	if (a.get_width() != b.get_width() || a.get_height() != b.get_height())
+		return false;
+	return memcmp(a.get_data(), b.get_data(), a.get_width() * a.get_height() * 4) == 0;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}
@@ -0,0 +1,56 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	void test_restart_intervals();
+	void test_scaled_sizes();
+	void test_scaled_content();
+	void test_low_memory();
+	void test_preview();
+	void benchmark();
+
+	CL_PixelBuffer create_test_image(int width, int height);
+	CL_DataBuffer encode(CL_PixelBuffer image, int restart_interval, bool progressive = false);
+	CL_PixelBuffer decode(CL_DataBuffer jpeg, int scale_denominator, int num_threads);
+	CL_PixelBuffer decode_low_memory(CL_DataBuffer jpeg, int scale_denominator);
+	void on_preview(CL_PixelBuffer preview);
+	bool equal(CL_PixelBuffer a, CL_PixelBuffer b);
+	void fail();
+
+	std::vector<CL_PixelBuffer> previews;
+};
@@ -0,0 +1,246 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+		CL_SetupGL setup_gl;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console", 80, 200);
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanDisplay CL_Draw primitives batching");
+
+		CL_DisplayWindow window("Line Speed Test", 800, 600, false, true);
+		CL_GraphicContext gc = window.get_gc();
+		gc.set_map_mode(cl_map_2d_upper_left);
+
+		test_batch_split(gc);
+		test_modelview(gc);
+		test_batcher_order(gc);
+
+		CL_Console::write_line("All Tests Complete");
+
+		benchmark(window, gc);
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_batch_split(CL_GraphicContext &gc)
+{
+	CL_Console::write_line(" Triangles spanning several batches are all drawn");
+
+	// 100x50 cells of two triangles each is 30000 vertices, more than one batch holds
+	gc.clear(CL_Colorf::black);
+	fill_with_triangles(gc, 0, 0, 200, 100, 2, CL_Colorf::red);
+	gc.flush_batcher();
+
+	CL_PixelBuffer pixels = gc.get_pixeldata(cl_rgba8);
+	for (int y = 0; y < 100; y++)
+	{
+		for (int x = 0; x < 200; x++)
+			check_pixel(pixels, x, y, CL_Colorf::red);
+	}
+	check_pixel(pixels, 200, 50, CL_Colorf::black);
+	check_pixel(pixels, 100, 100, CL_Colorf::black);
+}
+
+void TestApp::test_modelview(CL_GraphicContext &gc)
+{
+	CL_Console::write_line(" Modelview changes apply to primitives already batched");
+
+	gc.clear(CL_Colorf::black);
+	fill_with_triangles(gc, 0, 0, 50, 50, 50, CL_Colorf::blue);
+	gc.push_translate(300.0f, 0.0f);
+	fill_with_triangles(gc, 0, 0, 50, 50, 50, CL_Colorf::green);
+	CL_Draw::line(gc, 0.0f, 100.5f, 50.0f, 100.5f, CL_Colorf::white);
+	gc.pop_modelview();
+	fill_with_triangles(gc, 100, 0, 50, 50, 50, CL_Colorf::yellow);
+	gc.flush_batcher();
+
+	CL_PixelBuffer pixels = gc.get_pixeldata(cl_rgba8);
+	check_pixel(pixels, 25, 25, CL_Colorf::blue);
+	check_pixel(pixels, 325, 25, CL_Colorf::green);
+	check_pixel(pixels, 325, 100, CL_Colorf::white);
+	check_pixel(pixels, 25, 100, CL_Colorf::black);
+	check_pixel(pixels, 125, 25, CL_Colorf::yellow);
+	check_pixel(pixels, 425, 25, CL_Colorf::black);
+}
+
+void TestApp::test_batcher_order(CL_GraphicContext &gc)
+{
+	CL_Console::write_line(" Primitives and fills are drawn in submission order");
+
+	// CL_Draw::fill goes through the sprite batcher, gradient_circle and triangle through the primitives batcher
+	gc.clear(CL_Colorf::black);
+	CL_Draw::fill(gc, 0.0f, 0.0f, 100.0f, 100.0f, CL_Colorf::white);
+	CL_Draw::gradient_circle(gc, CL_Pointf(50.0f, 50.0f), 40.0f, CL_Gradient(CL_Colorf::red, CL_Colorf::red));
+	CL_Draw::fill(gc, 40.0f, 40.0f, 60.0f, 60.0f, CL_Colorf::blue);
+	CL_Draw::triangle(gc, CL_Pointf(45.0f, 45.0f), CL_Pointf(55.0f, 45.0f), CL_Pointf(45.0f, 55.0f), CL_Colorf::green);
+	gc.flush_batcher();
+
+	CL_PixelBuffer pixels = gc.get_pixeldata(cl_rgba8);
+	check_pixel(pixels, 5, 5, CL_Colorf::white);
+	check_pixel(pixels, 50, 20, CL_Colorf::red);
+	check_pixel(pixels, 58, 58, CL_Colorf::blue);
+	check_pixel(pixels, 47, 47, CL_Colorf::green);
+}
+
+void TestApp::benchmark(CL_DisplayWindow &window, CL_GraphicContext &gc)
+{
+	// Draws 100000 lines per frame with CL_Draw::line and reports the time spent submitting them.
+	// Press space to switch between lines, boxes and triangles.
+	CL_Console::write_line(" Benchmark: 100000 primitives per frame (space switches mode, escape quits)");
+
+	const int num_lines = 100000;
+	std::vector<CL_Vec2f> points(num_lines * 2);
+	std::vector<CL_Colorf> colors(num_lines);
+	for (int i = 0; i < num_lines; i++)
+	{
+		points[i*2+0] = CL_Vec2f((float)(rand() % 800), (float)(rand() % 600));
+		points[i*2+1] = CL_Vec2f(points[i*2+0].x + (float)(rand() % 41 - 20), points[i*2+0].y + (float)(rand() % 41 - 20));
+		colors[i] = CL_Colorf((rand() % 256) / 255.0f, (rand() % 256) / 255.0f, (rand() % 256) / 255.0f);
+	}
+
+	int mode = 0;
+	const char *mode_names[] = { "lines", "boxes", "triangles" };
+	int frames = 0;
+	cl_ubyte64 total_time = 0;
+
+	while(!window.get_ic().get_keyboard().get_keycode(CL_KEY_ESCAPE))
+	{
+		if (window.get_ic().get_keyboard().get_keycode(CL_KEY_SPACE))
+		{
+			while (window.get_ic().get_keyboard().get_keycode(CL_KEY_SPACE))
+				CL_KeepAlive::process();
+			mode = (mode + 1) % 3;
+			frames = 0;
+			total_time = 0;
+		}
+
+		gc.clear(CL_Colorf::black);
+
+		cl_ubyte64 start_time = CL_System::get_microseconds();
+		for (int i = 0; i < num_lines; i++)
+		{
+			const CL_Vec2f &p = points[i*2+0];
+			const CL_Vec2f &q = points[i*2+1];
+			if (mode == 0)
+				CL_Draw::line(gc, p.x, p.y, q.x, q.y, colors[i]);
+			else if (mode == 1)
+				CL_Draw::box(gc, p.x, p.y, q.x, q.y, colors[i]);
+			else
+				CL_Draw::triangle(gc, CL_Pointf(p.x, p.y), CL_Pointf(q.x, q.y), CL_Pointf(p.x, q.y), colors[i]);
+		}
+		gc.flush_batcher();
+		total_time += CL_System::get_microseconds() - start_time;
+		frames++;
+
+		if (frames == 100)
+		{
+			CL_Console::write_line("   %1 %2: %3 ms per frame", num_lines, mode_names[mode], (int)(total_time / frames / 1000));
+			frames = 0;
+			total_time = 0;
+		}
+
+		window.flip(0);
+		CL_KeepAlive::process();
+	}
+}
+
+void TestApp::fill_with_triangles(CL_GraphicContext &gc, int x, int y, int width, int height, int cell_size, const CL_Colorf &color)
+{
+	for (int cell_y = y; cell_y < y + height; cell_y += cell_size)
+	{
+		for (int cell_x = x; cell_x < x + width; cell_x += cell_size)
+		{
+			CL_Pointf top_left((float)cell_x, (float)cell_y);
+			CL_Pointf top_right((float)(cell_x + cell_size), (float)cell_y);
+			CL_Pointf bottom_left((float)cell_x, (float)(cell_y + cell_size));
+			CL_Pointf bottom_right((float)(cell_x + cell_size), (float)(cell_y + cell_size));
+			CL_Draw::triangle(gc, top_left, top_right, bottom_left, color);
+			CL_Draw::triangle(gc, top_right, bottom_right, bottom_left, color);
+		}
+	}
+}
+
+void TestApp::check_pixel(const CL_PixelBuffer &pixels, int x, int y, const CL_Colorf &color)
+{
+	// get_pixeldata returns the rows top down, with the bytes of cl_rgba8 in red, green, blue order
+	const unsigned char *pixel = pixels.get_line_uint8(y) + x * 4;
+	if (pixel[0] != (int) (color.r * 255.0f + 0.5f) || pixel[1] != (int) (color.g * 255.0f + 0.5f) || pixel[2] != (int) (color.b * 255.0f + 0.5f))
+	{
+		CL_Console::write_line("   Pixel %1,%2 is %3,%4,%5", x, y, (int) pixel[0], (int) pixel[1], (int) pixel[2]);
+		fail();
+	}
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}
@@ -0,0 +1,49 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+#include <ClanLib/gl.h>
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	void test_batch_split(CL_GraphicContext &gc);
+	void test_modelview(CL_GraphicContext &gc);
+	void test_batcher_order(CL_GraphicContext &gc);
+	void benchmark(CL_DisplayWindow &window, CL_GraphicContext &gc);
+
+	void fill_with_triangles(CL_GraphicContext &gc, int x, int y, int width, int height, int cell_size, const CL_Colorf &color);
+	void check_pixel(const CL_PixelBuffer &pixels, int x, int y, const CL_Colorf &color);
+	void fail();
+};
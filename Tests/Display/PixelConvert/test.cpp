@@ -0,0 +1,219 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanDisplay pixel format conversion");
+
+		test_conversions();
+		test_premultiply();
+		benchmark();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_conversions()
+{
+	CL_Console::write_line(" Specialized conversions match the generic converter");
+	test_conversion(cl_rgba8, cl_argb8);
+	test_conversion(cl_argb8, cl_rgba8);
+	test_conversion(cl_rgb8, cl_rgba8);
+	test_conversion(cl_rgb8, cl_argb8);
+	test_conversion(cl_bgr8, cl_rgba8);
+	test_conversion(cl_bgr8, cl_argb8);
+	test_conversion(cl_r8, cl_rgba8);
+	test_conversion(cl_r8, cl_argb8);
+
+	CL_Console::write_line(" Float to 8-bit conversion");
+	const int width = 37;
+	std::vector<float> values(width * 4);
+	for (int i = 0; i < width * 4; i++)
+		values[i] = (i % 13) / 10.0f - 0.1f;
+	CL_PixelBuffer input(width, 1, cl_rgba32f, &values[0]);
+	CL_PixelBuffer rgba = input.to_format(cl_rgba8);
+	CL_PixelBuffer argb = input.to_format(cl_argb8);
+	const cl_ubyte32 *rgba_data = (const cl_ubyte32 *) rgba.get_data();
+	const cl_ubyte32 *argb_data = (const cl_ubyte32 *) argb.get_data();
+	for (int x = 0; x < width; x++)
+	{
+		cl_ubyte32 c[4];
+		for (int i = 0; i < 4; i++)
+		{
+			float v = cl_clamp(values[x * 4 + i], 0.0f, 1.0f);
+			c[i] = (cl_ubyte32) (v * 255.0f + 0.5f);
+		}
+		if (rgba_data[x] != ((c[0] << 24) | (c[1] << 16) | (c[2] << 8) | c[3]))
+			fail();
+		if (argb_data[x] != ((c[3] << 24) | (c[0] << 16) | (c[1] << 8) | c[2]))
+			fail();
+	}
+}
+
+void TestApp::test_conversion(CL_TextureFormat input_format, CL_TextureFormat output_format)
+{
+	// Odd sizes exercise the scalar tails of the SIMD loops
+	CL_PixelBuffer input = create_random_buffer(67, 5, input_format);
+
+	// Enabling a colorkey that never matches forces the generic converter
+	CL_PixelBuffer generic_input = input.copy();
+	generic_input.set_colorkey(true, 0x01020304);
+
+	CL_PixelBuffer specialized = input.to_format(output_format);
+	CL_PixelBuffer generic = generic_input.to_format(output_format);
+	if (memcmp(specialized.get_data(), generic.get_data(), 67 * 5 * 4) != 0)
+		fail();
+}
+
+void TestApp::test_premultiply()
+{
+	CL_Console::write_line(" Premultiplied alpha");
+
+	// Every combination of color and alpha value
+	CL_PixelBuffer rgba(256, 256, cl_rgba8);
+	cl_ubyte32 *data = (cl_ubyte32 *) rgba.get_data();
+	for (int a = 0; a < 256; a++)
+		for (int c = 0; c < 256; c++)
+			data[a * 256 + c] = (c << 24) | ((255 - c) << 16) | (c << 8) | a;
+
+	CL_PixelBuffer argb = rgba.to_format(cl_argb8);
+	rgba.premultiply_alpha();
+	argb.premultiply_alpha();
+
+	const cl_ubyte32 *argb_data = (const cl_ubyte32 *) argb.get_data();
+	for (int a = 0; a < 256; a++)
+	{
+		for (int c = 0; c < 256; c++)
+		{
+			cl_ubyte32 r = c * a / 255;
+			cl_ubyte32 g = (255 - c) * a / 255;
+			if (data[a * 256 + c] != ((r << 24) | (g << 16) | (r << 8) | a))
+				fail();
+			if (argb_data[a * 256 + c] != ((a << 24) | (r << 16) | (g << 8) | r))
+				fail();
+		}
+	}
+}
+
+void TestApp::benchmark()
+{
+	CL_Console::write_line("Conversion speed for 3840x2160 images:");
+
+	const CL_TextureFormat pairs[][2] =
+	{
+		{ cl_rgba8, cl_argb8 },
+		{ cl_rgb8, cl_rgba8 },
+		{ cl_r8, cl_rgba8 },
+		{ cl_rgba32f, cl_rgba8 },
+		{ cl_rgba8, cl_rgb8 }
+	};
+	const char *names[] = { "rgba8 -> argb8", "rgb8 -> rgba8", "r8 -> rgba8", "rgba32f -> rgba8", "rgba8 -> rgb8 (generic)" };
+
+	for (int i = 0; i < 5; i++)
+	{
+		CL_PixelBuffer input = create_random_buffer(3840, 2160, pairs[i][0]);
+		CL_PixelBuffer output(3840, 2160, pairs[i][1]);
+
+		cl_ubyte64 start_time = CL_System::get_microseconds();
+		input.convert(output);
+		cl_ubyte64 end_time = CL_System::get_microseconds();
+
+		int elapsed = (int) (end_time - start_time);
+		CL_Console::write_line(cl_format("  %1: %2 ms (%3 megapixels/s)", names[i], elapsed / 1000, (int) (3840.0 * 2160.0 / cl_max(elapsed, 1))));
+	}
+}
+
+CL_PixelBuffer TestApp::create_random_buffer(int width, int height, CL_TextureFormat format)
+{
+	CL_PixelBuffer buffer(width, height, format);
+	int size = width * height * buffer.get_bytes_per_pixel();
+	unsigned char *data = (unsigned char *) buffer.get_data();
+	if (format == cl_rgba32f)
+	{
+		float *values = (float *) data;
+		for (int i = 0; i < width * height * 4; i++)
+			values[i] = (rand() % 1200) / 1000.0f - 0.1f;
+	}
+	else
+	{
+		for (int i = 0; i < size; i++)
+			data[i] = rand() & 0xfe;	// Never produces the 0x01020304 colorkey
+	}
+	return buffer;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}
@@ -0,0 +1,203 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupDisplay setup_display;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanDisplay pixel buffer scaling");
+
+		test_constant_color();
+		test_box_average();
+		test_threads();
+		test_mipmaps();
+		benchmark();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_constant_color()
+{
+	CL_Console::write_line(" Constant color is preserved by every filter");
+
+	CL_PixelBuffer input(53, 41, cl_rgba8);
+	cl_ubyte32 *data = (cl_ubyte32 *) input.get_data();
+	for (int i = 0; i < 53 * 41; i++)
+		data[i] = 0x80ff2040;
+
+	const CL_PixelBufferScaleFilter filters[] = { cl_scale_filter_box, cl_scale_filter_bilinear, cl_scale_filter_lanczos3 };
+	const CL_Size sizes[] = { CL_Size(17, 9), CL_Size(53, 41), CL_Size(120, 97), CL_Size(1, 1) };
+	for (int f = 0; f < 3; f++)
+	{
+		for (int s = 0; s < 4; s++)
+		{
+			CL_PixelBuffer output = CL_PixelBufferHelp::scale(input, sizes[s].width, sizes[s].height, filters[f]);
+			const cl_ubyte32 *output_data = (const cl_ubyte32 *) output.get_data();
+			for (int i = 0; i < sizes[s].width * sizes[s].height; i++)
+			{
+				if (output_data[i] != 0x80ff2040)
+					fail();
+			}
+		}
+	}
+}
+
+void TestApp::test_box_average()
+{
+	CL_Console::write_line(" Box filter halves by averaging 2x2 blocks");
+
+	CL_PixelBuffer input = create_random_buffer(64, 32);
+	CL_PixelBuffer output = CL_PixelBufferHelp::scale(input, 32, 16, cl_scale_filter_box);
+	const unsigned char *in = (const unsigned char *) input.get_data();
+	const unsigned char *out = (const unsigned char *) output.get_data();
+	for (int y = 0; y < 16; y++)
+	{
+		for (int x = 0; x < 32; x++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				int sum = in[((y * 2) * 64 + x * 2) * 4 + c] + in[((y * 2) * 64 + x * 2 + 1) * 4 + c] +
+					in[((y * 2 + 1) * 64 + x * 2) * 4 + c] + in[((y * 2 + 1) * 64 + x * 2 + 1) * 4 + c];
+				if (abs(out[(y * 32 + x) * 4 + c] - (sum + 2) / 4) > 1)
+					fail();
+			}
+		}
+	}
+}
+
+void TestApp::test_threads()
+{
+	CL_Console::write_line(" Threaded scaling matches single threaded scaling");
+
+	CL_PixelBuffer input = create_random_buffer(400, 300);
+	CL_PixelBuffer single = CL_PixelBufferHelp::scale(input, 257, 511, cl_scale_filter_lanczos3, 1);
+	CL_PixelBuffer threaded = CL_PixelBufferHelp::scale(input, 257, 511, cl_scale_filter_lanczos3, 4);
+	if (memcmp(single.get_data(), threaded.get_data(), 257 * 511 * 4) != 0)
+		fail();
+}
+
+void TestApp::test_mipmaps()
+{
+	CL_Console::write_line(" Mipmap chain");
+
+	CL_PixelBuffer input = create_random_buffer(100, 37);
+	std::vector<CL_PixelBuffer> levels = CL_PixelBufferHelp::generate_mipmaps(input);
+
+	const int widths[] = { 100, 50, 25, 12, 6, 3, 1 };
+	const int heights[] = { 37, 18, 9, 4, 2, 1, 1 };
+	if (levels.size() != 7)
+		fail();
+	for (int i = 0; i < 7; i++)
+	{
+		if (levels[i].get_width() != widths[i] || levels[i].get_height() != heights[i])
+			fail();
+	}
+}
+
+void TestApp::benchmark()
+{
+	CL_Console::write_line("Scaling 3840x2160 to 1920x1080:");
+
+	CL_PixelBuffer input = create_random_buffer(3840, 2160);
+	const CL_PixelBufferScaleFilter filters[] = { cl_scale_filter_box, cl_scale_filter_bilinear, cl_scale_filter_lanczos3 };
+	const char *names[] = { "box", "bilinear", "lanczos3" };
+	for (int f = 0; f < 3; f++)
+	{
+		for (int threads = 1; threads >= 0; threads--)
+		{
+			cl_ubyte64 start_time = CL_System::get_microseconds();
+			CL_PixelBufferHelp::scale(input, 1920, 1080, filters[f], threads);
+			cl_ubyte64 end_time = CL_System::get_microseconds();
+			CL_Console::write_line(cl_format("  %1, %2: %3 ms", names[f], threads == 1 ? "1 thread" : "all cores", (int) (end_time - start_time) / 1000));
+		}
+	}
+
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	CL_PixelBufferHelp::generate_mipmaps(input);
+	cl_ubyte64 end_time = CL_System::get_microseconds();
+	CL_Console::write_line(cl_format("  full mipmap chain: %1 ms", (int) (end_time - start_time) / 1000));
+}
+
+CL_PixelBuffer TestApp::create_random_buffer(int width, int height)
+{
+	CL_PixelBuffer buffer(width, height, cl_rgba8);
+	unsigned char *data = (unsigned char *) buffer.get_data();
+	for (int i = 0; i < width * height * 4; i++)
+		data[i] = rand() & 0xff;
+	return buffer;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}
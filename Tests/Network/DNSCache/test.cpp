@@ -0,0 +1,195 @@
+
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+
+// Minimal DNS server answering A queries on the loopback interface:
+//   "missing.test" gets a name error, "short.test" a one second TTL,
+//   "slow.test" is answered after 300 ms, and every other name gets a one hour TTL.
+class StubResponder
+{
+public:
+	StubResponder(const CL_SocketName &name)
+	: socket(name), query_count(0)
+	{
+		thread.start(this, &StubResponder::thread_main);
+	}
+
+	~StubResponder()
+	{
+		event_stop.set();
+		thread.join();
+	}
+
+	int get_query_count()
+	{
+		CL_MutexSection mutex_lock(&mutex);
+		return query_count;
+	}
+
+private:
+	void thread_main()
+	{
+		while (true)
+		{
+			CL_Event event_read = socket.get_read_event();
+			if (CL_Event::wait(event_stop, event_read) != 1)
+				break;
+
+			unsigned char query[512];
+			CL_SocketName from;
+			int size = socket.receive(query, 512, from);
+			if (size < 12)
+				continue;
+
+			CL_String8 name = get_question_name(query, size);
+			{
+				CL_MutexSection mutex_lock(&mutex);
+				query_count++;
+			}
+
+			if (name == "slow.test")
+				CL_System::sleep(300);
+
+			unsigned char answer[512];
+			int answer_size = create_answer(query, size, name, answer);
+			socket.send(answer, answer_size, from);
+		}
+	}
+
+	static CL_String8 get_question_name(const unsigned char *query, int size)
+	{
+		CL_String8 name;
+		int pos = 12;
+		while (pos < size && query[pos] != 0)
+		{
+			if (!name.empty())
+				name += ".";
+			name += CL_String8((const char *) query + pos + 1, query[pos]);
+			pos += query[pos] + 1;
+		}
+		return name;
+	}
+
+	static int create_answer(const unsigned char *query, int size, const CL_String8 &name, unsigned char *answer)
+	{
+		memcpy(answer, query, size);
+		bool missing = (name == "missing.test");
+		answer[2] = 0x81;
+		answer[3] = missing ? 0x83 : 0x80;
+		answer[7] = missing ? 0 : 1;	// Answer count
+		if (missing)
+			return size;
+
+		unsigned int ttl = (name == "short.test") ? 1 : 3600;
+		unsigned char record[16] =
+		{
+			0xc0, 0x0c,	// Pointer to the question name
+			0x00, 0x01,	// Type A
+			0x00, 0x01,	// Class IN
+			(unsigned char) (ttl >> 24), (unsigned char) (ttl >> 16), (unsigned char) (ttl >> 8), (unsigned char) ttl,
+			0x00, 0x04,
+			127, 0, 0, 1
+		};
+		memcpy(answer + size, record, 16);
+		return size + 16;
+	}
+
+	CL_UDPSocket socket;
+	CL_Thread thread;
+	CL_Event event_stop;
+	CL_Mutex mutex;
+	int query_count;
+};
+
+class ConcurrentLookup
+{
+public:
+	ConcurrentLookup(CL_DNSResolver &resolver) : resolver(resolver), found(false) { }
+
+	void run()
+	{
+		found = !resolver.lookup_resource("slow.test", "A", 5000).empty();
+	}
+
+	CL_DNSResolver &resolver;
+	bool found;
+};
+
+void check(bool condition, const char *test_name)
+{
+	CL_Console::write_line("%1: %2", test_name, condition ? "Passed" : "FAILED");
+	if (!condition)
+		throw CL_Exception("Test failed");
+}
+
+bool lookup_fails(CL_DNSResolver &resolver, const char *name)
+{
+	try
+	{
+		resolver.lookup_resource(name, "A", 5000);
+	}
+	catch (CL_Exception &)
+	{
+		return true;
+	}
+	return false;
+}
+
+int main(int, char**)
+{
+	CL_SetupCore setup_core;
+	CL_SetupNetwork setup_network;
+	try
+	{
+		CL_SocketName stub_name("127.0.0.1", "53531");
+		StubResponder stub(stub_name);
+
+		std::vector<CL_SocketName> dns_servers;
+		dns_servers.push_back(stub_name);
+		CL_DNSResolver resolver(dns_servers);
+
+		std::vector<CL_DNSResourceRecord> records = resolver.lookup_resource("cached.test", "A", 5000);
+		check(records.size() == 1 && records[0].get_a_address_str() == "127.0.0.1", "Answer");
+		resolver.lookup_resource("CACHED.test", "A", 5000);
+		check(stub.get_query_count() == 1, "Positive cache");
+
+		check(lookup_fails(resolver, "missing.test") && lookup_fails(resolver, "missing.test"), "Name error");
+		check(stub.get_query_count() == 2, "Negative cache");
+
+		resolver.lookup_resource("short.test", "A", 5000);
+		resolver.lookup_resource("short.test", "A", 5000);
+		check(stub.get_query_count() == 3, "Cached until TTL");
+		CL_System::sleep(1500);
+		resolver.lookup_resource("short.test", "A", 5000);
+		check(stub.get_query_count() == 4, "Expired after TTL");
+
+		std::vector<ConcurrentLookup *> lookups;
+		std::vector<CL_Thread> threads;
+		for (int i = 0; i < 4; i++)
+		{
+			lookups.push_back(new ConcurrentLookup(resolver));
+			threads.push_back(CL_Thread());
+			threads.back().start(lookups.back(), &ConcurrentLookup::run);
+		}
+		bool all_found = true;
+		for (int i = 0; i < 4; i++)
+		{
+			threads[i].join();
+			all_found = all_found && lookups[i]->found;
+			delete lookups[i];
+		}
+		check(all_found && stub.get_query_count() == 5, "Coalesced lookups");
+
+		resolver.clear_cache();
+		resolver.lookup_resource("cached.test", "A", 5000);
+		check(stub.get_query_count() == 6, "Clear cache");
+
+		CL_Console::write_line("All Tests Complete");
+	}
+	catch (CL_Exception e)
+	{
+		CL_Console::write_line(e.message);
+		return 1;
+	}
+	return 0;
+}
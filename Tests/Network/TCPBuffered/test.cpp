@@ -0,0 +1,278 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupNetwork setup_network;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanNetwork buffered TCP connections over loopback");
+
+		port = 27015;
+		CL_TCPListen loopback_listen(CL_SocketName("127.0.0.1", CL_StringHelp::int_to_text(port)));
+		listen = &loopback_listen;
+
+		test_unbuffered();
+		test_buffered();
+		test_partial_reads();
+		test_destructor_flush();
+		test_concurrent_flush();
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_unbuffered()
+{
+	CL_Console::write_line("   Unbuffered round trip");
+
+	CL_TCPConnection client, server;
+	connect_loopback(client, server);
+
+	// The sender runs on its own thread, as the data does not fit in the socket buffers
+	CL_Thread thread;
+	thread.start(this, &TestApp::send_pattern, client, 256*1024, 1000);
+	receive_pattern(server, 256*1024, 4096);
+	thread.join();
+}
+
+void TestApp::test_buffered()
+{
+	CL_Console::write_line("   Buffered round trip");
+
+	CL_TCPConnection client, server;
+	connect_loopback(client, server);
+	client.set_buffered();
+	server.set_buffered();
+
+	// Small writes are gathered in the write buffer, large ones bypass it
+	CL_Thread thread;
+	thread.start(this, &TestApp::send_pattern, client, 256*1024, 13);
+	receive_pattern(server, 256*1024, 7);
+	thread.join();
+
+	thread.start(this, &TestApp::send_pattern, client, 256*1024, 40000);
+	receive_pattern(server, 256*1024, 50000);
+	thread.join();
+
+	// A receive must flush the request the peer is waiting for before it waits for the reply
+	thread.start(this, &TestApp::echo, server, 4);
+	const char request[] = "ping";
+	char reply[4];
+	client.send(request, 4);
+	client.receive(reply, 4);
+	thread.join();
+	if (memcmp(reply, request, 4))
+		fail();
+}
+
+void TestApp::test_partial_reads()
+{
+	CL_Console::write_line("   Partial reads");
+
+	for (int buffered = 0; buffered < 2; buffered++)
+	{
+		CL_TCPConnection client, server;
+		connect_loopback(client, server);
+		client.set_buffered(buffered != 0);
+		server.set_buffered(buffered != 0);
+
+		const int length = 1000;
+		send_pattern(client, length, length);
+		client.flush();
+
+		// A read that is not required to complete returns what has arrived so far
+		char buffer[4*length];
+		int pos = 0;
+		while (pos < length)
+		{
+			int received = server.receive(buffer + pos, sizeof(buffer) - pos, false);
+			if (received <= 0)
+				fail();
+			pos += received;
+		}
+		if (pos != length)
+			fail();
+		for (int i = 0; i < length; i++)
+		{
+			if ((unsigned char) buffer[i] != pattern_byte(i))
+				fail();
+		}
+
+		// A peek does not consume the data
+		send_pattern(client, 10, 10);
+		client.flush();
+		int peeked = 0;
+		while (peeked == 0)
+		{
+			if (!server.get_read_event().wait(15000))
+				fail();
+			peeked = server.peek(buffer, 10);
+		}
+		if ((unsigned char) buffer[0] != pattern_byte(0))
+			fail();
+		receive_pattern(server, 10, 3);
+	}
+}
+
+void TestApp::test_destructor_flush()
+{
+	CL_Console::write_line("   Buffered data is sent when the connection is destroyed");
+
+	CL_TCPConnection server;
+	{
+		CL_TCPConnection client;
+		connect_loopback(client, server);
+		client.set_buffered();
+		unsigned char data[100];
+		for (int i = 0; i < 100; i++)
+			data[i] = pattern_byte(i);
+		client.send(data, 100);
+	}
+
+	receive_pattern(server, 100, 100);
+}
+
+void TestApp::test_concurrent_flush()
+{
+	CL_Console::write_line("   Flushing from another thread while sending");
+
+	CL_TCPConnection client, server;
+	connect_loopback(client, server);
+	client.set_buffered();
+
+	CL_Thread sender, flusher;
+	sender.start(this, &TestApp::send_pattern, client, 1024*1024, 11);
+	flusher.start(this, &TestApp::flush_repeatedly, client, 20000);
+	receive_pattern(server, 1024*1024, 4096);
+	sender.join();
+	flusher.join();
+}
+
+void TestApp::connect_loopback(CL_TCPConnection &client, CL_TCPConnection &server)
+{
+	client = CL_TCPConnection(CL_SocketName("127.0.0.1", CL_StringHelp::int_to_text(port)));
+	server = listen->accept();
+}
+
+void TestApp::send_pattern(CL_TCPConnection connection, int length, int chunk_size)
+{
+	std::vector<unsigned char> chunk(chunk_size);
+	for (int pos = 0; pos < length; pos += chunk_size)
+	{
+		int size = cl_min(chunk_size, length - pos);
+		for (int i = 0; i < size; i++)
+			chunk[i] = pattern_byte(pos + i);
+		connection.send(&chunk[0], size);
+	}
+	connection.flush();
+}
+
+void TestApp::echo(CL_TCPConnection connection, int length)
+{
+	std::vector<char> buffer(length);
+	connection.receive(&buffer[0], length);
+	connection.send(&buffer[0], length);
+	connection.flush();
+}
+
+void TestApp::flush_repeatedly(CL_TCPConnection connection, int count)
+{
+	for (int i = 0; i < count; i++)
+		connection.flush();
+}
+
+void TestApp::receive_pattern(CL_TCPConnection &connection, int length, int chunk_size)
+{
+	std::vector<unsigned char> chunk(chunk_size);
+	for (int pos = 0; pos < length; pos += chunk_size)
+	{
+		int size = cl_min(chunk_size, length - pos);
+		if (connection.receive(&chunk[0], size) != size)
+			fail();
+		for (int i = 0; i < size; i++)
+		{
+			if (chunk[i] != pattern_byte(pos + i))
+				fail();
+		}
+	}
+}
+
+unsigned char TestApp::pattern_byte(int pos)
+{
+	// Period of 251 so that chunk boundaries never line up with the pattern
+	return (unsigned char) (pos % 251);
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}
@@ -0,0 +1,56 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/network.h>
+
+class TestApp
+{
+public:
+	virtual int main(const std::vector<CL_String> &args);
+
+private:
+	void test_unbuffered();
+	void test_buffered();
+	void test_partial_reads();
+	void test_destructor_flush();
+	void test_concurrent_flush();
+
+	void connect_loopback(CL_TCPConnection &client, CL_TCPConnection &server);
+	void send_pattern(CL_TCPConnection connection, int length, int chunk_size);
+	void echo(CL_TCPConnection connection, int length);
+	void flush_repeatedly(CL_TCPConnection connection, int count);
+	void receive_pattern(CL_TCPConnection &connection, int length, int chunk_size);
+	static unsigned char pattern_byte(int pos);
+	void fail();
+
+	CL_TCPListen *listen;
+	int port;
+};
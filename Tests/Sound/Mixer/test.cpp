@@ -0,0 +1,281 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupSound setup_sound;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanSound offline mixing");
+
+		test_wave_output();
+		test_command_overflow();
+		test_commands_while_rendering();
+
+		CL_Console::write_line("Mixer throughput at 48 kHz (one second of audio):");
+		benchmark(16, 1, 0);
+		benchmark(64, 1, 0);
+		benchmark(256, 1, 0);
+		benchmark(256, 0, 0);
+		benchmark(256, 1, 32);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_wave_output()
+{
+	CL_Console::write_line(" Offline wave output");
+
+	CL_DataBuffer wave_data;
+	CL_IODevice_Memory wave_file(wave_data);
+	{
+		CL_SoundOutput_Description desc;
+		desc.set_mixing_frequency(48000);
+		CL_SoundOutput_Offline output(desc, wave_file);
+
+		CL_SoundBuffer buffer = create_tone(48000);
+		CL_SoundBuffer_Session session = buffer.play(true, &output);
+
+		int rendered = output.render(48000);
+		if (rendered < 48000 || rendered != output.get_rendered_samples())
+			fail();
+
+		session.stop();
+		output.render(1);
+	}
+
+	wave_data = wave_file.get_data();
+	if (wave_data.get_size() < 44 + 48000 * 4)
+		fail();
+
+	// The header must describe the samples that were written
+	CL_IODevice_Memory wave_input(wave_data);
+	CL_SoundProvider_Wave provider(wave_input);
+	CL_SoundProvider_Session *provider_session = provider.begin_session();
+	if (provider_session->get_frequency() != 48000 || provider_session->get_num_channels() != 2)
+		fail();
+	if (provider_session->get_num_samples() != (wave_data.get_size() - 44) / 4)
+		fail();
+
+	// The tone is looping, so the output must not be silent
+	std::vector<float> left(1024), right(1024);
+	float *channels[2] = { &left[0], &right[0] };
+	provider_session->set_position(10000);
+	provider_session->get_data(channels, 1024);
+	float peak = 0.0f;
+	for (int i = 0; i < 1024; i++)
+		peak = cl_max(peak, (float) fabs(left[i]));
+	if (peak < 0.1f)
+		fail();
+	provider.end_session(provider_session);
+}
+
+void TestApp::test_command_overflow()
+{
+	CL_Console::write_line(" Queueing more commands than the command queue holds");
+
+	// The offline output has no mixer thread, so nothing drains the queue until render() is called
+	CL_SoundOutput_Description desc;
+	desc.set_mixing_frequency(48000);
+	CL_SoundOutput_Offline output(desc);
+
+	CL_SoundBuffer buffer = create_tone(48000);
+	std::vector<CL_SoundBuffer_Session> sessions;
+	for (int i = 0; i < 1500; i++)
+	{
+		CL_SoundBuffer_Session session = buffer.prepare(true, &output);
+		session.set_volume(1.0f / 1500);
+		session.play();
+		sessions.push_back(session);
+	}
+
+	// The commands must be applied in the order they were queued
+	for (int i = 0; i < 3000; i++)
+		output.set_global_volume((i & 1) ? 1.0f : 0.5f);
+	output.set_global_volume(0.0f);
+	output.render(4800);
+	if (get_peak(output) != 0.0f)
+		fail();
+	output.clear();
+
+	for (int i = 0; i < 3000; i++)
+		output.set_global_volume((i & 1) ? 0.0f : 0.5f);
+	output.set_global_volume(1.0f);
+	output.render(4800);
+	if (get_peak(output) < 0.1f)
+		fail();
+	output.clear();
+
+	output.stop_all();
+	output.render(1);
+	for (std::vector<CL_SoundBuffer_Session>::size_type i = 0; i < sessions.size(); i++)
+	{
+		if (sessions[i].is_playing())
+			fail();
+	}
+}
+
+void TestApp::test_commands_while_rendering()
+{
+	CL_Console::write_line(" Queueing commands from another thread while rendering");
+
+	CL_SoundOutput_Description desc;
+	desc.set_mixing_frequency(48000);
+	CL_SoundOutput_Offline output(desc);
+
+	CL_Thread thread;
+	thread.start(this, &TestApp::play_sessions, &output, 5000);
+	while (!thread_done.wait(0))
+	{
+		output.render(480);
+		output.clear();
+	}
+	thread.join();
+
+	output.render(1);
+	for (std::vector<CL_SoundBuffer_Session>::size_type i = 0; i < thread_sessions.size(); i++)
+	{
+		if (thread_sessions[i].is_playing())
+			fail();
+	}
+	thread_sessions.clear();
+}
+
+void TestApp::play_sessions(CL_SoundOutput_Offline *output, int count)
+{
+	CL_SoundBuffer buffer = create_tone(48000);
+	for (int i = 0; i < count; i++)
+	{
+		CL_SoundBuffer_Session session = buffer.prepare(true, output);
+		session.set_volume(1.0f / count);
+		session.play();
+		thread_sessions.push_back(session);
+	}
+	output->stop_all();
+	thread_done.set();
+}
+
+void TestApp::benchmark(int num_voices, int mixer_threads, int max_real_voices)
+{
+	CL_SoundOutput_Description desc;
+	desc.set_mixing_frequency(48000);
+	desc.set_mixer_threads(mixer_threads);
+	desc.set_max_real_voices(max_real_voices);
+	CL_SoundOutput_Offline output(desc);
+
+	CL_SoundBuffer buffer = create_tone(22050);
+	std::vector<CL_SoundBuffer_Session> sessions;
+	for (int i = 0; i < num_voices; i++)
+	{
+		CL_SoundBuffer_Session session = buffer.prepare(true, &output);
+		session.set_volume(1.0f / num_voices);
+		session.set_frequency(22050 + i * 10);
+		session.set_priority(i % 4);
+		session.play();
+		sessions.push_back(session);
+	}
+
+	cl_ubyte64 start_time = CL_System::get_microseconds();
+	output.render(48000);
+	cl_ubyte64 end_time = CL_System::get_microseconds();
+	output.clear();
+
+	output.stop_all();
+	output.render(1);
+
+	int elapsed = (int) (end_time - start_time);
+	float realtime_factor = 1000000.0f / cl_max(elapsed, 1);
+	CL_Console::write_line(cl_format("  %1 voices, %2 mixer threads, %3 real voices: %4 ms (%5x realtime, %6 realtime voices)",
+		num_voices, mixer_threads, max_real_voices, elapsed / 1000, (int) realtime_factor, (int) (num_voices * realtime_factor)));
+}
+
+CL_SoundBuffer TestApp::create_tone(int frequency)
+{
+	std::vector<unsigned char> tone_data(frequency);
+	for (int i = 0; i < frequency; i++)
+		tone_data[i] = (unsigned char) (128.5 + 100.0 * sin(2.0 * CL_PI * 440.0 * i / frequency));
+	return CL_SoundBuffer(new CL_SoundProvider_Raw(&tone_data[0], frequency, 1, false, frequency));
+}
+
+float TestApp::get_peak(CL_SoundOutput_Offline &output)
+{
+	float peak = 0.0f;
+	const float *data = output.get_data();
+	for (int i = 0; i < output.get_data_size() * 2; i++)
+		peak = cl_max(peak, (float) fabs(data[i]));
+	return peak;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}
@@ -0,0 +1,290 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2011 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    Mark Page
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// This is the Program class that is called by CL_ClanApplication
+class Program
+{
+public:
+	static int main(const std::vector<CL_String> &args)
+	{
+		// Initialize ClanLib base components
+		CL_SetupCore setup_core;
+		CL_SetupSound setup_sound;
+
+		// Start the Application
+		TestApp app;
+		int retval = app.main(args);
+		return retval;
+	}
+};
+
+// Instantiate CL_ClanApplication, informing it where the Program is located
+CL_ClanApplication app(&Program::main);
+
+int TestApp::main(const std::vector<CL_String> &args)
+{
+	// Create a console window for text-output if not available
+	CL_ConsoleWindow console("Console");
+
+
+	try
+	{
+		CL_Console::write_line("ClanLib Test Suite:");
+		CL_Console::write_line("-------------------");
+#ifdef WIN32
+		CL_Console::write_line("Target: WIN32");
+#else
+		CL_Console::write_line("Target: LINUX");
+#endif
+		CL_Console::write_line("For clanSound sound providers");
+
+		test_cache();
+		test_wave_streaming(2, 16);
+		test_wave_streaming(1, 8);
+
+		CL_Console::write_line("All Tests Complete");
+		console.display_close_message();
+	}
+
+	catch(CL_Exception error)
+	{
+		CL_Console::write_line("Exception caught:");
+		CL_Console::write_line(error.message);
+		console.display_close_message();
+		return -1;
+	}
+
+	return 0;
+}
+
+void TestApp::test_cache()
+{
+	CL_Console::write_line(" Sound provider cache");
+
+	int old_budget = CL_SoundProviderCache::get_memory_budget();
+	CL_SoundProviderCache::clear();
+	CL_SoundProviderCache::reset_statistics();
+
+	// Room for three entries of 1000 stereo samples
+	int entry_size = 1000 * 2 * sizeof(float);
+	CL_SoundProviderCache::set_memory_budget(entry_size * 3);
+
+	int keys[4];
+	for (int i = 0; i < 3; i++)
+	{
+		if (!CL_SoundProviderCache::insert(&keys[i], create_cache_data(1000)))
+			fail();
+	}
+	if (CL_SoundProviderCache::get_memory_used() != entry_size * 3)
+		fail();
+
+	// Using the first entry makes the second one the least recently used
+	if (!CL_SoundProviderCache::find(&keys[0]))
+		fail();
+	CL_SoundProviderCache::insert(&keys[3], create_cache_data(1000));
+	if (!CL_SoundProviderCache::find(&keys[0]) || CL_SoundProviderCache::find(&keys[1]))
+		fail();
+	if (!CL_SoundProviderCache::find(&keys[2]) || !CL_SoundProviderCache::find(&keys[3]))
+		fail();
+	if (CL_SoundProviderCache::get_hits() != 4 || CL_SoundProviderCache::get_misses() != 1)
+		fail();
+	if (CL_SoundProviderCache::get_memory_used() != entry_size * 3)
+		fail();
+
+	// Entries larger than the budget are refused
+	if (CL_SoundProviderCache::insert(&keys[1], create_cache_data(4000)))
+		fail();
+
+	// Reads stop at the end of the data
+	float left[10], right[10];
+	float *channels[2] = { left, right };
+	CL_SharedPtr<CL_SoundProviderCacheData> data = CL_SoundProviderCache::find(&keys[0]);
+	if (data->get_data(995, channels, 0, 10) != 5)
+		fail();
+	if (left[4] != 999.0f || right[4] != -999.0f)
+		fail();
+
+	CL_SoundProviderCache::remove(&keys[0]);
+	if (CL_SoundProviderCache::find(&keys[0]) || CL_SoundProviderCache::get_memory_used() != entry_size * 2)
+		fail();
+
+	CL_SoundProviderCache::set_memory_budget(entry_size);
+	if (CL_SoundProviderCache::get_memory_used() > entry_size)
+		fail();
+
+	CL_SoundProviderCache::clear();
+	CL_SoundProviderCache::set_memory_budget(old_budget);
+}
+
+void TestApp::test_wave_streaming(int num_channels, int bits)
+{
+	CL_Console::write_line(cl_format(" Wave streaming, %1 channels, %2 bit", num_channels, bits));
+
+	const int num_samples = 100000;
+	CL_DataBuffer wave_data = create_wave(num_samples, num_channels, bits);
+	CL_IODevice_Memory memory_file(wave_data);
+	CL_IODevice_Memory stream_file(wave_data);
+	CL_SoundProvider_Wave memory_provider(memory_file, false);
+	CL_SoundProvider_Wave stream_provider(stream_file, true);
+
+	CL_SoundProvider_Session *memory_session = memory_provider.begin_session();
+	CL_SoundProvider_Session *stream_session = stream_provider.begin_session();
+	if (stream_session->get_num_samples() != num_samples)
+		fail();
+
+	std::vector<float> expected[2], streamed[2];
+	float *expected_ptrs[2], *streamed_ptrs[2];
+	for (int i = 0; i < 2; i++)
+	{
+		expected[i].resize(num_samples);
+		streamed[i].resize(num_samples);
+		expected_ptrs[i] = &expected[i][0];
+		streamed_ptrs[i] = &streamed[i][0];
+	}
+
+	// Read the whole file in odd sized blocks, then again after looping back to the start, then after a seek
+	int seek_position = 77777;
+	for (int pass = 0; pass < 3; pass++)
+	{
+		int start = (pass == 2) ? seek_position : 0;
+		if (pass > 0)
+		{
+			memory_session->set_position(start);
+			stream_session->set_position(start);
+		}
+
+		int pos = start;
+		while (pos < num_samples)
+		{
+			int block = cl_min(1237, num_samples - pos);
+			if (get_all_data(memory_session, expected_ptrs, num_channels, pos, block) != block)
+				fail();
+			if (get_all_data(stream_session, streamed_ptrs, num_channels, pos, block) != block)
+				fail();
+			pos += block;
+		}
+		if (!stream_session->eof())
+			fail();
+
+		for (int chan = 0; chan < num_channels; chan++)
+		{
+			for (int i = start; i < num_samples; i++)
+			{
+				if (fabs(expected[chan][i] - streamed[chan][i]) > 0.0001f)
+					fail();
+			}
+		}
+	}
+
+	memory_provider.end_session(memory_session);
+	stream_provider.end_session(stream_session);
+}
+
+int TestApp::get_all_data(CL_SoundProvider_Session *session, float **channels, int num_channels, int offset, int data_requested)
+{
+	// Streamed sessions return what has been read ahead so far, so keep asking until the block is complete
+	int received = 0;
+	unsigned int start_time = CL_System::get_time();
+	while (received < data_requested && CL_System::get_time() - start_time < 5000)
+	{
+		float *ptrs[2] = { channels[0] + offset + received, channels[num_channels - 1] + offset + received };
+		int result = session->get_data(ptrs, data_requested - received);
+		if (result == 0)
+			CL_System::sleep(1);
+		received += result;
+	}
+	return received;
+}
+
+CL_DataBuffer TestApp::create_wave(int num_samples, int num_channels, int bits)
+{
+	int block_align = num_channels * bits / 8;
+	int data_size = num_samples * block_align;
+
+	CL_DataBuffer wave_data;
+	CL_IODevice_Memory wave_file(wave_data);
+	wave_file.set_little_endian_mode();
+	wave_file.write("RIFF", 4);
+	wave_file.write_uint32(36 + data_size);
+	wave_file.write("WAVE", 4);
+	wave_file.write("fmt ", 4);
+	wave_file.write_uint32(16);
+	wave_file.write_uint16(1);
+	wave_file.write_uint16(num_channels);
+	wave_file.write_uint32(44100);
+	wave_file.write_uint32(44100 * block_align);
+	wave_file.write_uint16(block_align);
+	wave_file.write_uint16(bits);
+	wave_file.write("data", 4);
+	wave_file.write_uint32(data_size);
+
+	std::vector<unsigned char> samples;
+	samples.reserve(data_size);
+	for (int i = 0; i < num_samples; i++)
+	{
+		for (int chan = 0; chan < num_channels; chan++)
+		{
+			float value = (float) sin(i * 0.01 + chan);
+			if (bits == 16)
+			{
+				int sample = (int) (value * 30000.0f);
+				samples.push_back((unsigned char) (sample & 0xff));
+				samples.push_back((unsigned char) ((sample >> 8) & 0xff));
+			}
+			else
+			{
+				samples.push_back((unsigned char) (128.0f + value * 120.0f));
+			}
+		}
+	}
+	wave_file.write(&samples[0], data_size);
+	return wave_file.get_data();
+}
+
+CL_SharedPtr<CL_SoundProviderCacheData> TestApp::create_cache_data(int num_samples)
+{
+	std::vector<float> left(num_samples), right(num_samples);
+	for (int i = 0; i < num_samples; i++)
+	{
+		left[i] = (float) i;
+		right[i] = (float) -i;
+	}
+	float *channels[2] = { &left[0], &right[0] };
+
+	CL_SharedPtr<CL_SoundProviderCacheData> data(new CL_SoundProviderCacheData(2, 44100));
+	data->append(channels, 0, num_samples);
+	return data;
+}
+
+void TestApp::fail()
+{
+	throw CL_Exception("Failed");
+}